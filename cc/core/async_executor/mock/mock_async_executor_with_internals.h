@@ -59,6 +59,18 @@ class MockAsyncExecutorWithInternals : public core::AsyncExecutor {
     return AsyncExecutor::Schedule(work, priority, affinity);
   }
 
+  ExecutionResult Schedule(AsyncOperation&& work,
+                           AsyncPriority priority) noexcept override {
+    return Schedule(static_cast<const AsyncOperation&>(work), priority);
+  }
+
+  ExecutionResult Schedule(
+      AsyncOperation&& work, AsyncPriority priority,
+      AsyncExecutorAffinitySetting affinity) noexcept override {
+    return Schedule(static_cast<const AsyncOperation&>(work), priority,
+                    affinity);
+  }
+
   ExecutionResult ScheduleFor(const AsyncOperation& work,
                               Timestamp timestamp) noexcept override {
     std::function<bool()> callback;
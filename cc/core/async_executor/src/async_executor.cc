@@ -14,13 +14,18 @@
 
 #include "async_executor.h"
 
+#include <sched.h>
+
+#include <algorithm>
 #include <chrono>
 #include <functional>
 #include <memory>
 #include <random>
 #include <thread>
+#include <utility>
 #include <vector>
 
+#include "cc/core/common/time_provider/src/time_provider.h"
 #include "cc/core/interface/async_context.h"
 #include "cc/core/interface/async_executor_interface.h"
 #include "public/core/interface/execution_result.h"
@@ -28,17 +33,31 @@
 #include "error_codes.h"
 #include "typedef.h"
 
+using google::scp::core::common::TimeProvider;
 using std::atomic;
+using std::forward;
 using std::function;
 using std::is_same_v;
+using std::lower_bound;
 using std::make_shared;
+using std::make_unique;
+using std::max;
 using std::memory_order_relaxed;
+using std::memory_order_release;
+using std::min;
+using std::move;
 using std::mt19937;
+using std::mutex;
+using std::nullopt;
+using std::optional;
 using std::random_device;
 using std::shared_ptr;
 using std::thread;
 using std::uniform_int_distribution;
+using std::unique_lock;
 using std::vector;
+using std::chrono::nanoseconds;
+using std::chrono::steady_clock;
 using std::this_thread::get_id;
 
 namespace google::scp::core {
@@ -52,23 +71,74 @@ ExecutionResult AsyncExecutor::Init() noexcept {
     return FailureExecutionResult(errors::SC_ASYNC_EXECUTOR_INVALID_QUEUE_CAP);
   }
 
-  for (size_t i = 0; i < thread_count_; ++i) {
-    // TODO We select the CPU affinity just starting at 0 and working our way
-    // up. Should we instead randomly assign the CPUs?
-    size_t cpu_affinity_number = i % std::thread::hardware_concurrency();
-    urgent_task_executor_pool_.push_back(
-        make_shared<SingleThreadPriorityAsyncExecutor>(
-            queue_cap_, drop_tasks_on_stop_, cpu_affinity_number));
-    auto execution_result = urgent_task_executor_pool_.back()->Init();
-    if (!execution_result.Successful()) {
-      return execution_result;
+  // The elastic normal executors are all initialized upfront, and only the
+  // first thread_count_ of them are run.
+  auto normal_executor_count = thread_count_;
+  auto normal_telemetry_sample_interval = telemetry_sample_interval_;
+  if (elastic_thread_count_options_) {
+    normal_executor_count = elastic_thread_count_options_->max_thread_count;
+    if (normal_executor_count < thread_count_ ||
+        normal_executor_count > kMaxThreadCount) {
+      return FailureExecutionResult(
+          errors::SC_ASYNC_EXECUTOR_INVALID_THREAD_COUNT);
+    }
+    // The controller follows the queue wait time of the normal executors.
+    if (normal_telemetry_sample_interval == 0 ||
+        normal_telemetry_sample_interval > kElasticTelemetrySampleInterval) {
+      normal_telemetry_sample_interval = kElasticTelemetrySampleInterval;
+    }
+  }
+
+  if (!cpu_topology_) {
+    cpu_topology_ = CpuTopology::Discover();
+  }
+  node_executor_indices_.assign(cpu_topology_->GetNodeCount(), {});
+
+  for (size_t i = 0; i < normal_executor_count; ++i) {
+    // Both executors of a pair are pinned to the same CPU, out of the CPUs the
+    // process is allowed to run on, so that work moving between them with
+    // affinity stays on one core and one node. The pairs are spread over the
+    // nodes.
+    size_t cpu_affinity_number = cpu_topology_->GetCpuForWorker(i);
+    node_executor_indices_[*cpu_topology_->GetNodeOfCpu(cpu_affinity_number)]
+        .push_back(i);
+    if (i < thread_count_) {
+      urgent_task_executor_pool_.push_back(
+          make_shared<SingleThreadPriorityAsyncExecutor>(
+              queue_cap_, drop_tasks_on_stop_, cpu_affinity_number,
+              timer_queue_type_, telemetry_sample_interval_));
+      auto execution_result = urgent_task_executor_pool_.back()->Init();
+      if (!execution_result.Successful()) {
+        return execution_result;
+      }
     }
     normal_task_executor_pool_.push_back(make_shared<SingleThreadAsyncExecutor>(
-        queue_cap_, drop_tasks_on_stop_, cpu_affinity_number));
-    execution_result = normal_task_executor_pool_.back()->Init();
+        queue_cap_, drop_tasks_on_stop_, cpu_affinity_number,
+        worker_idle_strategy_, task_queue_backend_,
+        normal_telemetry_sample_interval));
+    auto execution_result = normal_task_executor_pool_.back()->Init();
     if (!execution_result.Successful()) {
       return execution_result;
     }
+    if (i < thread_count_ &&
+        threading_mode_ == ExecutorThreadingMode::SingleThreadPerCore) {
+      normal_task_executor_pool_.back()->SetTimerExecutor(
+          urgent_task_executor_pool_.back().get());
+    }
+  }
+
+  if (task_load_balancing_scheme_ == TaskLoadBalancingScheme::WorkStealing) {
+    // Every normal executor can steal from every other normal executor. The
+    // pool owns all the executors and outlives their worker threads.
+    for (auto& executor : normal_task_executor_pool_) {
+      vector<SingleThreadAsyncExecutor*> peers;
+      for (auto& peer : normal_task_executor_pool_) {
+        if (peer != executor) {
+          peers.push_back(peer.get());
+        }
+      }
+      executor->SetWorkStealingPeers(peers);
+    }
   }
 
   return SuccessExecutionResult();
@@ -95,19 +165,31 @@ ExecutionResult AsyncExecutor::Run() noexcept {
     if (!execution_result.Successful()) {
       return execution_result;
     }
-    ASSIGN_OR_RETURN(auto normal_thread_id, normal_executor->GetThreadId());
-    ASSIGN_OR_RETURN(auto urgent_thread_id, urgent_executor->GetThreadId());
     // We map both thread IDs to the same executors because we can maintain
     // affinity when migrating from normal -> urgent or vice versa. The
     // executors at the same index share the same affinity.
+    ASSIGN_OR_RETURN(auto normal_thread_id, normal_executor->GetThreadId());
     thread_id_to_executor_map_[normal_thread_id] = {normal_executor,
                                                     urgent_executor};
+    if (threading_mode_ == ExecutorThreadingMode::SingleThreadPerCore) {
+      // The urgent executor runs on the thread of the normal executor.
+      continue;
+    }
+    ASSIGN_OR_RETURN(auto urgent_thread_id, urgent_executor->GetThreadId());
     thread_id_to_executor_map_[urgent_thread_id] = {normal_executor,
                                                     urgent_executor};
   }
 
   running_ = true;
 
+  // The executors beyond thread_count_ are not in thread_id_to_executor_map_,
+  // as their threads come and go while the map is read without a lock. Work
+  // scheduled from them with affinity is picked an executor normally.
+  if (elastic_thread_count_options_) {
+    elastic_controller_thread_ =
+        make_unique<thread>([this]() { RunElasticController(); });
+  }
+
   return SuccessExecutionResult();
 }
 
@@ -117,6 +199,7 @@ ExecutionResult AsyncExecutor::Stop() noexcept {
   }
 
   running_ = false;
+  StopElasticController();
 
   // Ensures all of thread are waited to finish.
   for (size_t i = 0; i < thread_count_; ++i) {
@@ -129,10 +212,118 @@ ExecutionResult AsyncExecutor::Stop() noexcept {
       return execution_result;
     }
   }
+  // The elastic normal executors that are still running.
+  for (auto i = thread_count_; i < GetNormalExecutorCount(); ++i) {
+    auto execution_result = normal_task_executor_pool_.at(i)->Stop();
+    if (!execution_result.Successful()) {
+      return execution_result;
+    }
+  }
+  if (!drop_tasks_on_stop_) {
+    DrainRetiredNormalExecutors();
+  }
 
   return SuccessExecutionResult();
 }
 
+AsyncExecutor::~AsyncExecutor() {
+  StopElasticController();
+}
+
+void AsyncExecutor::StopElasticController() noexcept {
+  if (!elastic_controller_thread_) {
+    return;
+  }
+  {
+    unique_lock<mutex> lock(elastic_controller_mutex_);
+    running_ = false;
+  }
+  elastic_controller_condition_variable_.notify_all();
+  elastic_controller_thread_->join();
+  elastic_controller_thread_.reset();
+}
+
+void AsyncExecutor::RunElasticController() noexcept {
+  const auto& options = *elastic_thread_count_options_;
+  // The queue wait time histograms are cumulative, the last seen count and
+  // sum of every executor give the samples of the last control interval.
+  vector<uint64_t> last_queue_wait_counts(normal_task_executor_pool_.size());
+  vector<uint64_t> last_queue_wait_sums_ns(normal_task_executor_pool_.size());
+  auto last_busy_time = steady_clock::now();
+
+  unique_lock<mutex> lock(elastic_controller_mutex_);
+  while (true) {
+    elastic_controller_condition_variable_.wait_for(
+        lock, options.control_interval, [this]() { return !running_; });
+    if (!running_) {
+      break;
+    }
+
+    DrainRetiredNormalExecutors();
+
+    auto running_count = GetNormalExecutorCount();
+    uint64_t backlog = 0;
+    uint64_t queue_wait_count = 0;
+    uint64_t queue_wait_sum_ns = 0;
+    for (size_t i = 0; i < normal_task_executor_pool_.size(); ++i) {
+      auto telemetry = normal_task_executor_pool_[i]->GetTelemetrySnapshot();
+      if (i < running_count) {
+        backlog += telemetry.queue_depth;
+        queue_wait_count +=
+            telemetry.queue_wait_time.count - last_queue_wait_counts[i];
+        queue_wait_sum_ns +=
+            telemetry.queue_wait_time.sum_ns - last_queue_wait_sums_ns[i];
+      }
+      last_queue_wait_counts[i] = telemetry.queue_wait_time.count;
+      last_queue_wait_sums_ns[i] = telemetry.queue_wait_time.sum_ns;
+    }
+    auto mean_queue_wait_time = nanoseconds(
+        queue_wait_count == 0 ? 0 : queue_wait_sum_ns / queue_wait_count);
+
+    auto now = steady_clock::now();
+    auto backlog_threshold =
+        max<size_t>(options.backlog_per_thread_threshold, 1);
+    if (backlog > running_count * backlog_threshold ||
+        mean_queue_wait_time > options.queue_wait_time_threshold) {
+      last_busy_time = now;
+      // Adds enough executors to bring the backlog per executor under the
+      // threshold, and at least one.
+      auto target_count = max<size_t>(
+          running_count + 1,
+          (backlog + backlog_threshold - 1) / backlog_threshold);
+      target_count = min(target_count, normal_task_executor_pool_.size());
+      for (auto i = running_count; i < target_count; ++i) {
+        if (!normal_task_executor_pool_[i]->Run().Successful()) {
+          break;
+        }
+        running_normal_executor_count_.store(i + 1, memory_order_release);
+      }
+    } else if (backlog > 0) {
+      last_busy_time = now;
+    } else if (running_count > thread_count_ &&
+               now - last_busy_time >= options.idle_cool_down) {
+      // No new work is picked for the last executor before it is retired. Work
+      // that was already headed to it is either rejected and scheduled
+      // elsewhere, or queued and executed before its worker thread exits.
+      running_normal_executor_count_.store(running_count - 1,
+                                           memory_order_release);
+      normal_task_executor_pool_[running_count - 1]->Retire();
+      last_busy_time = now;
+    }
+  }
+}
+
+void AsyncExecutor::DrainRetiredNormalExecutors() noexcept {
+  for (auto i = GetNormalExecutorCount(); i < normal_task_executor_pool_.size();
+       ++i) {
+    auto& task_executor = normal_task_executor_pool_[i];
+    if (task_executor->GetPendingTaskCount() > 0 &&
+        task_executor->Run().Successful()) {
+      task_executor->Retire();
+    }
+  }
+}
+
 template <class TaskExecutorType>
 ExecutionResultOr<shared_ptr<TaskExecutorType>> AsyncExecutor::PickTaskExecutor(
     AsyncExecutorAffinitySetting affinity,
@@ -173,17 +364,20 @@ ExecutionResultOr<shared_ptr<TaskExecutorType>> AsyncExecutor::PickTaskExecutor(
     // an executor normally.
   }
 
+  auto pool_size =
+      GetSchedulableExecutorCount(task_executor_pool, task_executor_pool_type);
+
   if (task_load_balancing_scheme ==
       TaskLoadBalancingScheme::RoundRobinPerThread) {
     if (task_executor_pool_type == TaskExecutorPoolType::UrgentPool) {
       auto picked_index =
           task_counter_urgent_thread_local.fetch_add(1, memory_order_relaxed) %
-          task_executor_pool.size();
+          pool_size;
       return task_executor_pool.at(picked_index);
     } else if (task_executor_pool_type == TaskExecutorPoolType::NotUrgentPool) {
       auto picked_index = task_counter_not_urgent_thread_local.fetch_add(
                               1, memory_order_relaxed) %
-                          task_executor_pool.size();
+                          pool_size;
       return task_executor_pool.at(picked_index);
     } else {
       return FailureExecutionResult(
@@ -191,20 +385,51 @@ ExecutionResultOr<shared_ptr<TaskExecutorType>> AsyncExecutor::PickTaskExecutor(
     }
   }
 
+  if (task_load_balancing_scheme == TaskLoadBalancingScheme::NumaAware &&
+      cpu_topology_) {
+    auto current_cpu = GetCurrentCpu();
+    auto node =
+        current_cpu ? cpu_topology_->GetNodeOfCpu(*current_cpu) : nullopt;
+    if (node && *node < node_executor_indices_.size()) {
+      // The indices are ascending, so the ones of the schedulable executors
+      // come first.
+      const auto& executor_indices = node_executor_indices_[*node];
+      size_t node_pool_size =
+          lower_bound(executor_indices.begin(), executor_indices.end(),
+                      pool_size) -
+          executor_indices.begin();
+      if (node_pool_size > 0) {
+        // Thread local counters keep the callers of different nodes from
+        // contending on a shared cache line.
+        auto& task_counter =
+            task_executor_pool_type == TaskExecutorPoolType::UrgentPool
+                ? task_counter_urgent_thread_local
+                : task_counter_not_urgent_thread_local;
+        auto picked_index =
+            executor_indices[task_counter.fetch_add(1, memory_order_relaxed) %
+                             node_pool_size];
+        return task_executor_pool.at(picked_index);
+      }
+    }
+    // Otherwise the caller's node is unknown or has no executors, fall back to
+    // Round Robin across all the executors below.
+  }
+
   if (task_load_balancing_scheme == TaskLoadBalancingScheme::Random) {
-    auto picked_index =
-        distribution(random_generator) % task_executor_pool.size();
+    auto picked_index = distribution(random_generator) % pool_size;
     return task_executor_pool.at(picked_index);
   }
 
-  if (task_load_balancing_scheme == TaskLoadBalancingScheme::RoundRobinGlobal) {
+  // With work stealing, the initial placement is round robin and the idle
+  // executors rebalance the queued work afterwards.
+  if (task_load_balancing_scheme == TaskLoadBalancingScheme::RoundRobinGlobal ||
+      task_load_balancing_scheme == TaskLoadBalancingScheme::WorkStealing ||
+      task_load_balancing_scheme == TaskLoadBalancingScheme::NumaAware) {
     if (task_executor_pool_type == TaskExecutorPoolType::UrgentPool) {
-      auto picked_index =
-          task_counter_urgent.fetch_add(1) % task_executor_pool.size();
+      auto picked_index = task_counter_urgent.fetch_add(1) % pool_size;
       return task_executor_pool.at(picked_index);
     } else if (task_executor_pool_type == TaskExecutorPoolType::NotUrgentPool) {
-      auto picked_index =
-          task_counter_not_urgent.fetch_add(1) % task_executor_pool.size();
+      auto picked_index = task_counter_not_urgent.fetch_add(1) % pool_size;
       return task_executor_pool.at(picked_index);
     } else {
       return FailureExecutionResult(
@@ -216,6 +441,33 @@ ExecutionResultOr<shared_ptr<TaskExecutorType>> AsyncExecutor::PickTaskExecutor(
       errors::SC_ASYNC_EXECUTOR_INVALID_LOAD_BALANCING_TYPE);
 }
 
+template <class TaskExecutorType>
+size_t AsyncExecutor::GetSchedulableExecutorCount(
+    const vector<shared_ptr<TaskExecutorType>>& task_executor_pool,
+    TaskExecutorPoolType task_executor_pool_type) const noexcept {
+  if (elastic_thread_count_options_ &&
+      task_executor_pool_type == TaskExecutorPoolType::NotUrgentPool) {
+    return min(task_executor_pool.size(), GetNormalExecutorCount());
+  }
+  return task_executor_pool.size();
+}
+
+bool AsyncExecutor::ShouldRetryOnAnotherExecutor(
+    const ExecutionResult& execution_result, size_t attempt) const noexcept {
+  return elastic_thread_count_options_ && running_ &&
+         attempt + 1 < kElasticScheduleAttempts &&
+         execution_result ==
+             FailureExecutionResult(errors::SC_ASYNC_EXECUTOR_NOT_RUNNING);
+}
+
+optional<size_t> AsyncExecutor::GetCurrentCpu() const noexcept {
+  auto cpu = sched_getcpu();
+  if (cpu < 0) {
+    return nullopt;
+  }
+  return static_cast<size_t>(cpu);
+}
+
 ExecutionResult AsyncExecutor::Schedule(const AsyncOperation& work,
                                         AsyncPriority priority) noexcept {
   return Schedule(work, priority, AsyncExecutorAffinitySetting::NonAffinitized);
@@ -224,32 +476,186 @@ ExecutionResult AsyncExecutor::Schedule(const AsyncOperation& work,
 ExecutionResult AsyncExecutor::Schedule(
     const AsyncOperation& work, AsyncPriority priority,
     AsyncExecutorAffinitySetting affinity) noexcept {
+  return ScheduleWork(work, priority, affinity);
+}
+
+ExecutionResult AsyncExecutor::Schedule(AsyncOperation&& work,
+                                        AsyncPriority priority) noexcept {
+  return Schedule(move(work), priority,
+                  AsyncExecutorAffinitySetting::NonAffinitized);
+}
+
+ExecutionResult AsyncExecutor::Schedule(
+    AsyncOperation&& work, AsyncPriority priority,
+    AsyncExecutorAffinitySetting affinity) noexcept {
+  return ScheduleWork(move(work), priority, affinity);
+}
+
+ExecutionResult AsyncExecutor::ScheduleWithDeadline(
+    const AsyncOperation& work, AsyncPriority priority, Timestamp deadline,
+    const TaskExpirationCallback& expiration_callback) noexcept {
+  return ScheduleWork(work, priority,
+                      AsyncExecutorAffinitySetting::NonAffinitized, deadline,
+                      &expiration_callback);
+}
+
+ExecutionResult AsyncExecutor::ScheduleWithDeadline(
+    AsyncOperation&& work, AsyncPriority priority, Timestamp deadline,
+    const TaskExpirationCallback& expiration_callback) noexcept {
+  return ScheduleWork(move(work), priority,
+                      AsyncExecutorAffinitySetting::NonAffinitized, deadline,
+                      &expiration_callback);
+}
+
+ExecutionResult AsyncExecutor::ScheduleWithDeadline(
+    const AsyncOperation& work, AsyncPriority priority, Timestamp deadline,
+    const TaskExpirationCallback& expiration_callback,
+    AsyncExecutorAffinitySetting affinity) noexcept {
+  return ScheduleWork(work, priority, affinity, deadline, &expiration_callback);
+}
+
+ExecutionResult AsyncExecutor::ScheduleWithDeadline(
+    AsyncOperation&& work, AsyncPriority priority, Timestamp deadline,
+    const TaskExpirationCallback& expiration_callback,
+    AsyncExecutorAffinitySetting affinity) noexcept {
+  return ScheduleWork(move(work), priority, affinity, deadline,
+                      &expiration_callback);
+}
+
+template <class AsyncOperationType>
+ExecutionResult AsyncExecutor::ScheduleWork(
+    AsyncOperationType&& work, AsyncPriority priority,
+    AsyncExecutorAffinitySetting affinity, Timestamp deadline,
+    const TaskExpirationCallback* expiration_callback) noexcept {
   if (!running_) {
     return FailureExecutionResult(errors::SC_ASYNC_EXECUTOR_NOT_RUNNING);
   }
 
   if (priority == AsyncPriority::Urgent) {
+    // Urgent work is scheduled for now.
+    auto current_timestamp =
+        TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks();
+    if (expiration_callback && deadline <= current_timestamp) {
+      return FailureExecutionResult(
+          errors::SC_ASYNC_EXECUTOR_TASK_DEADLINE_EXCEEDED);
+    }
     ASSIGN_OR_RETURN(auto task_executor,
                      PickTaskExecutor(affinity, urgent_task_executor_pool_,
                                       TaskExecutorPoolType::UrgentPool,
                                       task_load_balancing_scheme_));
-    AsyncTask task(work);  // Creates a task for now
-    return task_executor->ScheduleFor(work, task.GetExecutionTimestamp());
+    return task_executor->ScheduleFor(forward<AsyncOperationType>(work),
+                                      current_timestamp);
   }
 
   if (priority == AsyncPriority::Normal || priority == AsyncPriority::High) {
-    ASSIGN_OR_RETURN(auto task_executor,
-                     PickTaskExecutor(affinity, normal_task_executor_pool_,
-                                      TaskExecutorPoolType::NotUrgentPool,
-                                      task_load_balancing_scheme_));
+    for (size_t attempt = 0;; ++attempt) {
+      ASSIGN_OR_RETURN(auto task_executor,
+                       PickTaskExecutor(affinity, normal_task_executor_pool_,
+                                        TaskExecutorPoolType::NotUrgentPool,
+                                        task_load_balancing_scheme_));
+      // The work is not moved from if the executor rejects it for not
+      // running, so it can be offered to another executor.
+      auto execution_result =
+          expiration_callback
+              ? task_executor->ScheduleWithDeadline(
+                    forward<AsyncOperationType>(work), priority, deadline,
+                    *expiration_callback)
+              : task_executor->Schedule(forward<AsyncOperationType>(work),
+                                        priority, affinity);
+      if (!ShouldRetryOnAnotherExecutor(execution_result, attempt)) {
+        return execution_result;
+      }
+    }
+  }
 
-    return task_executor->Schedule(work, priority);
+  return FailureExecutionResult(
+      errors::SC_ASYNC_EXECUTOR_INVALID_PRIORITY_TYPE);
+}
+
+ExecutionResult AsyncExecutor::ScheduleBatch(vector<AsyncOperation>& works,
+                                             AsyncPriority priority) noexcept {
+  return ScheduleBatch(works, priority,
+                       AsyncExecutorAffinitySetting::NonAffinitized);
+}
+
+ExecutionResult AsyncExecutor::ScheduleBatch(
+    vector<AsyncOperation>& works, AsyncPriority priority,
+    AsyncExecutorAffinitySetting affinity) noexcept {
+  if (!running_) {
+    return FailureExecutionResult(errors::SC_ASYNC_EXECUTOR_NOT_RUNNING);
+  }
+
+  if (priority == AsyncPriority::Urgent) {
+    // Urgent work is scheduled for now.
+    return ScheduleForBatch(
+        works, TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks(),
+        affinity);
+  }
+
+  if (priority == AsyncPriority::Normal || priority == AsyncPriority::High) {
+    return ScheduleBatchWork(
+        works, affinity, normal_task_executor_pool_,
+        TaskExecutorPoolType::NotUrgentPool,
+        [priority, affinity](NormalTaskExecutor& task_executor,
+                             vector<AsyncOperation>::iterator begin,
+                             vector<AsyncOperation>::iterator end,
+                             size_t& scheduled_count) {
+          return task_executor.ScheduleBatch(begin, end, priority,
+                                             scheduled_count, affinity);
+        });
   }
 
   return FailureExecutionResult(
       errors::SC_ASYNC_EXECUTOR_INVALID_PRIORITY_TYPE);
 }
 
+template <class TaskExecutorType, class ScheduleChunkFunction>
+ExecutionResult AsyncExecutor::ScheduleBatchWork(
+    vector<AsyncOperation>& works, AsyncExecutorAffinitySetting affinity,
+    const vector<shared_ptr<TaskExecutorType>>& task_executor_pool,
+    TaskExecutorPoolType task_executor_pool_type,
+    ScheduleChunkFunction&& schedule_chunk) noexcept {
+  if (works.empty()) {
+    return SuccessExecutionResult();
+  }
+
+  auto chunk_count =
+      min(works.size(), GetSchedulableExecutorCount(task_executor_pool,
+                                                    task_executor_pool_type));
+  auto chunk_size = (works.size() + chunk_count - 1) / chunk_count;
+
+  ExecutionResult execution_result = SuccessExecutionResult();
+  auto chunk_begin = works.begin();
+  size_t scheduled_count = 0;
+  size_t attempt = 0;
+  while (chunk_begin != works.end()) {
+    auto chunk_end =
+        chunk_begin + min<size_t>(chunk_size, works.end() - chunk_begin);
+    auto task_executor_or =
+        PickTaskExecutor(affinity, task_executor_pool, task_executor_pool_type,
+                         task_load_balancing_scheme_);
+    if (!task_executor_or.Successful()) {
+      execution_result = task_executor_or.result();
+      break;
+    }
+
+    execution_result = schedule_chunk(**task_executor_or, chunk_begin,
+                                      chunk_end, scheduled_count);
+    chunk_begin += scheduled_count;
+    if (!execution_result.Successful()) {
+      if (scheduled_count == 0 &&
+          ShouldRetryOnAnotherExecutor(execution_result, attempt++)) {
+        continue;
+      }
+      break;
+    }
+  }
+
+  // Everything before the first unscheduled operation has been moved from.
+  works.erase(works.begin(), chunk_begin);
+  return execution_result;
+}
+
 ExecutionResult AsyncExecutor::ScheduleFor(const AsyncOperation& work,
                                            Timestamp timestamp) noexcept {
   return ScheduleFor(work, timestamp,
@@ -284,4 +690,59 @@ ExecutionResult AsyncExecutor::ScheduleFor(
                                     task_load_balancing_scheme_));
   return task_executor->ScheduleFor(work, timestamp, cancellation_callback);
 }
+
+ExecutionResult AsyncExecutor::ScheduleForBatch(vector<AsyncOperation>& works,
+                                                Timestamp timestamp) noexcept {
+  return ScheduleForBatch(works, timestamp,
+                          AsyncExecutorAffinitySetting::NonAffinitized);
+}
+
+ExecutionResult AsyncExecutor::ScheduleForBatch(
+    vector<AsyncOperation>& works, Timestamp timestamp,
+    AsyncExecutorAffinitySetting affinity) noexcept {
+  if (!running_) {
+    return FailureExecutionResult(errors::SC_ASYNC_EXECUTOR_NOT_RUNNING);
+  }
+
+  return ScheduleBatchWork(
+      works, affinity, urgent_task_executor_pool_,
+      TaskExecutorPoolType::UrgentPool,
+      [timestamp](UrgentTaskExecutor& task_executor,
+                  vector<AsyncOperation>::iterator begin,
+                  vector<AsyncOperation>::iterator end,
+                  size_t& scheduled_count) {
+        return task_executor.ScheduleForBatch(begin, end, timestamp,
+                                              scheduled_count);
+      });
+}
+
+bool AsyncExecutor::IsRunningOnExecutorThread(
+    AsyncPriority priority) noexcept {
+  if (!running_) {
+    return false;
+  }
+  auto found_executors = thread_id_to_executor_map_.find(get_id());
+  if (found_executors == thread_id_to_executor_map_.end()) {
+    return false;
+  }
+  if (threading_mode_ == ExecutorThreadingMode::SingleThreadPerCore) {
+    // The thread runs the tasks of both executors.
+    return true;
+  }
+  auto normal_thread_id = found_executors->second.first->GetThreadId();
+  auto is_normal_executor_thread =
+      normal_thread_id.Successful() && *normal_thread_id == get_id();
+  return is_normal_executor_thread == (priority != AsyncPriority::Urgent);
+}
+
+AsyncExecutorTelemetrySnapshot AsyncExecutor::GetTelemetrySnapshot() noexcept {
+  AsyncExecutorTelemetrySnapshot snapshot;
+  for (auto& task_executor : normal_task_executor_pool_) {
+    snapshot.normal_executors.push_back(task_executor->GetTelemetrySnapshot());
+  }
+  for (auto& task_executor : urgent_task_executor_pool_) {
+    snapshot.urgent_executors.push_back(task_executor->GetTelemetrySnapshot());
+  }
+  return snapshot;
+}
 }  // namespace google::scp::core
@@ -15,11 +15,13 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <functional>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <queue>
 #include <thread>
 #include <utility>
@@ -30,9 +32,13 @@
 #include "public/core/interface/execution_result.h"
 
 #include "async_task.h"
+#include "cpu_topology.h"
 #include "error_codes.h"
+#include "executor_telemetry.h"
 #include "single_thread_async_executor.h"
 #include "single_thread_priority_async_executor.h"
+#include "task_queue.h"
+#include "typedef.h"
 
 static constexpr char kAsyncExecutor[] = "AsyncExecutor";
 
@@ -53,7 +59,20 @@ enum class TaskLoadBalancingScheme {
   /**
    * @brief Random across the executors
    */
-  Random = 2
+  Random = 2,
+  /**
+   * @brief Round Robin across the executors, and idle normal executors take
+   * queued normal and high priority work from their busy siblings. Urgent
+   * tasks are not stolen since they are bound to their execution timestamp.
+   */
+  WorkStealing = 3,
+  /**
+   * @brief Round Robin across the executors on the NUMA node of the calling
+   * CPU, so that tasks run next to the memory their caller has been using.
+   * Falls back to Round Robin across all the executors if the node of the
+   * calling CPU has no executors.
+   */
+  NumaAware = 4
 };
 
 /**
@@ -63,6 +82,83 @@ enum class TaskLoadBalancingScheme {
  */
 enum class TaskExecutorPoolType { UrgentPool = 0, NotUrgentPool = 1 };
 
+/**
+ * @brief The way the urgent and normal executor pairs of an AsyncExecutor map
+ * onto threads.
+ */
+enum class ExecutorThreadingMode {
+  /**
+   * @brief Every executor has a thread of its own, so the pool runs two
+   * threads per configured thread.
+   */
+  ThreadPerExecutor = 0,
+  /**
+   * @brief The normal executor of a pair also executes the due tasks of the
+   * urgent executor of the pair on its thread, so the pool runs one thread per
+   * configured thread. The due urgent tasks run ahead of the queued normal and
+   * high priority tasks, but wait for the task that is running to finish.
+   */
+  SingleThreadPerCore = 1,
+};
+
+/**
+ * @brief Options of an AsyncExecutor whose number of normal executors follows
+ * the load. The thread count of the AsyncExecutor is the minimum number of
+ * normal executors, and the number of urgent executors.
+ */
+struct ElasticThreadCountOptions {
+  /// The maximum number of normal executors.
+  size_t max_thread_count = 0;
+  /// Executors are added when the queued normal and high priority tasks per
+  /// running normal executor exceed this.
+  size_t backlog_per_thread_threshold = kElasticBacklogPerThreadThreshold;
+  /// An executor is added when the mean queue wait time of the tasks started
+  /// during the last control interval exceeds this.
+  std::chrono::nanoseconds queue_wait_time_threshold =
+      kElasticQueueWaitTimeThresholdNs;
+  /// An executor is retired once the normal executors have had no backlog for
+  /// this long, one executor per cool-down.
+  std::chrono::nanoseconds idle_cool_down = kElasticIdleCoolDownNs;
+  /// How often the load is checked.
+  std::chrono::nanoseconds control_interval = kElasticControlIntervalNs;
+};
+
+/// AsyncExecutor options.
+struct AsyncExecutorOptions {
+  /// The number of threads in the pool.
+  size_t thread_count = 0;
+  /// The maximum size of each work queue. It is not an accurate cap due to the
+  /// concurrency of the queue.
+  size_t queue_cap = 0;
+  /// Indicates whether the executor should wait on the tasks during the stop
+  /// operation.
+  bool drop_tasks_on_stop = false;
+  /// The type of load balancing scheme to use for the tasks.
+  TaskLoadBalancingScheme task_load_balancing_scheme =
+      TaskLoadBalancingScheme::RoundRobinGlobal;
+  /// The data structure the urgent executors keep their scheduled tasks in.
+  TimerQueueType timer_queue_type = TimerQueueType::BinaryHeap;
+  /// The way the normal executors wait for work when they are idle.
+  WorkerIdleStrategy worker_idle_strategy = WorkerIdleStrategy::Block;
+  /// If set, normal executors are added beyond thread_count under load and
+  /// retired when idle.
+  std::optional<ElasticThreadCountOptions> elastic_thread_count_options;
+  /// Whether the urgent executors have threads of their own or share the
+  /// threads of the normal executors.
+  ExecutorThreadingMode threading_mode =
+      ExecutorThreadingMode::ThreadPerExecutor;
+  /// The queue implementation the normal executors keep their tasks in.
+  TaskQueueBackend task_queue_backend = TaskQueueBackend::ConcurrentQueue;
+  /**
+   * @brief The executors time one out of every telemetry_sample_interval tasks
+   * for their telemetry histograms, 0 turns the histograms off. The normal
+   * executors of an elastic AsyncExecutor time at least one out of every
+   * kElasticTelemetrySampleInterval tasks, as their queue wait time drives the
+   * thread count.
+   */
+  size_t telemetry_sample_interval = 0;
+};
+
 /*! @copydoc AsyncExecutorInterface
  */
 class AsyncExecutor : public AsyncExecutorInterface {
@@ -83,11 +179,32 @@ class AsyncExecutor : public AsyncExecutorInterface {
                 bool drop_tasks_on_stop = false,
                 TaskLoadBalancingScheme task_load_balancing_scheme =
                     TaskLoadBalancingScheme::RoundRobinGlobal)
+      : AsyncExecutor(AsyncExecutorOptions{
+            .thread_count = thread_count,
+            .queue_cap = queue_cap,
+            .drop_tasks_on_stop = drop_tasks_on_stop,
+            .task_load_balancing_scheme = task_load_balancing_scheme}) {}
+
+  /**
+   * @brief Construct a new Async Executor object with the given options.
+   *
+   * @param options the options of the executor.
+   */
+  explicit AsyncExecutor(AsyncExecutorOptions options)
       : running_(false),
-        thread_count_(thread_count),
-        queue_cap_(queue_cap),
-        drop_tasks_on_stop_(drop_tasks_on_stop),
-        task_load_balancing_scheme_(task_load_balancing_scheme) {}
+        thread_count_(options.thread_count),
+        queue_cap_(options.queue_cap),
+        drop_tasks_on_stop_(options.drop_tasks_on_stop),
+        task_load_balancing_scheme_(options.task_load_balancing_scheme),
+        timer_queue_type_(options.timer_queue_type),
+        worker_idle_strategy_(options.worker_idle_strategy),
+        elastic_thread_count_options_(options.elastic_thread_count_options),
+        threading_mode_(options.threading_mode),
+        task_queue_backend_(options.task_queue_backend),
+        telemetry_sample_interval_(options.telemetry_sample_interval),
+        running_normal_executor_count_(options.thread_count) {}
+
+  ~AsyncExecutor();
 
   ExecutionResult Init() noexcept override;
 
@@ -102,6 +219,47 @@ class AsyncExecutor : public AsyncExecutorInterface {
       const AsyncOperation& work, AsyncPriority priority,
       AsyncExecutorAffinitySetting affinity) noexcept override;
 
+  ExecutionResult Schedule(AsyncOperation&& work,
+                           AsyncPriority priority) noexcept override;
+
+  ExecutionResult Schedule(
+      AsyncOperation&& work, AsyncPriority priority,
+      AsyncExecutorAffinitySetting affinity) noexcept override;
+
+  ExecutionResult ScheduleBatch(std::vector<AsyncOperation>& works,
+                                AsyncPriority priority) noexcept override;
+
+  ExecutionResult ScheduleBatch(
+      std::vector<AsyncOperation>& works, AsyncPriority priority,
+      AsyncExecutorAffinitySetting affinity) noexcept override;
+
+  /**
+   * @brief Schedules a task that is only worth starting until the deadline,
+   * see SingleThreadAsyncExecutor::ScheduleWithDeadline. Normal and high
+   * priority tasks with a deadline run earliest deadline first, and are dropped
+   * if the deadline passes before they start. Urgent tasks run as soon as
+   * possible already, so their deadline is only checked up front. The
+   * affinity picks the executor the task is queued on, but like the other
+   * tasks with a deadline it can still be stolen by an idle peer.
+   */
+  ExecutionResult ScheduleWithDeadline(
+      const AsyncOperation& work, AsyncPriority priority, Timestamp deadline,
+      const TaskExpirationCallback& expiration_callback) noexcept override;
+
+  ExecutionResult ScheduleWithDeadline(
+      AsyncOperation&& work, AsyncPriority priority, Timestamp deadline,
+      const TaskExpirationCallback& expiration_callback) noexcept override;
+
+  ExecutionResult ScheduleWithDeadline(
+      const AsyncOperation& work, AsyncPriority priority, Timestamp deadline,
+      const TaskExpirationCallback& expiration_callback,
+      AsyncExecutorAffinitySetting affinity) noexcept override;
+
+  ExecutionResult ScheduleWithDeadline(
+      AsyncOperation&& work, AsyncPriority priority, Timestamp deadline,
+      const TaskExpirationCallback& expiration_callback,
+      AsyncExecutorAffinitySetting affinity) noexcept override;
+
   ExecutionResult ScheduleFor(const AsyncOperation& work,
                               Timestamp timestamp) noexcept override;
 
@@ -118,10 +276,70 @@ class AsyncExecutor : public AsyncExecutorInterface {
       TaskCancellationLambda& cancellation_callback,
       AsyncExecutorAffinitySetting affinity) noexcept override;
 
+  ExecutionResult ScheduleForBatch(std::vector<AsyncOperation>& works,
+                                   Timestamp timestamp) noexcept override;
+
+  ExecutionResult ScheduleForBatch(
+      std::vector<AsyncOperation>& works, Timestamp timestamp,
+      AsyncExecutorAffinitySetting affinity) noexcept override;
+
+  /**
+   * @brief Only the threads of the first thread_count normal executors and
+   * their urgent executors are known, see thread_id_to_executor_map_. The
+   * normal executors run the normal and high priority tasks, and the urgent
+   * executors the urgent ones.
+   */
+  bool IsRunningOnExecutorThread(AsyncPriority priority) noexcept override;
+
+  /**
+   * @brief Returns a copy of the telemetry of every executor of the pool, to be
+   * exported periodically. The snapshot only briefly locks the urgent
+   * executors that keep their tasks in a binary heap.
+   */
+  AsyncExecutorTelemetrySnapshot GetTelemetrySnapshot() noexcept;
+
+  /**
+   * @brief Returns the number of running normal executors. It only changes
+   * over time with ElasticThreadCountOptions.
+   */
+  size_t GetNormalExecutorCount() const noexcept {
+    return running_normal_executor_count_.load(std::memory_order_acquire);
+  }
+
  protected:
   using UrgentTaskExecutor = SingleThreadPriorityAsyncExecutor;
   using NormalTaskExecutor = SingleThreadAsyncExecutor;
 
+  /**
+   * @brief Picks an executor for the work and schedules it. The work is
+   * forwarded as is so that rvalue work is moved into the task.
+   *
+   * @param expiration_callback if not null, the work is scheduled with the
+   * deadline and is dropped with a call to the callback once it expires.
+   */
+  template <class AsyncOperationType>
+  ExecutionResult ScheduleWork(
+      AsyncOperationType&& work, AsyncPriority priority,
+      AsyncExecutorAffinitySetting affinity, Timestamp deadline = 0,
+      const TaskExpirationCallback* expiration_callback = nullptr) noexcept;
+
+  /**
+   * @brief Splits the batch into one chunk per executor of the pool and hands
+   * every chunk to an executor picked for it, so that each worker thread is
+   * signaled once for its chunk rather than once per task. Stops at the first
+   * chunk that cannot be fully scheduled.
+   *
+   * @param works the batch of work. The scheduled operations are removed.
+   * @param schedule_chunk schedules [begin, end) on the given executor and
+   * reports how many of the operations were scheduled.
+   */
+  template <class TaskExecutorType, class ScheduleChunkFunction>
+  ExecutionResult ScheduleBatchWork(
+      std::vector<AsyncOperation>& works, AsyncExecutorAffinitySetting affinity,
+      const std::vector<std::shared_ptr<TaskExecutorType>>& task_executor_pool,
+      TaskExecutorPoolType task_executor_pool_type,
+      ScheduleChunkFunction&& schedule_chunk) noexcept;
+
   template <class TaskExecutorType>
   ExecutionResultOr<std::shared_ptr<TaskExecutorType>> PickTaskExecutor(
       AsyncExecutorAffinitySetting affinity,
@@ -129,6 +347,46 @@ class AsyncExecutor : public AsyncExecutorInterface {
       TaskExecutorPoolType task_executor_pool_type,
       TaskLoadBalancingScheme task_load_balancing_scheme);
 
+  /// Returns the CPU the calling thread is running on, if known.
+  virtual std::optional<size_t> GetCurrentCpu() const noexcept;
+
+  /**
+   * @brief Returns the number of executors of the pool that take new work. For
+   * an elastic executor, these are the running normal executors at the front
+   * of the pool.
+   */
+  template <class TaskExecutorType>
+  size_t GetSchedulableExecutorCount(
+      const std::vector<std::shared_ptr<TaskExecutorType>>& task_executor_pool,
+      TaskExecutorPoolType task_executor_pool_type) const noexcept;
+
+  /**
+   * @brief Returns true if scheduling failed because the picked executor was
+   * retired concurrently, in which case the work can be offered to another
+   * executor.
+   *
+   * @param execution_result the result of scheduling on the picked executor.
+   * @param attempt the zero based attempt that failed.
+   */
+  bool ShouldRetryOnAnotherExecutor(const ExecutionResult& execution_result,
+                                    size_t attempt) const noexcept;
+
+  /**
+   * @brief Periodically adds normal executors while they are overloaded and
+   * retires them once they have been idle, until the executor stops. Runs on
+   * its own thread with ElasticThreadCountOptions.
+   */
+  void RunElasticController() noexcept;
+
+  /**
+   * @brief Runs the retired executors that still have pending tasks, which
+   * were queued while they were being retired, until they have executed them.
+   */
+  void DrainRetiredNormalExecutors() noexcept;
+
+  /// Stops the elastic controller thread if it is running.
+  void StopElasticController() noexcept;
+
   /**
    * @brief While it is true, the thread pool will keep listening and
    * picking out work from work queue. While it is false, the thread pool
@@ -154,5 +412,35 @@ class AsyncExecutor : public AsyncExecutorInterface {
   /// Load balancing scheme to distribute incoming tasks on to the thread pool
   /// threads.
   TaskLoadBalancingScheme task_load_balancing_scheme_;
+  /// The data structure the urgent executors keep their scheduled tasks in.
+  TimerQueueType timer_queue_type_;
+  /// The way the normal executors wait for work when they are idle.
+  WorkerIdleStrategy worker_idle_strategy_;
+  /// The NUMA topology the executors are placed on. Discovered by Init unless
+  /// set beforehand.
+  std::optional<CpuTopology> cpu_topology_;
+  /// The indices of the executor pairs pinned to each NUMA node.
+  std::vector<std::vector<size_t>> node_executor_indices_;
+  /// Set when the number of normal executors follows the load.
+  std::optional<ElasticThreadCountOptions> elastic_thread_count_options_;
+  /// Whether the urgent executors share the threads of the normal executors.
+  ExecutorThreadingMode threading_mode_;
+  /// The queue implementation the normal executors keep their tasks in.
+  TaskQueueBackend task_queue_backend_;
+  /// One out of every this many tasks is timed for the telemetry, 0 for none.
+  size_t telemetry_sample_interval_;
+  /**
+   * @brief The number of normal executors at the front of the pool that are
+   * running. Only the elastic controller changes it. The rest of the pool is
+   * initialized but has no worker thread.
+   */
+  std::atomic<size_t> running_normal_executor_count_;
+  /// Adds and retires the normal executors in the elastic mode.
+  std::unique_ptr<std::thread> elastic_controller_thread_;
+  /// Used with the condition variable to wake the elastic controller up on
+  /// Stop.
+  std::mutex elastic_controller_mutex_;
+  /// Used with the mutex to wake the elastic controller up on Stop.
+  std::condition_variable elastic_controller_condition_variable_;
 };
 }  // namespace google::scp::core
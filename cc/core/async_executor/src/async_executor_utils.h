@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <iostream>
 #include <optional>
 #include <thread>
@@ -43,6 +44,18 @@ class AsyncExecutorUtils {
     return SuccessExecutionResult();
   }
 
+  /// Hints the CPU that the calling thread is in a spin-wait loop, which saves
+  /// power and frees the execution resources for the sibling hyperthread.
+  static inline void CpuRelax() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#else
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+  }
+
  private:
   static constexpr char kAsyncExecutorUtils[] = "AsyncExecutorUtils";
 };
@@ -14,10 +14,12 @@
 
 #pragma once
 
+#include <atomic>
 #include <chrono>
 #include <memory>
 #include <queue>
 #include <thread>
+#include <utility>
 #include <vector>
 
 #include "core/common/time_provider/src/time_provider.h"
@@ -29,6 +31,11 @@ namespace google::scp::core {
 /**
  * @brief  Is used by the async executor to encapsulate the async operations
  * provided by the user.
+ *
+ * The task is move-only so that it can be stored by value in the executor
+ * queues. Moving a task moves the wrapped operation without copying its
+ * captured state. A task must not be moved while it is shared with another
+ * thread.
  */
 class AsyncTask {
  public:
@@ -42,9 +49,25 @@ class AsyncTask {
       AsyncOperation async_operation = []() {},
       Timestamp execution_timestamp =
           common::TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks())
-      : async_operation_(async_operation),
+      : async_operation_(std::move(async_operation)),
         execution_timestamp_(execution_timestamp),
-        is_cancelled_(false) {}
+        state_(State::Pending) {}
+
+  AsyncTask(AsyncTask&& other) noexcept
+      : async_operation_(std::move(other.async_operation_)),
+        execution_timestamp_(other.execution_timestamp_),
+        state_(other.state_.load(std::memory_order_relaxed)) {}
+
+  AsyncTask& operator=(AsyncTask&& other) noexcept {
+    async_operation_ = std::move(other.async_operation_);
+    execution_timestamp_ = other.execution_timestamp_;
+    state_.store(other.state_.load(std::memory_order_relaxed),
+                 std::memory_order_relaxed);
+    return *this;
+  }
+
+  AsyncTask(const AsyncTask&) = delete;
+  AsyncTask& operator=(const AsyncTask&) = delete;
 
   /**
    * @brief Returns the execution time of the current task.
@@ -55,34 +78,29 @@ class AsyncTask {
 
   /// Calls the current task to be executed.
   void Execute() {
-    cancellation_mutex_.lock();
-    if (is_cancelled_) {
-      cancellation_mutex_.unlock();
+    auto expected_state = State::Pending;
+    if (!state_.compare_exchange_strong(expected_state, State::Executed)) {
       return;
     }
     async_operation_();
-    cancellation_mutex_.unlock();
   }
 
-  /// Calls the current task to be cancelled.
+  /**
+   * @brief Calls the current task to be cancelled.
+   *
+   * @return true if the task was cancelled before it started executing.
+   */
   bool Cancel() {
-    cancellation_mutex_.lock();
-    if (is_cancelled_) {
-      cancellation_mutex_.unlock();
-      return false;
-    }
-
-    is_cancelled_ = true;
-    cancellation_mutex_.unlock();
-    return true;
+    auto expected_state = State::Pending;
+    return state_.compare_exchange_strong(expected_state, State::Cancelled);
   }
 
-  bool IsCancelled() {
-    std::unique_lock lock(cancellation_mutex_);
-    return is_cancelled_;
-  }
+  bool IsCancelled() { return state_.load() == State::Cancelled; }
 
  private:
+  /// The lifecycle of a task. A task leaves Pending exactly once.
+  enum class State : uint8_t { Pending = 0, Executed = 1, Cancelled = 2 };
+
   /// Async operation to be executed.
   AsyncOperation async_operation_;
 
@@ -92,11 +110,8 @@ class AsyncTask {
    */
   Timestamp execution_timestamp_;
 
-  /// Cancellation mutex
-  std::mutex cancellation_mutex_;
-
-  /// Indicates whether a task was cancelled.
-  bool is_cancelled_;
+  /// The current state of the task.
+  std::atomic<State> state_;
 };
 
 /// Comparer class for the AsyncTasks
@@ -0,0 +1,216 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cpu_topology.h"
+
+#include <sched.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "error_codes.h"
+
+using std::getline;
+using std::ifstream;
+using std::map;
+using std::max;
+using std::nullopt;
+using std::optional;
+using std::set;
+using std::stoul;
+using std::string;
+using std::vector;
+using std::filesystem::directory_iterator;
+using std::filesystem::path;
+
+namespace {
+constexpr char kNodeDirectoryPrefix[] = "node";
+constexpr char kCpuListFileName[] = "cpulist";
+/// CPU lists with IDs above this are treated as malformed.
+constexpr size_t kMaxCpuId = 1 << 16;
+
+/// Returns the CPUs the calling process is allowed to run on.
+vector<size_t> GetAllowedCpus() noexcept {
+  vector<size_t> allowed_cpus;
+  cpu_set_t cpuset;
+  CPU_ZERO(&cpuset);
+  if (sched_getaffinity(0, sizeof(cpu_set_t), &cpuset) == 0) {
+    for (size_t cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+      if (CPU_ISSET(cpu, &cpuset)) {
+        allowed_cpus.push_back(cpu);
+      }
+    }
+  }
+  if (allowed_cpus.empty()) {
+    for (size_t cpu = 0; cpu < std::thread::hardware_concurrency(); ++cpu) {
+      allowed_cpus.push_back(cpu);
+    }
+  }
+  return allowed_cpus;
+}
+
+/// Returns the kernel node ID if the directory name is "node<ID>".
+optional<size_t> ParseNodeId(const string& directory_name) noexcept {
+  string prefix(kNodeDirectoryPrefix);
+  if (directory_name.size() <= prefix.size() ||
+      directory_name.compare(0, prefix.size(), prefix) != 0) {
+    return nullopt;
+  }
+  auto id = directory_name.substr(prefix.size());
+  if (!std::all_of(id.begin(), id.end(), ::isdigit) || id.size() > 6) {
+    return nullopt;
+  }
+  return stoul(id);
+}
+}  // namespace
+
+namespace google::scp::core {
+CpuTopology CpuTopology::Discover() noexcept {
+  return Discover(kSysfsNumaNodeDirectory, GetAllowedCpus());
+}
+
+CpuTopology CpuTopology::Discover(const string& node_directory,
+                                  const vector<size_t>& allowed_cpus) noexcept {
+  // Ordered by the kernel node ID so that the node indices follow the IDs.
+  map<size_t, vector<size_t>> cpus_by_node_id;
+  std::error_code error;
+  for (directory_iterator it(path(node_directory), error), end;
+       !error && it != end; it.increment(error)) {
+    auto node_id = ParseNodeId(it->path().filename().string());
+    if (!node_id) {
+      continue;
+    }
+    ifstream cpu_list_file(it->path() / kCpuListFileName);
+    string cpu_list;
+    if (!cpu_list_file || !getline(cpu_list_file, cpu_list)) {
+      continue;
+    }
+    vector<size_t> cpus;
+    if (ParseCpuList(cpu_list, cpus).Successful()) {
+      cpus_by_node_id[*node_id] = std::move(cpus);
+    }
+  }
+
+  vector<vector<size_t>> node_cpus;
+  for (auto& [node_id, cpus] : cpus_by_node_id) {
+    node_cpus.push_back(std::move(cpus));
+  }
+  return CpuTopology(node_cpus, allowed_cpus);
+}
+
+CpuTopology::CpuTopology(const vector<vector<size_t>>& node_cpus,
+                         const vector<size_t>& allowed_cpus) noexcept {
+  set<size_t> allowed_cpu_set(allowed_cpus.begin(), allowed_cpus.end());
+  if (allowed_cpu_set.empty()) {
+    allowed_cpu_set.insert(0);
+  }
+
+  set<size_t> assigned_cpus;
+  for (const auto& cpus : node_cpus) {
+    vector<size_t> allowed_node_cpus;
+    for (auto cpu : set<size_t>(cpus.begin(), cpus.end())) {
+      // A CPU belongs to a single node, the first listing it wins.
+      if (allowed_cpu_set.count(cpu) > 0 && assigned_cpus.insert(cpu).second) {
+        allowed_node_cpus.push_back(cpu);
+      }
+    }
+    if (!allowed_node_cpus.empty()) {
+      node_cpus_.push_back(std::move(allowed_node_cpus));
+    }
+  }
+
+  // Without any usable node information, all the allowed CPUs are one node.
+  if (node_cpus_.empty()) {
+    node_cpus_.emplace_back(allowed_cpu_set.begin(), allowed_cpu_set.end());
+  }
+
+  size_t max_cpu = 0;
+  for (const auto& cpus : node_cpus_) {
+    max_cpu = max(max_cpu, cpus.back());
+  }
+  cpu_to_node_.assign(max_cpu + 1, kNoNode);
+  for (size_t node = 0; node < node_cpus_.size(); ++node) {
+    for (auto cpu : node_cpus_[node]) {
+      cpu_to_node_[cpu] = node;
+    }
+  }
+}
+
+ExecutionResult CpuTopology::ParseCpuList(const string& cpu_list,
+                                          vector<size_t>& cpus) noexcept {
+  set<size_t> parsed_cpus;
+  size_t position = 0;
+  // Reads a CPU ID at the position and advances past it.
+  auto read_cpu_id = [&](size_t& cpu_id) {
+    auto end = cpu_list.find_first_not_of("0123456789", position);
+    if (end == string::npos) {
+      end = cpu_list.size();
+    }
+    if (end == position || end - position > 6) {
+      return false;
+    }
+    cpu_id = stoul(cpu_list.substr(position, end - position));
+    position = end;
+    return cpu_id <= kMaxCpuId;
+  };
+
+  auto trimmed_end = cpu_list.find_last_not_of(" \t\r\n");
+  auto length = trimmed_end == string::npos ? 0 : trimmed_end + 1;
+  while (position < length) {
+    size_t first_cpu;
+    if (!read_cpu_id(first_cpu)) {
+      return FailureExecutionResult(errors::SC_ASYNC_EXECUTOR_INVALID_CPU_LIST);
+    }
+    size_t last_cpu = first_cpu;
+    if (position < length && cpu_list[position] == '-') {
+      ++position;
+      if (!read_cpu_id(last_cpu) || last_cpu < first_cpu) {
+        return FailureExecutionResult(
+            errors::SC_ASYNC_EXECUTOR_INVALID_CPU_LIST);
+      }
+    }
+    for (auto cpu = first_cpu; cpu <= last_cpu; ++cpu) {
+      parsed_cpus.insert(cpu);
+    }
+    if (position < length) {
+      if (cpu_list[position] != ',' || position + 1 == length) {
+        return FailureExecutionResult(
+            errors::SC_ASYNC_EXECUTOR_INVALID_CPU_LIST);
+      }
+      ++position;
+    }
+  }
+
+  cpus.assign(parsed_cpus.begin(), parsed_cpus.end());
+  return SuccessExecutionResult();
+}
+
+optional<size_t> CpuTopology::GetNodeOfCpu(size_t cpu) const noexcept {
+  if (cpu >= cpu_to_node_.size() || cpu_to_node_[cpu] == kNoNode) {
+    return nullopt;
+  }
+  return cpu_to_node_[cpu];
+}
+
+size_t CpuTopology::GetCpuForWorker(size_t worker_index) const noexcept {
+  const auto& cpus = node_cpus_[worker_index % node_cpus_.size()];
+  return cpus[(worker_index / node_cpus_.size()) % cpus.size()];
+}
+}  // namespace google::scp::core
@@ -0,0 +1,102 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "public/core/interface/execution_result.h"
+
+namespace google::scp::core {
+/// The directory the kernel exposes the NUMA nodes in.
+static constexpr char kSysfsNumaNodeDirectory[] = "/sys/devices/system/node";
+
+/**
+ * @brief The NUMA nodes and the CPUs of each node that the process is allowed
+ * to run on. Nodes without any allowed CPU, e.g. memory only nodes or nodes
+ * excluded by the cgroup cpuset, are left out, so every node has at least one
+ * CPU. Nodes are identified by their index in [0, GetNodeCount()), which is
+ * not necessarily the kernel node ID.
+ */
+class CpuTopology {
+ public:
+  /**
+   * @brief Discovers the topology of the host from sysfs and the affinity mask
+   * of the process. Falls back to a single node with all the allowed CPUs if
+   * the host does not expose its NUMA nodes.
+   */
+  static CpuTopology Discover() noexcept;
+
+  /**
+   * @brief Discovers the topology from the given directory laid out like
+   * /sys/devices/system/node, i.e. with a nodeN/cpulist file per node.
+   *
+   * @param node_directory the directory containing the node directories.
+   * @param allowed_cpus the CPUs the process is allowed to run on.
+   */
+  static CpuTopology Discover(const std::string& node_directory,
+                              const std::vector<size_t>& allowed_cpus) noexcept;
+
+  /**
+   * @brief Builds the topology from the CPUs of every node, keeping only the
+   * allowed CPUs.
+   *
+   * @param node_cpus the CPUs of every node.
+   * @param allowed_cpus the CPUs the process is allowed to run on.
+   */
+  CpuTopology(const std::vector<std::vector<size_t>>& node_cpus,
+              const std::vector<size_t>& allowed_cpus) noexcept;
+
+  /**
+   * @brief Parses a kernel CPU list such as "0-3,8,10-11".
+   *
+   * @param cpu_list the CPU list to parse.
+   * @param cpus the parsed CPUs in ascending order.
+   * @return ExecutionResult the failure if the list is malformed.
+   */
+  static ExecutionResult ParseCpuList(const std::string& cpu_list,
+                                      std::vector<size_t>& cpus) noexcept;
+
+  /// Returns the number of nodes, at least one.
+  size_t GetNodeCount() const noexcept { return node_cpus_.size(); }
+
+  /// Returns the allowed CPUs of the node in ascending order.
+  const std::vector<size_t>& GetNodeCpus(size_t node) const noexcept {
+    return node_cpus_.at(node);
+  }
+
+  /// Returns the node of the CPU, if the CPU is allowed.
+  std::optional<size_t> GetNodeOfCpu(size_t cpu) const noexcept;
+
+  /**
+   * @brief Returns the CPU to pin the worker at the given index to. Workers are
+   * spread over the nodes first, and over the CPUs of each node next, so that
+   * consecutive workers land on different nodes and no CPU is reused before all
+   * the CPUs of its node are used.
+   */
+  size_t GetCpuForWorker(size_t worker_index) const noexcept;
+
+ private:
+  /// Marks the CPUs that are not allowed in cpu_to_node_.
+  static constexpr size_t kNoNode = static_cast<size_t>(-1);
+
+  /// The allowed CPUs of every node.
+  std::vector<std::vector<size_t>> node_cpus_;
+  /// The node of every CPU ID, or kNoNode if the CPU is not allowed.
+  std::vector<size_t> cpu_to_node_;
+};
+}  // namespace google::scp::core
@@ -0,0 +1,194 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iterator>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "core/interface/async_executor_interface.h"
+
+#include "async_task.h"
+
+namespace google::scp::core {
+/// A task that is only worth starting until its deadline.
+struct DeadlineTask {
+  /// The task to execute.
+  AsyncTask task;
+  /// The steady clock timestamp in nanoseconds after which the task is dropped.
+  Timestamp deadline = 0;
+  /// Is called instead of the task if it is dropped.
+  TaskExpirationCallback expiration_callback;
+  /// Orders the tasks with the same deadline by their arrival.
+  uint64_t sequence_number = 0;
+};
+
+/**
+ * @brief A bounded multi producer multi consumer queue of tasks that hands out
+ * the task with the earliest deadline first. The tasks are kept in a binary
+ * heap under a mutex. The size is tracked separately so that checking an empty
+ * queue does not take the mutex.
+ *
+ * The tasks found expired by TryDequeueUnexpired are set aside rather than
+ * handed out, so that whichever thread dequeues, the expiration callbacks are
+ * left to the owner of the queue, see TakeExpired.
+ */
+class DeadlineTaskQueue {
+ public:
+  /**
+   * @brief Construct a new Deadline Task Queue object
+   * @param max_size Maximum size of the queue
+   */
+  explicit DeadlineTaskQueue(size_t max_size)
+      : max_size_(max_size),
+        size_(0),
+        expired_count_(0),
+        next_sequence_number_(0) {}
+
+  DeadlineTaskQueue(const DeadlineTaskQueue&) = delete;
+  DeadlineTaskQueue& operator=(const DeadlineTaskQueue&) = delete;
+
+  /**
+   * @brief Enqueues the task if the queue is not full. The task is left
+   * untouched if it cannot be queued.
+   *
+   * @return true if the task was queued.
+   */
+  bool TryEnqueue(DeadlineTask&& deadline_task) noexcept {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (heap_.size() >= max_size_) {
+      return false;
+    }
+    deadline_task.sequence_number = next_sequence_number_++;
+    heap_.push_back(std::move(deadline_task));
+    std::push_heap(heap_.begin(), heap_.end(), CompareLater);
+    size_.store(heap_.size(), std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Dequeues the task with the earliest deadline, if any.
+   *
+   * @return true if a task was dequeued.
+   */
+  bool TryDequeue(DeadlineTask& deadline_task) noexcept {
+    if (Size() == 0) {
+      return false;
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (heap_.empty()) {
+      return false;
+    }
+    std::pop_heap(heap_.begin(), heap_.end(), CompareLater);
+    deadline_task = std::move(heap_.back());
+    heap_.pop_back();
+    size_.store(heap_.size(), std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Dequeues the task with the earliest deadline after the given
+   * timestamp, if any. The expired tasks before it are set aside for
+   * TakeExpired.
+   *
+   * @return true if a task was dequeued.
+   */
+  bool TryDequeueUnexpired(DeadlineTask& deadline_task,
+                           Timestamp current_timestamp) noexcept {
+    if (Size() == 0) {
+      return false;
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!heap_.empty()) {
+      std::pop_heap(heap_.begin(), heap_.end(), CompareLater);
+      auto& front = heap_.back();
+      bool is_expired = front.deadline <= current_timestamp;
+      if (is_expired) {
+        expired_.push_back(std::move(front));
+        // Counted as expired before it stops counting as queued, so the task
+        // is never missing from both.
+        expired_count_.store(expired_.size(), std::memory_order_release);
+      } else {
+        deadline_task = std::move(front);
+      }
+      heap_.pop_back();
+      size_.store(heap_.size(), std::memory_order_release);
+      if (!is_expired) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /**
+   * @brief Moves the tasks set aside as expired to the end of the given
+   * vector.
+   */
+  void TakeExpired(std::vector<DeadlineTask>& expired_tasks) noexcept {
+    if (GetExpiredCount() == 0) {
+      return;
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    std::move(expired_.begin(), expired_.end(),
+              std::back_inserter(expired_tasks));
+    expired_.clear();
+    expired_count_.store(0, std::memory_order_release);
+  }
+
+  /// Returns the number of queued tasks, not counting the expired ones.
+  size_t Size() const noexcept { return size_.load(std::memory_order_acquire); }
+
+  /// Returns the number of tasks set aside as expired.
+  size_t GetExpiredCount() const noexcept {
+    return expired_count_.load(std::memory_order_acquire);
+  }
+
+  /// Returns the number of queued and expired tasks.
+  size_t GetSizeWithExpired() const noexcept {
+    // The size is read first, see TryDequeueUnexpired.
+    auto size = Size();
+    return size + GetExpiredCount();
+  }
+
+ private:
+  /// Orders the heap so that the earliest deadline is at the front.
+  static bool CompareLater(const DeadlineTask& lhs,
+                           const DeadlineTask& rhs) noexcept {
+    if (lhs.deadline != rhs.deadline) {
+      return lhs.deadline > rhs.deadline;
+    }
+    return lhs.sequence_number > rhs.sequence_number;
+  }
+
+  /// The maximum number of queued tasks.
+  const size_t max_size_;
+  /// Guards the heap and the sequence number.
+  std::mutex mutex_;
+  /// The queued tasks, ordered as a heap by CompareLater.
+  std::vector<DeadlineTask> heap_;
+  /// The expired tasks waiting for TakeExpired.
+  std::vector<DeadlineTask> expired_;
+  /// The number of queued tasks, readable without the mutex.
+  std::atomic<size_t> size_;
+  /// The number of expired tasks, readable without the mutex.
+  std::atomic<size_t> expired_count_;
+  /// The sequence number of the next queued task.
+  uint64_t next_sequence_number_;
+};
+}  // namespace google::scp::core
@@ -61,4 +61,12 @@ DEFINE_ERROR_CODE(SC_ASYNC_EXECUTOR_INVALID_TASK_POOL_TYPE, SC_ASYNC_EXECUTOR,
 DEFINE_ERROR_CODE(SC_ASYNC_EXECUTOR_UNABLE_TO_SET_AFFINITY, SC_ASYNC_EXECUTOR,
                   0x000A, "Setting CPU affinity failed",
                   HttpStatusCode::BAD_REQUEST)
+
+DEFINE_ERROR_CODE(SC_ASYNC_EXECUTOR_INVALID_CPU_LIST, SC_ASYNC_EXECUTOR,
+                  0x000B, "The CPU list is malformed",
+                  HttpStatusCode::BAD_REQUEST)
+
+DEFINE_ERROR_CODE(SC_ASYNC_EXECUTOR_TASK_DEADLINE_EXCEEDED, SC_ASYNC_EXECUTOR,
+                  0x000C, "The deadline of the task passed before it started",
+                  HttpStatusCode::REQUEST_TIMEOUT)
 }  // namespace google::scp::core::errors
@@ -0,0 +1,121 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+namespace google::scp::core {
+/**
+ * @brief An eventcount lets consumers block on a condition of a lock-free data
+ * structure while keeping the producers lock-free when no consumer is blocked.
+ *
+ * A consumer calls PrepareWait, re-checks its condition, and then either calls
+ * CancelWait if the condition holds or Wait with the key returned by
+ * PrepareWait. A producer makes the condition true and then calls NotifyOne or
+ * NotifyAll. A notification between PrepareWait and Wait is not lost, Wait
+ * returns right away in that case.
+ *
+ * Notify only takes the mutex and signals the condition variable if there is a
+ * consumer between PrepareWait and the end of Wait.
+ */
+class EventCount {
+ public:
+  /// The epoch observed by PrepareWait.
+  using Key = uint32_t;
+
+  EventCount() : state_(0) {}
+
+  EventCount(const EventCount&) = delete;
+  EventCount& operator=(const EventCount&) = delete;
+
+  /**
+   * @brief Announces that the caller is about to wait. The caller must re-check
+   * its condition afterwards and then call either CancelWait or Wait.
+   *
+   * @return Key the key to pass to Wait.
+   */
+  Key PrepareWait() noexcept {
+    auto previous_state = state_.fetch_add(kWaiterIncrement);
+    // Orders the waiter registration before the condition re-check of the
+    // caller. Pairs with the fence in Notify.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return static_cast<Key>(previous_state >> kEpochShift);
+  }
+
+  /// Withdraws the announcement of PrepareWait without waiting.
+  void CancelWait() noexcept { state_.fetch_sub(kWaiterIncrement); }
+
+  /**
+   * @brief Blocks until a notification after the PrepareWait call that
+   * returned the key, or until the timeout elapses.
+   *
+   * @param key the key returned by PrepareWait.
+   * @param timeout the maximum duration to block for.
+   */
+  void Wait(Key key, std::chrono::nanoseconds timeout) noexcept {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      condition_variable_.wait_for(lock, timeout, [&]() {
+        return static_cast<Key>(state_.load() >> kEpochShift) != key;
+      });
+    }
+    state_.fetch_sub(kWaiterIncrement);
+  }
+
+  /// Wakes up one of the waiting consumers, if any.
+  void NotifyOne() noexcept { Notify(/*notify_all=*/false); }
+
+  /// Wakes up all the waiting consumers, if any.
+  void NotifyAll() noexcept { Notify(/*notify_all=*/true); }
+
+ private:
+  /// The lower half of the state counts the waiters, the upper half is the
+  /// epoch that is bumped by every notification with waiters.
+  static constexpr uint64_t kWaiterIncrement = 1;
+  static constexpr uint64_t kWaiterMask = (uint64_t{1} << 32) - 1;
+  static constexpr uint64_t kEpochShift = 32;
+  static constexpr uint64_t kEpochIncrement = uint64_t{1} << kEpochShift;
+
+  void Notify(bool notify_all) noexcept {
+    // Orders the change of the condition by the caller before the waiters
+    // check. Pairs with the fence in PrepareWait.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if ((state_.load(std::memory_order_relaxed) & kWaiterMask) == 0) {
+      return;
+    }
+
+    state_.fetch_add(kEpochIncrement);
+    // Taking the mutex ensures that a waiter that saw the old epoch is
+    // already blocked on the condition variable, so the signal is not lost.
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (notify_all) {
+      condition_variable_.notify_all();
+    } else {
+      condition_variable_.notify_one();
+    }
+  }
+
+  /// The number of waiters and the epoch.
+  std::atomic<uint64_t> state_;
+  /// Used in combination with the condition variable to block the waiters.
+  std::mutex mutex_;
+  /// Used in combination with the mutex to block the waiters.
+  std::condition_variable condition_variable_;
+};
+}  // namespace google::scp::core
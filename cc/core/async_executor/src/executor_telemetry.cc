@@ -0,0 +1,130 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "executor_telemetry.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+using std::max;
+using std::memory_order_relaxed;
+using std::min;
+using std::chrono::microseconds;
+using std::chrono::nanoseconds;
+
+namespace google::scp::core {
+void LatencyHistogramSnapshot::Merge(
+    const LatencyHistogramSnapshot& other) noexcept {
+  if (bucket_counts.size() < other.bucket_counts.size()) {
+    bucket_counts.resize(other.bucket_counts.size(), 0);
+  }
+  for (size_t i = 0; i < other.bucket_counts.size(); ++i) {
+    bucket_counts[i] += other.bucket_counts[i];
+  }
+  count += other.count;
+  sum_ns += other.sum_ns;
+}
+
+nanoseconds LatencyHistogramSnapshot::GetPercentileUpperBound(
+    double percentile) const noexcept {
+  uint64_t total_count = 0;
+  for (auto bucket_count : bucket_counts) {
+    total_count += bucket_count;
+  }
+  if (total_count == 0) {
+    return nanoseconds(0);
+  }
+
+  percentile = min(max(percentile, 0.0), 1.0);
+  auto target_count = max<uint64_t>(
+      1, static_cast<uint64_t>(std::ceil(percentile * total_count)));
+  uint64_t seen_count = 0;
+  for (size_t i = 0; i < bucket_counts.size(); ++i) {
+    seen_count += bucket_counts[i];
+    if (seen_count >= target_count) {
+      return LatencyHistogram::GetBucketUpperBound(i);
+    }
+  }
+  return LatencyHistogram::GetBucketUpperBound(bucket_counts.size() - 1);
+}
+
+LatencyHistogram::LatencyHistogram() : count_(0), sum_ns_(0) {
+  for (auto& bucket_count : bucket_counts_) {
+    bucket_count.store(0, memory_order_relaxed);
+  }
+}
+
+void LatencyHistogram::Record(nanoseconds duration) noexcept {
+  uint64_t duration_ns = max<int64_t>(duration.count(), 0);
+  uint64_t duration_us = duration_ns / 1000;
+  // The index is the bit width of the duration in microseconds.
+  size_t index = duration_us == 0 ? 0 : 64 - __builtin_clzll(duration_us);
+  index = min(index, kBucketCount - 1);
+
+  Add(bucket_counts_[index], 1);
+  Add(count_, 1);
+  Add(sum_ns_, duration_ns);
+}
+
+LatencyHistogramSnapshot LatencyHistogram::GetSnapshot() const noexcept {
+  LatencyHistogramSnapshot snapshot;
+  snapshot.bucket_counts.reserve(kBucketCount);
+  for (auto& bucket_count : bucket_counts_) {
+    snapshot.bucket_counts.push_back(bucket_count.load(memory_order_relaxed));
+  }
+  snapshot.count = count_.load(memory_order_relaxed);
+  snapshot.sum_ns = sum_ns_.load(memory_order_relaxed);
+  return snapshot;
+}
+
+nanoseconds LatencyHistogram::GetBucketUpperBound(size_t index) noexcept {
+  return microseconds(uint64_t{1} << min(index, kBucketCount - 1));
+}
+
+void TaskExecutorTelemetrySnapshot::Merge(
+    const TaskExecutorTelemetrySnapshot& other) noexcept {
+  queue_depth += other.queue_depth;
+  rejected_count += other.rejected_count;
+  expired_count += other.expired_count;
+  queue_wait_time.Merge(other.queue_wait_time);
+  timer_lateness.Merge(other.timer_lateness);
+  run_time.Merge(other.run_time);
+}
+
+TaskExecutorTelemetrySnapshot AsyncExecutorTelemetrySnapshot::GetTotal()
+    const noexcept {
+  TaskExecutorTelemetrySnapshot total;
+  for (const auto& executor_snapshot : normal_executors) {
+    total.Merge(executor_snapshot);
+  }
+  for (const auto& executor_snapshot : urgent_executors) {
+    total.Merge(executor_snapshot);
+  }
+  return total;
+}
+
+TaskExecutorTelemetrySnapshot TaskExecutorTelemetry::GetSnapshot(
+    uint64_t queue_depth) const noexcept {
+  TaskExecutorTelemetrySnapshot snapshot;
+  snapshot.queue_depth = queue_depth;
+  snapshot.rejected_count = rejected_count_.load(memory_order_relaxed);
+  snapshot.expired_count = expired_count_.load(memory_order_relaxed);
+  snapshot.queue_wait_time = queue_wait_time_.GetSnapshot();
+  snapshot.timer_lateness = timer_lateness_.GetSnapshot();
+  snapshot.run_time = run_time_.GetSnapshot();
+  return snapshot;
+}
+}  // namespace google::scp::core
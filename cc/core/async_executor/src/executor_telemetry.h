@@ -0,0 +1,194 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace google::scp::core {
+/// A point in time copy of a LatencyHistogram.
+struct LatencyHistogramSnapshot {
+  /// The number of samples in each bucket, see LatencyHistogram.
+  std::vector<uint64_t> bucket_counts;
+  /// The number of samples.
+  uint64_t count = 0;
+  /// The sum of all the samples in nanoseconds.
+  uint64_t sum_ns = 0;
+
+  /// Adds the samples of the other snapshot to this one.
+  void Merge(const LatencyHistogramSnapshot& other) noexcept;
+
+  /**
+   * @brief Returns the upper bound of the bucket that contains the given
+   * percentile of the samples, or 0 if there are no samples.
+   *
+   * @param percentile the percentile in [0, 1].
+   */
+  std::chrono::nanoseconds GetPercentileUpperBound(
+      double percentile) const noexcept;
+};
+
+/**
+ * @brief A histogram of durations with power of two buckets. Bucket 0 counts
+ * the durations below 1us, and bucket i > 0 the durations in
+ * [2^(i-1)us, 2^i us). The last bucket also counts everything above it.
+ *
+ * Recording is wait-free and meant to be done by a single thread, the worker
+ * thread of an executor. Any thread can take a snapshot, which may be off by
+ * the samples being recorded at the same time.
+ */
+class LatencyHistogram {
+ public:
+  static constexpr size_t kBucketCount = 32;
+
+  LatencyHistogram();
+
+  /// Records a sample. Must only be called by one thread at a time.
+  void Record(std::chrono::nanoseconds duration) noexcept;
+
+  /// Returns a copy of the histogram.
+  LatencyHistogramSnapshot GetSnapshot() const noexcept;
+
+  /// Returns the exclusive upper bound of the bucket at the given index.
+  static std::chrono::nanoseconds GetBucketUpperBound(size_t index) noexcept;
+
+ private:
+  /// Increments the counter without a read-modify-write, there is one writer.
+  static void Add(std::atomic<uint64_t>& counter, uint64_t value) noexcept {
+    counter.store(counter.load(std::memory_order_relaxed) + value,
+                  std::memory_order_relaxed);
+  }
+
+  std::array<std::atomic<uint64_t>, kBucketCount> bucket_counts_;
+  std::atomic<uint64_t> count_;
+  std::atomic<uint64_t> sum_ns_;
+};
+
+/// A point in time copy of the telemetry of a single threaded executor.
+struct TaskExecutorTelemetrySnapshot {
+  /// The number of tasks waiting in the queues of the executor.
+  uint64_t queue_depth = 0;
+  /// The number of tasks rejected because the queues were full.
+  uint64_t rejected_count = 0;
+  /// The number of tasks dropped because their deadline passed before they
+  /// started.
+  uint64_t expired_count = 0;
+  /**
+   * @brief The time the tasks spent in the queue before they started. Only
+   * recorded by the normal executors.
+   */
+  LatencyHistogramSnapshot queue_wait_time;
+  /**
+   * @brief How late the tasks started relative to their execution timestamp.
+   * Only recorded by the urgent executors, which run ScheduleFor tasks.
+   */
+  LatencyHistogramSnapshot timer_lateness;
+  /// The time the tasks took to execute.
+  LatencyHistogramSnapshot run_time;
+
+  /// Adds the counters of the other snapshot to this one.
+  void Merge(const TaskExecutorTelemetrySnapshot& other) noexcept;
+};
+
+/// A point in time copy of the telemetry of all the executors of a pool.
+struct AsyncExecutorTelemetrySnapshot {
+  /// The telemetry of the executors running normal and high priority tasks.
+  std::vector<TaskExecutorTelemetrySnapshot> normal_executors;
+  /// The telemetry of the executors running urgent and timed tasks.
+  std::vector<TaskExecutorTelemetrySnapshot> urgent_executors;
+
+  /// Returns the telemetry of all the executors merged together.
+  TaskExecutorTelemetrySnapshot GetTotal() const noexcept;
+};
+
+/**
+ * @brief The telemetry of a single threaded executor. The histograms are only
+ * recorded by the worker thread of the executor, so the hot path neither locks
+ * nor contends on shared cache lines. The rejections are counted by the
+ * scheduling threads, and are expected to be rare.
+ *
+ * Timing a task costs two clock reads and two histogram updates, so the
+ * histograms only record one out of every sample_interval tasks, as decided by
+ * ShouldSample. A sample_interval of 0 turns them off, and of 1 records every
+ * task. The rejected and expired counts are always recorded.
+ */
+class TaskExecutorTelemetry {
+ public:
+  explicit TaskExecutorTelemetry(size_t sample_interval = 0)
+      : sample_interval_(sample_interval),
+        sample_countdown_(sample_interval),
+        rejected_count_(0),
+        expired_count_(0) {}
+
+  /// Returns whether the next task is to be timed. Worker thread only.
+  bool ShouldSample() noexcept {
+    if (sample_interval_ == 0 || --sample_countdown_ > 0) {
+      return false;
+    }
+    sample_countdown_ = sample_interval_;
+    return true;
+  }
+
+  /// Records the time a task waited in the queue. Worker thread only.
+  void RecordQueueWaitTime(std::chrono::nanoseconds duration) noexcept {
+    queue_wait_time_.Record(duration);
+  }
+
+  /// Records how late a timed task started. Worker thread only.
+  void RecordTimerLateness(std::chrono::nanoseconds duration) noexcept {
+    timer_lateness_.Record(duration);
+  }
+
+  /// Records the execution time of a task. Worker thread only.
+  void RecordRunTime(std::chrono::nanoseconds duration) noexcept {
+    run_time_.Record(duration);
+  }
+
+  /// Counts rejected tasks. Can be called from any thread.
+  void RecordRejected(uint64_t count = 1) noexcept {
+    rejected_count_.fetch_add(count, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Counts tasks dropped for their deadline. Can be called from any
+   * thread, as the tasks can be dropped by work stealing peers.
+   */
+  void RecordExpired(uint64_t count = 1) noexcept {
+    expired_count_.fetch_add(count, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Returns a copy of the telemetry.
+   *
+   * @param queue_depth the current queue depth of the executor.
+   */
+  TaskExecutorTelemetrySnapshot GetSnapshot(
+      uint64_t queue_depth) const noexcept;
+
+ private:
+  const size_t sample_interval_;
+  /// The number of tasks until the next sampled one, worker thread only.
+  size_t sample_countdown_;
+  LatencyHistogram queue_wait_time_;
+  LatencyHistogram timer_lateness_;
+  LatencyHistogram run_time_;
+  std::atomic<uint64_t> rejected_count_;
+  std::atomic<uint64_t> expired_count_;
+};
+}  // namespace google::scp::core
@@ -0,0 +1,186 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace google::scp::core {
+/**
+ * @brief Makes shared objects whose memory blocks are kept on a free list once
+ * released, so that making an object reuses the block of a released one
+ * instead of allocating a new one. A block holds both the object and its
+ * shared_ptr control block.
+ *
+ * The objects can be released on any thread and can outlive the pool, the
+ * free list is kept alive until the last of them is released.
+ */
+template <class T>
+class SharedObjectPool {
+  static_assert(alignof(T) <= __STDCPP_DEFAULT_NEW_ALIGNMENT__,
+                "The blocks are only aligned for the default new alignment.");
+
+ public:
+  /**
+   * @brief Construct a new Shared Object Pool object.
+   *
+   * @param max_free_block_count the maximum number of released blocks to keep
+   * for reuse. The blocks released beyond it are freed.
+   */
+  explicit SharedObjectPool(size_t max_free_block_count)
+      : free_list_(new FreeList(max_free_block_count)) {}
+
+  ~SharedObjectPool() { free_list_->ReleaseOwner(); }
+
+  SharedObjectPool(const SharedObjectPool&) = delete;
+  SharedObjectPool& operator=(const SharedObjectPool&) = delete;
+
+  /// Makes a shared object from the arguments, reusing a free block if any.
+  template <class... Args>
+  std::shared_ptr<T> MakeShared(Args&&... args) {
+    return std::allocate_shared<T>(BlockAllocator<T>(free_list_),
+                                   std::forward<Args>(args)...);
+  }
+
+  /// Returns the number of released blocks kept for reuse.
+  size_t GetFreeBlockCount() noexcept {
+    std::lock_guard lock(free_list_->mutex);
+    return free_list_->blocks.size();
+  }
+
+ private:
+  /**
+   * @brief The released blocks. All the blocks have the same size, as the pool
+   * only allocates the blocks of one control block type.
+   *
+   * The free list deletes itself once the pool is destroyed and all of its
+   * blocks are released. It counts its blocks under the mutex it takes anyway,
+   * so that copying the allocators does not cost any reference counting.
+   */
+  struct FreeList {
+    explicit FreeList(size_t max_block_count)
+        : max_block_count(max_block_count) {}
+
+    ~FreeList() {
+      for (auto* block : blocks) {
+        ::operator delete(block);
+      }
+    }
+
+    void* Allocate(size_t size) {
+      {
+        std::lock_guard lock(mutex);
+        allocated_block_count++;
+        if (size == block_size && !blocks.empty()) {
+          auto* block = blocks.back();
+          blocks.pop_back();
+          return block;
+        }
+      }
+      return ::operator new(size);
+    }
+
+    void Deallocate(void* block, size_t size) noexcept {
+      auto is_kept = false;
+      auto is_unused = false;
+      {
+        std::lock_guard lock(mutex);
+        allocated_block_count--;
+        if (block_size == 0) {
+          block_size = size;
+        }
+        if (size == block_size && blocks.size() < max_block_count &&
+            !is_owner_released) {
+          blocks.push_back(block);
+          is_kept = true;
+        }
+        is_unused = is_owner_released && allocated_block_count == 0;
+      }
+      if (!is_kept) {
+        ::operator delete(block);
+      }
+      if (is_unused) {
+        delete this;
+      }
+    }
+
+    void ReleaseOwner() noexcept {
+      auto is_unused = false;
+      {
+        std::lock_guard lock(mutex);
+        is_owner_released = true;
+        is_unused = allocated_block_count == 0;
+      }
+      if (is_unused) {
+        delete this;
+      }
+    }
+
+    std::mutex mutex;
+    std::vector<void*> blocks;
+    /// The size of the blocks, set by the first release.
+    size_t block_size = 0;
+    const size_t max_block_count;
+    /// The number of blocks held by objects that are not released yet.
+    size_t allocated_block_count = 0;
+    /// Whether the pool is destroyed.
+    bool is_owner_released = false;
+  };
+
+  /// Allocates the blocks of std::allocate_shared from the free list.
+  template <class U>
+  class BlockAllocator {
+   public:
+    using value_type = U;
+
+    explicit BlockAllocator(FreeList* free_list) noexcept
+        : free_list_(free_list) {}
+
+    template <class V>
+    BlockAllocator(const BlockAllocator<V>& other) noexcept
+        : free_list_(other.free_list_) {}
+
+    U* allocate(size_t count) {
+      return static_cast<U*>(free_list_->Allocate(count * sizeof(U)));
+    }
+
+    void deallocate(U* pointer, size_t count) noexcept {
+      free_list_->Deallocate(pointer, count * sizeof(U));
+    }
+
+    template <class V>
+    bool operator==(const BlockAllocator<V>& other) const noexcept {
+      return free_list_ == other.free_list_;
+    }
+
+    template <class V>
+    bool operator!=(const BlockAllocator<V>& other) const noexcept {
+      return !(*this == other);
+    }
+
+   private:
+    template <class V>
+    friend class BlockAllocator;
+
+    FreeList* free_list_;
+  };
+
+  FreeList* const free_list_;
+};
+}  // namespace google::scp::core
@@ -19,33 +19,55 @@
 #include <functional>
 #include <memory>
 #include <thread>
+#include <utility>
+#include <vector>
+
+#include "core/common/time_provider/src/time_provider.h"
+#include "core/common/tracing/src/global_tracer.h"
 
 #include "async_executor_utils.h"
 #include "error_codes.h"
 #include "typedef.h"
 
-using google::scp::core::common::ConcurrentQueue;
+using google::scp::core::common::GetSampledTracer;
+using google::scp::core::common::kZeroUuid;
+using google::scp::core::common::SpanRecord;
+using google::scp::core::common::TimeProvider;
 using std::atomic;
 using std::make_shared;
 using std::make_unique;
+using std::min;
+using std::move;
 using std::mutex;
-using std::shared_ptr;
 using std::thread;
 using std::unique_lock;
+using std::vector;
 using std::chrono::milliseconds;
+using std::chrono::nanoseconds;
+using std::chrono::steady_clock;
+using std::this_thread::yield;
 
 static constexpr size_t kLockWaitTimeInMilliseconds = 5;
 
 namespace google::scp::core {
+/// The executor whose worker thread is the calling thread, if any.
+static thread_local SingleThreadAsyncExecutor* current_executor = nullptr;
+
 ExecutionResult SingleThreadAsyncExecutor::Init() noexcept {
   if (queue_cap_ <= 0 || queue_cap_ > kMaxQueueCap) {
     return FailureExecutionResult(errors::SC_ASYNC_EXECUTOR_INVALID_QUEUE_CAP);
   }
 
-  normal_pri_queue_ =
-      make_shared<ConcurrentQueue<shared_ptr<AsyncTask>>>(queue_cap_);
-  high_pri_queue_ =
-      make_shared<ConcurrentQueue<shared_ptr<AsyncTask>>>(queue_cap_);
+  // The slots of the mpsc queues are allocated upfront.
+  if (task_queue_backend_ == TaskQueueBackend::MpscQueue &&
+      queue_cap_ > kMaxMpscQueueCap) {
+    return FailureExecutionResult(errors::SC_ASYNC_EXECUTOR_INVALID_QUEUE_CAP);
+  }
+
+  normal_pri_queue_ = make_shared<TaskQueue>(queue_cap_, task_queue_backend_);
+  high_pri_queue_ = make_shared<TaskQueue>(queue_cap_, task_queue_backend_);
+  normal_pri_deadline_queue_ = make_shared<DeadlineTaskQueue>(queue_cap_);
+  high_pri_deadline_queue_ = make_shared<DeadlineTaskQueue>(queue_cap_);
   return SuccessExecutionResult();
 };
 
@@ -58,6 +80,10 @@ ExecutionResult SingleThreadAsyncExecutor::Run() noexcept {
     return FailureExecutionResult(errors::SC_ASYNC_EXECUTOR_NOT_INITIALIZED);
   }
 
+  // The executor may be run again after it was retired.
+  worker_thread_started_ = false;
+  worker_thread_stopped_ = false;
+  drop_queued_tasks_ = false;
   is_running_ = true;
   working_thread_ = make_unique<thread>(
       [affinity_cpu_number =
@@ -67,6 +93,7 @@ ExecutionResult SingleThreadAsyncExecutor::Run() noexcept {
           AsyncExecutorUtils::SetAffinity(*affinity_cpu_number);
         }
         ptr->worker_thread_started_ = true;
+        current_executor = ptr;
         ptr->StartWorker();
         ptr->worker_thread_stopped_ = true;
       },
@@ -78,36 +105,288 @@ ExecutionResult SingleThreadAsyncExecutor::Run() noexcept {
 }
 
 void SingleThreadAsyncExecutor::StartWorker() noexcept {
+  if (idle_strategy_ == WorkerIdleStrategy::SpinThenPark) {
+    StartSpinThenParkWorker();
+    return;
+  }
+
   unique_lock<mutex> thread_lock(mutex_);
 
   while (true) {
-    condition_variable_.wait_for(
-        thread_lock, milliseconds(kLockWaitTimeInMilliseconds), [&]() {
-          return !is_running_ || high_pri_queue_->Size() > 0 ||
-                 normal_pri_queue_->Size() > 0;
-        });
-
-    if (normal_pri_queue_->Size() == 0 && high_pri_queue_->Size() == 0) {
-      if (!is_running_) {
+    condition_variable_.wait_for(thread_lock, GetIdleWaitDuration(), [&]() {
+      return ShouldWakeUp() || timer_changed_;
+    });
+    // The wait time is recomputed for the next timed task on every iteration.
+    timer_changed_ = false;
+    DropQueuedTasksIfRequested();
+
+    if (HasDueTimerTasks()) {
+      thread_lock.unlock();
+      timer_executor_->RunDueTasks();
+      thread_lock.lock();
+    }
+
+    AsyncTask task;
+    bool has_task = false;
+    if (GetPendingTaskCount() == 0) {
+      if (!is_running_ && !HasTimerTasks()) {
         break;
       }
-      continue;
+      has_task = TryStealTaskFromPeers(task);
+    } else {
+      has_task = TryDequeueLocalTask(task);
     }
 
-    shared_ptr<AsyncTask> task;
-    // The priority is with the high pri tasks.
-    if (!high_pri_queue_->TryDequeue(task).Successful() &&
-        !normal_pri_queue_->TryDequeue(task).Successful()) {
+    if (!has_task && !HasExpiredTasks()) {
       continue;
     }
-
     thread_lock.unlock();
-    task->Execute();
+    RunExpirationCallbacks();
+    if (has_task) {
+      ExecuteTask(task);
+    }
     thread_lock.lock();
   }
 }
 
+void SingleThreadAsyncExecutor::StartSpinThenParkWorker() noexcept {
+  while (true) {
+    DropQueuedTasksIfRequested();
+    if (HasDueTimerTasks()) {
+      timer_executor_->RunDueTasks();
+    }
+
+    AsyncTask task;
+    auto has_task = TryGetTask(task);
+    RunExpirationCallbacks();
+    if (has_task) {
+      ExecuteTask(task);
+      continue;
+    }
+
+    if (!is_running_ && !HasTimerTasks() && GetPendingTaskCount() == 0) {
+      break;
+    }
+
+    // Spin for a bounded time, more work usually arrives shortly under load.
+    auto spin_deadline = steady_clock::now() + kWorkerIdleSpinDurationNs;
+    bool found_task = false;
+    for (size_t spin_count = 1;
+         is_running_ && steady_clock::now() < spin_deadline; ++spin_count) {
+      if (HasPendingTasks() || HasDueTimerTasks()) {
+        found_task = true;
+        break;
+      }
+      if (spin_count % kWorkerIdleSpinYieldInterval == 0) {
+        yield();
+      } else {
+        AsyncExecutorUtils::CpuRelax();
+      }
+    }
+    if (found_task) {
+      continue;
+    }
+
+    // Park. The queues are checked once more after announcing the wait, so a
+    // task scheduled in between either is seen here or wakes the worker up.
+    auto key = event_count_.PrepareWait();
+    if (ShouldWakeUp()) {
+      event_count_.CancelWait();
+      continue;
+    }
+    // The peers do not signal this executor, so the wait is bounded to look
+    // for tasks to steal periodically.
+    event_count_.Wait(key, GetIdleWaitDuration());
+  }
+}
+
+bool SingleThreadAsyncExecutor::TryGetTask(AsyncTask& task) noexcept {
+  return TryDequeueLocalTask(task) || TryStealTaskFromPeers(task);
+}
+
+bool SingleThreadAsyncExecutor::TryDequeueLocalTask(AsyncTask& task) noexcept {
+  // The priority is with the high pri tasks.
+  return TryDequeuePriorityTask(*high_pri_deadline_queue_,
+                                pinned_high_pri_queue_.get(), *high_pri_queue_,
+                                high_pri_deadline_task_streak_, task) ||
+         TryDequeuePriorityTask(*normal_pri_deadline_queue_,
+                                pinned_normal_pri_queue_.get(),
+                                *normal_pri_queue_,
+                                normal_pri_deadline_task_streak_, task);
+}
+
+bool SingleThreadAsyncExecutor::TryDequeuePriorityTask(
+    DeadlineTaskQueue& deadline_queue, TaskQueue* pinned_queue,
+    TaskQueue& queue, size_t& deadline_task_streak, AsyncTask& task) noexcept {
+  // The tasks that have a deadline go first, but only so many in a row, so
+  // that a steady stream of them does not starve the other tasks.
+  if (deadline_task_streak < kMaxConsecutiveDeadlineTasks &&
+      TryDequeueDeadlineTask(deadline_queue, task)) {
+    ++deadline_task_streak;
+    return true;
+  }
+  if ((pinned_queue && pinned_queue->TryDequeue(task).Successful()) ||
+      queue.TryDequeue(task).Successful()) {
+    deadline_task_streak = 0;
+    return true;
+  }
+  return TryDequeueDeadlineTask(deadline_queue, task);
+}
+
+bool SingleThreadAsyncExecutor::TryDequeueDeadlineTask(
+    DeadlineTaskQueue& deadline_queue, AsyncTask& task) noexcept {
+  DeadlineTask deadline_task;
+  if (!deadline_queue.TryDequeueUnexpired(
+          deadline_task,
+          TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks())) {
+    return false;
+  }
+  task = move(deadline_task.task);
+  return true;
+}
+
+bool SingleThreadAsyncExecutor::HasExpiredTasks() noexcept {
+  return high_pri_deadline_queue_->GetExpiredCount() > 0 ||
+         normal_pri_deadline_queue_->GetExpiredCount() > 0;
+}
+
+void SingleThreadAsyncExecutor::RunExpirationCallbacks() noexcept {
+  if (!HasExpiredTasks()) {
+    return;
+  }
+  high_pri_deadline_queue_->TakeExpired(expired_tasks_);
+  normal_pri_deadline_queue_->TakeExpired(expired_tasks_);
+  // The caller has given up on the tasks, so they are not worth the CPU time.
+  telemetry_.RecordExpired(expired_tasks_.size());
+  for (auto& deadline_task : expired_tasks_) {
+    if (deadline_task.expiration_callback) {
+      deadline_task.expiration_callback(FailureExecutionResult(
+          errors::SC_ASYNC_EXECUTOR_TASK_DEADLINE_EXCEEDED));
+    }
+  }
+  expired_tasks_.clear();
+}
+
+bool SingleThreadAsyncExecutor::HasPendingTasks() noexcept {
+  return GetPendingTaskCount() > 0 || PeersHavePendingTasks();
+}
+
+void SingleThreadAsyncExecutor::DropQueuedTasksIfRequested() noexcept {
+  if (!drop_queued_tasks_) {
+    return;
+  }
+  AsyncTask task;
+  while (normal_pri_queue_->TryDequeue(task).Successful()) {}
+  while (high_pri_queue_->TryDequeue(task).Successful()) {}
+}
+
+bool SingleThreadAsyncExecutor::HasTimerTasks() noexcept {
+  return timer_executor_ &&
+         timer_executor_->GetNextTaskTimestamp() != UINT64_MAX;
+}
+
+bool SingleThreadAsyncExecutor::HasDueTimerTasks() noexcept {
+  return timer_executor_ &&
+         timer_executor_->GetNextTaskTimestamp() <=
+             TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks();
+}
+
+bool SingleThreadAsyncExecutor::ShouldWakeUp() noexcept {
+  // A stopped worker keeps running until the hosted timed tasks are done too.
+  return (!is_running_ && !HasTimerTasks()) || HasPendingTasks() ||
+         HasDueTimerTasks();
+}
+
+nanoseconds SingleThreadAsyncExecutor::GetIdleWaitDuration() noexcept {
+  nanoseconds wait_duration = milliseconds(kLockWaitTimeInMilliseconds);
+  if (!timer_executor_) {
+    return wait_duration;
+  }
+  auto next_task_timestamp = timer_executor_->GetNextTaskTimestamp();
+  auto current_timestamp =
+      TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks();
+  if (next_task_timestamp <= current_timestamp) {
+    return nanoseconds(0);
+  }
+  // Compared before the conversion, as the difference to UINT64_MAX does not
+  // fit into nanoseconds.
+  return nanoseconds(min<Timestamp>(wait_duration.count(),
+                                    next_task_timestamp - current_timestamp));
+}
+
+void SingleThreadAsyncExecutor::SetTimerExecutor(
+    SingleThreadPriorityAsyncExecutor* timer_executor) noexcept {
+  timer_executor_ = timer_executor;
+  timer_executor_->SetHost([this]() { NotifyWorkerOfTimerChange(); });
+}
+
+void SingleThreadAsyncExecutor::ExecuteTask(AsyncTask& task) noexcept {
+  auto* tracer = GetSampledTracer(kZeroUuid);
+  auto should_record_telemetry = telemetry_.ShouldSample();
+  if (!tracer && !should_record_telemetry) {
+    task.Execute();
+    return;
+  }
+
+  auto start_timestamp =
+      TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks();
+  // The tasks of the normal executors are timestamped when they are queued.
+  auto queued_timestamp = task.GetExecutionTimestamp();
+  auto queue_wait_time =
+      start_timestamp > queued_timestamp ? start_timestamp - queued_timestamp
+                                         : 0;
+  task.Execute();
+  auto end_timestamp =
+      TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks();
+  if (should_record_telemetry) {
+    telemetry_.RecordQueueWaitTime(nanoseconds(queue_wait_time));
+    telemetry_.RecordRunTime(nanoseconds(end_timestamp - start_timestamp));
+  }
+
+  if (tracer) {
+    SpanRecord span;
+    span.name = "AsyncExecutor::Task";
+    span.start_timestamp = start_timestamp;
+    span.end_timestamp = end_timestamp;
+    span.argument_name = "queue_wait_ns";
+    span.argument_value = queue_wait_time;
+    tracer->RecordSpan(span);
+  }
+}
+
+void SingleThreadAsyncExecutor::NotifyWorker() noexcept {
+  if (idle_strategy_ == WorkerIdleStrategy::SpinThenPark) {
+    event_count_.NotifyOne();
+    return;
+  }
+  condition_variable_.notify_one();
+}
+
+void SingleThreadAsyncExecutor::NotifyWorkerOfTimerChange() noexcept {
+  if (idle_strategy_ == WorkerIdleStrategy::SpinThenPark) {
+    event_count_.NotifyOne();
+    return;
+  }
+  // A timed task can be due well within the bounded wait of the worker, so the
+  // signal must not be lost between the worker computing its wait time and
+  // blocking. Setting the flag under the mutex orders the two.
+  {
+    unique_lock<mutex> thread_lock(mutex_);
+    timer_changed_ = true;
+  }
+  condition_variable_.notify_one();
+}
+
 ExecutionResult SingleThreadAsyncExecutor::Stop() noexcept {
+  return StopWorker(drop_tasks_on_stop_);
+}
+
+ExecutionResult SingleThreadAsyncExecutor::Retire() noexcept {
+  return StopWorker(/*drop_tasks=*/false);
+}
+
+ExecutionResult SingleThreadAsyncExecutor::StopWorker(
+    bool drop_tasks) noexcept {
   if (!is_running_) {
     return FailureExecutionResult(errors::SC_ASYNC_EXECUTOR_NOT_RUNNING);
   }
@@ -115,14 +394,31 @@ ExecutionResult SingleThreadAsyncExecutor::Stop() noexcept {
   unique_lock<mutex> thread_lock(mutex_);
   is_running_ = false;
 
-  if (drop_tasks_on_stop_) {
-    shared_ptr<AsyncTask> task;
-    while (normal_pri_queue_->TryDequeue(task).Successful()) {}
-    while (high_pri_queue_->TryDequeue(task).Successful()) {}
+  if (drop_tasks) {
+    if (normal_pri_queue_->IsSingleConsumer()) {
+      // Only the worker thread may dequeue, the flag is seen by the worker
+      // before it checks the queues again.
+      drop_queued_tasks_ = true;
+    } else {
+      AsyncTask task;
+      while (normal_pri_queue_->TryDequeue(task).Successful()) {}
+      while (high_pri_queue_->TryDequeue(task).Successful()) {}
+      if (pinned_normal_pri_queue_) {
+        while (pinned_normal_pri_queue_->TryDequeue(task).Successful()) {}
+        while (pinned_high_pri_queue_->TryDequeue(task).Successful()) {}
+      }
+    }
+    DeadlineTask deadline_task;
+    while (normal_pri_deadline_queue_->TryDequeue(deadline_task)) {}
+    while (high_pri_deadline_queue_->TryDequeue(deadline_task)) {}
+    vector<DeadlineTask> expired_tasks;
+    normal_pri_deadline_queue_->TakeExpired(expired_tasks);
+    high_pri_deadline_queue_->TakeExpired(expired_tasks);
   }
 
   condition_variable_.notify_all();
   thread_lock.unlock();
+  event_count_.NotifyAll();
 
   // To ensure stop can happen cleanly, it is required to wait for the thread to
   // start and exit gracefully. If stop happens before the starting the thread,
@@ -136,7 +432,71 @@ ExecutionResult SingleThreadAsyncExecutor::Stop() noexcept {
 };
 
 ExecutionResult SingleThreadAsyncExecutor::Schedule(
-    const AsyncOperation& work, AsyncPriority priority) noexcept {
+    const AsyncOperation& work, AsyncPriority priority,
+    AsyncExecutorAffinitySetting affinity) noexcept {
+  RETURN_IF_FAILURE(CanSchedule(priority));
+  return ScheduleTask(AsyncTask(work), priority, affinity);
+};
+
+ExecutionResult SingleThreadAsyncExecutor::Schedule(
+    AsyncOperation&& work, AsyncPriority priority,
+    AsyncExecutorAffinitySetting affinity) noexcept {
+  // Checked before the work is moved into the task, so that the caller can
+  // still schedule the work elsewhere.
+  RETURN_IF_FAILURE(CanSchedule(priority));
+  return ScheduleTask(AsyncTask(move(work)), priority, affinity);
+};
+
+ExecutionResult SingleThreadAsyncExecutor::ScheduleWithDeadline(
+    const AsyncOperation& work, AsyncPriority priority, Timestamp deadline,
+    const TaskExpirationCallback& expiration_callback) noexcept {
+  RETURN_IF_FAILURE(CanSchedule(priority));
+  auto current_timestamp =
+      TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks();
+  if (deadline <= current_timestamp) {
+    return FailureExecutionResult(
+        errors::SC_ASYNC_EXECUTOR_TASK_DEADLINE_EXCEEDED);
+  }
+  return ScheduleDeadlineTask(
+      DeadlineTask{AsyncTask(work, current_timestamp), deadline,
+                   expiration_callback},
+      priority);
+}
+
+ExecutionResult SingleThreadAsyncExecutor::ScheduleWithDeadline(
+    AsyncOperation&& work, AsyncPriority priority, Timestamp deadline,
+    const TaskExpirationCallback& expiration_callback) noexcept {
+  // Checked before the work is moved into the task, so that the caller can
+  // still use the work.
+  RETURN_IF_FAILURE(CanSchedule(priority));
+  auto current_timestamp =
+      TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks();
+  if (deadline <= current_timestamp) {
+    return FailureExecutionResult(
+        errors::SC_ASYNC_EXECUTOR_TASK_DEADLINE_EXCEEDED);
+  }
+  return ScheduleDeadlineTask(
+      DeadlineTask{AsyncTask(move(work), current_timestamp), deadline,
+                   expiration_callback},
+      priority);
+}
+
+ExecutionResult SingleThreadAsyncExecutor::ScheduleDeadlineTask(
+    DeadlineTask&& deadline_task, AsyncPriority priority) noexcept {
+  auto& deadline_queue = priority == AsyncPriority::Normal
+                             ? normal_pri_deadline_queue_
+                             : high_pri_deadline_queue_;
+  if (!deadline_queue->TryEnqueue(move(deadline_task))) {
+    telemetry_.RecordRejected();
+    return RetryExecutionResult(errors::SC_ASYNC_EXECUTOR_EXCEEDING_QUEUE_CAP);
+  }
+
+  NotifyWorker();
+  return SuccessExecutionResult();
+}
+
+ExecutionResult SingleThreadAsyncExecutor::CanSchedule(
+    AsyncPriority priority) noexcept {
   if (!is_running_) {
     return FailureExecutionResult(errors::SC_ASYNC_EXECUTOR_NOT_RUNNING);
   }
@@ -145,23 +505,64 @@ ExecutionResult SingleThreadAsyncExecutor::Schedule(
     return FailureExecutionResult(
         errors::SC_ASYNC_EXECUTOR_INVALID_PRIORITY_TYPE);
   }
+  return SuccessExecutionResult();
+}
 
-  auto task = make_shared<AsyncTask>(work);
-  ExecutionResult execution_result;
-  if (priority == AsyncPriority::Normal) {
-    execution_result = normal_pri_queue_->TryEnqueue(task);
-  } else {
-    execution_result = high_pri_queue_->TryEnqueue(task);
+TaskQueue& SingleThreadAsyncExecutor::GetTaskQueue(
+    AsyncPriority priority, AsyncExecutorAffinitySetting affinity) noexcept {
+  // Only the tasks scheduled from the worker thread itself are pinned, as
+  // the others were not placed on this executor for their affinity.
+  if (affinity ==
+          AsyncExecutorAffinitySetting::AffinitizedToCallingAsyncExecutor &&
+      pinned_normal_pri_queue_ && current_executor == this) {
+    return priority == AsyncPriority::Normal ? *pinned_normal_pri_queue_
+                                             : *pinned_high_pri_queue_;
   }
+  return priority == AsyncPriority::Normal ? *normal_pri_queue_
+                                           : *high_pri_queue_;
+}
 
+ExecutionResult SingleThreadAsyncExecutor::ScheduleTask(
+    AsyncTask&& task, AsyncPriority priority,
+    AsyncExecutorAffinitySetting affinity) noexcept {
+  auto execution_result =
+      GetTaskQueue(priority, affinity).TryEnqueue(move(task));
   if (!execution_result.Successful()) {
+    telemetry_.RecordRejected();
     return RetryExecutionResult(errors::SC_ASYNC_EXECUTOR_EXCEEDING_QUEUE_CAP);
   }
 
-  condition_variable_.notify_one();
+  NotifyWorker();
   return SuccessExecutionResult();
 };
 
+ExecutionResult SingleThreadAsyncExecutor::ScheduleBatch(
+    vector<AsyncOperation>::iterator begin,
+    vector<AsyncOperation>::iterator end, AsyncPriority priority,
+    size_t& scheduled_count, AsyncExecutorAffinitySetting affinity) noexcept {
+  scheduled_count = 0;
+  RETURN_IF_FAILURE(CanSchedule(priority));
+
+  auto& queue = GetTaskQueue(priority, affinity);
+  ExecutionResult execution_result = SuccessExecutionResult();
+  for (auto it = begin; it != end; ++it) {
+    // The task is constructed in the queue, so the operation is only moved
+    // from if there is room for it.
+    if (!queue.TryEmplace(move(*it)).Successful()) {
+      telemetry_.RecordRejected(end - it);
+      execution_result =
+          RetryExecutionResult(errors::SC_ASYNC_EXECUTOR_EXCEEDING_QUEUE_CAP);
+      break;
+    }
+    scheduled_count++;
+  }
+
+  if (scheduled_count > 0) {
+    NotifyWorker();
+  }
+  return execution_result;
+}
+
 ExecutionResultOr<thread::id> SingleThreadAsyncExecutor::GetThreadId() const {
   if (!is_running_.load()) {
     return FailureExecutionResult(errors::SC_ASYNC_EXECUTOR_NOT_RUNNING);
@@ -169,4 +570,93 @@ ExecutionResultOr<thread::id> SingleThreadAsyncExecutor::GetThreadId() const {
   return working_thread_id_;
 }
 
+TaskExecutorTelemetrySnapshot
+SingleThreadAsyncExecutor::GetTelemetrySnapshot() noexcept {
+  return telemetry_.GetSnapshot(GetPendingTaskCount());
+}
+
+size_t SingleThreadAsyncExecutor::GetPendingTaskCount() noexcept {
+  if (!normal_pri_queue_ || !high_pri_queue_) {
+    return 0;
+  }
+  auto pending_task_count = normal_pri_queue_->Size() +
+                            high_pri_queue_->Size() +
+                            normal_pri_deadline_queue_->GetSizeWithExpired() +
+                            high_pri_deadline_queue_->GetSizeWithExpired();
+  if (pinned_normal_pri_queue_) {
+    pending_task_count +=
+        pinned_normal_pri_queue_->Size() + pinned_high_pri_queue_->Size();
+  }
+  return pending_task_count;
+}
+
+void SingleThreadAsyncExecutor::SetWorkStealingPeers(
+    const vector<SingleThreadAsyncExecutor*>& peers) noexcept {
+  work_stealing_peers_ = peers;
+  // The single consumer queues are not stolen from in the first place.
+  if (!peers.empty() && normal_pri_queue_ &&
+      !normal_pri_queue_->IsSingleConsumer()) {
+    pinned_normal_pri_queue_ =
+        make_shared<TaskQueue>(queue_cap_, task_queue_backend_);
+    pinned_high_pri_queue_ =
+        make_shared<TaskQueue>(queue_cap_, task_queue_backend_);
+  }
+}
+
+size_t SingleThreadAsyncExecutor::GetStealableTaskCount() noexcept {
+  if (!normal_pri_queue_ || !high_pri_queue_) {
+    return 0;
+  }
+  auto stealable_task_count =
+      normal_pri_deadline_queue_->Size() + high_pri_deadline_queue_->Size();
+  if (!normal_pri_queue_->IsSingleConsumer()) {
+    stealable_task_count += normal_pri_queue_->Size() + high_pri_queue_->Size();
+  }
+  return stealable_task_count;
+}
+
+bool SingleThreadAsyncExecutor::TryStealTask(AsyncTask& task) noexcept {
+  if (!normal_pri_queue_ || !high_pri_queue_) {
+    return false;
+  }
+  // Only the worker thread of this executor may dequeue from the single
+  // consumer queues, so only the tasks with a deadline can be stolen then.
+  // The pinned queues are never stolen from.
+  auto is_single_consumer = normal_pri_queue_->IsSingleConsumer();
+  auto has_task = TryDequeueDeadlineTask(*high_pri_deadline_queue_, task) ||
+                  (!is_single_consumer &&
+                   high_pri_queue_->TryDequeue(task).Successful()) ||
+                  TryDequeueDeadlineTask(*normal_pri_deadline_queue_, task) ||
+                  (!is_single_consumer &&
+                   normal_pri_queue_->TryDequeue(task).Successful());
+  // The expired tasks found by the thief are left to the worker thread of this
+  // executor, which may be waiting.
+  if (HasExpiredTasks()) {
+    NotifyWorker();
+  }
+  return has_task;
+}
+
+bool SingleThreadAsyncExecutor::PeersHavePendingTasks() noexcept {
+  for (auto* peer : work_stealing_peers_) {
+    if (peer->GetStealableTaskCount() > 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool SingleThreadAsyncExecutor::TryStealTaskFromPeers(
+    AsyncTask& task) noexcept {
+  auto peers_count = work_stealing_peers_.size();
+  for (size_t i = 0; i < peers_count; ++i) {
+    auto peer_index = (next_work_stealing_peer_index_ + i) % peers_count;
+    if (work_stealing_peers_[peer_index]->TryStealTask(task)) {
+      next_work_stealing_peer_index_ = (peer_index + 1) % peers_count;
+      return true;
+    }
+  }
+  return false;
+}
+
 }  // namespace google::scp::core
@@ -15,17 +15,38 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <memory>
 #include <mutex>
 #include <optional>
+#include <vector>
 
-#include "core/common/concurrent_queue/src/concurrent_queue.h"
 #include "core/interface/async_executor_interface.h"
 
 #include "async_task.h"
+#include "deadline_task_queue.h"
+#include "event_count.h"
+#include "executor_telemetry.h"
+#include "single_thread_priority_async_executor.h"
+#include "task_queue.h"
 
 namespace google::scp::core {
+/// The way the worker of an executor waits for work when its queues are empty.
+enum class WorkerIdleStrategy {
+  /**
+   * @brief The worker blocks on a condition variable, and every scheduled task
+   * signals it.
+   */
+  Block = 0,
+  /**
+   * @brief The worker spins for kWorkerIdleSpinDurationNs before parking on an
+   * eventcount. The scheduling side only signals the worker if it is parked,
+   * so there is no signaling cost while the worker is busy or spinning.
+   */
+  SpinThenPark = 1,
+};
+
 /**
  * @brief A single threaded async executor. This executor will have one thread
  * working with one queue.
@@ -34,13 +55,19 @@ class SingleThreadAsyncExecutor : ServiceInterface {
  public:
   explicit SingleThreadAsyncExecutor(
       size_t queue_cap, bool drop_tasks_on_stop = false,
-      std::optional<size_t> affinity_cpu_number = std::nullopt)
+      std::optional<size_t> affinity_cpu_number = std::nullopt,
+      WorkerIdleStrategy idle_strategy = WorkerIdleStrategy::Block,
+      TaskQueueBackend task_queue_backend = TaskQueueBackend::ConcurrentQueue,
+      size_t telemetry_sample_interval = 0)
       : is_running_(false),
         worker_thread_started_(false),
         worker_thread_stopped_(false),
         queue_cap_(queue_cap),
         drop_tasks_on_stop_(drop_tasks_on_stop),
-        affinity_cpu_number_(affinity_cpu_number) {}
+        affinity_cpu_number_(affinity_cpu_number),
+        idle_strategy_(idle_strategy),
+        task_queue_backend_(task_queue_backend),
+        telemetry_(telemetry_sample_interval) {}
 
   ExecutionResult Init() noexcept override;
 
@@ -48,15 +75,86 @@ class SingleThreadAsyncExecutor : ServiceInterface {
 
   ExecutionResult Stop() noexcept override;
 
+  /**
+   * @brief Stops the worker thread once it has executed all the pending tasks,
+   * regardless of drop_tasks_on_stop. Unlike Stop, this is meant for an
+   * executor that is Run again later, and keeps its queues.
+   */
+  ExecutionResult Retire() noexcept;
+
   /**
    * @brief Schedules a task with certain priority to be execute immediately or
    * deferred.
    * @param work the task that needs to be scheduled.
    * @param priority the priority of the task. Either normal or medium.
+   * @param affinity the affinity of the task. With work stealing, a task
+   * scheduled from the worker thread of this executor with
+   * AffinitizedToCallingAsyncExecutor is kept out of reach of the peers.
+   * @return ExecutionResult result of the execution with possible error code.
+   */
+  ExecutionResult Schedule(
+      const AsyncOperation& work, AsyncPriority priority,
+      AsyncExecutorAffinitySetting affinity =
+          AsyncExecutorAffinitySetting::NonAffinitized) noexcept;
+
+  /**
+   * @brief Same as above but takes ownership of the work to avoid copying the
+   * captured state of the operation. The work is left untouched if the
+   * executor is not running.
+   */
+  ExecutionResult Schedule(
+      AsyncOperation&& work, AsyncPriority priority,
+      AsyncExecutorAffinitySetting affinity =
+          AsyncExecutorAffinitySetting::NonAffinitized) noexcept;
+
+  /**
+   * @brief Schedules a task with certain priority that is only worth starting
+   * until its deadline. The tasks with a deadline run earliest deadline first,
+   * ahead of the tasks without a deadline of the same priority. A task whose
+   * deadline has passed by the time it is dequeued is dropped, and its
+   * expiration callback is called with SC_ASYNC_EXECUTOR_TASK_DEADLINE_EXCEEDED
+   * instead.
+   *
+   * @param work the task that needs to be scheduled.
+   * @param priority the priority of the task. Either normal or medium.
+   * @param deadline the steady clock timestamp in nanoseconds after which the
+   * task is dropped.
+   * @param expiration_callback is called instead of the task if it is dropped.
+   * @return ExecutionResult result of the execution with possible error code.
+   * SC_ASYNC_EXECUTOR_TASK_DEADLINE_EXCEEDED if the deadline has already
+   * passed, in which case the work is left untouched and the expiration
+   * callback is not called.
+   */
+  ExecutionResult ScheduleWithDeadline(
+      const AsyncOperation& work, AsyncPriority priority, Timestamp deadline,
+      const TaskExpirationCallback& expiration_callback) noexcept;
+
+  /**
+   * @brief Same as above but takes ownership of the work to avoid copying the
+   * captured state of the operation.
+   */
+  ExecutionResult ScheduleWithDeadline(
+      AsyncOperation&& work, AsyncPriority priority, Timestamp deadline,
+      const TaskExpirationCallback& expiration_callback) noexcept;
+
+  /**
+   * @brief Schedules the operations in [begin, end) with certain priority and
+   * signals the worker thread once for the whole batch.
+   *
+   * @param begin the first operation to be scheduled.
+   * @param end the end of the operations to be scheduled.
+   * @param priority the priority of the tasks. Either normal or medium.
+   * @param scheduled_count the number of operations that were scheduled. The
+   * scheduled operations are moved from, and the rest are left untouched.
+   * @param affinity the affinity of the tasks, see Schedule.
    * @return ExecutionResult result of the execution with possible error code.
    */
-  ExecutionResult Schedule(const AsyncOperation& work,
-                           AsyncPriority priority) noexcept;
+  ExecutionResult ScheduleBatch(
+      std::vector<AsyncOperation>::iterator begin,
+      std::vector<AsyncOperation>::iterator end, AsyncPriority priority,
+      size_t& scheduled_count,
+      AsyncExecutorAffinitySetting affinity =
+          AsyncExecutorAffinitySetting::NonAffinitized) noexcept;
 
   /**
    * @brief Returns the ID of the spawned thread object to enable looking it up
@@ -64,10 +162,193 @@ class SingleThreadAsyncExecutor : ServiceInterface {
    */
   ExecutionResultOr<std::thread::id> GetThreadId() const;
 
+  /// Returns a copy of the telemetry of the executor.
+  TaskExecutorTelemetrySnapshot GetTelemetrySnapshot() noexcept;
+
+  /// Returns the approximate number of tasks waiting in the queues.
+  size_t GetPendingTaskCount() noexcept;
+
+  /**
+   * @brief Returns the approximate number of pending tasks that TryStealTask
+   * can hand out. With TaskQueueBackend::MpscQueue, only the tasks with a
+   * deadline can be stolen. The affinitized tasks are never stolen.
+   */
+  size_t GetStealableTaskCount() noexcept;
+
+  /**
+   * @brief Sets the sibling executors that this executor can take queued work
+   * from when its own queues are empty. Must be called after Init() and before
+   * Run(). The peers must outlive the worker thread of this executor.
+   *
+   * @param peers the sibling executors, excluding this executor.
+   */
+  void SetWorkStealingPeers(
+      const std::vector<SingleThreadAsyncExecutor*>& peers) noexcept;
+
+  /**
+   * @brief Dequeues a pending task of this executor on behalf of a sibling
+   * executor. High priority tasks are handed out first, and within a priority
+   * the tasks with a deadline. Expired tasks are dropped on the way. The
+   * affinitized tasks are left to this executor.
+   *
+   * @param task the stolen task if any.
+   * @return true if a task was stolen.
+   */
+  bool TryStealTask(AsyncTask& task) noexcept;
+
+  /**
+   * @brief Makes the worker thread of this executor also execute the tasks of
+   * the given timer executor, which then has no thread of its own. The due
+   * timed tasks run ahead of the queued tasks. Must be called before Run(),
+   * and the timer executor must be Run before and stopped before this
+   * executor, and outlive its worker thread.
+   *
+   * @param timer_executor the timer executor to host.
+   */
+  void SetTimerExecutor(
+      SingleThreadPriorityAsyncExecutor* timer_executor) noexcept;
+
  private:
   /// Starts the internal worker thread.
   void StartWorker() noexcept;
 
+  /// Runs the worker loop for WorkerIdleStrategy::SpinThenPark.
+  void StartSpinThenParkWorker() noexcept;
+
+  /**
+   * @brief Dequeues a task from the local queues, high priority first, or
+   * steals one from the peers.
+   *
+   * @param task the dequeued task if any.
+   * @return true if a task was dequeued.
+   */
+  bool TryGetTask(AsyncTask& task) noexcept;
+
+  /// Returns true if this executor or any of its peers has pending tasks.
+  bool HasPendingTasks() noexcept;
+
+  /**
+   * @brief Drops the queued tasks on the worker thread if StopWorker asked for
+   * it. The single consumer queues cannot be drained by StopWorker itself.
+   */
+  void DropQueuedTasksIfRequested() noexcept;
+
+  /// Signals the worker thread that tasks were queued.
+  void NotifyWorker() noexcept;
+
+  /**
+   * @brief Signals the worker thread that the next timed task is due earlier
+   * than it was when the worker last computed its wait time.
+   */
+  void NotifyWorkerOfTimerChange() noexcept;
+
+  /// Returns true if the hosted timer executor has scheduled tasks.
+  bool HasTimerTasks() noexcept;
+
+  /// Returns true if a task of the hosted timer executor is due.
+  bool HasDueTimerTasks() noexcept;
+
+  /// Returns true if the worker thread has to stop waiting.
+  bool ShouldWakeUp() noexcept;
+
+  /**
+   * @brief Returns how long the worker thread can wait for work, bounded by
+   * the next timed task of the hosted timer executor.
+   */
+  std::chrono::nanoseconds GetIdleWaitDuration() noexcept;
+
+  /**
+   * @brief Stops the worker thread and waits for it to exit.
+   *
+   * @param drop_tasks whether to drop the pending tasks rather than letting
+   * the worker thread execute them before exiting.
+   */
+  ExecutionResult StopWorker(bool drop_tasks) noexcept;
+
+  /**
+   * @brief Dequeues a task from the local queues, see TryStealTask.
+   *
+   * @param task the dequeued task if any.
+   * @return true if a task was dequeued.
+   */
+  bool TryDequeueLocalTask(AsyncTask& task) noexcept;
+
+  /**
+   * @brief Dequeues a task of one priority. The tasks that have a deadline go
+   * first, except that after kMaxConsecutiveDeadlineTasks of them in a row a
+   * task without a deadline goes. Worker thread only.
+   *
+   * @param deadline_queue the deadline queue of the priority.
+   * @param pinned_queue the pinned queue of the priority, if any.
+   * @param queue the queue of the priority.
+   * @param deadline_task_streak the number of tasks with a deadline dequeued
+   * in a row for the priority.
+   * @param task the dequeued task if any.
+   * @return true if a task was dequeued.
+   */
+  bool TryDequeuePriorityTask(DeadlineTaskQueue& deadline_queue,
+                              TaskQueue* pinned_queue, TaskQueue& queue,
+                              size_t& deadline_task_streak,
+                              AsyncTask& task) noexcept;
+
+  /**
+   * @brief Dequeues the task with the earliest deadline that has not passed.
+   * The expired tasks before it are set aside in the queue, for the worker
+   * thread of this executor to call their expiration callbacks.
+   *
+   * @param deadline_queue the queue to dequeue from.
+   * @param task the dequeued task if any.
+   * @return true if a task was dequeued.
+   */
+  bool TryDequeueDeadlineTask(DeadlineTaskQueue& deadline_queue,
+                              AsyncTask& task) noexcept;
+
+  /// Returns true if the deadline queues have expired tasks set aside.
+  bool HasExpiredTasks() noexcept;
+
+  /**
+   * @brief Calls the expiration callbacks of the expired tasks. Worker thread
+   * only, and without holding mutex_, as the callbacks can be arbitrary code.
+   */
+  void RunExpirationCallbacks() noexcept;
+
+  /// Enqueues the task into the deadline queue of the given priority.
+  ExecutionResult ScheduleDeadlineTask(DeadlineTask&& deadline_task,
+                                       AsyncPriority priority) noexcept;
+
+  /// Checks that a task of the given priority can be scheduled.
+  ExecutionResult CanSchedule(AsyncPriority priority) noexcept;
+
+  /// Executes the task on the worker thread and records its telemetry.
+  void ExecuteTask(AsyncTask& task) noexcept;
+
+  /**
+   * @brief Enqueues the task into the queue of the given priority. CanSchedule
+   * must have succeeded for the priority.
+   */
+  ExecutionResult ScheduleTask(AsyncTask&& task, AsyncPriority priority,
+                               AsyncExecutorAffinitySetting affinity) noexcept;
+
+  /**
+   * @brief Returns the queue that the tasks of the given priority and affinity
+   * are enqueued into.
+   */
+  TaskQueue& GetTaskQueue(AsyncPriority priority,
+                          AsyncExecutorAffinitySetting affinity) noexcept;
+
+  /// Returns true if any of the work stealing peers has pending tasks.
+  bool PeersHavePendingTasks() noexcept;
+
+  /**
+   * @brief Tries to steal a task from the work stealing peers. The peers are
+   * visited starting from a rotating offset so that the idle executors do not
+   * all contend on the same sibling.
+   *
+   * @param task the stolen task if any.
+   * @return true if a task was stolen.
+   */
+  bool TryStealTaskFromPeers(AsyncTask& task) noexcept;
+
   /**
    * @brief While it is true, the running thread will keep listening and
    * picking out work from work queue. While it is false, the thread will try to
@@ -84,12 +365,36 @@ class SingleThreadAsyncExecutor : ServiceInterface {
   bool drop_tasks_on_stop_;
   /// An optional CPU to have an affinity for.
   std::optional<size_t> affinity_cpu_number_;
-  /// Queue for accepting the incoming normal priority tasks.
-  std::shared_ptr<common::ConcurrentQueue<std::shared_ptr<AsyncTask>>>
-      normal_pri_queue_;
+  /// The way the worker waits for work when the queues are empty.
+  WorkerIdleStrategy idle_strategy_;
+  /// The queue implementation of the normal and high priority queues.
+  TaskQueueBackend task_queue_backend_;
+  /**
+   * @brief Queue for accepting the incoming normal priority tasks. The tasks
+   * are stored by value in the queue to avoid a heap allocation per task.
+   */
+  std::shared_ptr<TaskQueue> normal_pri_queue_;
   /// Queue for accepting the incoming high priority tasks.
-  std::shared_ptr<common::ConcurrentQueue<std::shared_ptr<AsyncTask>>>
-      high_pri_queue_;
+  std::shared_ptr<TaskQueue> high_pri_queue_;
+  /**
+   * @brief Queues for the affinitized normal and high priority tasks, which
+   * the work stealing peers cannot dequeue from. Only created with work
+   * stealing peers, as the other queues are not stolen from otherwise.
+   */
+  std::shared_ptr<TaskQueue> pinned_normal_pri_queue_;
+  std::shared_ptr<TaskQueue> pinned_high_pri_queue_;
+  /// Queue for the normal priority tasks with a deadline.
+  std::shared_ptr<DeadlineTaskQueue> normal_pri_deadline_queue_;
+  /// Queue for the high priority tasks with a deadline.
+  std::shared_ptr<DeadlineTaskQueue> high_pri_deadline_queue_;
+  /// The expired tasks taken out of the deadline queues, worker thread only.
+  std::vector<DeadlineTask> expired_tasks_;
+  /**
+   * @brief The number of tasks with a deadline dequeued in a row for each
+   * priority, see TryDequeuePriorityTask. Worker thread only.
+   */
+  size_t normal_pri_deadline_task_streak_ = 0;
+  size_t high_pri_deadline_task_streak_ = 0;
   /// A unique pointer to the working thread.
   std::unique_ptr<std::thread> working_thread_;
   /// The ID of the working_thread_.
@@ -104,5 +409,25 @@ class SingleThreadAsyncExecutor : ServiceInterface {
    * element is pushed to the queue.
    */
   std::condition_variable condition_variable_;
+  /// Parks the worker thread for WorkerIdleStrategy::SpinThenPark.
+  EventCount event_count_;
+  /// Sibling executors to steal work from when this executor is idle.
+  std::vector<SingleThreadAsyncExecutor*> work_stealing_peers_;
+  /// The index of the peer to start the next steal attempt from.
+  size_t next_work_stealing_peer_index_ = 0;
+  /// The telemetry of the executor, recorded by the worker thread.
+  TaskExecutorTelemetry telemetry_;
+  /// The timer executor whose tasks the worker thread executes, if any.
+  SingleThreadPriorityAsyncExecutor* timer_executor_ = nullptr;
+  /**
+   * @brief Indicates that the worker needs to recompute its wait time for the
+   * next timed task. Guarded by the mutex.
+   */
+  bool timer_changed_ = false;
+  /**
+   * @brief Set by StopWorker for the worker thread to drop the tasks of the
+   * single consumer queues.
+   */
+  std::atomic<bool> drop_queued_tasks_ = false;
 };
 }  // namespace google::scp::core
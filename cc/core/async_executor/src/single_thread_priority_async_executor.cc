@@ -20,25 +20,32 @@
 #include <memory>
 #include <queue>
 #include <thread>
+#include <utility>
 #include <vector>
 
 #include "core/common/time_provider/src/time_provider.h"
+#include "core/common/tracing/src/global_tracer.h"
 
 #include "async_executor_utils.h"
 #include "error_codes.h"
 #include "typedef.h"
 
+using google::scp::core::common::GetSampledTracer;
+using google::scp::core::common::kZeroUuid;
+using google::scp::core::common::SpanRecord;
 using google::scp::core::common::TimeProvider;
 using std::atomic;
 using std::function;
 using std::make_shared;
 using std::make_unique;
+using std::move;
 using std::mutex;
 using std::priority_queue;
 using std::shared_ptr;
 using std::thread;
 using std::unique_lock;
 using std::vector;
+using std::weak_ptr;
 using std::chrono::milliseconds;
 using std::chrono::nanoseconds;
 
@@ -48,6 +55,14 @@ ExecutionResult SingleThreadPriorityAsyncExecutor::Init() noexcept {
     return FailureExecutionResult(errors::SC_ASYNC_EXECUTOR_INVALID_QUEUE_CAP);
   }
 
+  if (timer_queue_type_ == TimerQueueType::HierarchicalTimerWheel) {
+    timer_wheel_ = make_shared<TimerWheel>(
+        kTimerWheelTickDurationNs,
+        TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks(),
+        queue_cap_);
+    return SuccessExecutionResult();
+  }
+
   queue_ = make_shared<
       priority_queue<shared_ptr<AsyncTask>, vector<shared_ptr<AsyncTask>>,
                      AsyncTaskCompareGreater>>();
@@ -59,11 +74,16 @@ ExecutionResult SingleThreadPriorityAsyncExecutor::Run() noexcept {
     return FailureExecutionResult(errors::SC_ASYNC_EXECUTOR_ALREADY_RUNNING);
   }
 
-  if (!queue_) {
+  if (!queue_ && !timer_wheel_) {
     return FailureExecutionResult(errors::SC_ASYNC_EXECUTOR_NOT_INITIALIZED);
   }
 
   is_running_ = true;
+  if (wake_up_host_) {
+    // The tasks are executed by the host, there is no thread to spawn.
+    return SuccessExecutionResult();
+  }
+
   working_thread_ = make_unique<thread>(
       [affinity_cpu_number =
            affinity_cpu_number_](SingleThreadPriorityAsyncExecutor* ptr) {
@@ -99,36 +119,120 @@ void SingleThreadPriorityAsyncExecutor::StartWorker() noexcept {
       update_wait_time_ = false;
     }
 
-    // Discard any cancelled tasks on top of the queue as an optimization to
-    // avoid waiting for the future to arrive on an already cancelled task
-    while (!queue_->empty() && queue_->top()->IsCancelled()) {
-      queue_->pop();
-    }
-
-    if (queue_->size() == 0) {
+    next_scheduled_task_timestamp_ = ExecuteDueTasks(thread_lock);
+    if (next_scheduled_task_timestamp_ == UINT64_MAX) {
       if (!is_running_) {
         break;
       }
-      next_scheduled_task_timestamp_ = UINT64_MAX;
       wait_timeout_duration_ns = kInfiniteWaitDurationNs;
       continue;
     }
 
     Timestamp current_timestamp =
         TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks();
-
-    next_scheduled_task_timestamp_ = queue_->top()->GetExecutionTimestamp();
     wait_timeout_duration_ns = nanoseconds(0);
     if (current_timestamp < next_scheduled_task_timestamp_) {
       wait_timeout_duration_ns =
           nanoseconds(next_scheduled_task_timestamp_ - current_timestamp);
-    } else {
-      auto top = queue_->top();
-      queue_->pop();
+    }
+  }
+}
+
+Timestamp SingleThreadPriorityAsyncExecutor::ExecuteDueTasks(
+    unique_lock<mutex>& thread_lock) noexcept {
+  if (timer_wheel_) {
+    vector<shared_ptr<AsyncTask>> expired_tasks;
+    timer_wheel_->PopExpired(
+        TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks(),
+        expired_tasks);
+    if (!expired_tasks.empty()) {
       thread_lock.unlock();
-      top->Execute();
+      for (auto& task : expired_tasks) {
+        ExecuteTask(*task);
+      }
       thread_lock.lock();
     }
+
+    // The wheel also needs to be advanced to cascade its higher levels, so the
+    // next event is not necessarily the execution of a task.
+    return timer_wheel_->Size() == 0 ? UINT64_MAX
+                                     : timer_wheel_->GetNextEventTimestamp();
+  }
+
+  while (true) {
+    // Discard any cancelled tasks on top of the queue as an optimization to
+    // avoid waiting for the future to arrive on an already cancelled task
+    while (!queue_->empty() && queue_->top()->IsCancelled()) {
+      queue_->pop();
+    }
+
+    if (queue_->empty()) {
+      return UINT64_MAX;
+    }
+
+    auto next_timestamp = queue_->top()->GetExecutionTimestamp();
+    if (TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks() <
+        next_timestamp) {
+      return next_timestamp;
+    }
+
+    auto top = queue_->top();
+    queue_->pop();
+    thread_lock.unlock();
+    ExecuteTask(*top);
+    thread_lock.lock();
+  }
+}
+
+void SingleThreadPriorityAsyncExecutor::SetHost(
+    function<void()> wake_up_host) noexcept {
+  wake_up_host_ = move(wake_up_host);
+}
+
+void SingleThreadPriorityAsyncExecutor::RunDueTasks() noexcept {
+  unique_lock<mutex> thread_lock(mutex_);
+  next_scheduled_task_timestamp_ = ExecuteDueTasks(thread_lock);
+}
+
+Timestamp SingleThreadPriorityAsyncExecutor::GetNextTaskTimestamp()
+    const noexcept {
+  return next_scheduled_task_timestamp_.load();
+}
+
+void SingleThreadPriorityAsyncExecutor::ExecuteTask(AsyncTask& task) noexcept {
+  if (task.IsCancelled()) {
+    return;
+  }
+
+  auto* tracer = GetSampledTracer(kZeroUuid);
+  auto should_record_telemetry = telemetry_.ShouldSample();
+  if (!tracer && !should_record_telemetry) {
+    task.Execute();
+    return;
+  }
+
+  auto start_timestamp =
+      TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks();
+  auto execution_timestamp = task.GetExecutionTimestamp();
+  auto timer_lateness = start_timestamp > execution_timestamp
+                            ? start_timestamp - execution_timestamp
+                            : 0;
+  task.Execute();
+  auto end_timestamp =
+      TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks();
+  if (should_record_telemetry) {
+    telemetry_.RecordTimerLateness(nanoseconds(timer_lateness));
+    telemetry_.RecordRunTime(nanoseconds(end_timestamp - start_timestamp));
+  }
+
+  if (tracer) {
+    SpanRecord span;
+    span.name = "AsyncExecutor::TimedTask";
+    span.start_timestamp = start_timestamp;
+    span.end_timestamp = end_timestamp;
+    span.argument_name = "timer_lateness_ns";
+    span.argument_value = timer_lateness;
+    tracer->RecordSpan(span);
   }
 }
 
@@ -141,14 +245,26 @@ ExecutionResult SingleThreadPriorityAsyncExecutor::Stop() noexcept {
   is_running_ = false;
 
   if (drop_tasks_on_stop_) {
-    while (queue_->size() > 0) {
-      queue_->pop();
+    if (timer_wheel_) {
+      timer_wheel_->Clear();
+    } else {
+      while (queue_->size() > 0) {
+        queue_->pop();
+      }
     }
+    // A host waits for the next task timestamp before it stops.
+    next_scheduled_task_timestamp_ = UINT64_MAX;
   }
 
   condition_variable_.notify_all();
   thread_lock.unlock();
 
+  if (wake_up_host_) {
+    // The host keeps executing the remaining tasks until it is stopped.
+    wake_up_host_();
+    return SuccessExecutionResult();
+  }
+
   // To ensure stop can happen cleanly, it is required to wait for the thread to
   // start and exit gracefully. If stop happens before the starting the thread,
   // there is a chance that Stop returns successful but the thread has not been
@@ -162,35 +278,142 @@ ExecutionResult SingleThreadPriorityAsyncExecutor::Stop() noexcept {
 
 ExecutionResult SingleThreadPriorityAsyncExecutor::ScheduleFor(
     const AsyncOperation& work, Timestamp timestamp) noexcept {
-  function<bool()> cancellation_callback = []() { return false; };
-  return ScheduleFor(work, timestamp, cancellation_callback);
+  return ScheduleTask(task_pool_.MakeShared(work, timestamp));
+};
+
+ExecutionResult SingleThreadPriorityAsyncExecutor::ScheduleFor(
+    AsyncOperation&& work, Timestamp timestamp) noexcept {
+  return ScheduleTask(task_pool_.MakeShared(move(work), timestamp));
 };
 
 ExecutionResult SingleThreadPriorityAsyncExecutor::ScheduleFor(
     const AsyncOperation& work, Timestamp timestamp,
     function<bool()>& cancellation_callback) noexcept {
+  return ScheduleTask(task_pool_.MakeShared(work, timestamp),
+                      &cancellation_callback);
+};
+
+ExecutionResult SingleThreadPriorityAsyncExecutor::ScheduleTask(
+    const shared_ptr<AsyncTask>& task,
+    function<bool()>* cancellation_callback) noexcept {
   if (!is_running_) {
     return FailureExecutionResult(errors::SC_ASYNC_EXECUTOR_NOT_RUNNING);
   }
 
   unique_lock<mutex> thread_lock(mutex_);
 
-  if (queue_->size() >= queue_cap_) {
-    return RetryExecutionResult(errors::SC_ASYNC_EXECUTOR_EXCEEDING_QUEUE_CAP);
+  auto timestamp = task->GetExecutionTimestamp();
+  if (timer_wheel_) {
+    if (timer_wheel_->Size() >= queue_cap_) {
+      telemetry_.RecordRejected();
+      return RetryExecutionResult(
+          errors::SC_ASYNC_EXECUTOR_EXCEEDING_QUEUE_CAP);
+    }
+
+    auto timer = timer_wheel_->Arm(task);
+    if (cancellation_callback) {
+      // The wheel is not kept alive by the callback, it can outlive the
+      // executor.
+      *cancellation_callback = [task, timer,
+                                weak_timer_wheel = weak_ptr<TimerWheel>(
+                                    timer_wheel_)]() mutable {
+        if (!task->Cancel()) {
+          return false;
+        }
+        if (auto timer_wheel = weak_timer_wheel.lock()) {
+          timer_wheel->Cancel(timer);
+        }
+        return true;
+      };
+    }
+  } else {
+    if (queue_->size() >= queue_cap_) {
+      telemetry_.RecordRejected();
+      return RetryExecutionResult(
+          errors::SC_ASYNC_EXECUTOR_EXCEEDING_QUEUE_CAP);
+    }
+
+    queue_->push(task);
+    if (cancellation_callback) {
+      *cancellation_callback = [task]() mutable { return task->Cancel(); };
+    }
   }
 
-  auto task = make_shared<AsyncTask>(work, timestamp);
-  cancellation_callback = [task]() mutable { return task->Cancel(); };
-  queue_->push(task);
+  SignalWorker(thread_lock, timestamp);
+  return SuccessExecutionResult();
+};
 
-  if (timestamp < next_scheduled_task_timestamp_.load()) {
+ExecutionResult SingleThreadPriorityAsyncExecutor::ScheduleForBatch(
+    vector<AsyncOperation>::iterator begin,
+    vector<AsyncOperation>::iterator end, Timestamp timestamp,
+    size_t& scheduled_count) noexcept {
+  scheduled_count = 0;
+  if (!is_running_) {
+    return FailureExecutionResult(errors::SC_ASYNC_EXECUTOR_NOT_RUNNING);
+  }
+
+  unique_lock<mutex> thread_lock(mutex_);
+
+  ExecutionResult execution_result = SuccessExecutionResult();
+  for (auto it = begin; it != end; ++it) {
+    auto size = timer_wheel_ ? timer_wheel_->Size() : queue_->size();
+    if (size >= queue_cap_) {
+      telemetry_.RecordRejected(end - it);
+      execution_result =
+          RetryExecutionResult(errors::SC_ASYNC_EXECUTOR_EXCEEDING_QUEUE_CAP);
+      break;
+    }
+
+    auto task = task_pool_.MakeShared(move(*it), timestamp);
+    if (timer_wheel_) {
+      timer_wheel_->Arm(task);
+    } else {
+      queue_->push(task);
+    }
+    scheduled_count++;
+  }
+
+  if (scheduled_count == 0) {
+    return execution_result;
+  }
+
+  SignalWorker(thread_lock, timestamp);
+  return execution_result;
+}
+
+void SingleThreadPriorityAsyncExecutor::SignalWorker(
+    unique_lock<mutex>& thread_lock, Timestamp timestamp) noexcept {
+  bool is_earliest = timestamp < next_scheduled_task_timestamp_.load();
+  if (is_earliest) {
     next_scheduled_task_timestamp_ = timestamp;
     update_wait_time_ = true;
   }
 
-  condition_variable_.notify_one();
-  return SuccessExecutionResult();
-};
+  if (!wake_up_host_) {
+    condition_variable_.notify_one();
+    return;
+  }
+
+  // The host only needs to recompute its wait time when the task is due
+  // earlier than the ones it knows of. It is woken up without holding the lock
+  // since the host executes the tasks while holding its own.
+  thread_lock.unlock();
+  if (is_earliest) {
+    wake_up_host_();
+  }
+}
+
+TaskExecutorTelemetrySnapshot
+SingleThreadPriorityAsyncExecutor::GetTelemetrySnapshot() noexcept {
+  uint64_t queue_depth = 0;
+  if (timer_wheel_) {
+    queue_depth = timer_wheel_->Size();
+  } else if (queue_) {
+    unique_lock<mutex> thread_lock(mutex_);
+    queue_depth = queue_->size();
+  }
+  return telemetry_.GetSnapshot(queue_depth);
+}
 
 ExecutionResultOr<thread::id> SingleThreadPriorityAsyncExecutor::GetThreadId()
     const {
@@ -16,6 +16,7 @@
 
 #include <atomic>
 #include <condition_variable>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <optional>
@@ -25,8 +26,26 @@
 #include "core/interface/async_executor_interface.h"
 
 #include "async_task.h"
+#include "executor_telemetry.h"
+#include "shared_object_pool.h"
+#include "timer_wheel.h"
 
 namespace google::scp::core {
+/// The data structure keeping the scheduled tasks of an urgent executor.
+enum class TimerQueueType {
+  /**
+   * @brief A binary heap ordered by execution timestamp. Insertion is
+   * O(log n) and cancelled tasks stay in the heap until they reach the top.
+   */
+  BinaryHeap = 0,
+  /**
+   * @brief A hierarchical timing wheel. Arm and cancel are O(1) and cancelled
+   * tasks are removed right away. Tasks run at the resolution of the wheel,
+   * see kTimerWheelTickDurationNs.
+   */
+  HierarchicalTimerWheel = 1,
+};
+
 /**
  * @brief A single threaded priority async executor. This executor will have one
  * thread working with one priority queue.
@@ -35,7 +54,9 @@ class SingleThreadPriorityAsyncExecutor : ServiceInterface {
  public:
   explicit SingleThreadPriorityAsyncExecutor(
       size_t queue_cap, bool drop_tasks_on_stop = false,
-      std::optional<size_t> affinity_cpu_number = std::nullopt)
+      std::optional<size_t> affinity_cpu_number = std::nullopt,
+      TimerQueueType timer_queue_type = TimerQueueType::BinaryHeap,
+      size_t telemetry_sample_interval = 0)
       : is_running_(false),
         worker_thread_started_(false),
         worker_thread_stopped_(false),
@@ -43,7 +64,10 @@ class SingleThreadPriorityAsyncExecutor : ServiceInterface {
         next_scheduled_task_timestamp_(UINT64_MAX),
         queue_cap_(queue_cap),
         drop_tasks_on_stop_(drop_tasks_on_stop),
-        affinity_cpu_number_(affinity_cpu_number) {}
+        affinity_cpu_number_(affinity_cpu_number),
+        timer_queue_type_(timer_queue_type),
+        telemetry_(telemetry_sample_interval),
+        task_pool_(queue_cap) {}
 
   ExecutionResult Init() noexcept override;
 
@@ -62,6 +86,13 @@ class SingleThreadPriorityAsyncExecutor : ServiceInterface {
   ExecutionResult ScheduleFor(const AsyncOperation& work,
                               Timestamp timestamp) noexcept;
 
+  /**
+   * @brief Same as above but takes ownership of the work to avoid copying the
+   * captured state of the operation.
+   */
+  ExecutionResult ScheduleFor(AsyncOperation&& work,
+                              Timestamp timestamp) noexcept;
+
   /**
    * @brief Schedules a task to be executed at a certain time.
    *
@@ -75,16 +106,90 @@ class SingleThreadPriorityAsyncExecutor : ServiceInterface {
       const AsyncOperation& work, Timestamp timestamp,
       std::function<bool()>& cancellation_callback) noexcept;
 
+  /**
+   * @brief Schedules the operations in [begin, end) to be executed at a certain
+   * time. The queue is locked and the worker thread is signaled once for the
+   * whole batch.
+   *
+   * @param begin the first operation to be scheduled.
+   * @param end the end of the operations to be scheduled.
+   * @param timestamp The timestamp to the tasks to be executed.
+   * @param scheduled_count the number of operations that were scheduled. The
+   * scheduled operations are moved from, and the rest are left untouched.
+   * @return ExecutionResult result of the execution with possible error code.
+   */
+  ExecutionResult ScheduleForBatch(std::vector<AsyncOperation>::iterator begin,
+                                   std::vector<AsyncOperation>::iterator end,
+                                   Timestamp timestamp,
+                                   size_t& scheduled_count) noexcept;
+
+  /**
+   * @brief Makes the executor run its tasks on the thread of a host instead of
+   * spawning a thread of its own. Must be called before Run(). The host calls
+   * RunDueTasks whenever GetNextTaskTimestamp has passed, and keeps doing so
+   * after Stop() until no tasks are left.
+   *
+   * @param wake_up_host called when a task is scheduled earlier than the next
+   * task timestamp, and when the executor is stopped.
+   */
+  void SetHost(std::function<void()> wake_up_host) noexcept;
+
+  /// Executes the due tasks on the calling host thread.
+  void RunDueTasks() noexcept;
+
+  /**
+   * @brief Returns the timestamp at which RunDueTasks next needs to be called,
+   * or UINT64_MAX if no tasks are scheduled.
+   */
+  Timestamp GetNextTaskTimestamp() const noexcept;
+
   /**
    * @brief Returns the ID of the spawned thread object to enable looking it up
-   * via thread IDs later. Will only be populated after Run() is called.
+   * via thread IDs later. Will only be populated after Run() is called, and
+   * never for an executor with a host.
    */
   ExecutionResultOr<std::thread::id> GetThreadId() const;
 
+  /// Returns a copy of the telemetry of the executor.
+  TaskExecutorTelemetrySnapshot GetTelemetrySnapshot() noexcept;
+
  private:
   /// Starts the internal worker thread.
   void StartWorker() noexcept;
 
+  /**
+   * @brief Executes the due tasks, releasing the lock while each task runs.
+   *
+   * @param thread_lock the lock held on the mutex.
+   * @return Timestamp the timestamp of the next event, or UINT64_MAX if no
+   * tasks are scheduled.
+   */
+  Timestamp ExecuteDueTasks(std::unique_lock<std::mutex>& thread_lock) noexcept;
+
+  /**
+   * @brief Signals the worker, or the host, that a task was scheduled. Might
+   * release the lock.
+   *
+   * @param thread_lock the lock held on the mutex.
+   * @param timestamp the execution timestamp of the scheduled task.
+   */
+  void SignalWorker(std::unique_lock<std::mutex>& thread_lock,
+                    Timestamp timestamp) noexcept;
+
+  /// Executes the task on the worker thread and records its telemetry.
+  void ExecuteTask(AsyncTask& task) noexcept;
+
+  /**
+   * @brief Pushes the task into the queue and signals the worker if needed.
+   *
+   * @param task the task to be scheduled.
+   * @param cancellation_callback if not null, set to a callback that cancels
+   * the task once it is scheduled.
+   */
+  ExecutionResult ScheduleTask(
+      const std::shared_ptr<AsyncTask>& task,
+      std::function<bool()>* cancellation_callback = nullptr) noexcept;
+
   /**
    * @brief While it is true, the running thread will keep listening and
    * picking out work from work queue. While it is false, the thread will try to
@@ -112,11 +217,18 @@ class SingleThreadPriorityAsyncExecutor : ServiceInterface {
   std::unique_ptr<std::thread> working_thread_;
   /// The ID of the working_thread_.
   std::thread::id working_thread_id_;
-  /// Queue for accepting the incoming tasks.
+  /// The data structure to keep the scheduled tasks in.
+  TimerQueueType timer_queue_type_;
+  /// Queue for accepting the incoming tasks, for TimerQueueType::BinaryHeap.
   std::shared_ptr<std::priority_queue<std::shared_ptr<AsyncTask>,
                                       std::vector<std::shared_ptr<AsyncTask>>,
                                       AsyncTaskCompareGreater>>
       queue_;
+  /**
+   * @brief Wheel for accepting the incoming tasks, for
+   * TimerQueueType::HierarchicalTimerWheel.
+   */
+  std::shared_ptr<TimerWheel> timer_wheel_;
   /**
    * @brief Used in combination with the condition variable for signaling the
    * thread that an element is pushed to the queue.
@@ -127,5 +239,11 @@ class SingleThreadPriorityAsyncExecutor : ServiceInterface {
    * element is pushed to the queue.
    */
   std::condition_variable condition_variable_;
+  /// The telemetry of the executor, recorded by the worker thread.
+  TaskExecutorTelemetry telemetry_;
+  /// Wakes up the host executing the tasks, if the executor has one.
+  std::function<void()> wake_up_host_;
+  /// Reuses the memory of the executed tasks for the tasks scheduled next.
+  SharedObjectPool<AsyncTask> task_pool_;
 };
 }  // namespace google::scp::core
@@ -0,0 +1,97 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <memory>
+#include <utility>
+
+#include "core/common/concurrent_queue/src/concurrent_queue.h"
+#include "core/common/concurrent_queue/src/mpsc_queue.h"
+#include "public/core/interface/execution_result.h"
+
+#include "async_task.h"
+
+namespace google::scp::core {
+/// The queue the normal and high priority tasks of an executor are kept in.
+enum class TaskQueueBackend {
+  /// A ConcurrentQueue, which any thread can dequeue from.
+  ConcurrentQueue = 0,
+  /**
+   * @brief A lock-free MpscQueue, which only the worker thread of the executor
+   * dequeues from. Its slots are allocated upfront, so the queue cap is
+   * limited to kMaxMpscQueueCap, and the tasks cannot be stolen by work
+   * stealing peers.
+   */
+  MpscQueue = 1,
+};
+
+/**
+ * @brief A bounded queue of tasks backed by either of the queues of
+ * TaskQueueBackend. Both backends reject a task once max_size tasks are queued.
+ */
+class TaskQueue {
+ public:
+  /**
+   * @brief Construct a new Task Queue object
+   * @param max_size Maximum size of the queue
+   * @param backend the queue implementation to use
+   */
+  TaskQueue(size_t max_size, TaskQueueBackend backend) {
+    if (backend == TaskQueueBackend::MpscQueue) {
+      mpsc_queue_ = std::make_unique<common::MpscQueue<AsyncTask>>(max_size);
+    } else {
+      concurrent_queue_ =
+          std::make_unique<common::ConcurrentQueue<AsyncTask>>(max_size);
+    }
+  }
+
+  /// Enqueues the task, see ConcurrentQueue::TryEnqueue.
+  ExecutionResult TryEnqueue(AsyncTask&& task) noexcept {
+    return mpsc_queue_ ? mpsc_queue_->TryEnqueue(std::move(task))
+                       : concurrent_queue_->TryEnqueue(std::move(task));
+  }
+
+  /// Constructs a task in place, see ConcurrentQueue::TryEmplace.
+  template <class... Args>
+  ExecutionResult TryEmplace(Args&&... args) noexcept {
+    return mpsc_queue_
+               ? mpsc_queue_->TryEmplace(std::forward<Args>(args)...)
+               : concurrent_queue_->TryEmplace(std::forward<Args>(args)...);
+  }
+
+  /**
+   * @brief Dequeues a task, see ConcurrentQueue::TryDequeue. Must only be
+   * called by the consumer thread if IsSingleConsumer.
+   */
+  ExecutionResult TryDequeue(AsyncTask& task) noexcept {
+    return mpsc_queue_ ? mpsc_queue_->TryDequeue(task)
+                       : concurrent_queue_->TryDequeue(task);
+  }
+
+  /// Returns the approximate number of queued tasks.
+  size_t Size() noexcept {
+    return mpsc_queue_ ? mpsc_queue_->Size() : concurrent_queue_->Size();
+  }
+
+  /// Returns true if only one thread may dequeue from the queue.
+  bool IsSingleConsumer() const noexcept { return mpsc_queue_ != nullptr; }
+
+ private:
+  /// The queue for TaskQueueBackend::ConcurrentQueue.
+  std::unique_ptr<common::ConcurrentQueue<AsyncTask>> concurrent_queue_;
+  /// The queue for TaskQueueBackend::MpscQueue.
+  std::unique_ptr<common::MpscQueue<AsyncTask>> mpsc_queue_;
+};
+}  // namespace google::scp::core
@@ -0,0 +1,271 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "timer_wheel.h"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using std::min;
+using std::mutex;
+using std::shared_ptr;
+using std::unique_lock;
+using std::vector;
+using std::chrono::nanoseconds;
+
+namespace google::scp::core {
+TimerWheel::TimerWheel(nanoseconds tick_duration, Timestamp start_timestamp,
+                       size_t max_free_timer_count)
+    : tick_duration_ns_(std::max<uint64_t>(tick_duration.count(), 1)),
+      current_tick_(start_timestamp / tick_duration_ns_),
+      size_(0),
+      slots_(),
+      occupancy_(),
+      timer_pool_(max_free_timer_count) {}
+
+TimerWheel::~TimerWheel() {
+  Clear();
+}
+
+shared_ptr<TimerWheel::Timer> TimerWheel::Arm(
+    const shared_ptr<AsyncTask>& task) noexcept {
+  auto timer = timer_pool_.MakeShared();
+  timer->task = task;
+  // Rounds up so that the timer never expires before the task is due.
+  auto execution_timestamp = task->GetExecutionTimestamp();
+  timer->expiration_tick = execution_timestamp / tick_duration_ns_ +
+                           (execution_timestamp % tick_duration_ns_ != 0);
+  timer->self = timer;
+
+  unique_lock<mutex> lock(mutex_);
+  Insert(timer.get());
+  size_++;
+  return timer;
+}
+
+bool TimerWheel::Cancel(const shared_ptr<Timer>& timer) noexcept {
+  unique_lock<mutex> lock(mutex_);
+  if (!timer->self) {
+    return false;
+  }
+  Unlink(timer.get());
+  size_--;
+  timer->self.reset();
+  return true;
+}
+
+void TimerWheel::PopExpired(
+    Timestamp current_timestamp,
+    vector<shared_ptr<AsyncTask>>& expired_tasks) noexcept {
+  unique_lock<mutex> lock(mutex_);
+  Advance(current_timestamp / tick_duration_ns_);
+
+  auto* timer = expired_.head;
+  expired_ = Slot();
+  while (timer != nullptr) {
+    auto* next = timer->next;
+    expired_tasks.push_back(std::move(timer->task));
+    size_--;
+    timer->self.reset();
+    timer = next;
+  }
+}
+
+Timestamp TimerWheel::GetNextEventTimestamp() noexcept {
+  unique_lock<mutex> lock(mutex_);
+  if (expired_.head != nullptr) {
+    return current_tick_ * tick_duration_ns_;
+  }
+  auto next_tick = GetNextEventTick();
+  if (next_tick == UINT64_MAX) {
+    return UINT64_MAX;
+  }
+  return next_tick * tick_duration_ns_;
+}
+
+size_t TimerWheel::Size() noexcept {
+  unique_lock<mutex> lock(mutex_);
+  return size_;
+}
+
+void TimerWheel::Clear() noexcept {
+  unique_lock<mutex> lock(mutex_);
+  for (size_t level = 0; level <= kExpiredLevel; ++level) {
+    auto slot_count = level == kExpiredLevel ? 1 : kSlotCount;
+    for (size_t slot = 0; slot < slot_count; ++slot) {
+      auto* timer = DetachSlot(level, slot);
+      while (timer != nullptr) {
+        auto* next = timer->next;
+        timer->self.reset();
+        timer = next;
+      }
+    }
+  }
+  size_ = 0;
+}
+
+void TimerWheel::Insert(Timer* timer) noexcept {
+  if (timer->expiration_tick <= current_tick_) {
+    Link(timer, kExpiredLevel, 0);
+    return;
+  }
+
+  // The level is picked so that the slot cascades before the timer expires,
+  // i.e. kSlotCount^level <= delta < kSlotCount^(level + 1). Timers beyond the
+  // range of the wheel are kept at the top level and re-inserted every time
+  // their slot cascades.
+  auto delta = timer->expiration_tick - current_tick_;
+  size_t level = (63 - __builtin_clzll(delta)) / kSlotBits;
+  level = min(level, kLevelCount - 1);
+  auto slot =
+      (timer->expiration_tick >> (level * kSlotBits)) & (kSlotCount - 1);
+  Link(timer, level, slot);
+}
+
+void TimerWheel::Link(Timer* timer, size_t level, size_t slot) noexcept {
+  auto& list = GetSlot(level, slot);
+  timer->level = level;
+  timer->slot = slot;
+  timer->next = nullptr;
+  timer->previous = list.tail;
+  if (list.tail != nullptr) {
+    list.tail->next = timer;
+  } else {
+    list.head = timer;
+  }
+  list.tail = timer;
+
+  if (level != kExpiredLevel) {
+    occupancy_[level][slot / 64] |= (1ULL << (slot % 64));
+  }
+}
+
+void TimerWheel::Unlink(Timer* timer) noexcept {
+  auto& list = GetSlot(timer->level, timer->slot);
+  if (timer->previous != nullptr) {
+    timer->previous->next = timer->next;
+  } else {
+    list.head = timer->next;
+  }
+  if (timer->next != nullptr) {
+    timer->next->previous = timer->previous;
+  } else {
+    list.tail = timer->previous;
+  }
+  timer->previous = nullptr;
+  timer->next = nullptr;
+
+  if (list.head == nullptr && timer->level != kExpiredLevel) {
+    occupancy_[timer->level][timer->slot / 64] &= ~(1ULL << (timer->slot % 64));
+  }
+}
+
+TimerWheel::Timer* TimerWheel::DetachSlot(size_t level, size_t slot) noexcept {
+  auto& list = GetSlot(level, slot);
+  auto* head = list.head;
+  list = Slot();
+  if (level != kExpiredLevel) {
+    occupancy_[level][slot / 64] &= ~(1ULL << (slot % 64));
+  }
+  return head;
+}
+
+void TimerWheel::Advance(uint64_t tick) noexcept {
+  while (current_tick_ < tick) {
+    // Jumps over the ticks where nothing happens.
+    auto next_tick = GetNextEventTick();
+    if (next_tick > tick) {
+      current_tick_ = tick;
+      return;
+    }
+    current_tick_ = next_tick;
+
+    // Cascades from the highest level first, so that the timers cascaded at
+    // this tick can be cascaded again by the lower levels at the same tick.
+    for (size_t level = kLevelCount - 1; level > 0; --level) {
+      auto level_shift = level * kSlotBits;
+      if ((current_tick_ & ((1ULL << level_shift) - 1)) != 0) {
+        continue;
+      }
+      auto slot = (current_tick_ >> level_shift) & (kSlotCount - 1);
+      auto* timer = DetachSlot(level, slot);
+      while (timer != nullptr) {
+        auto* next = timer->next;
+        Insert(timer);
+        timer = next;
+      }
+    }
+
+    auto* timer = DetachSlot(0, current_tick_ & (kSlotCount - 1));
+    while (timer != nullptr) {
+      auto* next = timer->next;
+      Link(timer, kExpiredLevel, 0);
+      timer = next;
+    }
+  }
+}
+
+uint64_t TimerWheel::GetNextEventTick() noexcept {
+  auto next_tick = UINT64_MAX;
+
+  // The timers at level 0 expire within the next kSlotCount ticks.
+  auto distance =
+      FindOccupiedSlotDistance(0, (current_tick_ + 1) % kSlotCount);
+  if (distance < kSlotCount) {
+    next_tick = current_tick_ + 1 + distance;
+  }
+
+  // The slots of the higher levels cascade at the boundaries of their span.
+  for (size_t level = 1; level < kLevelCount; ++level) {
+    auto level_shift = level * kSlotBits;
+    auto next_boundary_tick = ((current_tick_ >> level_shift) + 1)
+                              << level_shift;
+    auto next_boundary_slot =
+        (next_boundary_tick >> level_shift) & (kSlotCount - 1);
+    distance = FindOccupiedSlotDistance(level, next_boundary_slot);
+    if (distance < kSlotCount) {
+      next_tick =
+          min(next_tick, next_boundary_tick + (distance << level_shift));
+    }
+  }
+  return next_tick;
+}
+
+size_t TimerWheel::FindOccupiedSlotDistance(size_t level,
+                                            size_t from_slot) noexcept {
+  auto slot = from_slot;
+  size_t scanned = 0;
+  while (scanned < kSlotCount) {
+    auto bit = slot % 64;
+    auto bits = occupancy_[level][slot / 64] >> bit;
+    if (bits != 0) {
+      // Set bits at or after from_slot would have been found in the first
+      // word, so the distance is always less than kSlotCount.
+      return scanned + __builtin_ctzll(bits);
+    }
+    scanned += 64 - bit;
+    slot = (slot + 64 - bit) % kSlotCount;
+  }
+  return kSlotCount;
+}
+
+TimerWheel::Slot& TimerWheel::GetSlot(size_t level, size_t slot) noexcept {
+  if (level == kExpiredLevel) {
+    return expired_;
+  }
+  return slots_[level][slot];
+}
+}  // namespace google::scp::core
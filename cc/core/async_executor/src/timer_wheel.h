@@ -0,0 +1,189 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "core/interface/type_def.h"
+
+#include "async_task.h"
+#include "shared_object_pool.h"
+
+namespace google::scp::core {
+/**
+ * @brief A hierarchical timing wheel holding tasks scheduled for the future.
+ * Arming and cancelling a timer are O(1), and a cancelled timer is removed
+ * from the wheel right away.
+ *
+ * The wheel has kLevelCount levels of kSlotCount slots. A slot of level L
+ * spans kSlotCount^L ticks. As the time advances, the timers of a higher level
+ * slot are cascaded down to the lower levels until they expire. Expiration
+ * times are rounded up to the tick duration, so a timer never fires early but
+ * can fire up to one tick late.
+ *
+ * All the functions are thread-safe.
+ */
+class TimerWheel {
+ public:
+  /// An armed timer. Can be used to cancel the timer.
+  class Timer {
+   private:
+    friend class TimerWheel;
+
+    /// The task to be returned when the timer expires.
+    std::shared_ptr<AsyncTask> task;
+    /// The tick at which the timer expires.
+    uint64_t expiration_tick = 0;
+    /// The level of the slot the timer is linked to.
+    size_t level = 0;
+    /// The index of the slot the timer is linked to.
+    size_t slot = 0;
+    /// The previous timer in the slot.
+    Timer* previous = nullptr;
+    /// The next timer in the slot.
+    Timer* next = nullptr;
+    /// Keeps the timer alive while it is linked to a slot of the wheel.
+    std::shared_ptr<Timer> self;
+  };
+
+  /**
+   * @brief Construct a new Timer Wheel object.
+   *
+   * @param tick_duration the resolution of the wheel.
+   * @param start_timestamp the current time in nanoseconds, as clock ticks.
+   * @param max_free_timer_count the maximum number of released timers whose
+   * memory is kept for the timers armed next.
+   */
+  TimerWheel(std::chrono::nanoseconds tick_duration, Timestamp start_timestamp,
+             size_t max_free_timer_count = kDefaultMaxFreeTimerCount);
+
+  ~TimerWheel();
+
+  TimerWheel(const TimerWheel&) = delete;
+  TimerWheel& operator=(const TimerWheel&) = delete;
+
+  /**
+   * @brief Arms a timer that expires at the execution timestamp of the task.
+   *
+   * @param task the task to be returned once the timer expires.
+   * @return std::shared_ptr<Timer> the armed timer.
+   */
+  std::shared_ptr<Timer> Arm(const std::shared_ptr<AsyncTask>& task) noexcept;
+
+  /**
+   * @brief Removes the timer from the wheel.
+   *
+   * @param timer the timer to be removed.
+   * @return true if the timer was armed and is now removed.
+   */
+  bool Cancel(const std::shared_ptr<Timer>& timer) noexcept;
+
+  /**
+   * @brief Advances the wheel to the current timestamp and returns the tasks
+   * of all the expired timers, in the order of expiration.
+   *
+   * @param current_timestamp the current time in nanoseconds, as clock ticks.
+   * @param expired_tasks the vector to append the expired tasks to.
+   */
+  void PopExpired(
+      Timestamp current_timestamp,
+      std::vector<std::shared_ptr<AsyncTask>>& expired_tasks) noexcept;
+
+  /**
+   * @brief Returns the timestamp at which the wheel needs to be advanced next.
+   * This is either the expiration of the earliest timer or the time at which
+   * timers are cascaded down to the lower levels. UINT64_MAX if the wheel is
+   * empty.
+   */
+  Timestamp GetNextEventTimestamp() noexcept;
+
+  /// Returns the number of armed timers, including the expired ones which are
+  /// not popped yet.
+  size_t Size() noexcept;
+
+  /// Removes all the timers.
+  void Clear() noexcept;
+
+ private:
+  /// The default maximum number of released timers kept for reuse.
+  static constexpr size_t kDefaultMaxFreeTimerCount = 1024;
+  /// Number of bits of a tick that index the slots of one level.
+  static constexpr size_t kSlotBits = 8;
+  /// Number of slots per level.
+  static constexpr size_t kSlotCount = 1 << kSlotBits;
+  /// Number of levels of the wheel.
+  static constexpr size_t kLevelCount = 4;
+  /// The pseudo level of the timers that expired but are not popped yet.
+  static constexpr size_t kExpiredLevel = kLevelCount;
+  /// Number of words in the slot occupancy bitmap of a level.
+  static constexpr size_t kOccupancyWordCount = kSlotCount / 64;
+
+  /// A doubly linked list of timers.
+  struct Slot {
+    Timer* head = nullptr;
+    Timer* tail = nullptr;
+  };
+
+  /// Links the timer to the slot matching its expiration tick.
+  void Insert(Timer* timer) noexcept;
+
+  /// Appends the timer to the slot.
+  void Link(Timer* timer, size_t level, size_t slot) noexcept;
+
+  /// Removes the timer from its slot. The timer is kept alive by the caller.
+  void Unlink(Timer* timer) noexcept;
+
+  /// Detaches and returns all the timers of the slot.
+  Timer* DetachSlot(size_t level, size_t slot) noexcept;
+
+  /// Advances the current tick up to the given tick.
+  void Advance(uint64_t tick) noexcept;
+
+  /// Returns the next tick after the current tick at which a timer expires or
+  /// a slot needs to be cascaded. UINT64_MAX if there is none.
+  uint64_t GetNextEventTick() noexcept;
+
+  /**
+   * @brief Returns the distance from the given slot to the first occupied slot
+   * at the level, wrapping around. kSlotCount if the level is empty.
+   */
+  size_t FindOccupiedSlotDistance(size_t level, size_t from_slot) noexcept;
+
+  /// Returns the slot at the level, including the expired pseudo level.
+  Slot& GetSlot(size_t level, size_t slot) noexcept;
+
+  /// The duration of a tick in nanoseconds.
+  const uint64_t tick_duration_ns_;
+  /// The last tick that the wheel advanced to.
+  uint64_t current_tick_;
+  /// The number of timers linked to the wheel.
+  size_t size_;
+  /// The slots of every level.
+  std::array<std::array<Slot, kSlotCount>, kLevelCount> slots_;
+  /// Bitmaps of the non-empty slots of every level.
+  std::array<std::array<uint64_t, kOccupancyWordCount>, kLevelCount>
+      occupancy_;
+  /// The timers that expired but are not popped yet.
+  Slot expired_;
+  /// Guards the state of the wheel.
+  std::mutex mutex_;
+  /// Reuses the memory of the released timers for the timers armed next.
+  SharedObjectPool<Timer> timer_pool_;
+};
+}  // namespace google::scp::core
@@ -24,10 +24,46 @@ namespace google::scp::core {
 static constexpr size_t kMaxThreadCount = 10000;
 /// The maximum queue cap could be set.
 static const size_t kMaxQueueCap = UINT_MAX;
+/// The maximum queue cap with TaskQueueBackend::MpscQueue, which allocates the
+/// slots of its queues upfront.
+static constexpr size_t kMaxMpscQueueCap = 1 << 20;
 /// The sleep interval for shutting down threads in miliseconds.
 static const size_t kSleepDurationMs = 10;
 /// Indicates an infinite wait time.
 static constexpr std::chrono::nanoseconds kInfiniteWaitDurationNs =
     std::chrono::duration_cast<std::chrono::nanoseconds>(
         std::chrono::hours(87600));  // 10 years
+/// The tick duration of the timer wheels of the urgent executors.
+static constexpr std::chrono::nanoseconds kTimerWheelTickDurationNs =
+    std::chrono::milliseconds(1);
+/// The duration an idle worker spins for before parking, for the executors
+/// with WorkerIdleStrategy::SpinThenPark.
+static constexpr std::chrono::nanoseconds kWorkerIdleSpinDurationNs =
+    std::chrono::microseconds(50);
+/// The number of spin iterations after which an idle spinning worker yields
+/// its time slice, in case the thread that would schedule work needs it.
+static constexpr size_t kWorkerIdleSpinYieldInterval = 64;
+/// The number of tasks with a deadline an executor runs in a row before it runs
+/// a task of the same priority without a deadline, if there is one.
+static constexpr size_t kMaxConsecutiveDeadlineTasks = 4;
+/// How often an elastic AsyncExecutor checks the load of its executors.
+static constexpr std::chrono::nanoseconds kElasticControlIntervalNs =
+    std::chrono::milliseconds(10);
+/// The queued tasks per running executor above which an elastic AsyncExecutor
+/// adds executors.
+static constexpr size_t kElasticBacklogPerThreadThreshold = 16;
+/// The largest telemetry sample interval of the normal executors of an elastic
+/// AsyncExecutor, which need the queue wait times to follow the load.
+static constexpr size_t kElasticTelemetrySampleInterval = 8;
+/// The mean queue wait time above which an elastic AsyncExecutor adds
+/// executors.
+static constexpr std::chrono::nanoseconds kElasticQueueWaitTimeThresholdNs =
+    std::chrono::milliseconds(5);
+/// How long the executors of an elastic AsyncExecutor must have had no backlog
+/// before one of them is retired.
+static constexpr std::chrono::nanoseconds kElasticIdleCoolDownNs =
+    std::chrono::seconds(5);
+/// The number of executors a task is offered to when a racing retirement makes
+/// the picked elastic executor reject it.
+static constexpr size_t kElasticScheduleAttempts = 3;
 }  // namespace google::scp::core
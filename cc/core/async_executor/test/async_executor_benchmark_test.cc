@@ -27,6 +27,9 @@ using std::shared_ptr;
 namespace google::scp::core::test {
 
 static constexpr size_t kDepth = 10;
+/// Slow tasks block their thread without using the CPU, so the skewed
+/// benchmarks use a fixed pool size independent of the number of cores.
+static constexpr size_t kSkewedBenchmarkThreadCount = 8;
 
 static std::mutex global_hashes_mutex;
 static std::vector<size_t> global_hashes;
@@ -107,6 +110,118 @@ static void BM_TaskAssignmentGlobalRandom(benchmark::State& state) {
         executor_random, state.range(0), state.range(1), kDepth);
   }
 }
+
+static void BM_TaskAssignmentWorkStealing(benchmark::State& state) {
+  for (auto _ : state) {
+    auto executor_work_stealing = make_shared<AsyncExecutor>(
+        std::thread::hardware_concurrency(), 100000,
+        /*drop_tasks=*/false, TaskLoadBalancingScheme::WorkStealing);
+    state.counters["TaskCount"] = BenchmarkWorkFunction(
+        executor_work_stealing, state.range(0), state.range(1), kDepth);
+  }
+}
+
+/**
+ * @brief Schedules num_tasks tasks of which every slow_task_interval-th task
+ * blocks its thread for slow_task_duration_ms, similar to a blocking cloud SDK
+ * call. Returns once all the tasks are executed.
+ */
+static size_t BenchmarkSkewedWorkFunction(
+    shared_ptr<AsyncExecutorInterface> async_executor, size_t num_tasks,
+    size_t slow_task_interval, size_t slow_task_duration_ms) {
+  EXPECT_SUCCESS(async_executor->Init());
+  EXPECT_SUCCESS(async_executor->Run());
+  std::atomic<size_t> task_completion_counter = 0;
+  for (size_t i = 0; i < num_tasks; i++) {
+    auto is_slow_task = (i % slow_task_interval) == 0;
+    EXPECT_SUCCESS(async_executor->Schedule(
+        [&task_completion_counter, is_slow_task, slow_task_duration_ms]() {
+          if (is_slow_task) {
+            std::this_thread::sleep_for(
+                std::chrono::milliseconds(slow_task_duration_ms));
+          }
+          task_completion_counter++;
+        },
+        AsyncPriority::Normal));
+  }
+  while (task_completion_counter < num_tasks) {}
+  EXPECT_SUCCESS(async_executor->Stop());
+  return task_completion_counter;
+}
+
+static void BenchmarkSkewedTaskAssignment(
+    benchmark::State& state, TaskLoadBalancingScheme load_balancing_scheme) {
+  for (auto _ : state) {
+    auto async_executor = make_shared<AsyncExecutor>(
+        kSkewedBenchmarkThreadCount, 100000,
+        /*drop_tasks=*/false, load_balancing_scheme);
+    state.counters["TaskCount"] = BenchmarkSkewedWorkFunction(
+        async_executor, state.range(0), state.range(1), state.range(2));
+  }
+}
+
+static void BM_SkewedTaskAssignmentGlobalRoundRobin(benchmark::State& state) {
+  BenchmarkSkewedTaskAssignment(state,
+                                TaskLoadBalancingScheme::RoundRobinGlobal);
+}
+
+static void BM_SkewedTaskAssignmentThreadRoundRobin(benchmark::State& state) {
+  BenchmarkSkewedTaskAssignment(state,
+                                TaskLoadBalancingScheme::RoundRobinPerThread);
+}
+
+static void BM_SkewedTaskAssignmentGlobalRandom(benchmark::State& state) {
+  BenchmarkSkewedTaskAssignment(state, TaskLoadBalancingScheme::Random);
+}
+
+static void BM_SkewedTaskAssignmentWorkStealing(benchmark::State& state) {
+  BenchmarkSkewedTaskAssignment(state, TaskLoadBalancingScheme::WorkStealing);
+}
+
+/**
+ * @brief Schedules batches of state.range(0) tasks with priority
+ * state.range(1) and waits for each batch to be executed. The schedule
+ * function is called with every batch.
+ */
+template <class ScheduleBatchFunction>
+static void BenchmarkBatchScheduling(
+    benchmark::State& state, ScheduleBatchFunction schedule_batch_function) {
+  auto async_executor =
+      make_shared<AsyncExecutor>(std::thread::hardware_concurrency(), 100000);
+  EXPECT_SUCCESS(async_executor->Init());
+  EXPECT_SUCCESS(async_executor->Run());
+  size_t batch_size = state.range(0);
+  auto priority = static_cast<AsyncPriority>(state.range(1));
+  std::atomic<size_t> task_completion_counter = 0;
+  for (auto _ : state) {
+    task_completion_counter = 0;
+    std::vector<AsyncOperation> works(batch_size, [&task_completion_counter]() {
+      task_completion_counter++;
+    });
+    schedule_batch_function(*async_executor, works, priority);
+    while (task_completion_counter < batch_size) {}
+  }
+  state.SetItemsProcessed(state.iterations() * batch_size);
+  EXPECT_SUCCESS(async_executor->Stop());
+}
+
+static void BM_SchedulePerTask(benchmark::State& state) {
+  BenchmarkBatchScheduling(state, [](AsyncExecutor& async_executor,
+                                     std::vector<AsyncOperation>& works,
+                                     AsyncPriority priority) {
+    for (auto& work : works) {
+      EXPECT_SUCCESS(async_executor.Schedule(std::move(work), priority));
+    }
+  });
+}
+
+static void BM_ScheduleBatch(benchmark::State& state) {
+  BenchmarkBatchScheduling(state, [](AsyncExecutor& async_executor,
+                                     std::vector<AsyncOperation>& works,
+                                     AsyncPriority priority) {
+    EXPECT_SUCCESS(async_executor.ScheduleBatch(works, priority));
+  });
+}
 }  // namespace google::scp::core::test
 
 // ArgPair<Task Size, Number of Tasks>
@@ -130,5 +245,46 @@ BENCHMARK(google::scp::core::test::BM_TaskAssignmentGlobalRandom)
     ->ArgPair(100, 10000)
     ->ArgPair(1000, 10000);
 
+// ArgPair<Task Size, Number of Tasks>
+BENCHMARK(google::scp::core::test::BM_TaskAssignmentWorkStealing)
+    ->ArgPair(1, 10000)
+    ->ArgPair(10, 10000)
+    ->ArgPair(100, 10000)
+    ->ArgPair(1000, 10000);
+
+// Args<Number of Tasks, Slow Task Interval, Slow Task Duration in ms>
+BENCHMARK(google::scp::core::test::BM_SkewedTaskAssignmentGlobalRoundRobin)
+    ->Args({10000, 100, 10})
+    ->Args({10000, 1000, 100})
+    ->Unit(benchmark::kMillisecond);
+
+// Args<Number of Tasks, Slow Task Interval, Slow Task Duration in ms>
+BENCHMARK(google::scp::core::test::BM_SkewedTaskAssignmentThreadRoundRobin)
+    ->Args({10000, 100, 10})
+    ->Args({10000, 1000, 100})
+    ->Unit(benchmark::kMillisecond);
+
+// Args<Number of Tasks, Slow Task Interval, Slow Task Duration in ms>
+BENCHMARK(google::scp::core::test::BM_SkewedTaskAssignmentGlobalRandom)
+    ->Args({10000, 100, 10})
+    ->Args({10000, 1000, 100})
+    ->Unit(benchmark::kMillisecond);
+
+// Args<Number of Tasks, Slow Task Interval, Slow Task Duration in ms>
+BENCHMARK(google::scp::core::test::BM_SkewedTaskAssignmentWorkStealing)
+    ->Args({10000, 100, 10})
+    ->Args({10000, 1000, 100})
+    ->Unit(benchmark::kMillisecond);
+
+// ArgPair<Batch Size, Priority>
+BENCHMARK(google::scp::core::test::BM_SchedulePerTask)
+    ->ArgPair(1000, static_cast<int>(google::scp::core::AsyncPriority::Normal))
+    ->ArgPair(1000, static_cast<int>(google::scp::core::AsyncPriority::Urgent));
+
+// ArgPair<Batch Size, Priority>
+BENCHMARK(google::scp::core::test::BM_ScheduleBatch)
+    ->ArgPair(1000, static_cast<int>(google::scp::core::AsyncPriority::Normal))
+    ->ArgPair(1000, static_cast<int>(google::scp::core::AsyncPriority::Urgent));
+
 // Run the benchmark
 BENCHMARK_MAIN();
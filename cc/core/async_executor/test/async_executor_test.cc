@@ -20,12 +20,15 @@
 #include <chrono>
 #include <functional>
 #include <mutex>
+#include <optional>
+#include <set>
 #include <string>
 #include <thread>
 
 #include "core/async_executor/mock/mock_async_executor_with_internals.h"
 #include "core/async_executor/src/error_codes.h"
 #include "core/async_executor/src/typedef.h"
+#include "core/common/time_provider/src/time_provider.h"
 #include "core/interface/async_context.h"
 #include "core/interface/async_executor_interface.h"
 #include "core/test/test_config.h"
@@ -34,6 +37,7 @@
 #include "public/core/test/interface/execution_result_matchers.h"
 
 using google::scp::core::async_executor::mock::MockAsyncExecutorWithInternals;
+using google::scp::core::common::TimeProvider;
 using std::atomic;
 using std::hash;
 using std::make_shared;
@@ -46,6 +50,8 @@ using std::unique_lock;
 using std::vector;
 using std::chrono::duration_cast;
 using std::chrono::high_resolution_clock;
+using std::chrono::hours;
+using std::chrono::milliseconds;
 using std::chrono::nanoseconds;
 using std::chrono::seconds;
 using std::this_thread::sleep_for;
@@ -331,6 +337,569 @@ TEST(AsyncExecutorTests, CountWorkMultipleThread) {
   EXPECT_EQ(count, queue_cap);
 }
 
+TEST(AsyncExecutorTests, CountMovedWork) {
+  int queue_cap = 10;
+  AsyncExecutor executor(2, queue_cap);
+  EXPECT_SUCCESS(executor.Init());
+  EXPECT_SUCCESS(executor.Run());
+  {
+    atomic<int> count(0);
+    for (auto priority :
+         {AsyncPriority::Normal, AsyncPriority::High, AsyncPriority::Urgent}) {
+      AsyncOperation work = [&]() { count++; };
+      EXPECT_SUCCESS(executor.Schedule(std::move(work), priority));
+      AsyncOperation affinitized_work = [&]() { count++; };
+      EXPECT_SUCCESS(executor.Schedule(
+          std::move(affinitized_work), priority,
+          AsyncExecutorAffinitySetting::AffinitizedToCallingAsyncExecutor));
+    }
+    WaitUntil([&]() { return count == 6; });
+    EXPECT_EQ(count, 6);
+  }
+  EXPECT_SUCCESS(executor.Stop());
+}
+
+TEST(AsyncExecutorTests, CannotScheduleBatchBeforeRun) {
+  AsyncExecutor executor(2, 10);
+  EXPECT_SUCCESS(executor.Init());
+
+  vector<AsyncOperation> works(3, []() {});
+  EXPECT_THAT(executor.ScheduleBatch(works, AsyncPriority::Normal),
+              ResultIs(FailureExecutionResult(
+                  errors::SC_ASYNC_EXECUTOR_NOT_RUNNING)));
+  EXPECT_THAT(executor.ScheduleForBatch(works, 0),
+              ResultIs(FailureExecutionResult(
+                  errors::SC_ASYNC_EXECUTOR_NOT_RUNNING)));
+  EXPECT_EQ(works.size(), 3);
+}
+
+TEST(AsyncExecutorTests, CountBatchWork) {
+  int queue_cap = 10;
+  size_t thread_count = 4;
+  AsyncExecutor executor(thread_count, queue_cap);
+  EXPECT_SUCCESS(executor.Init());
+  EXPECT_SUCCESS(executor.Run());
+  {
+    atomic<int> count(0);
+    // Batches that are both smaller and larger than the number of threads.
+    for (size_t batch_size : {thread_count - 1, 3 * thread_count + 1}) {
+      for (auto priority : {AsyncPriority::Normal, AsyncPriority::High,
+                            AsyncPriority::Urgent}) {
+        vector<AsyncOperation> works(batch_size, [&]() { count++; });
+        EXPECT_SUCCESS(executor.ScheduleBatch(works, priority));
+        EXPECT_TRUE(works.empty());
+      }
+      vector<AsyncOperation> works(batch_size, [&]() { count++; });
+      EXPECT_SUCCESS(executor.ScheduleForBatch(works, 1234));
+      EXPECT_TRUE(works.empty());
+    }
+    int expected_count = 4 * (thread_count - 1 + 3 * thread_count + 1);
+    WaitUntil([&]() { return count == expected_count; });
+    EXPECT_EQ(count, expected_count);
+  }
+  EXPECT_SUCCESS(executor.Stop());
+}
+
+TEST(AsyncExecutorTests, ExceedingQueueCapScheduleBatch) {
+  int queue_cap = 2;
+  AsyncExecutor executor(2, queue_cap, /*drop_tasks_on_stop=*/true);
+  EXPECT_SUCCESS(executor.Init());
+  EXPECT_SUCCESS(executor.Run());
+
+  // The tasks are scheduled far in the future so that the queues stay full.
+  Timestamp timestamp =
+      TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks() +
+      nanoseconds(hours(1)).count();
+  vector<size_t> executed_indices;
+  vector<AsyncOperation> works;
+  for (size_t i = 0; i < 6; i++) {
+    works.push_back(
+        [&executed_indices, i]() { executed_indices.push_back(i); });
+  }
+  EXPECT_THAT(executor.ScheduleForBatch(works, timestamp),
+              ResultIs(RetryExecutionResult(
+                  errors::SC_ASYNC_EXECUTOR_EXCEEDING_QUEUE_CAP)));
+
+  // The first executor got a chunk of three operations but only had room for
+  // two of them, so the batch stopped there.
+  ASSERT_EQ(works.size(), 4);
+  for (auto& work : works) {
+    work();
+  }
+  EXPECT_EQ(executed_indices, vector<size_t>({2, 3, 4, 5}));
+
+  EXPECT_SUCCESS(executor.Stop());
+}
+
+TEST(AsyncExecutorTests, TelemetrySnapshot) {
+  constexpr int queue_cap = 10;
+  AsyncExecutor executor({.thread_count = 2,
+                          .queue_cap = queue_cap,
+                          .telemetry_sample_interval = 1});
+  EXPECT_SUCCESS(executor.Init());
+  EXPECT_SUCCESS(executor.Run());
+
+  atomic<int> count(0);
+  for (int i = 0; i < queue_cap; i++) {
+    EXPECT_SUCCESS(
+        executor.Schedule([&]() { count++; }, AsyncPriority::Normal));
+    EXPECT_SUCCESS(
+        executor.Schedule([&]() { count++; }, AsyncPriority::Urgent));
+  }
+  WaitUntil([&]() { return count == 2 * queue_cap; });
+  EXPECT_SUCCESS(executor.Stop());
+
+  auto snapshot = executor.GetTelemetrySnapshot();
+  EXPECT_EQ(snapshot.normal_executors.size(), 2);
+  EXPECT_EQ(snapshot.urgent_executors.size(), 2);
+  auto total = snapshot.GetTotal();
+  EXPECT_EQ(total.queue_depth, 0);
+  EXPECT_EQ(total.rejected_count, 0);
+  EXPECT_EQ(total.run_time.count, 2 * queue_cap);
+  EXPECT_EQ(total.queue_wait_time.count, queue_cap);
+  EXPECT_EQ(total.timer_lateness.count, queue_cap);
+}
+
+TEST(AsyncExecutorTests, CountWorkWithTimerWheel) {
+  constexpr int queue_cap = 10;
+  AsyncExecutor executor(
+      {.thread_count = 2,
+       .queue_cap = queue_cap,
+       .timer_queue_type = TimerQueueType::HierarchicalTimerWheel});
+  EXPECT_SUCCESS(executor.Init());
+  EXPECT_SUCCESS(executor.Run());
+
+  atomic<int> count(0);
+  for (int i = 0; i < queue_cap; i++) {
+    EXPECT_SUCCESS(
+        executor.Schedule([&]() { count++; }, AsyncPriority::Urgent));
+    EXPECT_SUCCESS(executor.ScheduleFor([&]() { count++; }, 1234));
+  }
+  WaitUntil([&]() { return count == 2 * queue_cap; });
+  EXPECT_EQ(count, 2 * queue_cap);
+
+  EXPECT_SUCCESS(executor.Stop());
+}
+
+TEST(AsyncExecutorTests, CountWorkWithSpinThenPark) {
+  constexpr int queue_cap = 10;
+  AsyncExecutor executor(
+      {.thread_count = 2,
+       .queue_cap = queue_cap,
+       .task_load_balancing_scheme = TaskLoadBalancingScheme::WorkStealing,
+       .worker_idle_strategy = WorkerIdleStrategy::SpinThenPark});
+  EXPECT_SUCCESS(executor.Init());
+  EXPECT_SUCCESS(executor.Run());
+
+  atomic<int> count(0);
+  for (int i = 0; i < queue_cap; i++) {
+    EXPECT_SUCCESS(
+        executor.Schedule([&]() { count++; }, AsyncPriority::Normal));
+    EXPECT_SUCCESS(executor.Schedule([&]() { count++; }, AsyncPriority::High));
+  }
+  WaitUntil([&]() { return count == 2 * queue_cap; });
+  EXPECT_EQ(count, 2 * queue_cap);
+
+  EXPECT_SUCCESS(executor.Stop());
+}
+
+TEST(AsyncExecutorTests, CountWorkWithWorkStealing) {
+  int queue_cap = 50;
+  AsyncExecutor executor(4, queue_cap, /*drop_tasks_on_stop=*/false,
+                         TaskLoadBalancingScheme::WorkStealing);
+  EXPECT_SUCCESS(executor.Init());
+  EXPECT_SUCCESS(executor.Run());
+
+  // One of the executors is blocked for the duration of the test. The tasks
+  // that are queued behind it get picked up by the other executors.
+  atomic<bool> release_blocking_task(false);
+  EXPECT_SUCCESS(executor.Schedule(
+      [&]() {
+        while (!release_blocking_task) {
+          std::this_thread::yield();
+        }
+      },
+      AsyncPriority::Normal));
+
+  atomic<int> count(0);
+  for (int i = 0; i < queue_cap; i++) {
+    EXPECT_SUCCESS(executor.Schedule([&]() { count++; },
+                                     i % 2 == 0 ? AsyncPriority::Normal
+                                                : AsyncPriority::High));
+  }
+  WaitUntil([&]() { return count == queue_cap; });
+  EXPECT_EQ(count, queue_cap);
+
+  release_blocking_task = true;
+  EXPECT_SUCCESS(executor.Stop());
+}
+
+TEST(AsyncExecutorTests, AffinitizedWorkIsNotStolen) {
+  int queue_cap = 50;
+  AsyncExecutor executor(4, queue_cap, /*drop_tasks_on_stop=*/false,
+                         TaskLoadBalancingScheme::WorkStealing);
+  EXPECT_SUCCESS(executor.Init());
+  EXPECT_SUCCESS(executor.Run());
+
+  // The scheduling task keeps its executor busy for a while, so the peers
+  // would steal the affinitized tasks if they were stealable.
+  mutex thread_ids_mutex;
+  vector<std::thread::id> thread_ids;
+  std::thread::id scheduling_thread_id;
+  atomic<bool> scheduled(false);
+  EXPECT_SUCCESS(executor.Schedule(
+      [&]() {
+        scheduling_thread_id = std::this_thread::get_id();
+        for (int i = 0; i < queue_cap - 1; i++) {
+          EXPECT_SUCCESS(executor.Schedule(
+              [&]() {
+                unique_lock<mutex> lock(thread_ids_mutex);
+                thread_ids.push_back(std::this_thread::get_id());
+              },
+              AsyncPriority::Normal,
+              AsyncExecutorAffinitySetting::AffinitizedToCallingAsyncExecutor));
+        }
+        sleep_for(milliseconds(50));
+        scheduled = true;
+      },
+      AsyncPriority::Normal));
+
+  WaitUntil([&]() {
+    unique_lock<mutex> lock(thread_ids_mutex);
+    return thread_ids.size() == static_cast<size_t>(queue_cap - 1);
+  });
+  EXPECT_TRUE(scheduled);
+  for (const auto& thread_id : thread_ids) {
+    EXPECT_EQ(thread_id, scheduling_thread_id);
+  }
+
+  EXPECT_SUCCESS(executor.Stop());
+}
+
+TEST(AsyncExecutorTests, CountWorkMpscQueueBackend) {
+  constexpr int queue_cap = 10;
+  AsyncExecutor executor({.thread_count = 2,
+                          .queue_cap = queue_cap,
+                          .task_queue_backend = TaskQueueBackend::MpscQueue});
+  EXPECT_SUCCESS(executor.Init());
+  EXPECT_SUCCESS(executor.Run());
+
+  atomic<int> count(0);
+  for (int i = 0; i < queue_cap; i++) {
+    EXPECT_SUCCESS(
+        executor.Schedule([&]() { count++; }, AsyncPriority::Normal));
+    EXPECT_SUCCESS(executor.Schedule([&]() { count++; }, AsyncPriority::High));
+  }
+  WaitUntil([&]() { return count == 2 * queue_cap; });
+  EXPECT_SUCCESS(executor.Stop());
+  EXPECT_EQ(count, 2 * queue_cap);
+}
+
+TEST(AsyncExecutorTests, CannotInitMpscQueueBackendWithTooBigQueueCap) {
+  AsyncExecutor executor({.thread_count = 1,
+                          .queue_cap = kMaxMpscQueueCap + 1,
+                          .task_queue_backend = TaskQueueBackend::MpscQueue});
+  EXPECT_THAT(executor.Init(),
+              ResultIs(FailureExecutionResult(
+                  errors::SC_ASYNC_EXECUTOR_INVALID_QUEUE_CAP)));
+}
+
+TEST(AsyncExecutorTests, CountWorkSingleThreadPerCore) {
+  constexpr int queue_cap = 10;
+  AsyncExecutor executor(
+      {.thread_count = 2,
+       .queue_cap = queue_cap,
+       .threading_mode = ExecutorThreadingMode::SingleThreadPerCore,
+       .telemetry_sample_interval = 1});
+  EXPECT_SUCCESS(executor.Init());
+  EXPECT_SUCCESS(executor.Run());
+
+  mutex thread_ids_mutex;
+  std::set<std::thread::id> thread_ids;
+  atomic<int> count(0);
+  auto count_work = [&]() {
+    unique_lock<mutex> lock(thread_ids_mutex);
+    thread_ids.insert(std::this_thread::get_id());
+    count++;
+  };
+  // Half of the queue cap, as the urgent and timed work share the queues of the
+  // urgent executors.
+  int task_count = queue_cap / 2;
+  for (int i = 0; i < task_count; i++) {
+    EXPECT_SUCCESS(executor.Schedule(count_work, AsyncPriority::Normal));
+    EXPECT_SUCCESS(executor.Schedule(count_work, AsyncPriority::High));
+    EXPECT_SUCCESS(executor.Schedule(count_work, AsyncPriority::Urgent));
+    EXPECT_SUCCESS(executor.ScheduleFor(
+        count_work,
+        (TimeProvider::GetSteadyTimestampInNanoseconds() + milliseconds(10))
+            .count()));
+  }
+  // Urgent work scheduled with affinity stays on the thread of the caller.
+  EXPECT_SUCCESS(executor.Schedule(
+      [&]() {
+        auto thread_id = std::this_thread::get_id();
+        EXPECT_SUCCESS(executor.Schedule(
+            [&, thread_id]() {
+              EXPECT_EQ(std::this_thread::get_id(), thread_id);
+              count++;
+            },
+            AsyncPriority::Urgent,
+            AsyncExecutorAffinitySetting::AffinitizedToCallingAsyncExecutor));
+      },
+      AsyncPriority::Normal));
+
+  // Cancelled work does not run.
+  TaskCancellationLambda cancellation_callback;
+  EXPECT_SUCCESS(executor.ScheduleFor(
+      [&]() { EXPECT_EQ(true, false); },
+      (TimeProvider::GetSteadyTimestampInNanoseconds() + hours(24)).count(),
+      cancellation_callback));
+  EXPECT_TRUE(cancellation_callback());
+
+  WaitUntil([&]() { return count == 4 * task_count + 1; });
+  EXPECT_EQ(count, 4 * task_count + 1);
+  EXPECT_SUCCESS(executor.Stop());
+
+  // All the work ran on one thread per configured thread.
+  EXPECT_LE(thread_ids.size(), 2);
+  auto snapshot = executor.GetTelemetrySnapshot();
+  auto total = snapshot.GetTotal();
+  EXPECT_EQ(total.timer_lateness.count, 2 * task_count + 1);
+  EXPECT_EQ(total.queue_wait_time.count, 2 * task_count + 1);
+}
+
+TEST(AsyncExecutorTests, CannotInitElasticWithTooSmallMaxThreadCount) {
+  ElasticThreadCountOptions options;
+  options.max_thread_count = 1;
+  AsyncExecutor executor({.thread_count = 2,
+                          .queue_cap = 10,
+                          .elastic_thread_count_options = options});
+  EXPECT_THAT(executor.Init(),
+              ResultIs(FailureExecutionResult(
+                  errors::SC_ASYNC_EXECUTOR_INVALID_THREAD_COUNT)));
+}
+
+TEST(AsyncExecutorTests, ElasticThreadCountFollowsBacklog) {
+  ElasticThreadCountOptions options;
+  options.max_thread_count = 4;
+  options.backlog_per_thread_threshold = 1;
+  options.queue_wait_time_threshold = hours(1);
+  options.idle_cool_down = milliseconds(20);
+  options.control_interval = milliseconds(1);
+  AsyncExecutor executor({.thread_count = 1,
+                          .queue_cap = 100,
+                          .elastic_thread_count_options = options});
+  EXPECT_SUCCESS(executor.Init());
+  EXPECT_SUCCESS(executor.Run());
+  EXPECT_EQ(executor.GetNormalExecutorCount(), 1);
+
+  // The tasks queue up behind the first one, and the backlog makes the
+  // executor grow to its maximum.
+  atomic<bool> release_tasks(false);
+  atomic<int> count(0);
+  auto blocking_work = [&]() {
+    while (!release_tasks) {
+      sleep_for(milliseconds(1));
+    }
+    count++;
+  };
+  for (int i = 0; i < 20; i++) {
+    EXPECT_SUCCESS(executor.Schedule(blocking_work, AsyncPriority::Normal));
+  }
+  WaitUntil([&]() { return executor.GetNormalExecutorCount() == 4; });
+
+  // The added executors take new work.
+  for (int i = 0; i < 20; i++) {
+    EXPECT_SUCCESS(executor.Schedule(blocking_work, AsyncPriority::Normal));
+  }
+  release_tasks = true;
+  WaitUntil([&]() { return count == 40; });
+
+  // Once idle, the executor shrinks back to its thread count.
+  WaitUntil([&]() { return executor.GetNormalExecutorCount() == 1; });
+  EXPECT_SUCCESS(executor.Schedule([&]() { count++; }, AsyncPriority::Normal));
+  WaitUntil([&]() { return count == 41; });
+  EXPECT_EQ(executor.GetTelemetrySnapshot().normal_executors.size(), 4);
+
+  EXPECT_SUCCESS(executor.Stop());
+}
+
+TEST(AsyncExecutorTests, ElasticThreadCountDoesNotLoseTasks) {
+  // The executors are added and retired as fast as possible while tasks are
+  // scheduled concurrently.
+  ElasticThreadCountOptions options;
+  options.max_thread_count = 4;
+  options.backlog_per_thread_threshold = 1;
+  options.idle_cool_down = nanoseconds(0);
+  options.control_interval = nanoseconds(100000);
+  AsyncExecutor executor({.thread_count = 1,
+                          .queue_cap = 100000,
+                          .elastic_thread_count_options = options});
+  EXPECT_SUCCESS(executor.Init());
+  EXPECT_SUCCESS(executor.Run());
+
+  atomic<int> scheduled_count(0);
+  atomic<int> count(0);
+  vector<thread> threads;
+  for (int i = 0; i < 4; i++) {
+    threads.emplace_back([&]() {
+      for (int j = 0; j < 2000; j++) {
+        if (j % 100 == 0) {
+          sleep_for(milliseconds(1));
+        }
+        if (executor.Schedule([&]() { count++; }, AsyncPriority::Normal)
+                .Successful()) {
+          scheduled_count++;
+        }
+        vector<AsyncOperation> works(2, [&]() { count++; });
+        executor.ScheduleBatch(works, AsyncPriority::High);
+        scheduled_count += 2 - works.size();
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_SUCCESS(executor.Stop());
+  EXPECT_EQ(scheduled_count, 4 * 2000 * 3);
+  EXPECT_EQ(count, scheduled_count);
+}
+
+TEST(AsyncExecutorTests, ScheduleWithDeadline) {
+  AsyncExecutor executor(2, 10);
+  EXPECT_SUCCESS(executor.Init());
+  EXPECT_SUCCESS(executor.Run());
+
+  atomic<int> count(0);
+  TaskExpirationCallback expiration_callback =
+      [](const ExecutionResult&) { ADD_FAILURE(); };
+  auto deadline = TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks() +
+                  nanoseconds(hours(1)).count();
+  for (auto priority :
+       {AsyncPriority::Normal, AsyncPriority::High, AsyncPriority::Urgent}) {
+    EXPECT_SUCCESS(executor.ScheduleWithDeadline(
+        [&]() { count++; }, priority, deadline, expiration_callback));
+  }
+  WaitUntil([&]() { return count == 3; });
+
+  // The work whose deadline has passed is rejected up front, whatever its
+  // priority.
+  auto passed_deadline =
+      TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks() - 1;
+  for (auto priority :
+       {AsyncPriority::Normal, AsyncPriority::High, AsyncPriority::Urgent}) {
+    EXPECT_THAT(executor.ScheduleWithDeadline([&]() { count++; }, priority,
+                                              passed_deadline,
+                                              expiration_callback),
+                ResultIs(FailureExecutionResult(
+                    errors::SC_ASYNC_EXECUTOR_TASK_DEADLINE_EXCEEDED)));
+  }
+
+  EXPECT_SUCCESS(executor.Stop());
+  EXPECT_EQ(count, 3);
+}
+
+TEST(AsyncExecutorTests, ScheduleWithDeadlineWithAffinity) {
+  AsyncExecutor executor(2, 10);
+  EXPECT_SUCCESS(executor.Init());
+  EXPECT_SUCCESS(executor.Run());
+
+  atomic<int> count(0);
+  TaskExpirationCallback expiration_callback =
+      [](const ExecutionResult&) { ADD_FAILURE(); };
+  auto deadline = TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks() +
+                  nanoseconds(hours(1)).count();
+  for (auto priority :
+       {AsyncPriority::Normal, AsyncPriority::High, AsyncPriority::Urgent}) {
+    EXPECT_SUCCESS(executor.ScheduleWithDeadline(
+        [&, priority]() {
+          count++;
+          // Scheduled from the executor thread so that the affinity picks the
+          // executor of the calling thread.
+          EXPECT_SUCCESS(executor.ScheduleWithDeadline(
+              [&]() { count++; }, priority, deadline, expiration_callback,
+              AsyncExecutorAffinitySetting::AffinitizedToCallingAsyncExecutor));
+        },
+        priority, deadline, expiration_callback,
+        AsyncExecutorAffinitySetting::NonAffinitized));
+  }
+  WaitUntil([&]() { return count == 6; });
+
+  EXPECT_SUCCESS(executor.Stop());
+  EXPECT_EQ(count, 6);
+}
+
+TEST(AsyncExecutorTests, ScheduleBeforeExpiration) {
+  auto executor = make_shared<AsyncExecutor>(1, 10);
+  EXPECT_SUCCESS(executor->Init());
+  EXPECT_SUCCESS(executor->Run());
+  shared_ptr<AsyncExecutorInterface> async_executor = executor;
+
+  atomic<int> work_count(0);
+  atomic<int> callback_count(0);
+  vector<ExecutionResult> results(3);
+  auto make_context = [&](size_t index) {
+    return AsyncContext<string, string>(
+        make_shared<string>("request"),
+        [&, index](AsyncContext<string, string>& context) {
+          results[index] = context.result;
+          callback_count++;
+        });
+  };
+
+  // The work of a context that has not expired runs.
+  auto context = make_context(0);
+  EXPECT_SUCCESS(ScheduleBeforeExpiration(
+      [&]() mutable {
+        work_count++;
+        FinishContext(SuccessExecutionResult(), context);
+      },
+      context, async_executor, AsyncPriority::Normal));
+  WaitUntil([&]() { return callback_count == 1; });
+  EXPECT_EQ(work_count, 1);
+  EXPECT_SUCCESS(results[0]);
+
+  // The work of a context that has already expired is rejected and the
+  // context is left to the caller to finish.
+  auto expired_context = make_context(1);
+  expired_context.expiration_time =
+      TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks() - 1;
+  EXPECT_THAT(ScheduleBeforeExpiration([&]() { work_count++; },
+                                       expired_context, async_executor,
+                                       AsyncPriority::Normal),
+              ResultIs(FailureExecutionResult(
+                  errors::SC_ASYNC_EXECUTOR_TASK_DEADLINE_EXCEEDED)));
+
+  // The work of a context that expires while it waits behind a blocked worker
+  // is dropped, and the context is finished with the expiration instead.
+  atomic<bool> is_blocked(true);
+  EXPECT_SUCCESS(executor->Schedule(
+      [&]() {
+        while (is_blocked) {
+          sleep_for(milliseconds(1));
+        }
+      },
+      AsyncPriority::Normal));
+  auto expiring_context = make_context(2);
+  expiring_context.expiration_time =
+      TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks() +
+      nanoseconds(milliseconds(10)).count();
+  EXPECT_SUCCESS(ScheduleBeforeExpiration([&]() { work_count++; },
+                                          expiring_context, async_executor,
+                                          AsyncPriority::Normal));
+  sleep_for(milliseconds(50));
+  is_blocked = false;
+  WaitUntil([&]() { return callback_count == 2; });
+  EXPECT_THAT(results[2],
+              ResultIs(FailureExecutionResult(
+                  errors::SC_ASYNC_EXECUTOR_TASK_DEADLINE_EXCEEDED)));
+
+  EXPECT_SUCCESS(executor->Stop());
+  EXPECT_EQ(work_count, 1);
+  EXPECT_EQ(callback_count, 2);
+}
+
 TEST(AsyncExecutorTests, AsyncContextCallback) {
   AsyncExecutor executor(1, 10);
   executor.Init();
@@ -393,6 +962,120 @@ TEST(AsyncExecutorTests, AsyncContextCallback) {
   executor.Stop();
 }
 
+TEST(AsyncExecutorTests, IsRunningOnExecutorThread) {
+  AsyncExecutor executor(1, 10);
+  EXPECT_SUCCESS(executor.Init());
+  EXPECT_FALSE(executor.IsRunningOnExecutorThread(AsyncPriority::Normal));
+  EXPECT_SUCCESS(executor.Run());
+
+  EXPECT_FALSE(executor.IsRunningOnExecutorThread(AsyncPriority::Normal));
+  EXPECT_FALSE(executor.IsRunningOnExecutorThread(AsyncPriority::Urgent));
+
+  atomic<int> count(0);
+  EXPECT_SUCCESS(executor.Schedule(
+      [&]() {
+        EXPECT_TRUE(executor.IsRunningOnExecutorThread(AsyncPriority::Normal));
+        EXPECT_TRUE(executor.IsRunningOnExecutorThread(AsyncPriority::High));
+        EXPECT_FALSE(executor.IsRunningOnExecutorThread(AsyncPriority::Urgent));
+        count++;
+      },
+      AsyncPriority::Normal));
+  EXPECT_SUCCESS(executor.Schedule(
+      [&]() {
+        EXPECT_FALSE(executor.IsRunningOnExecutorThread(AsyncPriority::High));
+        EXPECT_TRUE(executor.IsRunningOnExecutorThread(AsyncPriority::Urgent));
+        count++;
+      },
+      AsyncPriority::Urgent));
+  WaitUntil([&]() { return count == 2; });
+  EXPECT_SUCCESS(executor.Stop());
+}
+
+TEST(AsyncExecutorTests, FinishContextCompletionPolicy) {
+  AsyncExecutor executor(1, 10);
+  EXPECT_SUCCESS(executor.Init());
+  EXPECT_SUCCESS(executor.Run());
+  auto executor_ptr = shared_ptr<AsyncExecutorInterface>(
+      &executor, [](AsyncExecutorInterface*) {});
+
+  atomic<int> callback_count(0);
+  // Counts the callbacks run on the current thread. The total is not enough, as
+  // the urgent executor can run a scheduled callback before the task checks it.
+  static thread_local int thread_callback_count = 0;
+  auto context = AsyncContext<string, string>(
+      make_shared<string>("request"), [&](AsyncContext<string, string>&) {
+        callback_count++;
+        thread_callback_count++;
+      });
+
+  // Finished from a thread outside of the executor.
+  context.completion_policy = AsyncCompletionPolicy::InlineOnExecutorThread;
+  FinishContext(SuccessExecutionResult(), context, executor_ptr);
+  WaitUntil([&]() { return callback_count == 1; });
+
+  context.completion_policy = AsyncCompletionPolicy::InlineCheapCallback;
+  FinishContext(SuccessExecutionResult(), context, executor_ptr);
+  EXPECT_EQ(callback_count, 2);
+
+  // Finished from a task of the executor. The worker is busy with the task, so
+  // a scheduled callback only runs after the task.
+  atomic<bool> task_done(false);
+  EXPECT_SUCCESS(executor.Schedule(
+      [&]() {
+        auto initial_thread_callback_count = thread_callback_count;
+        context.completion_policy = AsyncCompletionPolicy::Schedule;
+        FinishContext(SuccessExecutionResult(), context, executor_ptr);
+        EXPECT_EQ(thread_callback_count, initial_thread_callback_count);
+
+        context.completion_policy =
+            AsyncCompletionPolicy::InlineOnExecutorThread;
+        FinishContext(SuccessExecutionResult(), context, executor_ptr);
+        EXPECT_EQ(thread_callback_count, initial_thread_callback_count + 1);
+        // Urgent callbacks belong to the urgent executor.
+        FinishContext(SuccessExecutionResult(), context, executor_ptr,
+                      AsyncPriority::Urgent);
+        EXPECT_EQ(thread_callback_count, initial_thread_callback_count + 1);
+        task_done = true;
+      },
+      AsyncPriority::High));
+  WaitUntil([&]() { return task_done && callback_count == 5; });
+  EXPECT_SUCCESS(executor.Stop());
+}
+
+TEST(AsyncExecutorTests, FinishContextInlineDepthIsBounded) {
+  AsyncExecutor executor(1, 100);
+  EXPECT_SUCCESS(executor.Init());
+  EXPECT_SUCCESS(executor.Run());
+  auto executor_ptr = shared_ptr<AsyncExecutorInterface>(
+      &executor, [](AsyncExecutorInterface*) {});
+
+  // Every callback finishes the next context of the chain.
+  constexpr size_t kChainLength = 3 * kMaxInlineFinishContextDepth;
+  atomic<size_t> finished_count(0);
+  atomic<size_t> max_depth(0);
+  std::function<void(size_t)> finish_chain = [&](size_t index) {
+    auto context = AsyncContext<string, string>(
+        make_shared<string>("request"),
+        [&, index](AsyncContext<string, string>&) {
+          auto depth = GetInlineFinishContextDepth();
+          if (depth > max_depth) {
+            max_depth = depth;
+          }
+          finished_count++;
+          if (index + 1 < kChainLength) {
+            finish_chain(index + 1);
+          }
+        });
+    context.completion_policy = AsyncCompletionPolicy::InlineCheapCallback;
+    FinishContext(SuccessExecutionResult(), context, executor_ptr);
+  };
+  finish_chain(0);
+
+  WaitUntil([&]() { return finished_count == kChainLength; });
+  EXPECT_EQ(max_depth, kMaxInlineFinishContextDepth);
+  EXPECT_SUCCESS(executor.Stop());
+}
+
 TEST(AsyncExecutorTests, FinishWorkWhenStopInMiddle) {
   int queue_cap = 5;
   AsyncExecutor executor(2, queue_cap);
@@ -433,6 +1116,73 @@ class AsyncExecutorAccessor : public AsyncExecutor {
   explicit AsyncExecutorAccessor(size_t thread_count = 1)
       : AsyncExecutor(thread_count, 1 /* queue cap */) {}
 
+  std::optional<size_t> GetCurrentCpu() const noexcept override {
+    return current_cpu_;
+  }
+
+  void TestInitPlacesExecutorPairsOnNodes() {
+    // Two nodes with two CPUs each, CPU 3 is excluded by the cpuset.
+    cpu_topology_ = CpuTopology({{0, 1}, {2, 3}}, {0, 1, 2});
+    EXPECT_SUCCESS(Init());
+
+    // The pairs alternate between the nodes.
+    EXPECT_EQ(node_executor_indices_,
+              (vector<vector<size_t>>{{0, 2}, {1, 3}}));
+    EXPECT_EQ(normal_task_executor_pool_.size(), 4);
+    EXPECT_EQ(urgent_task_executor_pool_.size(), 4);
+  }
+
+  template <class TaskExecutorType>
+  void TestPickTaskExecutorNumaAware(
+      const vector<shared_ptr<TaskExecutorType>>& task_executor_pool,
+      TaskExecutorPoolType task_executor_pool_type) {
+    // The executors at the odd indices are on the second node.
+    current_cpu_ = 2;
+    map<shared_ptr<TaskExecutorType>, int> task_executor_pool_picked_counts;
+    for (int i = 0; i < 10; i++) {
+      auto task_executor_or =
+          PickTaskExecutor(AsyncExecutorAffinitySetting::NonAffinitized,
+                           task_executor_pool, task_executor_pool_type,
+                           TaskLoadBalancingScheme::NumaAware);
+      EXPECT_SUCCESS(task_executor_or);
+      task_executor_pool_picked_counts[*task_executor_or] += 1;
+    }
+    EXPECT_EQ(task_executor_pool_picked_counts[task_executor_pool[0]], 0);
+    EXPECT_EQ(task_executor_pool_picked_counts[task_executor_pool[1]], 5);
+    EXPECT_EQ(task_executor_pool_picked_counts[task_executor_pool[2]], 0);
+    EXPECT_EQ(task_executor_pool_picked_counts[task_executor_pool[3]], 5);
+
+    // A CPU outside of the topology falls back to round robin over all the
+    // executors.
+    current_cpu_ = 42;
+    task_executor_pool_picked_counts.clear();
+    for (int i = 0; i < 4; i++) {
+      auto task_executor_or =
+          PickTaskExecutor(AsyncExecutorAffinitySetting::NonAffinitized,
+                           task_executor_pool, task_executor_pool_type,
+                           TaskLoadBalancingScheme::NumaAware);
+      EXPECT_SUCCESS(task_executor_or);
+      task_executor_pool_picked_counts[*task_executor_or] += 1;
+    }
+    for (auto task_executor : task_executor_pool) {
+      EXPECT_EQ(task_executor_pool_picked_counts[task_executor], 1);
+    }
+  }
+
+  void TestPickTaskExecutorNumaAwareNonUrgentPool() {
+    cpu_topology_ = CpuTopology({{0, 1}, {2, 3}}, {0, 1, 2, 3});
+    EXPECT_SUCCESS(Init());
+    TestPickTaskExecutorNumaAware(normal_task_executor_pool_,
+                                  TaskExecutorPoolType::NotUrgentPool);
+  }
+
+  void TestPickTaskExecutorNumaAwareUrgentPool() {
+    cpu_topology_ = CpuTopology({{0, 1}, {2, 3}}, {0, 1, 2, 3});
+    EXPECT_SUCCESS(Init());
+    TestPickTaskExecutorNumaAware(urgent_task_executor_pool_,
+                                  TaskExecutorPoolType::UrgentPool);
+  }
+
   void TestPickTaskExecutorRoundRobinGlobalUrgentPool() {
     int num_executors = 10;
     vector<shared_ptr<SingleThreadPriorityAsyncExecutor>> task_executor_pool;
@@ -485,6 +1235,33 @@ class AsyncExecutorAccessor : public AsyncExecutor {
     }
   }
 
+  void TestPickTaskExecutorWorkStealingNonUrgentPool() {
+    int num_executors = 10;
+    vector<shared_ptr<SingleThreadAsyncExecutor>> task_executor_pool;
+    for (int i = 0; i < num_executors; i++) {
+      task_executor_pool.push_back(
+          make_shared<SingleThreadAsyncExecutor>(100 /* queue cap */));
+    }
+
+    // Run picking executors
+    map<shared_ptr<SingleThreadAsyncExecutor>, int>
+        task_executor_pool_picked_counts;
+    for (int i = 0; i < num_executors; i++) {
+      auto task_executor_or = PickTaskExecutor(
+          AsyncExecutorAffinitySetting::NonAffinitized, task_executor_pool,
+          TaskExecutorPoolType::NotUrgentPool,
+          TaskLoadBalancingScheme::WorkStealing);
+      EXPECT_SUCCESS(task_executor_or);
+      task_executor_pool_picked_counts[*task_executor_or] += 1;
+    }
+
+    // Initial placement is round robin, so the picked counts are 1 on all the
+    // executors
+    for (auto task_executor : task_executor_pool) {
+      EXPECT_EQ(task_executor_pool_picked_counts[task_executor], 1);
+    }
+  }
+
   void PickTaskExecutorRoundRobinThreadLocalUrgentPool() {
     int num_executors = 10;
     vector<shared_ptr<SingleThreadPriorityAsyncExecutor>> task_executor_pool;
@@ -794,6 +1571,9 @@ class AsyncExecutorAccessor : public AsyncExecutor {
     WaitUntil([&done]() { return done.load(); });
     EXPECT_SUCCESS(Stop());
   }
+
+ private:
+  std::optional<size_t> current_cpu_;
 };
 
 TEST(AsyncExecutorTests, PickTaskExecutorRoundRobinGlobalUrgentPool) {
@@ -804,6 +1584,22 @@ TEST(AsyncExecutorTests, PickTaskExecutorRoundRobinGlobalNonUrgentPool) {
   AsyncExecutorAccessor().TestPickTaskExecutorRoundRobinGlobalNonUrgentPool();
 }
 
+TEST(AsyncExecutorTests, PickTaskExecutorWorkStealingNonUrgentPool) {
+  AsyncExecutorAccessor().TestPickTaskExecutorWorkStealingNonUrgentPool();
+}
+
+TEST(AsyncExecutorTests, InitPlacesExecutorPairsOnNodes) {
+  AsyncExecutorAccessor(4).TestInitPlacesExecutorPairsOnNodes();
+}
+
+TEST(AsyncExecutorTests, PickTaskExecutorNumaAwareNonUrgentPool) {
+  AsyncExecutorAccessor(4).TestPickTaskExecutorNumaAwareNonUrgentPool();
+}
+
+TEST(AsyncExecutorTests, PickTaskExecutorNumaAwareUrgentPool) {
+  AsyncExecutorAccessor(4).TestPickTaskExecutorNumaAwareUrgentPool();
+}
+
 TEST(AsyncExecutorTests, PickTaskExecutorRoundRobinThreadLocalUrgentPool) {
   AsyncExecutorAccessor().PickTaskExecutorRoundRobinThreadLocalUrgentPool();
 }
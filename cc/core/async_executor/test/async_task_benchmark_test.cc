@@ -0,0 +1,201 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <optional>
+#include <utility>
+
+#include <benchmark/benchmark.h>
+
+#include "core/async_executor/src/async_task.h"
+#include "core/async_executor/src/single_thread_async_executor.h"
+#include "core/async_executor/src/single_thread_priority_async_executor.h"
+#include "core/common/time_provider/src/time_provider.h"
+
+using google::scp::core::AsyncOperation;
+using google::scp::core::AsyncPriority;
+using google::scp::core::AsyncTask;
+using google::scp::core::SingleThreadAsyncExecutor;
+using google::scp::core::SingleThreadPriorityAsyncExecutor;
+using google::scp::core::TimerQueueType;
+using google::scp::core::common::TimeProvider;
+using std::array;
+using std::atomic;
+using std::make_shared;
+using std::memory_order_relaxed;
+using std::move;
+using std::shared_ptr;
+
+/// Counts the heap allocations done by the process.
+static atomic<size_t> allocation_count(0);
+
+void* operator new(size_t size) {
+  allocation_count.fetch_add(1, memory_order_relaxed);
+  if (auto* ptr = std::malloc(size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept {
+  std::free(ptr);
+}
+
+namespace google::scp::core::test {
+/// Roughly the size of the state captured by a callback with an AsyncContext.
+static constexpr size_t kCapturedStateSize = 128;
+static constexpr size_t kTasksPerIteration = 1000;
+
+struct CapturedState {
+  array<char, kCapturedStateSize> payload = {};
+};
+
+static shared_ptr<SingleThreadAsyncExecutor> CreateExecutor() {
+  auto executor = make_shared<SingleThreadAsyncExecutor>(
+      kTasksPerIteration * 10, /*drop_tasks_on_stop=*/false);
+  executor->Init();
+  executor->Run();
+  return executor;
+}
+
+static void ReportAllocations(benchmark::State& state,
+                              size_t allocation_count_before) {
+  auto allocations = allocation_count.load() - allocation_count_before;
+  state.counters["AllocsPerTask"] = static_cast<double>(allocations) /
+                                    (state.iterations() * kTasksPerIteration);
+  state.SetItemsProcessed(state.iterations() * kTasksPerIteration);
+}
+
+/// The work is copied into the executor, as in the const reference overload.
+static void BM_ScheduleCopiedWork(benchmark::State& state) {
+  auto executor = CreateExecutor();
+  atomic<size_t> executed_count(0);
+  CapturedState captured_state;
+  auto allocation_count_before = allocation_count.load();
+  for (auto _ : state) {
+    executed_count = 0;
+    for (size_t i = 0; i < kTasksPerIteration; i++) {
+      AsyncOperation work = [&executed_count, captured_state]() {
+        benchmark::DoNotOptimize(captured_state);
+        executed_count++;
+      };
+      executor->Schedule(work, AsyncPriority::Normal);
+    }
+    while (executed_count < kTasksPerIteration) {}
+  }
+  ReportAllocations(state, allocation_count_before);
+  executor->Stop();
+}
+
+/// The work is moved into the executor through the rvalue overload.
+static void BM_ScheduleMovedWork(benchmark::State& state) {
+  auto executor = CreateExecutor();
+  atomic<size_t> executed_count(0);
+  CapturedState captured_state;
+  auto allocation_count_before = allocation_count.load();
+  for (auto _ : state) {
+    executed_count = 0;
+    for (size_t i = 0; i < kTasksPerIteration; i++) {
+      AsyncOperation work = [&executed_count, captured_state]() {
+        benchmark::DoNotOptimize(captured_state);
+        executed_count++;
+      };
+      executor->Schedule(move(work), AsyncPriority::Normal);
+    }
+    while (executed_count < kTasksPerIteration) {}
+  }
+  ReportAllocations(state, allocation_count_before);
+  executor->Stop();
+}
+
+/// The work is moved into a timer executor, with the timer queue of the
+/// argument, and is due right away.
+static void BM_ScheduleForMovedWork(benchmark::State& state) {
+  auto executor = make_shared<SingleThreadPriorityAsyncExecutor>(
+      kTasksPerIteration * 10, /*drop_tasks_on_stop=*/false,
+      /*affinity_cpu_number=*/std::nullopt,
+      static_cast<TimerQueueType>(state.range(0)));
+  executor->Init();
+  executor->Run();
+  atomic<size_t> executed_count(0);
+  CapturedState captured_state;
+  auto allocation_count_before = allocation_count.load();
+  for (auto _ : state) {
+    executed_count = 0;
+    for (size_t i = 0; i < kTasksPerIteration; i++) {
+      AsyncOperation work = [&executed_count, captured_state]() {
+        benchmark::DoNotOptimize(captured_state);
+        executed_count++;
+      };
+      executor->ScheduleFor(
+          move(work),
+          TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks());
+    }
+    while (executed_count < kTasksPerIteration) {}
+  }
+  ReportAllocations(state, allocation_count_before);
+  executor->Stop();
+}
+
+/// The previous task representation: a shared task holding a copy of the work.
+static void BM_CreateSharedTask(benchmark::State& state) {
+  CapturedState captured_state;
+  auto allocation_count_before = allocation_count.load();
+  for (auto _ : state) {
+    for (size_t i = 0; i < kTasksPerIteration; i++) {
+      AsyncOperation work = [captured_state]() {
+        benchmark::DoNotOptimize(captured_state);
+      };
+      auto task = make_shared<AsyncTask>(work);
+      task->Execute();
+    }
+  }
+  ReportAllocations(state, allocation_count_before);
+}
+
+/// The current task representation: a move-only task owning the work.
+static void BM_CreateMovedTask(benchmark::State& state) {
+  CapturedState captured_state;
+  auto allocation_count_before = allocation_count.load();
+  for (auto _ : state) {
+    for (size_t i = 0; i < kTasksPerIteration; i++) {
+      AsyncOperation work = [captured_state]() {
+        benchmark::DoNotOptimize(captured_state);
+      };
+      AsyncTask task(move(work));
+      task.Execute();
+    }
+  }
+  ReportAllocations(state, allocation_count_before);
+}
+}  // namespace google::scp::core::test
+
+BENCHMARK(google::scp::core::test::BM_ScheduleCopiedWork);
+BENCHMARK(google::scp::core::test::BM_ScheduleMovedWork);
+BENCHMARK(google::scp::core::test::BM_ScheduleForMovedWork)
+    ->Arg(static_cast<int64_t>(TimerQueueType::BinaryHeap))
+    ->Arg(static_cast<int64_t>(TimerQueueType::HierarchicalTimerWheel));
+BENCHMARK(google::scp::core::test::BM_CreateSharedTask);
+BENCHMARK(google::scp::core::test::BM_CreateMovedTask);
+
+// Run the benchmark
+BENCHMARK_MAIN();
@@ -31,4 +31,42 @@ TEST(AsyncTaskTests, BasicTests) {
   AsyncTask async_task1(func, 1234);
   EXPECT_EQ(async_task1.GetExecutionTimestamp(), 1234);
 }
+
+TEST(AsyncTaskTests, CancelBeforeExecution) {
+  int execution_count = 0;
+  AsyncTask async_task([&]() { execution_count++; });
+  EXPECT_FALSE(async_task.IsCancelled());
+  EXPECT_TRUE(async_task.Cancel());
+  EXPECT_TRUE(async_task.IsCancelled());
+  EXPECT_FALSE(async_task.Cancel());
+
+  async_task.Execute();
+  EXPECT_EQ(execution_count, 0);
+}
+
+TEST(AsyncTaskTests, CannotCancelAfterExecution) {
+  int execution_count = 0;
+  AsyncTask async_task([&]() { execution_count++; });
+  async_task.Execute();
+  EXPECT_EQ(execution_count, 1);
+  EXPECT_FALSE(async_task.Cancel());
+  EXPECT_FALSE(async_task.IsCancelled());
+
+  // A task is executed at most once.
+  async_task.Execute();
+  EXPECT_EQ(execution_count, 1);
+}
+
+TEST(AsyncTaskTests, MoveTask) {
+  int execution_count = 0;
+  AsyncTask async_task([&]() { execution_count++; }, 1234);
+  AsyncTask moved_task(std::move(async_task));
+  EXPECT_EQ(moved_task.GetExecutionTimestamp(), 1234);
+
+  AsyncTask assigned_task;
+  assigned_task = std::move(moved_task);
+  EXPECT_EQ(assigned_task.GetExecutionTimestamp(), 1234);
+  assigned_task.Execute();
+  EXPECT_EQ(execution_count, 1);
+}
 }  // namespace google::scp::core::test
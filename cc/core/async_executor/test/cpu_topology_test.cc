@@ -0,0 +1,146 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "core/async_executor/src/cpu_topology.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "core/async_executor/src/error_codes.h"
+#include "public/core/test/interface/execution_result_matchers.h"
+
+using std::move;
+using std::nullopt;
+using std::string;
+using std::vector;
+using std::filesystem::path;
+
+namespace google::scp::core::test {
+path GetTestDataDir(string relative_path) {
+  path test_srcdir_env = std::getenv("TEST_SRCDIR");
+  path test_workspace_env = std::getenv("TEST_WORKSPACE");
+
+  return path(test_srcdir_env) / path(test_workspace_env) / move(relative_path);
+}
+
+path GetTopologyFixtureDir(const string& fixture_name) {
+  return GetTestDataDir("cc/core/async_executor/test/resources/cpu_topology/" +
+                        fixture_name);
+}
+
+TEST(CpuTopologyTest, ParseCpuList) {
+  vector<size_t> cpus;
+  EXPECT_SUCCESS(CpuTopology::ParseCpuList("0-3,8,10-11\n", cpus));
+  EXPECT_EQ(cpus, (vector<size_t>{0, 1, 2, 3, 8, 10, 11}));
+
+  EXPECT_SUCCESS(CpuTopology::ParseCpuList("5", cpus));
+  EXPECT_EQ(cpus, (vector<size_t>{5}));
+
+  // Memory only nodes have an empty list.
+  EXPECT_SUCCESS(CpuTopology::ParseCpuList("\n", cpus));
+  EXPECT_TRUE(cpus.empty());
+}
+
+TEST(CpuTopologyTest, ParseMalformedCpuList) {
+  vector<size_t> cpus;
+  for (const auto& cpu_list : {"a", "1-", "-1", "3-1", "1,", "1,,2", "1 2",
+                               "0-99999999"}) {
+    EXPECT_THAT(CpuTopology::ParseCpuList(cpu_list, cpus),
+                ResultIs(FailureExecutionResult(
+                    errors::SC_ASYNC_EXECUTOR_INVALID_CPU_LIST)))
+        << cpu_list;
+  }
+}
+
+TEST(CpuTopologyTest, DiscoverDualSocket) {
+  vector<size_t> allowed_cpus;
+  for (size_t cpu = 0; cpu < 16; ++cpu) {
+    allowed_cpus.push_back(cpu);
+  }
+  auto topology = CpuTopology::Discover(GetTopologyFixtureDir("dual_socket"),
+                                        allowed_cpus);
+
+  // The memory only node is left out.
+  ASSERT_EQ(topology.GetNodeCount(), 2);
+  EXPECT_EQ(topology.GetNodeCpus(0),
+            (vector<size_t>{0, 1, 2, 3, 8, 9, 10, 11}));
+  EXPECT_EQ(topology.GetNodeCpus(1),
+            (vector<size_t>{4, 5, 6, 7, 12, 13, 14, 15}));
+  EXPECT_EQ(topology.GetNodeOfCpu(9), 0);
+  EXPECT_EQ(topology.GetNodeOfCpu(12), 1);
+  EXPECT_EQ(topology.GetNodeOfCpu(16), nullopt);
+}
+
+TEST(CpuTopologyTest, DiscoverRespectsAffinityMask) {
+  // A cpuset with two CPUs on the first node and one on the second.
+  auto topology = CpuTopology::Discover(GetTopologyFixtureDir("dual_socket"),
+                                        {2, 9, 13});
+
+  ASSERT_EQ(topology.GetNodeCount(), 2);
+  EXPECT_EQ(topology.GetNodeCpus(0), (vector<size_t>{2, 9}));
+  EXPECT_EQ(topology.GetNodeCpus(1), (vector<size_t>{13}));
+  EXPECT_EQ(topology.GetNodeOfCpu(0), nullopt);
+
+  // A cpuset within a single node.
+  topology = CpuTopology::Discover(GetTopologyFixtureDir("dual_socket"),
+                                   {4, 5});
+  ASSERT_EQ(topology.GetNodeCount(), 1);
+  EXPECT_EQ(topology.GetNodeCpus(0), (vector<size_t>{4, 5}));
+}
+
+TEST(CpuTopologyTest, DiscoverSkipsMalformedNodes) {
+  auto topology = CpuTopology::Discover(GetTopologyFixtureDir("sparse_nodes"),
+                                        {0, 1, 2, 3, 4});
+
+  // Nodes are indexed densely in the order of their IDs, and the node with a
+  // malformed CPU list is left out.
+  ASSERT_EQ(topology.GetNodeCount(), 2);
+  EXPECT_EQ(topology.GetNodeCpus(0), (vector<size_t>{0, 1}));
+  EXPECT_EQ(topology.GetNodeCpus(1), (vector<size_t>{2, 3}));
+  EXPECT_EQ(topology.GetNodeOfCpu(4), nullopt);
+}
+
+TEST(CpuTopologyTest, DiscoverWithoutNodes) {
+  auto topology = CpuTopology::Discover("/this/directory/does/not/exist",
+                                        {1, 3, 5});
+
+  ASSERT_EQ(topology.GetNodeCount(), 1);
+  EXPECT_EQ(topology.GetNodeCpus(0), (vector<size_t>{1, 3, 5}));
+  EXPECT_EQ(topology.GetNodeOfCpu(3), 0);
+}
+
+TEST(CpuTopologyTest, DiscoverHost) {
+  auto topology = CpuTopology::Discover();
+
+  ASSERT_GE(topology.GetNodeCount(), 1);
+  for (size_t node = 0; node < topology.GetNodeCount(); ++node) {
+    EXPECT_FALSE(topology.GetNodeCpus(node).empty());
+  }
+}
+
+TEST(CpuTopologyTest, GetCpuForWorker) {
+  CpuTopology topology({{0, 1, 2}, {3, 4}}, {0, 1, 2, 3, 4});
+
+  // Workers alternate between the nodes and wrap around within each node.
+  vector<size_t> cpus;
+  for (size_t worker_index = 0; worker_index < 8; ++worker_index) {
+    cpus.push_back(topology.GetCpuForWorker(worker_index));
+  }
+  EXPECT_EQ(cpus, (vector<size_t>{0, 3, 1, 4, 2, 3, 0, 4}));
+}
+}  // namespace google::scp::core::test
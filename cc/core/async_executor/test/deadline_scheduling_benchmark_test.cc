@@ -0,0 +1,144 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include <benchmark/benchmark.h>
+
+#include "core/async_executor/src/async_executor.h"
+#include "core/common/time_provider/src/time_provider.h"
+#include "public/core/test/interface/execution_result_matchers.h"
+
+using google::scp::core::common::TimeProvider;
+using std::atomic;
+using std::make_shared;
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+using std::chrono::nanoseconds;
+using std::chrono::seconds;
+using std::chrono::steady_clock;
+
+namespace google::scp::core::test {
+static constexpr size_t kTasksPerIteration = 2000;
+/// The time every task keeps the worker busy for.
+static constexpr microseconds kTaskRunTime(100);
+/// Every other task has the tight deadline, the rest the loose one.
+static constexpr milliseconds kTightDeadline(2);
+static constexpr milliseconds kLooseDeadline(20);
+
+/// Keeps the calling thread busy for the given duration.
+static void Spin(nanoseconds duration) {
+  auto end = steady_clock::now() + duration;
+  while (steady_clock::now() < end) {}
+}
+
+/**
+ * @brief Offers an open loop load of state.range(0) percent of the capacity of
+ * a single worker, and counts the tasks that complete before their deadline.
+ * The FIFO variant schedules with Schedule and runs every task, however late.
+ * The deadline variant schedules with ScheduleWithDeadline, so the worker runs
+ * the earliest deadline first and drops the tasks that cannot start in time.
+ */
+static void BenchmarkGoodputUnderOverload(benchmark::State& state,
+                                          bool use_deadlines) {
+  auto async_executor = make_shared<AsyncExecutor>(1, 100000);
+  EXPECT_SUCCESS(async_executor->Init());
+  EXPECT_SUCCESS(async_executor->Run());
+  auto interval = duration_cast<nanoseconds>(kTaskRunTime) * 100 /
+                  static_cast<int64_t>(state.range(0));
+
+  atomic<size_t> in_time_count(0);
+  atomic<size_t> late_count(0);
+  atomic<size_t> expired_count(0);
+  TaskExpirationCallback expiration_callback =
+      [&expired_count](const ExecutionResult&) { expired_count++; };
+  for (auto _ : state) {
+    auto start_time = steady_clock::now();
+    for (size_t i = 0; i < kTasksPerIteration; i++) {
+      Spin(start_time + interval * i - steady_clock::now());
+      auto deadline =
+          TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks() +
+          nanoseconds(i % 2 == 0 ? kTightDeadline : kLooseDeadline).count();
+      auto work = [&in_time_count, &late_count, deadline]() {
+        Spin(kTaskRunTime);
+        if (TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks() <=
+            deadline) {
+          in_time_count++;
+        } else {
+          late_count++;
+        }
+      };
+      if (use_deadlines) {
+        EXPECT_SUCCESS(async_executor->ScheduleWithDeadline(
+            work, AsyncPriority::Normal, deadline, expiration_callback));
+      } else {
+        EXPECT_SUCCESS(async_executor->Schedule(work, AsyncPriority::Normal));
+      }
+    }
+    while (in_time_count + late_count + expired_count <
+           state.iterations() * kTasksPerIteration) {
+      std::this_thread::yield();
+    }
+    state.SetIterationTime(
+        duration_cast<nanoseconds>(steady_clock::now() - start_time).count() /
+        1e9);
+  }
+  EXPECT_SUCCESS(async_executor->Stop());
+
+  // The counts are per iteration, the goodput is in time completions per
+  // second.
+  state.counters["completed_in_time"] = benchmark::Counter(
+      in_time_count.load(), benchmark::Counter::kAvgIterations);
+  state.counters["late"] =
+      benchmark::Counter(late_count.load(), benchmark::Counter::kAvgIterations);
+  state.counters["expired"] = benchmark::Counter(
+      expired_count.load(), benchmark::Counter::kAvgIterations);
+  state.counters["goodput"] =
+      benchmark::Counter(in_time_count.load(), benchmark::Counter::kIsRate);
+  state.SetItemsProcessed(state.iterations() * kTasksPerIteration);
+}
+
+static void BM_GoodputUnderOverloadFifo(benchmark::State& state) {
+  BenchmarkGoodputUnderOverload(state, /*use_deadlines=*/false);
+}
+
+static void BM_GoodputUnderOverloadDeadline(benchmark::State& state) {
+  BenchmarkGoodputUnderOverload(state, /*use_deadlines=*/true);
+}
+}  // namespace google::scp::core::test
+
+// Arg<Offered load in percent of the worker capacity>
+BENCHMARK(google::scp::core::test::BM_GoodputUnderOverloadFifo)
+    ->Arg(80)
+    ->Arg(120)
+    ->Arg(200)
+    ->Iterations(5)
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond);
+
+// Arg<Offered load in percent of the worker capacity>
+BENCHMARK(google::scp::core::test::BM_GoodputUnderOverloadDeadline)
+    ->Arg(80)
+    ->Arg(120)
+    ->Arg(200)
+    ->Iterations(5)
+    ->UseManualTime()
+    ->Unit(benchmark::kMillisecond);
+
+// Run the benchmark
+BENCHMARK_MAIN();
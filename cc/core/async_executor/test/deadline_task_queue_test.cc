@@ -0,0 +1,127 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "core/async_executor/src/deadline_task_queue.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using std::atomic;
+using std::thread;
+using std::vector;
+
+namespace google::scp::core::test {
+DeadlineTask MakeDeadlineTask(Timestamp deadline, int id, vector<int>& ids) {
+  return DeadlineTask{AsyncTask([id, &ids]() { ids.push_back(id); }),
+                      deadline};
+}
+
+TEST(DeadlineTaskQueueTest, EarliestDeadlineFirst) {
+  DeadlineTaskQueue queue(10);
+  vector<int> ids;
+  EXPECT_TRUE(queue.TryEnqueue(MakeDeadlineTask(300, 1, ids)));
+  EXPECT_TRUE(queue.TryEnqueue(MakeDeadlineTask(100, 2, ids)));
+  EXPECT_TRUE(queue.TryEnqueue(MakeDeadlineTask(200, 3, ids)));
+  // The tasks with the same deadline keep their arrival order.
+  EXPECT_TRUE(queue.TryEnqueue(MakeDeadlineTask(100, 4, ids)));
+  EXPECT_TRUE(queue.TryEnqueue(MakeDeadlineTask(100, 5, ids)));
+  EXPECT_EQ(queue.Size(), 5);
+
+  DeadlineTask deadline_task;
+  vector<Timestamp> deadlines;
+  while (queue.TryDequeue(deadline_task)) {
+    deadlines.push_back(deadline_task.deadline);
+    deadline_task.task.Execute();
+  }
+  EXPECT_EQ(deadlines, (vector<Timestamp>{100, 100, 100, 200, 300}));
+  EXPECT_EQ(ids, (vector<int>{2, 4, 5, 3, 1}));
+  EXPECT_EQ(queue.Size(), 0);
+}
+
+TEST(DeadlineTaskQueueTest, Capacity) {
+  DeadlineTaskQueue queue(2);
+  vector<int> ids;
+  EXPECT_TRUE(queue.TryEnqueue(MakeDeadlineTask(100, 1, ids)));
+  EXPECT_TRUE(queue.TryEnqueue(MakeDeadlineTask(200, 2, ids)));
+
+  // The rejected task is left untouched.
+  auto deadline_task = MakeDeadlineTask(50, 3, ids);
+  EXPECT_FALSE(queue.TryEnqueue(std::move(deadline_task)));
+  deadline_task.task.Execute();
+  EXPECT_EQ(ids, (vector<int>{3}));
+
+  EXPECT_TRUE(queue.TryDequeue(deadline_task));
+  EXPECT_EQ(deadline_task.deadline, 100);
+  EXPECT_TRUE(queue.TryEnqueue(MakeDeadlineTask(300, 4, ids)));
+  EXPECT_EQ(queue.Size(), 2);
+}
+
+TEST(DeadlineTaskQueueTest, ExpiredTasksAreSetAside) {
+  DeadlineTaskQueue queue(10);
+  vector<int> ids;
+  EXPECT_TRUE(queue.TryEnqueue(MakeDeadlineTask(100, 1, ids)));
+  EXPECT_TRUE(queue.TryEnqueue(MakeDeadlineTask(200, 2, ids)));
+  EXPECT_TRUE(queue.TryEnqueue(MakeDeadlineTask(300, 3, ids)));
+
+  DeadlineTask deadline_task;
+  EXPECT_TRUE(queue.TryDequeueUnexpired(deadline_task, 250));
+  EXPECT_EQ(deadline_task.deadline, 300);
+  EXPECT_EQ(queue.Size(), 0);
+  EXPECT_EQ(queue.GetExpiredCount(), 2);
+  EXPECT_EQ(queue.GetSizeWithExpired(), 2);
+  EXPECT_FALSE(queue.TryDequeueUnexpired(deadline_task, 250));
+
+  vector<DeadlineTask> expired_tasks;
+  queue.TakeExpired(expired_tasks);
+  ASSERT_EQ(expired_tasks.size(), 2);
+  EXPECT_EQ(expired_tasks[0].deadline, 100);
+  EXPECT_EQ(expired_tasks[1].deadline, 200);
+  EXPECT_EQ(queue.GetExpiredCount(), 0);
+  EXPECT_EQ(queue.GetSizeWithExpired(), 0);
+}
+
+TEST(DeadlineTaskQueueTest, ConcurrentEnqueueAndDequeue) {
+  DeadlineTaskQueue queue(100000);
+  constexpr int kTaskCountPerThread = 10000;
+  atomic<int> executed_count(0);
+  vector<thread> threads;
+  for (int i = 0; i < 4; i++) {
+    threads.emplace_back([&, i]() {
+      for (int j = 0; j < kTaskCountPerThread; j++) {
+        EXPECT_TRUE(queue.TryEnqueue(DeadlineTask{
+            AsyncTask([&]() { executed_count++; }),
+            static_cast<Timestamp>(j * 4 + i)}));
+      }
+    });
+  }
+  for (int i = 0; i < 4; i++) {
+    threads.emplace_back([&]() {
+      DeadlineTask deadline_task;
+      while (executed_count < 4 * kTaskCountPerThread) {
+        if (queue.TryDequeue(deadline_task)) {
+          deadline_task.task.Execute();
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(executed_count, 4 * kTaskCountPerThread);
+  EXPECT_EQ(queue.Size(), 0);
+}
+}  // namespace google::scp::core::test
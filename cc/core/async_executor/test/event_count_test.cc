@@ -0,0 +1,117 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "core/async_executor/src/event_count.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using std::atomic;
+using std::thread;
+using std::chrono::hours;
+using std::chrono::milliseconds;
+using std::chrono::steady_clock;
+
+namespace google::scp::core::test {
+TEST(EventCountTest, NotifyWithoutWaiters) {
+  EventCount event_count;
+  event_count.NotifyOne();
+  event_count.NotifyAll();
+
+  // A notification without waiters does not wake up later waiters.
+  auto key = event_count.PrepareWait();
+  auto start = steady_clock::now();
+  event_count.Wait(key, milliseconds(20));
+  EXPECT_GE(steady_clock::now() - start, milliseconds(20));
+}
+
+TEST(EventCountTest, CancelWait) {
+  EventCount event_count;
+  auto key = event_count.PrepareWait();
+  event_count.CancelWait();
+  event_count.NotifyOne();
+
+  // The cancelled wait is not counted as a waiter, so the epoch is unchanged.
+  EXPECT_EQ(event_count.PrepareWait(), key);
+  event_count.CancelWait();
+}
+
+TEST(EventCountTest, NotifyBetweenPrepareAndWaitIsNotLost) {
+  EventCount event_count;
+  auto key = event_count.PrepareWait();
+  event_count.NotifyOne();
+
+  auto start = steady_clock::now();
+  event_count.Wait(key, hours(1));
+  EXPECT_LT(steady_clock::now() - start, hours(1));
+}
+
+TEST(EventCountTest, NotifyWakesUpWaiter) {
+  EventCount event_count;
+  atomic<bool> condition(false);
+  atomic<bool> woken_up(false);
+
+  thread waiter([&]() {
+    while (!condition) {
+      auto key = event_count.PrepareWait();
+      if (condition) {
+        event_count.CancelWait();
+        break;
+      }
+      event_count.Wait(key, hours(1));
+    }
+    woken_up = true;
+  });
+
+  std::this_thread::sleep_for(milliseconds(20));
+  EXPECT_FALSE(woken_up);
+  condition = true;
+  event_count.NotifyOne();
+  waiter.join();
+  EXPECT_TRUE(woken_up);
+}
+
+TEST(EventCountTest, ProducerConsumer) {
+  EventCount event_count;
+  atomic<size_t> produced(0);
+  size_t consumed = 0;
+  constexpr size_t kItemCount = 100000;
+
+  thread consumer([&]() {
+    while (consumed < kItemCount) {
+      if (produced > consumed) {
+        consumed++;
+        continue;
+      }
+      auto key = event_count.PrepareWait();
+      if (produced > consumed) {
+        event_count.CancelWait();
+        continue;
+      }
+      // Without a notification, the consumer would block for the whole test.
+      event_count.Wait(key, hours(1));
+    }
+  });
+
+  for (size_t i = 0; i < kItemCount; i++) {
+    produced++;
+    event_count.NotifyOne();
+  }
+  consumer.join();
+  EXPECT_EQ(consumed, kItemCount);
+}
+}  // namespace google::scp::core::test
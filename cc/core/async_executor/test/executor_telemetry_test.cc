@@ -0,0 +1,132 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "core/async_executor/src/executor_telemetry.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+using std::chrono::hours;
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+using std::chrono::nanoseconds;
+
+namespace google::scp::core::test {
+TEST(LatencyHistogramTest, EmptyHistogram) {
+  LatencyHistogram histogram;
+  auto snapshot = histogram.GetSnapshot();
+  EXPECT_EQ(snapshot.bucket_counts.size(), LatencyHistogram::kBucketCount);
+  EXPECT_EQ(snapshot.count, 0);
+  EXPECT_EQ(snapshot.sum_ns, 0);
+  EXPECT_EQ(snapshot.GetPercentileUpperBound(0.5), nanoseconds(0));
+}
+
+TEST(LatencyHistogramTest, Buckets) {
+  LatencyHistogram histogram;
+  histogram.Record(nanoseconds(500));
+  histogram.Record(microseconds(1));
+  histogram.Record(microseconds(3));
+  histogram.Record(microseconds(4));
+  histogram.Record(nanoseconds(-1));
+  histogram.Record(hours(24 * 365));
+
+  auto snapshot = histogram.GetSnapshot();
+  EXPECT_EQ(snapshot.count, 6);
+  // Below 1us, including the negative sample.
+  EXPECT_EQ(snapshot.bucket_counts[0], 2);
+  // [1us, 2us)
+  EXPECT_EQ(snapshot.bucket_counts[1], 1);
+  // [2us, 4us)
+  EXPECT_EQ(snapshot.bucket_counts[2], 1);
+  // [4us, 8us)
+  EXPECT_EQ(snapshot.bucket_counts[3], 1);
+  // Everything above the range lands in the last bucket.
+  EXPECT_EQ(snapshot.bucket_counts[LatencyHistogram::kBucketCount - 1], 1);
+
+  EXPECT_EQ(LatencyHistogram::GetBucketUpperBound(0), microseconds(1));
+  EXPECT_EQ(LatencyHistogram::GetBucketUpperBound(3), microseconds(8));
+}
+
+TEST(LatencyHistogramTest, Percentiles) {
+  LatencyHistogram histogram;
+  for (int i = 0; i < 99; i++) {
+    histogram.Record(microseconds(3));
+  }
+  histogram.Record(milliseconds(3));
+
+  auto snapshot = histogram.GetSnapshot();
+  EXPECT_EQ(snapshot.sum_ns, 99 * 3000 + 3000000);
+  EXPECT_EQ(snapshot.GetPercentileUpperBound(0), microseconds(4));
+  EXPECT_EQ(snapshot.GetPercentileUpperBound(0.5), microseconds(4));
+  EXPECT_EQ(snapshot.GetPercentileUpperBound(0.99), microseconds(4));
+  EXPECT_EQ(snapshot.GetPercentileUpperBound(1), microseconds(4096));
+}
+
+TEST(LatencyHistogramTest, Merge) {
+  LatencyHistogram first;
+  first.Record(microseconds(3));
+  LatencyHistogram second;
+  second.Record(microseconds(3));
+  second.Record(microseconds(5));
+
+  LatencyHistogramSnapshot merged;
+  merged.Merge(first.GetSnapshot());
+  merged.Merge(second.GetSnapshot());
+  EXPECT_EQ(merged.count, 3);
+  EXPECT_EQ(merged.sum_ns, 11000);
+  EXPECT_EQ(merged.bucket_counts[2], 2);
+  EXPECT_EQ(merged.bucket_counts[3], 1);
+}
+
+TEST(TaskExecutorTelemetryTest, ShouldSample) {
+  TaskExecutorTelemetry disabled_telemetry;
+  TaskExecutorTelemetry full_telemetry(/*sample_interval=*/1);
+  TaskExecutorTelemetry sampled_telemetry(/*sample_interval=*/4);
+  size_t full_count = 0;
+  size_t sampled_count = 0;
+  for (int i = 0; i < 16; i++) {
+    EXPECT_FALSE(disabled_telemetry.ShouldSample());
+    full_count += full_telemetry.ShouldSample() ? 1 : 0;
+    sampled_count += sampled_telemetry.ShouldSample() ? 1 : 0;
+  }
+  EXPECT_EQ(full_count, 16);
+  EXPECT_EQ(sampled_count, 4);
+}
+
+TEST(TaskExecutorTelemetryTest, Snapshot) {
+  TaskExecutorTelemetry telemetry;
+  telemetry.RecordQueueWaitTime(microseconds(1));
+  telemetry.RecordRunTime(microseconds(1));
+  telemetry.RecordRunTime(microseconds(1));
+  telemetry.RecordTimerLateness(microseconds(1));
+  telemetry.RecordRejected();
+  telemetry.RecordRejected(2);
+
+  auto snapshot = telemetry.GetSnapshot(/*queue_depth=*/7);
+  EXPECT_EQ(snapshot.queue_depth, 7);
+  EXPECT_EQ(snapshot.rejected_count, 3);
+  EXPECT_EQ(snapshot.queue_wait_time.count, 1);
+  EXPECT_EQ(snapshot.run_time.count, 2);
+  EXPECT_EQ(snapshot.timer_lateness.count, 1);
+
+  AsyncExecutorTelemetrySnapshot executor_snapshot;
+  executor_snapshot.normal_executors.push_back(snapshot);
+  executor_snapshot.urgent_executors.push_back(snapshot);
+  auto total = executor_snapshot.GetTotal();
+  EXPECT_EQ(total.queue_depth, 14);
+  EXPECT_EQ(total.rejected_count, 6);
+  EXPECT_EQ(total.run_time.count, 4);
+}
+}  // namespace google::scp::core::test
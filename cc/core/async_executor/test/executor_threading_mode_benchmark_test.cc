@@ -0,0 +1,148 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "core/async_executor/src/async_executor.h"
+#include "public/core/test/interface/execution_result_matchers.h"
+
+using std::atomic;
+using std::make_shared;
+using std::sort;
+using std::vector;
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+using std::chrono::nanoseconds;
+using std::chrono::steady_clock;
+
+namespace google::scp::core::test {
+static constexpr size_t kTasksPerIteration = 1000;
+/// Every fourth task is a timed task, due this long after it is scheduled.
+static constexpr microseconds kTimedTaskDelay = microseconds(100);
+/// The interval between two scheduled tasks.
+static constexpr microseconds kScheduleInterval = microseconds(20);
+
+/// Returns the number of context switches of the process so far.
+static uint64_t GetContextSwitchCount() {
+  rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_nvcsw + usage.ru_nivcsw;
+}
+
+/// Returns the given percentile of the sorted latencies in microseconds.
+static double GetPercentileUs(const vector<nanoseconds>& latencies,
+                              double percentile) {
+  auto index = static_cast<size_t>(percentile * (latencies.size() - 1));
+  return duration_cast<nanoseconds>(latencies[index]).count() / 1000.0;
+}
+
+/**
+ * @brief Schedules a mix of normal, high priority and timed tasks on
+ * state.range(0) threads, and measures how late the tasks start: the normal
+ * and high priority tasks relative to when they were scheduled, and the timed
+ * tasks relative to their execution timestamp.
+ */
+static void BenchmarkMixedWorkload(benchmark::State& state,
+                                   ExecutorThreadingMode threading_mode) {
+  auto async_executor = make_shared<AsyncExecutor>(
+      AsyncExecutorOptions{.thread_count = static_cast<size_t>(state.range(0)),
+                           .queue_cap = 100000,
+                           .threading_mode = threading_mode});
+  EXPECT_SUCCESS(async_executor->Init());
+  EXPECT_SUCCESS(async_executor->Run());
+
+  vector<nanoseconds> queued_latencies;
+  vector<nanoseconds> timed_latencies;
+  vector<nanoseconds> iteration_latencies(kTasksPerIteration);
+  auto context_switch_count_before = GetContextSwitchCount();
+  for (auto _ : state) {
+    atomic<size_t> task_completion_counter = 0;
+    for (size_t i = 0; i < kTasksPerIteration; i++) {
+      bool is_timed = i % 4 == 3;
+      // The time the task is expected to start at.
+      auto start_time = steady_clock::now();
+      if (is_timed) {
+        start_time += kTimedTaskDelay;
+      }
+      auto work = [&iteration_latencies, &task_completion_counter, start_time,
+                   i]() {
+        iteration_latencies[i] = steady_clock::now() - start_time;
+        task_completion_counter++;
+      };
+      if (is_timed) {
+        EXPECT_SUCCESS(async_executor->ScheduleFor(
+            work, duration_cast<nanoseconds>(start_time.time_since_epoch())
+                      .count()));
+      } else {
+        EXPECT_SUCCESS(async_executor->Schedule(
+            work, i % 4 == 0 ? AsyncPriority::High : AsyncPriority::Normal));
+      }
+      std::this_thread::sleep_for(kScheduleInterval);
+    }
+    while (task_completion_counter < kTasksPerIteration) {}
+    for (size_t i = 0; i < kTasksPerIteration; i++) {
+      (i % 4 == 3 ? timed_latencies : queued_latencies)
+          .push_back(iteration_latencies[i]);
+    }
+  }
+  auto context_switch_count =
+      GetContextSwitchCount() - context_switch_count_before;
+  EXPECT_SUCCESS(async_executor->Stop());
+
+  sort(queued_latencies.begin(), queued_latencies.end());
+  sort(timed_latencies.begin(), timed_latencies.end());
+  state.counters["queued_p50_us"] = GetPercentileUs(queued_latencies, 0.5);
+  state.counters["queued_p99_us"] = GetPercentileUs(queued_latencies, 0.99);
+  state.counters["timed_p50_us"] = GetPercentileUs(timed_latencies, 0.5);
+  state.counters["timed_p99_us"] = GetPercentileUs(timed_latencies, 0.99);
+  state.counters["ctx_switches_per_task"] =
+      static_cast<double>(context_switch_count) /
+      (state.iterations() * kTasksPerIteration);
+  state.SetItemsProcessed(state.iterations() * kTasksPerIteration);
+}
+
+static void BM_MixedWorkloadThreadPerExecutor(benchmark::State& state) {
+  BenchmarkMixedWorkload(state, ExecutorThreadingMode::ThreadPerExecutor);
+}
+
+static void BM_MixedWorkloadSingleThreadPerCore(benchmark::State& state) {
+  BenchmarkMixedWorkload(state, ExecutorThreadingMode::SingleThreadPerCore);
+}
+}  // namespace google::scp::core::test
+
+// Arg<Thread count>
+BENCHMARK(google::scp::core::test::BM_MixedWorkloadThreadPerExecutor)
+    ->Arg(1)
+    ->Arg(4)
+    ->Iterations(10)
+    ->Unit(benchmark::kMillisecond);
+
+// Arg<Thread count>
+BENCHMARK(google::scp::core::test::BM_MixedWorkloadSingleThreadPerCore)
+    ->Arg(1)
+    ->Arg(4)
+    ->Iterations(10)
+    ->Unit(benchmark::kMillisecond);
+
+// Run the benchmark
+BENCHMARK_MAIN();
@@ -0,0 +1,90 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "core/async_executor/src/shared_object_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using std::atomic;
+using std::make_unique;
+using std::move;
+using std::shared_ptr;
+using std::string;
+using std::thread;
+using std::vector;
+
+namespace google::scp::core::test {
+TEST(SharedObjectPoolTest, ReusesTheBlocksOfReleasedObjects) {
+  SharedObjectPool<string> pool(/*max_free_block_count=*/10);
+  auto object = pool.MakeShared("first");
+  EXPECT_EQ(*object, "first");
+  auto* block = object.get();
+  EXPECT_EQ(pool.GetFreeBlockCount(), 0);
+
+  object.reset();
+  EXPECT_EQ(pool.GetFreeBlockCount(), 1);
+
+  object = pool.MakeShared("second");
+  EXPECT_EQ(*object, "second");
+  EXPECT_EQ(object.get(), block);
+  EXPECT_EQ(pool.GetFreeBlockCount(), 0);
+}
+
+TEST(SharedObjectPoolTest, KeepsUpToTheMaxFreeBlockCount) {
+  SharedObjectPool<string> pool(/*max_free_block_count=*/2);
+  vector<shared_ptr<string>> objects;
+  for (auto i = 0; i < 5; i++) {
+    objects.push_back(pool.MakeShared());
+  }
+  objects.clear();
+  EXPECT_EQ(pool.GetFreeBlockCount(), 2);
+}
+
+TEST(SharedObjectPoolTest, ObjectsCanOutliveThePool) {
+  auto pool = make_unique<SharedObjectPool<string>>(
+      /*max_free_block_count=*/10);
+  auto object = pool->MakeShared("object");
+  pool.reset();
+  EXPECT_EQ(*object, "object");
+  object.reset();
+}
+
+TEST(SharedObjectPoolTest, ObjectsCanBeReleasedOnAnyThread) {
+  SharedObjectPool<string> pool(/*max_free_block_count=*/100);
+  atomic<size_t> released_count(0);
+  vector<thread> threads;
+  for (auto i = 0; i < 4; i++) {
+    threads.emplace_back([&]() {
+      for (auto j = 0; j < 1000; j++) {
+        auto object = pool.MakeShared("object");
+        thread([object = move(object), &released_count]() mutable {
+          object.reset();
+          released_count++;
+        }).join();
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(released_count, 4000);
+  EXPECT_LE(pool.GetFreeBlockCount(), 4);
+}
+}  // namespace google::scp::core::test
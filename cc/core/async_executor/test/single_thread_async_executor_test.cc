@@ -18,8 +18,10 @@
 
 #include <algorithm>
 #include <chrono>
+#include <mutex>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include "core/async_executor/mock/mock_async_executor_with_internals.h"
 #include "core/async_executor/src/error_codes.h"
@@ -36,8 +38,10 @@ using google::scp::core::common::TimeProvider;
 using std::atomic;
 using std::make_shared;
 using std::string;
+using std::vector;
 using std::chrono::duration_cast;
 using std::chrono::high_resolution_clock;
+using std::chrono::milliseconds;
 using std::chrono::nanoseconds;
 using std::chrono::seconds;
 using testing::Values;
@@ -193,6 +197,123 @@ INSTANTIATE_TEST_SUITE_P(SingleThreadAsyncExecutorTests, AffinityTest,
                          Values(0, 1, std::thread::hardware_concurrency() - 1,
                                 std::thread::hardware_concurrency()));
 
+TEST(SingleThreadAsyncExecutorTests, CountMovedWork) {
+  int queue_cap = 10;
+  SingleThreadAsyncExecutor executor(queue_cap);
+  EXPECT_SUCCESS(executor.Init());
+  EXPECT_SUCCESS(executor.Run());
+  {
+    atomic<int> count(0);
+    auto captured_string = make_shared<string>("captured");
+    for (int i = 0; i < queue_cap; i++) {
+      AsyncOperation work = [&count, captured_string]() {
+        EXPECT_EQ(*captured_string, "captured");
+        count++;
+      };
+      EXPECT_SUCCESS(executor.Schedule(std::move(work),
+                                       i % 2 == 0 ? AsyncPriority::Normal
+                                                  : AsyncPriority::High));
+    }
+    WaitUntil([&]() { return count == queue_cap; });
+    EXPECT_EQ(count, queue_cap);
+    // All the tasks, and the captured state with them, are released.
+    WaitUntil([&]() { return captured_string.use_count() == 1; });
+  }
+  EXPECT_SUCCESS(executor.Stop());
+}
+
+TEST(SingleThreadAsyncExecutorTests, RetireRunsPendingTasksAndRunsAgain) {
+  int queue_cap = 10;
+  SingleThreadAsyncExecutor executor(queue_cap, /*drop_tasks_on_stop=*/true);
+  EXPECT_SUCCESS(executor.Init());
+  EXPECT_SUCCESS(executor.Run());
+
+  atomic<int> count(0);
+  for (int i = 0; i < queue_cap; i++) {
+    EXPECT_SUCCESS(
+        executor.Schedule([&]() { count++; }, AsyncPriority::Normal));
+  }
+  // The pending tasks are executed regardless of drop_tasks_on_stop.
+  EXPECT_SUCCESS(executor.Retire());
+  EXPECT_EQ(count, queue_cap);
+  EXPECT_EQ(executor.GetPendingTaskCount(), 0);
+
+  // Rejected work is not moved from.
+  AsyncOperation work = [&]() { count++; };
+  EXPECT_THAT(
+      executor.Schedule(std::move(work), AsyncPriority::Normal),
+      ResultIs(FailureExecutionResult(errors::SC_ASYNC_EXECUTOR_NOT_RUNNING)));
+  EXPECT_TRUE(work);
+
+  EXPECT_SUCCESS(executor.Run());
+  EXPECT_SUCCESS(executor.Schedule(std::move(work), AsyncPriority::High));
+  WaitUntil([&]() { return count == queue_cap + 1; });
+  EXPECT_SUCCESS(executor.Stop());
+}
+
+TEST(SingleThreadAsyncExecutorTests, CountBatchWork) {
+  int queue_cap = 10;
+  SingleThreadAsyncExecutor executor(queue_cap);
+  EXPECT_SUCCESS(executor.Init());
+  EXPECT_SUCCESS(executor.Run());
+  {
+    atomic<int> count(0);
+    for (auto priority : {AsyncPriority::Normal, AsyncPriority::High}) {
+      vector<AsyncOperation> works(queue_cap, [&]() { count++; });
+      size_t scheduled_count = 0;
+      EXPECT_SUCCESS(executor.ScheduleBatch(works.begin(), works.end(),
+                                            priority, scheduled_count));
+      EXPECT_EQ(scheduled_count, queue_cap);
+    }
+    WaitUntil([&]() { return count == 2 * queue_cap; });
+    EXPECT_EQ(count, 2 * queue_cap);
+  }
+  EXPECT_SUCCESS(executor.Stop());
+}
+
+TEST(SingleThreadAsyncExecutorTests, ExceedingQueueCapScheduleBatch) {
+  int queue_cap = 2;
+  SingleThreadAsyncExecutor executor(queue_cap);
+  EXPECT_SUCCESS(executor.Init());
+  EXPECT_SUCCESS(executor.Run());
+  {
+    // Block the worker so that the queue does not drain.
+    atomic<bool> blocking_task_started(false);
+    atomic<bool> release_blocking_task(false);
+    EXPECT_SUCCESS(executor.Schedule(
+        [&]() {
+          blocking_task_started = true;
+          while (!release_blocking_task) {
+            std::this_thread::yield();
+          }
+        },
+        AsyncPriority::Normal));
+    WaitUntil([&]() { return blocking_task_started.load(); });
+
+    atomic<int> count(0);
+    vector<AsyncOperation> works(5, [&]() { count++; });
+    size_t scheduled_count = 0;
+    EXPECT_THAT(executor.ScheduleBatch(works.begin(), works.end(),
+                                       AsyncPriority::Normal, scheduled_count),
+                ResultIs(RetryExecutionResult(
+                    errors::SC_ASYNC_EXECUTOR_EXCEEDING_QUEUE_CAP)));
+    EXPECT_EQ(scheduled_count, queue_cap);
+    // The operations that did not fit are left untouched.
+    for (size_t i = scheduled_count; i < works.size(); i++) {
+      EXPECT_TRUE(works[i]);
+    }
+
+    auto telemetry = executor.GetTelemetrySnapshot();
+    EXPECT_EQ(telemetry.queue_depth, queue_cap);
+    EXPECT_EQ(telemetry.rejected_count, works.size() - scheduled_count);
+
+    release_blocking_task = true;
+    WaitUntil([&]() { return count == queue_cap; });
+    EXPECT_EQ(count, queue_cap);
+  }
+  EXPECT_SUCCESS(executor.Stop());
+}
+
 TEST(SingleThreadAsyncExecutorTests, CannotScheduleHiPri) {
   int queue_cap = 50;
   SingleThreadAsyncExecutor executor(queue_cap);
@@ -223,6 +344,258 @@ TEST(SingleThreadAsyncExecutorTests, CountWorkMultipleThread) {
   EXPECT_EQ(count, queue_cap);
 }
 
+TEST(SingleThreadAsyncExecutorTests, CountWorkSpinThenPark) {
+  int queue_cap = 10;
+  SingleThreadAsyncExecutor executor(queue_cap, /*drop_tasks_on_stop=*/false,
+                                     /*affinity_cpu_number=*/{},
+                                     WorkerIdleStrategy::SpinThenPark);
+  EXPECT_SUCCESS(executor.Init());
+  EXPECT_SUCCESS(executor.Run());
+
+  atomic<int> count(0);
+  for (int round = 1; round <= 3; round++) {
+    for (int i = 0; i < queue_cap / 2; i++) {
+      EXPECT_SUCCESS(
+          executor.Schedule([&]() { count++; }, AsyncPriority::Normal));
+      EXPECT_SUCCESS(
+          executor.Schedule([&]() { count++; }, AsyncPriority::High));
+    }
+    WaitUntil([&]() { return count == round * queue_cap; });
+    // Gives the worker time to go from spinning to parked.
+    std::this_thread::sleep_for(milliseconds(20));
+  }
+  EXPECT_EQ(count, 3 * queue_cap);
+
+  vector<AsyncOperation> works(queue_cap, [&]() { count++; });
+  size_t scheduled_count = 0;
+  EXPECT_SUCCESS(executor.ScheduleBatch(
+      works.begin(), works.end(), AsyncPriority::Normal, scheduled_count));
+  WaitUntil([&]() { return count == 4 * queue_cap; });
+
+  EXPECT_SUCCESS(executor.Stop());
+}
+
+TEST(SingleThreadAsyncExecutorTests, FinishWorkWhenStopInMiddleSpinThenPark) {
+  int queue_cap = 5;
+  SingleThreadAsyncExecutor executor(queue_cap, /*drop_tasks_on_stop=*/false,
+                                     /*affinity_cpu_number=*/{},
+                                     WorkerIdleStrategy::SpinThenPark);
+  EXPECT_SUCCESS(executor.Init());
+  EXPECT_SUCCESS(executor.Run());
+
+  atomic<int> count(0);
+  for (int i = 0; i < queue_cap; i++) {
+    EXPECT_SUCCESS(executor.Schedule(
+        [&]() {
+          std::this_thread::sleep_for(milliseconds(10));
+          count++;
+        },
+        AsyncPriority::Normal));
+  }
+  EXPECT_SUCCESS(executor.Stop());
+  EXPECT_EQ(count, queue_cap);
+}
+
+TEST(SingleThreadAsyncExecutorTests, Telemetry) {
+  int queue_cap = 10;
+  SingleThreadAsyncExecutor executor(
+      queue_cap, /*drop_tasks_on_stop=*/false, /*affinity_cpu_number=*/{},
+      WorkerIdleStrategy::Block, TaskQueueBackend::ConcurrentQueue,
+      /*telemetry_sample_interval=*/1);
+  EXPECT_SUCCESS(executor.Init());
+  EXPECT_SUCCESS(executor.Run());
+
+  atomic<int> count(0);
+  for (int i = 0; i < queue_cap; i++) {
+    EXPECT_SUCCESS(executor.Schedule(
+        [&]() {
+          std::this_thread::sleep_for(milliseconds(2));
+          count++;
+        },
+        AsyncPriority::Normal));
+  }
+  WaitUntil([&]() { return count == queue_cap; });
+  EXPECT_SUCCESS(executor.Stop());
+
+  auto telemetry = executor.GetTelemetrySnapshot();
+  EXPECT_EQ(telemetry.queue_depth, 0);
+  EXPECT_EQ(telemetry.rejected_count, 0);
+  EXPECT_EQ(telemetry.run_time.count, queue_cap);
+  EXPECT_GE(telemetry.run_time.sum_ns, nanoseconds(milliseconds(2)).count() *
+                                           queue_cap);
+  EXPECT_GE(telemetry.run_time.GetPercentileUpperBound(0.5), milliseconds(2));
+  // The last task waited for all the others to run.
+  EXPECT_EQ(telemetry.queue_wait_time.count, queue_cap);
+  EXPECT_GE(telemetry.queue_wait_time.GetPercentileUpperBound(1),
+            milliseconds(2 * (queue_cap - 1)));
+  EXPECT_EQ(telemetry.timer_lateness.count, 0);
+}
+
+TEST(SingleThreadAsyncExecutorTests, ScheduleWithDeadlineEarliestFirst) {
+  int queue_cap = 10;
+  SingleThreadAsyncExecutor executor(queue_cap);
+  EXPECT_SUCCESS(executor.Init());
+  EXPECT_SUCCESS(executor.Run());
+
+  // Keeps the worker busy until all the tasks are queued.
+  atomic<bool> blocking_task_started(false);
+  atomic<bool> release_blocking_task(false);
+  EXPECT_SUCCESS(executor.Schedule(
+      [&]() {
+        blocking_task_started = true;
+        while (!release_blocking_task) {
+          std::this_thread::yield();
+        }
+      },
+      AsyncPriority::Normal));
+  WaitUntil([&]() { return blocking_task_started.load(); });
+
+  std::mutex order_mutex;
+  vector<string> order;
+  auto record = [&](const string& name) {
+    return [&, name]() {
+      std::unique_lock<std::mutex> lock(order_mutex);
+      order.push_back(name);
+    };
+  };
+  TaskExpirationCallback expiration_callback =
+      [](const ExecutionResult&) { ADD_FAILURE(); };
+  auto now = TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks();
+  auto second = nanoseconds(seconds(1)).count();
+  EXPECT_SUCCESS(executor.Schedule(record("normal"), AsyncPriority::Normal));
+  EXPECT_SUCCESS(executor.ScheduleWithDeadline(record("normal_3s"),
+                                               AsyncPriority::Normal,
+                                               now + 3 * second,
+                                               expiration_callback));
+  EXPECT_SUCCESS(executor.ScheduleWithDeadline(
+      record("normal_1s"), AsyncPriority::Normal, now + second,
+      expiration_callback));
+  EXPECT_SUCCESS(executor.ScheduleWithDeadline(record("normal_2s"),
+                                               AsyncPriority::Normal,
+                                               now + 2 * second,
+                                               expiration_callback));
+  EXPECT_SUCCESS(executor.Schedule(record("high"), AsyncPriority::High));
+  EXPECT_SUCCESS(executor.ScheduleWithDeadline(record("high_3s"),
+                                               AsyncPriority::High,
+                                               now + 3 * second,
+                                               expiration_callback));
+  EXPECT_EQ(executor.GetPendingTaskCount(), 6);
+
+  release_blocking_task = true;
+  WaitUntil([&]() { return executor.GetPendingTaskCount() == 0; });
+  EXPECT_SUCCESS(executor.Stop());
+  EXPECT_EQ(order, (vector<string>{"high_3s", "high", "normal_1s", "normal_2s",
+                                   "normal_3s", "normal"}));
+}
+
+TEST(SingleThreadAsyncExecutorTests, DeadlineTasksDoNotStarveOtherTasks) {
+  int queue_cap = 10;
+  SingleThreadAsyncExecutor executor(queue_cap);
+  EXPECT_SUCCESS(executor.Init());
+  EXPECT_SUCCESS(executor.Run());
+
+  atomic<bool> blocking_task_started(false);
+  atomic<bool> release_blocking_task(false);
+  EXPECT_SUCCESS(executor.Schedule(
+      [&]() {
+        blocking_task_started = true;
+        while (!release_blocking_task) {
+          std::this_thread::yield();
+        }
+      },
+      AsyncPriority::Normal));
+  WaitUntil([&]() { return blocking_task_started.load(); });
+
+  std::mutex order_mutex;
+  string order;
+  auto record = [&](char name) {
+    return [&, name]() {
+      std::unique_lock<std::mutex> lock(order_mutex);
+      order.push_back(name);
+    };
+  };
+  auto deadline = TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks() +
+                  nanoseconds(seconds(10)).count();
+  for (size_t i = 0; i < 2 * kMaxConsecutiveDeadlineTasks; i++) {
+    EXPECT_SUCCESS(executor.ScheduleWithDeadline(
+        record('d'), AsyncPriority::Normal, deadline,
+        [](const ExecutionResult&) { ADD_FAILURE(); }));
+  }
+  EXPECT_SUCCESS(executor.Schedule(record('n'), AsyncPriority::Normal));
+  EXPECT_SUCCESS(executor.Schedule(record('n'), AsyncPriority::Normal));
+
+  release_blocking_task = true;
+  WaitUntil([&]() { return executor.GetPendingTaskCount() == 0; });
+  EXPECT_SUCCESS(executor.Stop());
+  string deadline_tasks(kMaxConsecutiveDeadlineTasks, 'd');
+  EXPECT_EQ(order, deadline_tasks + "n" + deadline_tasks + "n");
+}
+
+TEST(SingleThreadAsyncExecutorTests, ScheduleWithDeadlineDropsExpiredTasks) {
+  int queue_cap = 10;
+  SingleThreadAsyncExecutor executor(
+      queue_cap, /*drop_tasks_on_stop=*/false, /*affinity_cpu_number=*/{},
+      WorkerIdleStrategy::Block, TaskQueueBackend::ConcurrentQueue,
+      /*telemetry_sample_interval=*/1);
+  EXPECT_SUCCESS(executor.Init());
+  EXPECT_SUCCESS(executor.Run());
+
+  atomic<bool> blocking_task_started(false);
+  atomic<bool> release_blocking_task(false);
+  EXPECT_SUCCESS(executor.Schedule(
+      [&]() {
+        blocking_task_started = true;
+        while (!release_blocking_task) {
+          std::this_thread::yield();
+        }
+      },
+      AsyncPriority::Normal));
+  WaitUntil([&]() { return blocking_task_started.load(); });
+
+  // The deadline passes while the task waits behind the blocking task.
+  atomic<int> executed_count(0);
+  atomic<int> expired_count(0);
+  auto deadline = TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks() +
+                  nanoseconds(milliseconds(10)).count();
+  EXPECT_SUCCESS(executor.ScheduleWithDeadline(
+      [&]() { executed_count++; }, AsyncPriority::Normal, deadline,
+      [&](const ExecutionResult& result) {
+        EXPECT_THAT(result,
+                    ResultIs(FailureExecutionResult(
+                        errors::SC_ASYNC_EXECUTOR_TASK_DEADLINE_EXCEEDED)));
+        expired_count++;
+      }));
+  std::this_thread::sleep_for(milliseconds(20));
+  release_blocking_task = true;
+  WaitUntil([&]() { return expired_count == 1; });
+  EXPECT_SUCCESS(executor.Stop());
+
+  EXPECT_EQ(executed_count, 0);
+  auto telemetry = executor.GetTelemetrySnapshot();
+  EXPECT_EQ(telemetry.expired_count, 1);
+  // Only the blocking task ran.
+  EXPECT_EQ(telemetry.run_time.count, 1);
+}
+
+TEST(SingleThreadAsyncExecutorTests, ScheduleWithPassedDeadline) {
+  SingleThreadAsyncExecutor executor(10);
+  EXPECT_SUCCESS(executor.Init());
+  EXPECT_SUCCESS(executor.Run());
+
+  // The task is rejected up front, without calling the expiration callback.
+  AsyncOperation work = []() { ADD_FAILURE(); };
+  EXPECT_THAT(
+      executor.ScheduleWithDeadline(
+          std::move(work), AsyncPriority::Normal,
+          TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks(),
+          [](const ExecutionResult&) { ADD_FAILURE(); }),
+      ResultIs(FailureExecutionResult(
+          errors::SC_ASYNC_EXECUTOR_TASK_DEADLINE_EXCEEDED)));
+  EXPECT_TRUE(work);
+  EXPECT_EQ(executor.GetPendingTaskCount(), 0);
+  EXPECT_SUCCESS(executor.Stop());
+}
+
 TEST(SingleThreadAsyncExecutorTests, AsyncContextCallback) {
   SingleThreadAsyncExecutor executor(10);
   executor.Init();
@@ -298,4 +671,300 @@ TEST(SingleThreadAsyncExecutorTests, FinishWorkWhenStopInMiddle) {
 
   EXPECT_EQ(medium_count + normal_count, queue_cap);
 }
+
+TEST(SingleThreadAsyncExecutorTests, IdleExecutorStealsWorkFromBusyPeer) {
+  SingleThreadAsyncExecutor busy_executor(10);
+  SingleThreadAsyncExecutor idle_executor(10);
+  EXPECT_SUCCESS(busy_executor.Init());
+  EXPECT_SUCCESS(idle_executor.Init());
+  busy_executor.SetWorkStealingPeers({&idle_executor});
+  idle_executor.SetWorkStealingPeers({&busy_executor});
+  EXPECT_SUCCESS(busy_executor.Run());
+  EXPECT_SUCCESS(idle_executor.Run());
+
+  // Block the busy executor until the queued tasks are done.
+  atomic<bool> blocking_task_started(false);
+  atomic<bool> release_blocking_task(false);
+  EXPECT_SUCCESS(busy_executor.Schedule(
+      [&]() {
+        blocking_task_started = true;
+        while (!release_blocking_task) {
+          std::this_thread::yield();
+        }
+      },
+      AsyncPriority::Normal));
+  WaitUntil([&]() { return blocking_task_started.load(); });
+
+  atomic<int> count(0);
+  auto idle_thread_id = *idle_executor.GetThreadId();
+  for (int i = 0; i < 4; i++) {
+    EXPECT_SUCCESS(busy_executor.Schedule(
+        [&]() {
+          EXPECT_EQ(std::this_thread::get_id(), idle_thread_id);
+          count++;
+        },
+        i % 2 == 0 ? AsyncPriority::Normal : AsyncPriority::High));
+  }
+
+  // The queued tasks complete while the busy executor is still blocked.
+  WaitUntil([&]() { return count == 4; });
+  EXPECT_EQ(count, 4);
+  release_blocking_task = true;
+
+  EXPECT_SUCCESS(busy_executor.Stop());
+  EXPECT_SUCCESS(idle_executor.Stop());
+}
+
+TEST(SingleThreadAsyncExecutorTests, NoWorkToStealFromPeer) {
+  SingleThreadAsyncExecutor executor(10);
+  AsyncTask task;
+  // Not initialized yet.
+  EXPECT_FALSE(executor.TryStealTask(task));
+  EXPECT_SUCCESS(executor.Init());
+  EXPECT_FALSE(executor.TryStealTask(task));
+}
+
+TEST(SingleThreadAsyncExecutorTests,
+     CannotInitMpscQueueBackendWithTooBigQueueCap) {
+  SingleThreadAsyncExecutor executor(
+      kMaxMpscQueueCap + 1, /*drop_tasks_on_stop=*/false,
+      /*affinity_cpu_number=*/{}, WorkerIdleStrategy::Block,
+      TaskQueueBackend::MpscQueue);
+  EXPECT_THAT(executor.Init(),
+              ResultIs(FailureExecutionResult(
+                  errors::SC_ASYNC_EXECUTOR_INVALID_QUEUE_CAP)));
+}
+
+TEST(SingleThreadAsyncExecutorTests, CountWorkMpscQueueBackend) {
+  for (auto idle_strategy :
+       {WorkerIdleStrategy::Block, WorkerIdleStrategy::SpinThenPark}) {
+    int queue_cap = 1000;
+    SingleThreadAsyncExecutor executor(
+        queue_cap, /*drop_tasks_on_stop=*/false, /*affinity_cpu_number=*/{},
+        idle_strategy, TaskQueueBackend::MpscQueue);
+    EXPECT_SUCCESS(executor.Init());
+    EXPECT_SUCCESS(executor.Run());
+
+    atomic<int> count(0);
+    vector<std::thread> producers;
+    for (int producer = 0; producer < 4; producer++) {
+      producers.push_back(std::thread([&]() {
+        for (int i = 0; i < queue_cap / 8; i++) {
+          EXPECT_SUCCESS(
+              executor.Schedule([&]() { count++; }, AsyncPriority::Normal));
+          EXPECT_SUCCESS(
+              executor.Schedule([&]() { count++; }, AsyncPriority::High));
+        }
+      }));
+    }
+    for (auto& producer : producers) {
+      producer.join();
+    }
+    WaitUntil([&]() { return count == queue_cap; });
+
+    vector<AsyncOperation> works(queue_cap, [&]() { count++; });
+    size_t scheduled_count = 0;
+    EXPECT_SUCCESS(executor.ScheduleBatch(
+        works.begin(), works.end(), AsyncPriority::Normal, scheduled_count));
+    EXPECT_EQ(scheduled_count, queue_cap);
+    WaitUntil([&]() { return count == 2 * queue_cap; });
+
+    EXPECT_SUCCESS(executor.Stop());
+    EXPECT_EQ(count, 2 * queue_cap);
+  }
+}
+
+TEST(SingleThreadAsyncExecutorTests, DropTasksOnStopMpscQueueBackend) {
+  SingleThreadAsyncExecutor executor(10, /*drop_tasks_on_stop=*/true,
+                                     /*affinity_cpu_number=*/{},
+                                     WorkerIdleStrategy::Block,
+                                     TaskQueueBackend::MpscQueue);
+  EXPECT_SUCCESS(executor.Init());
+  EXPECT_SUCCESS(executor.Run());
+
+  // Blocks the worker until the executor is stopped.
+  atomic<bool> blocking_task_started(false);
+  EXPECT_SUCCESS(executor.Schedule(
+      [&]() {
+        blocking_task_started = true;
+        while (executor.GetThreadId().Successful()) {
+          std::this_thread::yield();
+        }
+      },
+      AsyncPriority::Normal));
+  WaitUntil([&]() { return blocking_task_started.load(); });
+
+  atomic<int> count(0);
+  for (int i = 0; i < 4; i++) {
+    EXPECT_SUCCESS(executor.Schedule(
+        [&]() { count++; },
+        i % 2 == 0 ? AsyncPriority::Normal : AsyncPriority::High));
+  }
+  EXPECT_SUCCESS(executor.Stop());
+
+  EXPECT_EQ(count, 0);
+  EXPECT_EQ(executor.GetPendingTaskCount(), 0);
+}
+
+TEST(SingleThreadAsyncExecutorTests, OnlyDeadlineTasksStolenFromMpscQueue) {
+  SingleThreadAsyncExecutor busy_executor(10, /*drop_tasks_on_stop=*/false,
+                                          /*affinity_cpu_number=*/{},
+                                          WorkerIdleStrategy::Block,
+                                          TaskQueueBackend::MpscQueue);
+  SingleThreadAsyncExecutor idle_executor(10);
+  EXPECT_SUCCESS(busy_executor.Init());
+  EXPECT_SUCCESS(idle_executor.Init());
+  idle_executor.SetWorkStealingPeers({&busy_executor});
+  EXPECT_SUCCESS(busy_executor.Run());
+  EXPECT_SUCCESS(idle_executor.Run());
+
+  atomic<bool> blocking_task_started(false);
+  atomic<bool> release_blocking_task(false);
+  EXPECT_SUCCESS(busy_executor.Schedule(
+      [&]() {
+        blocking_task_started = true;
+        while (!release_blocking_task) {
+          std::this_thread::yield();
+        }
+      },
+      AsyncPriority::Normal));
+  WaitUntil([&]() { return blocking_task_started.load(); });
+
+  auto busy_thread_id = *busy_executor.GetThreadId();
+  auto idle_thread_id = *idle_executor.GetThreadId();
+  atomic<int> count(0);
+  EXPECT_SUCCESS(busy_executor.Schedule(
+      [&]() {
+        EXPECT_EQ(std::this_thread::get_id(), busy_thread_id);
+        count++;
+      },
+      AsyncPriority::Normal));
+  EXPECT_EQ(busy_executor.GetStealableTaskCount(), 0);
+  auto deadline = TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks() +
+                  nanoseconds(seconds(10)).count();
+  EXPECT_SUCCESS(busy_executor.ScheduleWithDeadline(
+      [&]() {
+        EXPECT_EQ(std::this_thread::get_id(), idle_thread_id);
+        count++;
+      },
+      AsyncPriority::Normal, deadline, [](const ExecutionResult&) {}));
+
+  // The task with a deadline completes while the busy executor is blocked.
+  WaitUntil([&]() { return count == 1; });
+  std::this_thread::sleep_for(milliseconds(20));
+  EXPECT_EQ(count, 1);
+  release_blocking_task = true;
+  WaitUntil([&]() { return count == 2; });
+
+  EXPECT_SUCCESS(busy_executor.Stop());
+  EXPECT_SUCCESS(idle_executor.Stop());
+}
+
+TEST(SingleThreadAsyncExecutorTests, ExpirationCallbacksRunOnOwningExecutor) {
+  SingleThreadAsyncExecutor busy_executor(10);
+  SingleThreadAsyncExecutor idle_executor(10);
+  EXPECT_SUCCESS(busy_executor.Init());
+  EXPECT_SUCCESS(idle_executor.Init());
+  idle_executor.SetWorkStealingPeers({&busy_executor});
+  EXPECT_SUCCESS(busy_executor.Run());
+  EXPECT_SUCCESS(idle_executor.Run());
+
+  // The idle executor is kept busy too until the first task expires.
+  atomic<int> blocking_task_started_count(0);
+  atomic<bool> release_blocking_task(false);
+  atomic<bool> release_idle_executor(false);
+  EXPECT_SUCCESS(busy_executor.Schedule(
+      [&]() {
+        blocking_task_started_count++;
+        while (!release_blocking_task) {
+          std::this_thread::yield();
+        }
+      },
+      AsyncPriority::Normal));
+  EXPECT_SUCCESS(idle_executor.Schedule(
+      [&]() {
+        blocking_task_started_count++;
+        while (!release_idle_executor) {
+          std::this_thread::yield();
+        }
+      },
+      AsyncPriority::Normal));
+  WaitUntil([&]() { return blocking_task_started_count == 2; });
+
+  // The idle executor steals the task behind the expired one, and leaves the
+  // expired one to the busy executor.
+  auto busy_thread_id = *busy_executor.GetThreadId();
+  auto now = TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks();
+  atomic<int> executed_count(0);
+  atomic<int> expired_count(0);
+  EXPECT_SUCCESS(busy_executor.ScheduleWithDeadline(
+      [&]() { executed_count++; }, AsyncPriority::Normal,
+      now + nanoseconds(milliseconds(10)).count(),
+      [&](const ExecutionResult&) {
+        EXPECT_EQ(std::this_thread::get_id(), busy_thread_id);
+        expired_count++;
+      }));
+  std::this_thread::sleep_for(milliseconds(20));
+  EXPECT_SUCCESS(busy_executor.ScheduleWithDeadline(
+      [&]() { executed_count++; }, AsyncPriority::Normal,
+      now + nanoseconds(seconds(10)).count(),
+      [](const ExecutionResult&) { ADD_FAILURE(); }));
+  release_idle_executor = true;
+  WaitUntil([&]() { return executed_count == 1; });
+  std::this_thread::sleep_for(milliseconds(20));
+  EXPECT_EQ(expired_count, 0);
+
+  release_blocking_task = true;
+  WaitUntil([&]() { return expired_count == 1; });
+  EXPECT_SUCCESS(busy_executor.Stop());
+  EXPECT_SUCCESS(idle_executor.Stop());
+  EXPECT_EQ(executed_count, 1);
+  EXPECT_EQ(busy_executor.GetTelemetrySnapshot().expired_count, 1);
+}
+
+TEST(SingleThreadAsyncExecutorTests, HostsTimerExecutor) {
+  for (auto idle_strategy :
+       {WorkerIdleStrategy::Block, WorkerIdleStrategy::SpinThenPark}) {
+    SingleThreadPriorityAsyncExecutor timer_executor(10);
+    SingleThreadAsyncExecutor executor(10, /*drop_tasks_on_stop=*/false,
+                                       /*affinity_cpu_number=*/{},
+                                       idle_strategy);
+    EXPECT_SUCCESS(timer_executor.Init());
+    EXPECT_SUCCESS(executor.Init());
+    executor.SetTimerExecutor(&timer_executor);
+    EXPECT_SUCCESS(timer_executor.Run());
+    EXPECT_SUCCESS(executor.Run());
+
+    // The timed tasks run in order on the worker thread of the host, next to
+    // the queued tasks.
+    atomic<int> timer_count(0);
+    atomic<int> normal_count(0);
+    auto thread_id = *executor.GetThreadId();
+    auto now = TimeProvider::GetSteadyTimestampInNanoseconds();
+    for (int i = 2; i >= 0; i--) {
+      EXPECT_SUCCESS(timer_executor.ScheduleFor(
+          [&, i]() {
+            EXPECT_EQ(std::this_thread::get_id(), thread_id);
+            EXPECT_EQ(timer_count++, i);
+          },
+          (now + milliseconds(50 * i)).count()));
+    }
+    EXPECT_SUCCESS(executor.Schedule(
+        [&]() {
+          EXPECT_EQ(std::this_thread::get_id(), thread_id);
+          normal_count++;
+        },
+        AsyncPriority::Normal));
+    WaitUntil([&]() { return timer_count == 3 && normal_count == 1; });
+
+    // A timed task still pending on stop is executed before the host stops.
+    EXPECT_SUCCESS(timer_executor.ScheduleFor(
+        [&]() { timer_count++; },
+        (TimeProvider::GetSteadyTimestampInNanoseconds() + milliseconds(50))
+            .count()));
+    EXPECT_SUCCESS(timer_executor.Stop());
+    EXPECT_SUCCESS(executor.Stop());
+    EXPECT_EQ(timer_count, 4);
+  }
+}
 }  // namespace google::scp::core::test
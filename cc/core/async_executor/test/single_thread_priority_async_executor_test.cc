@@ -38,6 +38,7 @@ using std::atomic;
 using std::function;
 using std::make_shared;
 using std::string;
+using std::vector;
 using std::chrono::duration_cast;
 using std::chrono::hours;
 using std::chrono::milliseconds;
@@ -308,4 +309,233 @@ TEST(SingleThreadPriorityAsyncExecutorTests,
   EXPECT_SUCCESS(executor.Stop());
 }
 
+TEST(SingleThreadPriorityAsyncExecutorTests, CountBatchWork) {
+  int queue_cap = 10;
+  for (auto timer_queue_type : {TimerQueueType::BinaryHeap,
+                                TimerQueueType::HierarchicalTimerWheel}) {
+    SingleThreadPriorityAsyncExecutor executor(
+        queue_cap, /*drop_tasks_on_stop=*/false, /*affinity_cpu_number=*/{},
+        timer_queue_type);
+    EXPECT_SUCCESS(executor.Init());
+    EXPECT_SUCCESS(executor.Run());
+
+    atomic<int> count(0);
+    vector<AsyncOperation> works(queue_cap, [&]() { count++; });
+    size_t scheduled_count = 0;
+    EXPECT_SUCCESS(executor.ScheduleForBatch(works.begin(), works.end(),
+                                             123456, scheduled_count));
+    EXPECT_EQ(scheduled_count, queue_cap);
+    WaitUntil([&]() { return count == queue_cap; }, seconds(30));
+    EXPECT_EQ(count, queue_cap);
+
+    EXPECT_SUCCESS(executor.Stop());
+  }
+}
+
+TEST(SingleThreadPriorityAsyncExecutorTests, ExceedingQueueCapScheduleBatch) {
+  int queue_cap = 3;
+  for (auto timer_queue_type : {TimerQueueType::BinaryHeap,
+                                TimerQueueType::HierarchicalTimerWheel}) {
+    SingleThreadPriorityAsyncExecutor executor(
+        queue_cap, /*drop_tasks_on_stop=*/true, /*affinity_cpu_number=*/{},
+        timer_queue_type);
+    EXPECT_SUCCESS(executor.Init());
+    EXPECT_SUCCESS(executor.Run());
+
+    // The tasks are scheduled far in the future so that the queue stays full.
+    Timestamp timestamp =
+        TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks() +
+        nanoseconds(hours(1)).count();
+    vector<AsyncOperation> works(5, []() {});
+    size_t scheduled_count = 0;
+    EXPECT_THAT(executor.ScheduleForBatch(works.begin(), works.end(),
+                                          timestamp, scheduled_count),
+                ResultIs(RetryExecutionResult(
+                    errors::SC_ASYNC_EXECUTOR_EXCEEDING_QUEUE_CAP)));
+    EXPECT_EQ(scheduled_count, queue_cap);
+    // The operations that did not fit are left untouched.
+    for (size_t i = scheduled_count; i < works.size(); i++) {
+      EXPECT_TRUE(works[i]);
+    }
+
+    auto telemetry = executor.GetTelemetrySnapshot();
+    EXPECT_EQ(telemetry.queue_depth, queue_cap);
+    EXPECT_EQ(telemetry.rejected_count, works.size() - scheduled_count);
+
+    EXPECT_SUCCESS(executor.Stop());
+  }
+}
+
+TEST(SingleThreadPriorityAsyncExecutorTests, Telemetry) {
+  for (auto timer_queue_type : {TimerQueueType::BinaryHeap,
+                                TimerQueueType::HierarchicalTimerWheel}) {
+    SingleThreadPriorityAsyncExecutor executor(
+        10, /*drop_tasks_on_stop=*/false, /*affinity_cpu_number=*/{},
+        timer_queue_type, /*telemetry_sample_interval=*/1);
+    EXPECT_SUCCESS(executor.Init());
+    EXPECT_SUCCESS(executor.Run());
+
+    // The task is due right away but the worker is busy for 10ms.
+    atomic<int> count(0);
+    auto now = TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks();
+    EXPECT_SUCCESS(executor.ScheduleFor(
+        [&]() {
+          std::this_thread::sleep_for(milliseconds(10));
+          count++;
+        },
+        now));
+    EXPECT_SUCCESS(executor.ScheduleFor([&]() { count++; }, now + 1));
+    WaitUntil([&]() { return count == 2; });
+    EXPECT_SUCCESS(executor.Stop());
+
+    auto telemetry = executor.GetTelemetrySnapshot();
+    EXPECT_EQ(telemetry.queue_depth, 0);
+    EXPECT_EQ(telemetry.rejected_count, 0);
+    EXPECT_EQ(telemetry.run_time.count, 2);
+    EXPECT_GE(telemetry.run_time.GetPercentileUpperBound(1), milliseconds(10));
+    EXPECT_EQ(telemetry.timer_lateness.count, 2);
+    EXPECT_GE(telemetry.timer_lateness.GetPercentileUpperBound(1),
+              milliseconds(10));
+    EXPECT_EQ(telemetry.queue_wait_time.count, 0);
+  }
+}
+
+TEST(SingleThreadPriorityAsyncExecutorTests, TimerWheelCountWork) {
+  int queue_cap = 10;
+  SingleThreadPriorityAsyncExecutor executor(
+      queue_cap, /*drop_tasks_on_stop=*/false, /*affinity_cpu_number=*/{},
+      TimerQueueType::HierarchicalTimerWheel);
+  EXPECT_SUCCESS(executor.Init());
+  EXPECT_SUCCESS(executor.Run());
+
+  atomic<int> count(0);
+  for (int i = 0; i < queue_cap; i++) {
+    EXPECT_SUCCESS(executor.ScheduleFor([&]() { count++; }, 123456));
+  }
+  WaitUntil([&]() { return count == queue_cap; }, seconds(30));
+  EXPECT_EQ(count, queue_cap);
+
+  EXPECT_SUCCESS(executor.Stop());
+}
+
+TEST(SingleThreadPriorityAsyncExecutorTests, TimerWheelOrderedTasksExecution) {
+  int queue_cap = 10;
+  SingleThreadPriorityAsyncExecutor executor(
+      queue_cap, /*drop_tasks_on_stop=*/false, /*affinity_cpu_number=*/{},
+      TimerQueueType::HierarchicalTimerWheel);
+  EXPECT_SUCCESS(executor.Init());
+  EXPECT_SUCCESS(executor.Run());
+
+  AsyncTask task;
+  auto half_second = duration_cast<nanoseconds>(milliseconds(500)).count();
+  auto one_second = duration_cast<nanoseconds>(seconds(1)).count();
+  auto two_seconds = duration_cast<nanoseconds>(seconds(2)).count();
+
+  atomic<size_t> counter(0);
+  EXPECT_SUCCESS(executor.ScheduleFor(
+      [&]() {
+        EXPECT_GE(TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks(),
+                  task.GetExecutionTimestamp() + two_seconds);
+        EXPECT_EQ(counter++, 2);
+      },
+      task.GetExecutionTimestamp() + two_seconds));
+  EXPECT_SUCCESS(
+      executor.ScheduleFor([&]() { EXPECT_EQ(counter++, 1); },
+                           task.GetExecutionTimestamp() + one_second));
+  EXPECT_SUCCESS(
+      executor.ScheduleFor([&]() { EXPECT_EQ(counter++, 0); },
+                           task.GetExecutionTimestamp() + half_second));
+
+  WaitUntil([&]() { return counter == 3; }, seconds(30));
+  EXPECT_SUCCESS(executor.Stop());
+}
+
+TEST(SingleThreadPriorityAsyncExecutorTests,
+     TimerWheelTaskCancellationReleasesCapacity) {
+  int queue_cap = 3;
+  SingleThreadPriorityAsyncExecutor executor(
+      queue_cap, /*drop_tasks_on_stop=*/false, /*affinity_cpu_number=*/{},
+      TimerQueueType::HierarchicalTimerWheel);
+  EXPECT_SUCCESS(executor.Init());
+  EXPECT_SUCCESS(executor.Run());
+
+  auto far_ahead_timestamp =
+      (TimeProvider::GetSteadyTimestampInNanoseconds() + hours(24)).count();
+  for (int round = 0; round < 2; round++) {
+    for (int i = 0; i < queue_cap; i++) {
+      function<bool()> cancellation_callback;
+      EXPECT_SUCCESS(executor.ScheduleFor([&]() { EXPECT_EQ(true, false); },
+                                          far_ahead_timestamp,
+                                          cancellation_callback));
+      // Cancelled tasks are removed right away, so the queue cap is never
+      // exceeded.
+      EXPECT_EQ(cancellation_callback(), true);
+      EXPECT_EQ(cancellation_callback(), false);
+    }
+  }
+  // This should exit quickly and should not get stuck.
+  EXPECT_SUCCESS(executor.Stop());
+}
+
+TEST(SingleThreadPriorityAsyncExecutorTests, TimerWheelExceedingQueueCap) {
+  int queue_cap = 1;
+  SingleThreadPriorityAsyncExecutor executor(
+      queue_cap, /*drop_tasks_on_stop=*/true, /*affinity_cpu_number=*/{},
+      TimerQueueType::HierarchicalTimerWheel);
+  EXPECT_SUCCESS(executor.Init());
+  EXPECT_SUCCESS(executor.Run());
+
+  auto far_ahead_timestamp =
+      (TimeProvider::GetSteadyTimestampInNanoseconds() + hours(24)).count();
+  EXPECT_SUCCESS(executor.ScheduleFor([&]() { EXPECT_EQ(true, false); },
+                                      far_ahead_timestamp));
+  EXPECT_THAT(executor.ScheduleFor([&]() {}, far_ahead_timestamp),
+              ResultIs(RetryExecutionResult(
+                  errors::SC_ASYNC_EXECUTOR_EXCEEDING_QUEUE_CAP)));
+
+  // The pending task is dropped.
+  EXPECT_SUCCESS(executor.Stop());
+}
+
+TEST(SingleThreadPriorityAsyncExecutorTests, HostedExecutorRunsOnHostThread) {
+  SingleThreadPriorityAsyncExecutor executor(10, /*drop_tasks_on_stop=*/true);
+  atomic<int> wake_up_count(0);
+  executor.SetHost([&]() { wake_up_count++; });
+  EXPECT_SUCCESS(executor.Init());
+  EXPECT_SUCCESS(executor.Run());
+  EXPECT_EQ(executor.GetNextTaskTimestamp(), UINT64_MAX);
+
+  auto far_ahead_timestamp =
+      (TimeProvider::GetSteadyTimestampInNanoseconds() + hours(24)).count();
+  EXPECT_SUCCESS(executor.ScheduleFor([&]() { EXPECT_EQ(true, false); },
+                                      far_ahead_timestamp));
+  EXPECT_EQ(wake_up_count, 1);
+  EXPECT_EQ(executor.GetNextTaskTimestamp(), far_ahead_timestamp);
+
+  // Nothing runs without the host, and the host is only woken up for tasks
+  // that are due earlier than the next one.
+  atomic<int> count(0);
+  auto host_thread_id = std::this_thread::get_id();
+  for (int i = 0; i < 2; i++) {
+    EXPECT_SUCCESS(executor.ScheduleFor(
+        [&]() {
+          EXPECT_EQ(std::this_thread::get_id(), host_thread_id);
+          count++;
+        },
+        1234));
+  }
+  EXPECT_EQ(wake_up_count, 2);
+  EXPECT_EQ(executor.GetNextTaskTimestamp(), 1234);
+  std::this_thread::sleep_for(milliseconds(10));
+  EXPECT_EQ(count, 0);
+
+  executor.RunDueTasks();
+  EXPECT_EQ(count, 2);
+  EXPECT_EQ(executor.GetNextTaskTimestamp(), far_ahead_timestamp);
+
+  // The pending task is dropped, and the host is told to stop waiting for it.
+  EXPECT_SUCCESS(executor.Stop());
+  EXPECT_EQ(wake_up_count, 3);
+  EXPECT_EQ(executor.GetNextTaskTimestamp(), UINT64_MAX);
+}
 }  // namespace google::scp::core::test
@@ -0,0 +1,210 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <queue>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "core/async_executor/src/async_task.h"
+#include "core/async_executor/src/timer_wheel.h"
+
+using google::scp::core::AsyncTask;
+using google::scp::core::AsyncTaskCompareGreater;
+using google::scp::core::Timestamp;
+using google::scp::core::TimerWheel;
+using std::make_shared;
+using std::mt19937;
+using std::priority_queue;
+using std::shared_ptr;
+using std::uniform_int_distribution;
+using std::vector;
+using std::chrono::milliseconds;
+using std::chrono::nanoseconds;
+using std::chrono::seconds;
+
+namespace google::scp::core::test {
+using TaskHeap = priority_queue<shared_ptr<AsyncTask>,
+                                vector<shared_ptr<AsyncTask>>,
+                                AsyncTaskCompareGreater>;
+
+/// Timers are spread over the next minute, like retry backoffs and GC timers.
+static constexpr nanoseconds kTimerSpread = seconds(60);
+static constexpr nanoseconds kTimerResolution = milliseconds(1);
+
+static vector<shared_ptr<AsyncTask>> CreateTasks(size_t count) {
+  mt19937 random_generator(1234);
+  uniform_int_distribution<Timestamp> distribution(1, kTimerSpread.count());
+  vector<shared_ptr<AsyncTask>> tasks;
+  tasks.reserve(count);
+  for (size_t i = 0; i < count; i++) {
+    tasks.push_back(
+        make_shared<AsyncTask>([]() {}, distribution(random_generator)));
+  }
+  return tasks;
+}
+
+/// Arms a timer on top of state.range(0) pending timers.
+static void BM_HeapArm(benchmark::State& state) {
+  auto pending_tasks = CreateTasks(state.range(0));
+  auto tasks = CreateTasks(1000);
+  TaskHeap heap;
+  for (auto& task : pending_tasks) {
+    heap.push(task);
+  }
+  for (auto _ : state) {
+    for (auto& task : tasks) {
+      heap.push(task);
+    }
+    state.PauseTiming();
+    while (heap.size() > pending_tasks.size()) {
+      heap.pop();
+    }
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * tasks.size());
+}
+
+static void BM_TimerWheelArm(benchmark::State& state) {
+  auto pending_tasks = CreateTasks(state.range(0));
+  auto tasks = CreateTasks(1000);
+  TimerWheel timer_wheel(kTimerResolution, 0);
+  for (auto& task : pending_tasks) {
+    timer_wheel.Arm(task);
+  }
+  vector<shared_ptr<TimerWheel::Timer>> timers;
+  timers.reserve(tasks.size());
+  for (auto _ : state) {
+    for (auto& task : tasks) {
+      timers.push_back(timer_wheel.Arm(task));
+    }
+    state.PauseTiming();
+    for (auto& timer : timers) {
+      timer_wheel.Cancel(timer);
+    }
+    timers.clear();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * tasks.size());
+}
+
+/**
+ * @brief Arms and cancels a timer on top of state.range(0) pending timers. The
+ * heap cannot remove a cancelled task, it is only flagged and stays in the
+ * heap until its deadline.
+ */
+static void BM_HeapArmAndCancel(benchmark::State& state) {
+  auto pending_tasks = CreateTasks(state.range(0));
+  TaskHeap heap;
+  for (auto& task : pending_tasks) {
+    heap.push(task);
+  }
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto tasks = CreateTasks(1000);
+    state.ResumeTiming();
+    for (auto& task : tasks) {
+      heap.push(task);
+      task->Cancel();
+    }
+  }
+  state.counters["PendingTasks"] = heap.size();
+  state.SetItemsProcessed(state.iterations() * 1000);
+}
+
+static void BM_TimerWheelArmAndCancel(benchmark::State& state) {
+  auto pending_tasks = CreateTasks(state.range(0));
+  TimerWheel timer_wheel(kTimerResolution, 0);
+  for (auto& task : pending_tasks) {
+    timer_wheel.Arm(task);
+  }
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto tasks = CreateTasks(1000);
+    state.ResumeTiming();
+    for (auto& task : tasks) {
+      auto timer = timer_wheel.Arm(task);
+      task->Cancel();
+      timer_wheel.Cancel(timer);
+    }
+  }
+  state.counters["PendingTasks"] = timer_wheel.Size();
+  state.SetItemsProcessed(state.iterations() * 1000);
+}
+
+/**
+ * @brief Fires state.range(0) timers. Like the executor workers, the time
+ * jumps to the next event instead of polling every tick.
+ */
+static void BM_HeapFire(benchmark::State& state) {
+  auto tasks = CreateTasks(state.range(0));
+  for (auto _ : state) {
+    state.PauseTiming();
+    TaskHeap heap;
+    for (auto& task : tasks) {
+      heap.push(task);
+    }
+    state.ResumeTiming();
+    Timestamp current_timestamp;
+    while (!heap.empty()) {
+      current_timestamp = heap.top()->GetExecutionTimestamp();
+      while (!heap.empty() &&
+             heap.top()->GetExecutionTimestamp() <= current_timestamp) {
+        benchmark::DoNotOptimize(heap.top());
+        heap.pop();
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * tasks.size());
+}
+
+static void BM_TimerWheelFire(benchmark::State& state) {
+  auto tasks = CreateTasks(state.range(0));
+  vector<shared_ptr<AsyncTask>> expired_tasks;
+  for (auto _ : state) {
+    state.PauseTiming();
+    TimerWheel timer_wheel(kTimerResolution, 0);
+    for (auto& task : tasks) {
+      timer_wheel.Arm(task);
+    }
+    state.ResumeTiming();
+    Timestamp current_timestamp;
+    while (timer_wheel.Size() > 0) {
+      current_timestamp = timer_wheel.GetNextEventTimestamp();
+      timer_wheel.PopExpired(current_timestamp, expired_tasks);
+      benchmark::DoNotOptimize(expired_tasks.data());
+      expired_tasks.clear();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * tasks.size());
+}
+}  // namespace google::scp::core::test
+
+// Arg<Number of pending timers>
+BENCHMARK(google::scp::core::test::BM_HeapArm)->Arg(1000)->Arg(100000);
+BENCHMARK(google::scp::core::test::BM_TimerWheelArm)->Arg(1000)->Arg(100000);
+BENCHMARK(google::scp::core::test::BM_HeapArmAndCancel)
+    ->Arg(1000)
+    ->Arg(100000);
+BENCHMARK(google::scp::core::test::BM_TimerWheelArmAndCancel)
+    ->Arg(1000)
+    ->Arg(100000);
+// Arg<Number of timers to fire>
+BENCHMARK(google::scp::core::test::BM_HeapFire)->Arg(1000)->Arg(100000);
+BENCHMARK(google::scp::core::test::BM_TimerWheelFire)->Arg(1000)->Arg(100000);
+
+// Run the benchmark
+BENCHMARK_MAIN();
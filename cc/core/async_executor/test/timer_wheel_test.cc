@@ -0,0 +1,177 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "core/async_executor/src/timer_wheel.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "core/async_executor/src/async_task.h"
+
+using std::make_shared;
+using std::mt19937;
+using std::shared_ptr;
+using std::uniform_int_distribution;
+using std::vector;
+using std::chrono::nanoseconds;
+
+namespace google::scp::core::test {
+static constexpr nanoseconds kTickDuration(10);
+
+static shared_ptr<AsyncTask> CreateTask(Timestamp execution_timestamp) {
+  return make_shared<AsyncTask>([]() {}, execution_timestamp);
+}
+
+TEST(TimerWheelTest, EmptyWheel) {
+  TimerWheel timer_wheel(kTickDuration, 0);
+  EXPECT_EQ(timer_wheel.Size(), 0);
+  EXPECT_EQ(timer_wheel.GetNextEventTimestamp(), UINT64_MAX);
+
+  vector<shared_ptr<AsyncTask>> expired_tasks;
+  timer_wheel.PopExpired(UINT32_MAX, expired_tasks);
+  EXPECT_TRUE(expired_tasks.empty());
+}
+
+TEST(TimerWheelTest, ExpiresAtTheRoundedUpTick) {
+  TimerWheel timer_wheel(kTickDuration, 0);
+  auto task = CreateTask(95);
+  timer_wheel.Arm(task);
+  EXPECT_EQ(timer_wheel.Size(), 1);
+  EXPECT_EQ(timer_wheel.GetNextEventTimestamp(), 100);
+
+  vector<shared_ptr<AsyncTask>> expired_tasks;
+  timer_wheel.PopExpired(99, expired_tasks);
+  EXPECT_TRUE(expired_tasks.empty());
+
+  timer_wheel.PopExpired(100, expired_tasks);
+  ASSERT_EQ(expired_tasks.size(), 1);
+  EXPECT_EQ(expired_tasks[0], task);
+  EXPECT_EQ(timer_wheel.Size(), 0);
+  EXPECT_EQ(timer_wheel.GetNextEventTimestamp(), UINT64_MAX);
+}
+
+TEST(TimerWheelTest, PastTimersExpireRightAway) {
+  TimerWheel timer_wheel(kTickDuration, 1000);
+  auto task = CreateTask(10);
+  timer_wheel.Arm(task);
+  EXPECT_EQ(timer_wheel.GetNextEventTimestamp(), 1000);
+
+  vector<shared_ptr<AsyncTask>> expired_tasks;
+  timer_wheel.PopExpired(1000, expired_tasks);
+  ASSERT_EQ(expired_tasks.size(), 1);
+  EXPECT_EQ(expired_tasks[0], task);
+}
+
+TEST(TimerWheelTest, CancelRemovesTheTimer) {
+  TimerWheel timer_wheel(kTickDuration, 0);
+  auto timer = timer_wheel.Arm(CreateTask(1000));
+  EXPECT_EQ(timer_wheel.Size(), 1);
+  EXPECT_TRUE(timer_wheel.Cancel(timer));
+  EXPECT_FALSE(timer_wheel.Cancel(timer));
+  EXPECT_EQ(timer_wheel.Size(), 0);
+  EXPECT_EQ(timer_wheel.GetNextEventTimestamp(), UINT64_MAX);
+
+  vector<shared_ptr<AsyncTask>> expired_tasks;
+  timer_wheel.PopExpired(2000, expired_tasks);
+  EXPECT_TRUE(expired_tasks.empty());
+}
+
+TEST(TimerWheelTest, CannotCancelExpiredTimer) {
+  TimerWheel timer_wheel(kTickDuration, 0);
+  auto timer = timer_wheel.Arm(CreateTask(1000));
+  vector<shared_ptr<AsyncTask>> expired_tasks;
+  timer_wheel.PopExpired(2000, expired_tasks);
+  EXPECT_EQ(expired_tasks.size(), 1);
+  EXPECT_FALSE(timer_wheel.Cancel(timer));
+}
+
+TEST(TimerWheelTest, ClearRemovesAllTheTimers) {
+  TimerWheel timer_wheel(kTickDuration, 0);
+  auto task = CreateTask(100000);
+  timer_wheel.Arm(task);
+  timer_wheel.Arm(CreateTask(1000000000));
+  timer_wheel.Arm(CreateTask(0));
+  EXPECT_EQ(timer_wheel.Size(), 3);
+
+  timer_wheel.Clear();
+  EXPECT_EQ(timer_wheel.Size(), 0);
+  // Only the caller keeps the task.
+  EXPECT_EQ(task.use_count(), 1);
+}
+
+TEST(TimerWheelTest, CascadesTimersOfAllLevels) {
+  TimerWheel timer_wheel(nanoseconds(1), 0);
+  // One timer per level, and one beyond the range of the wheel.
+  vector<Timestamp> execution_timestamps = {
+      200, 300, 70000, 20000000, 5000000000, 1ULL << 40};
+  for (auto execution_timestamp : execution_timestamps) {
+    timer_wheel.Arm(CreateTask(execution_timestamp));
+  }
+
+  for (auto execution_timestamp : execution_timestamps) {
+    vector<shared_ptr<AsyncTask>> expired_tasks;
+    timer_wheel.PopExpired(execution_timestamp - 1, expired_tasks);
+    EXPECT_TRUE(expired_tasks.empty());
+    EXPECT_LE(timer_wheel.GetNextEventTimestamp(), execution_timestamp);
+
+    timer_wheel.PopExpired(execution_timestamp, expired_tasks);
+    ASSERT_EQ(expired_tasks.size(), 1);
+    EXPECT_EQ(expired_tasks[0]->GetExecutionTimestamp(), execution_timestamp);
+  }
+  EXPECT_EQ(timer_wheel.Size(), 0);
+}
+
+TEST(TimerWheelTest, ExpiresRandomTimersInOrder) {
+  TimerWheel timer_wheel(nanoseconds(1), 0);
+  mt19937 random_generator(1234);
+  uniform_int_distribution<Timestamp> distribution(1, 1 << 26);
+  vector<shared_ptr<TimerWheel::Timer>> cancelled_timers;
+  size_t armed_count = 0;
+  for (int i = 0; i < 10000; i++) {
+    auto timer = timer_wheel.Arm(CreateTask(distribution(random_generator)));
+    if (i % 10 == 0) {
+      cancelled_timers.push_back(timer);
+    } else {
+      armed_count++;
+    }
+  }
+  for (auto& timer : cancelled_timers) {
+    EXPECT_TRUE(timer_wheel.Cancel(timer));
+  }
+  EXPECT_EQ(timer_wheel.Size(), armed_count);
+
+  // Advance in steps of random size, only following the next events.
+  Timestamp current_timestamp = 0;
+  Timestamp last_expired_timestamp = 0;
+  size_t expired_count = 0;
+  while (timer_wheel.Size() > 0) {
+    auto next_event_timestamp = timer_wheel.GetNextEventTimestamp();
+    ASSERT_GT(next_event_timestamp, current_timestamp);
+    current_timestamp = next_event_timestamp;
+
+    vector<shared_ptr<AsyncTask>> expired_tasks;
+    timer_wheel.PopExpired(current_timestamp, expired_tasks);
+    for (auto& task : expired_tasks) {
+      EXPECT_EQ(task->GetExecutionTimestamp(), current_timestamp);
+      EXPECT_GE(task->GetExecutionTimestamp(), last_expired_timestamp);
+      last_expired_timestamp = task->GetExecutionTimestamp();
+    }
+    expired_count += expired_tasks.size();
+  }
+  EXPECT_EQ(expired_count, armed_count);
+}
+}  // namespace google::scp::core::test
@@ -0,0 +1,114 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "core/async_executor/src/async_executor.h"
+#include "public/core/test/interface/execution_result_matchers.h"
+
+using std::atomic;
+using std::make_shared;
+using std::sort;
+using std::vector;
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+using std::chrono::nanoseconds;
+using std::chrono::steady_clock;
+
+namespace google::scp::core::test {
+static constexpr size_t kTasksPerIteration = 1000;
+
+/**
+ * @brief Measures the latency from scheduling a task to the start of its
+ * execution. Tasks are scheduled one by one with state.range(0) microseconds
+ * between them: 0 keeps the worker busy, larger gaps let it go idle.
+ */
+static void BenchmarkEnqueueToStartLatency(
+    benchmark::State& state, WorkerIdleStrategy worker_idle_strategy) {
+  auto async_executor = make_shared<AsyncExecutor>(
+      AsyncExecutorOptions{.thread_count = 1,
+                           .queue_cap = 100000,
+                           .worker_idle_strategy = worker_idle_strategy});
+  EXPECT_SUCCESS(async_executor->Init());
+  EXPECT_SUCCESS(async_executor->Run());
+  auto interval = microseconds(state.range(0));
+
+  vector<nanoseconds> latencies;
+  latencies.reserve(state.max_iterations * kTasksPerIteration);
+  vector<nanoseconds> iteration_latencies(kTasksPerIteration);
+  for (auto _ : state) {
+    atomic<size_t> task_completion_counter = 0;
+    for (size_t i = 0; i < kTasksPerIteration; i++) {
+      auto schedule_time = steady_clock::now();
+      EXPECT_SUCCESS(async_executor->Schedule(
+          [&iteration_latencies, &task_completion_counter, schedule_time, i]() {
+            iteration_latencies[i] = steady_clock::now() - schedule_time;
+            task_completion_counter++;
+          },
+          AsyncPriority::Normal));
+      if (interval.count() > 0) {
+        std::this_thread::sleep_for(interval);
+      }
+    }
+    while (task_completion_counter < kTasksPerIteration) {}
+    latencies.insert(latencies.end(), iteration_latencies.begin(),
+                     iteration_latencies.end());
+  }
+  EXPECT_SUCCESS(async_executor->Stop());
+
+  sort(latencies.begin(), latencies.end());
+  auto percentile_us = [&](double percentile) {
+    auto index = static_cast<size_t>(percentile * (latencies.size() - 1));
+    return duration_cast<nanoseconds>(latencies[index]).count() / 1000.0;
+  };
+  state.counters["p50_us"] = percentile_us(0.5);
+  state.counters["p99_us"] = percentile_us(0.99);
+  state.counters["p999_us"] = percentile_us(0.999);
+  state.SetItemsProcessed(state.iterations() * kTasksPerIteration);
+}
+
+static void BM_EnqueueToStartLatencyBlock(benchmark::State& state) {
+  BenchmarkEnqueueToStartLatency(state, WorkerIdleStrategy::Block);
+}
+
+static void BM_EnqueueToStartLatencySpinThenPark(benchmark::State& state) {
+  BenchmarkEnqueueToStartLatency(state, WorkerIdleStrategy::SpinThenPark);
+}
+}  // namespace google::scp::core::test
+
+// Arg<Interval between tasks in microseconds>
+BENCHMARK(google::scp::core::test::BM_EnqueueToStartLatencyBlock)
+    ->Arg(0)
+    ->Arg(20)
+    ->Arg(1000)
+    ->Iterations(10)
+    ->Unit(benchmark::kMillisecond);
+
+// Arg<Interval between tasks in microseconds>
+BENCHMARK(google::scp::core::test::BM_EnqueueToStartLatencySpinThenPark)
+    ->Arg(0)
+    ->Arg(20)
+    ->Arg(1000)
+    ->Iterations(10)
+    ->Unit(benchmark::kMillisecond);
+
+// Run the benchmark
+BENCHMARK_MAIN();
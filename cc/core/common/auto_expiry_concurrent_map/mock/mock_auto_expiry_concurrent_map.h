@@ -47,6 +47,20 @@ class MockAutoExpiryConcurrentMap
     AutoExpiryConcurrentMap<TKey, TValue, TCompare>::RunGarbageCollector();
   }
 
+  /**
+   * @brief Indexes the entry of the key by its current expiration time, for
+   * entries inserted into the underlying map directly or whose expiration time
+   * was moved back.
+   */
+  void AddToExpiryIndex(const TKey& key) {
+    std::shared_ptr<typename AutoExpiryConcurrentMap<
+        TKey, TValue, TCompare>::AutoExpiryConcurrentMapEntry>
+        entry;
+    GetUnderlyingConcurrentMap().Find(key, entry);
+    AutoExpiryConcurrentMap<TKey, TValue, TCompare>::AddToExpiryIndex(key,
+                                                                      entry);
+  }
+
   bool IsEvictable(TKey& key) {
     std::shared_ptr<typename AutoExpiryConcurrentMap<
         TKey, TValue, TCompare>::AutoExpiryConcurrentMapEntry>
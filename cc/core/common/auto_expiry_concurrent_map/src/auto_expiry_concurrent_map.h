@@ -19,6 +19,7 @@
 #include <atomic>
 #include <chrono>
 #include <functional>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <thread>
@@ -44,11 +45,26 @@ static constexpr std::chrono::seconds
     kAutoExpiryConcurrentMapStopWaitMaxDurationToWait =
         std::chrono::seconds(10);
 
+/// The span of expiration times of the entries grouped in an expiry bucket.
+static constexpr std::chrono::milliseconds
+    kAutoExpiryConcurrentMapExpiryBucketDuration =
+        std::chrono::milliseconds(100);
+
+/// The number of independently locked shards of the expiry index.
+static constexpr size_t kAutoExpiryConcurrentMapExpiryIndexShardCount = 16;
+
 namespace google::scp::core::common {
 /**
  * @brief AutoExpiryConcurrentMap provides auto cleanup functionality on
  * top of a concurrent map which is a multi producers and multi consumers map
  * support to be used generically.
+ *
+ * The entries are tracked by an expiry index, which groups the keys into
+ * buckets by expiration time, so that a garbage collection round only visits
+ * the buckets that are due instead of every key of the map. The index is
+ * updated lazily: an entry whose expiration was extended is moved to its new
+ * bucket when its old bucket comes due, and an erased key is dropped from the
+ * index at that point.
  */
 template <class TKey, class TValue,
           typename TCompare = oneapi::tbb::tbb_hash_compare<TKey>>
@@ -123,6 +139,13 @@ class AutoExpiryConcurrentMap : public ServiceInterface {
 
     /// Expiration of the entry in the memory
     std::atomic<core::Timestamp> expiration_time;
+
+    /**
+     * @brief The generation of the expiry index entry of the record. Only the
+     * index entry with the latest generation is live, the older ones are
+     * dropped when their bucket comes due.
+     */
+    std::atomic<uint64_t> expiry_index_generation{0};
   };
 
   /**
@@ -151,6 +174,9 @@ class AutoExpiryConcurrentMap : public ServiceInterface {
             on_before_element_deletion_callback),
         async_executor_(async_executor),
         pending_garbage_collection_callbacks_(0),
+        next_expiry_index_generation_(1),
+        expiry_index_shards_(std::make_unique<ExpiryIndexShard[]>(
+            kAutoExpiryConcurrentMapExpiryIndexShardCount)),
         is_running_(false),
         activity_id_(Uuid::GenerateUuid()) {}
 
@@ -218,7 +244,9 @@ class AutoExpiryConcurrentMap : public ServiceInterface {
     auto pair = std::make_pair(key_value.first, record);
     auto execution_result = concurrent_map_.Insert(pair, record);
 
-    if (!execution_result.Successful()) {
+    if (execution_result.Successful()) {
+      AddToExpiryIndex(key_value.first, record);
+    } else {
       if (execution_result !=
           FailureExecutionResult(
               core::errors::SC_CONCURRENT_MAP_ENTRY_ALREADY_EXISTS)) {
@@ -350,6 +378,58 @@ class AutoExpiryConcurrentMap : public ServiceInterface {
   }
 
  protected:
+  /// An entry of the expiry index.
+  struct ExpiryIndexEntry {
+    TKey key;
+    /// The expiry index generation of the record at the time of indexing.
+    uint64_t generation;
+  };
+
+  /**
+   * @brief A shard of the expiry index, holding the keys of its buckets. A
+   * bucket is keyed by the start of the span of expiration times it holds.
+   */
+  struct ExpiryIndexShard {
+    std::mutex mutex;
+    std::map<Timestamp, std::vector<ExpiryIndexEntry>> buckets;
+  };
+
+  /**
+   * @brief Indexes the record of the key by its current expiration time,
+   * superseding the previous index entry of the record, if any. The record
+   * must be in the map under the key.
+   *
+   * @param key The key of the record.
+   * @param record The record to index.
+   */
+  void AddToExpiryIndex(
+      const TKey& key,
+      const std::shared_ptr<AutoExpiryConcurrentMapEntry>& record) noexcept {
+    auto generation = next_expiry_index_generation_.fetch_add(1);
+    record->expiry_index_generation = generation;
+    auto& shard = GetExpiryIndexShard(key);
+    std::lock_guard lock(shard.mutex);
+    shard.buckets[GetExpiryBucket(record->expiration_time)].push_back(
+        ExpiryIndexEntry{key, generation});
+  }
+
+  /// Returns the start of the bucket of the expiration time.
+  static Timestamp GetExpiryBucket(Timestamp expiration_time) noexcept {
+    static constexpr Timestamp kBucketDuration =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            kAutoExpiryConcurrentMapExpiryBucketDuration)
+            .count();
+    return expiration_time - expiration_time % kBucketDuration;
+  }
+
+  /// Returns the expiry index shard of the key.
+  ExpiryIndexShard& GetExpiryIndexShard(const TKey& key) noexcept {
+    auto hash = static_cast<uint64_t>(TCompare().hash(key));
+    // Mixed, as the hashes of integer keys are the keys themselves.
+    return expiry_index_shards_[((hash * 0x9E3779B97F4A7C15ULL) >> 32) %
+                                kAutoExpiryConcurrentMapExpiryIndexShardCount];
+  }
+
   /**
    * @brief Schedules a round of garbage collection in the next
    * map_entry_lifetime_seconds_.
@@ -383,37 +463,65 @@ class AutoExpiryConcurrentMap : public ServiceInterface {
    * alert must be raised.
    */
   void RunGarbageCollector() {
-    std::vector<TKey> keys;
-    auto execution_result = concurrent_map_.Keys(keys);
-    if (!execution_result.Successful()) {
-      // Reschedule
-      ScheduleGarbageCollection();
-      return;
-    }
-
     std::vector<std::pair<TKey, std::shared_ptr<AutoExpiryConcurrentMapEntry>>>
         elements_to_remove;
-
-    for (auto key : keys) {
-      std::shared_ptr<AutoExpiryConcurrentMapEntry> value;
-      auto execution_result = concurrent_map_.Find(key, value);
-      if (!execution_result.Successful()) {
-        // TODO: log and continue
-        continue;
+    auto current_time =
+        TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks();
+
+    for (size_t i = 0; i < kAutoExpiryConcurrentMapExpiryIndexShardCount;
+         ++i) {
+      auto& shard = expiry_index_shards_[i];
+      // Takes the due buckets out of the shard, so that the shard is only
+      // locked for the time of a splice.
+      std::map<Timestamp, std::vector<ExpiryIndexEntry>> due_buckets;
+      {
+        std::lock_guard lock(shard.mutex);
+        auto due_end = shard.buckets.upper_bound(current_time);
+        while (shard.buckets.begin() != due_end) {
+          due_buckets.insert(shard.buckets.extract(shard.buckets.begin()));
+        }
       }
 
-      std::unique_lock<std::shared_timed_mutex> lock(value->record_lock,
-                                                     std::defer_lock);
-      if (!lock.try_lock()) {
-        continue;
+      // The entries to put back into the index, with their new bucket.
+      std::vector<std::pair<Timestamp, ExpiryIndexEntry>> entries_to_reindex;
+      for (auto& [bucket, entries] : due_buckets) {
+        for (auto& index_entry : entries) {
+          std::shared_ptr<AutoExpiryConcurrentMapEntry> value;
+          auto execution_result = concurrent_map_.Find(index_entry.key, value);
+          if (!execution_result.Successful() ||
+              value->expiry_index_generation != index_entry.generation) {
+            // Erased, or superseded by a newer index entry.
+            continue;
+          }
+
+          std::unique_lock<std::shared_timed_mutex> lock(value->record_lock,
+                                                         std::defer_lock);
+          if (!lock.try_lock() || !value->is_evictable) {
+            // Checked again in the next round.
+            entries_to_reindex.emplace_back(GetExpiryBucket(current_time),
+                                            std::move(index_entry));
+            continue;
+          }
+
+          if (!value->IsExpired()) {
+            entries_to_reindex.emplace_back(
+                GetExpiryBucket(value->expiration_time),
+                std::move(index_entry));
+            continue;
+          }
+
+          value->being_evicted = true;
+          elements_to_remove.push_back(
+              std::make_pair(std::move(index_entry.key), value));
+        }
       }
 
-      if (!value->is_evictable || !value->IsExpired()) {
-        continue;
+      if (!entries_to_reindex.empty()) {
+        std::lock_guard lock(shard.mutex);
+        for (auto& [bucket, index_entry] : entries_to_reindex) {
+          shard.buckets[bucket].push_back(std::move(index_entry));
+        }
       }
-
-      value->being_evicted = true;
-      elements_to_remove.push_back(std::make_pair(key, value));
     }
 
     if (elements_to_remove.size() == 0) {
@@ -460,9 +568,15 @@ class AutoExpiryConcurrentMap : public ServiceInterface {
     } else {
       // TODO: Log.
       // Set the loaded flag to true since we dont want to keep it unavailable.
-      std::unique_lock<std::shared_timed_mutex> lock(
-          std::get<1>(key_value_pair)->record_lock);
-      std::get<1>(key_value_pair)->being_evicted = false;
+      {
+        std::unique_lock<std::shared_timed_mutex> lock(
+            std::get<1>(key_value_pair)->record_lock);
+        std::get<1>(key_value_pair)->being_evicted = false;
+      }
+      // The entry left the index when it was picked for eviction, it is
+      // picked again in the next round if it is still expired.
+      AddToExpiryIndex(std::get<0>(key_value_pair),
+                       std::get<1>(key_value_pair));
     }
 
     // Last callback
@@ -490,6 +604,10 @@ class AutoExpiryConcurrentMap : public ServiceInterface {
   const std::shared_ptr<AsyncExecutorInterface> async_executor_;
   /// The total pending callbacks waiting during the garbage collection period.
   std::atomic<size_t> pending_garbage_collection_callbacks_;
+  /// The generation of the next expiry index entry.
+  std::atomic<uint64_t> next_expiry_index_generation_;
+  /// The shards of the expiry index.
+  std::unique_ptr<ExpiryIndexShard[]> expiry_index_shards_;
   /// The cancellation callback.
   std::function<bool()> current_cancellation_callback_;
   /// Sync mutex
@@ -0,0 +1,158 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <utility>
+
+#include <benchmark/benchmark.h>
+
+#include "core/async_executor/mock/mock_async_executor.h"
+#include "core/common/auto_expiry_concurrent_map/mock/mock_auto_expiry_concurrent_map.h"
+
+using google::scp::core::AsyncOperation;
+using google::scp::core::ExecutionResult;
+using google::scp::core::SuccessExecutionResult;
+using google::scp::core::Timestamp;
+using google::scp::core::async_executor::mock::MockAsyncExecutor;
+using google::scp::core::common::auto_expiry_concurrent_map::mock::
+    MockAutoExpiryConcurrentMap;
+using std::atomic;
+using std::function;
+using std::make_pair;
+using std::make_shared;
+using std::make_unique;
+using std::shared_ptr;
+using std::thread;
+using std::unique_ptr;
+
+namespace google::scp::core::common::test {
+/// The number of entries in the map.
+static constexpr int kEntryCount = 1000000;
+
+using BenchmarkMap = MockAutoExpiryConcurrentMap<int, int>;
+
+/// The map shared by the benchmark threads of a run.
+static unique_ptr<BenchmarkMap> map;
+/// Runs garbage collection rounds next to the readers.
+static unique_ptr<thread> garbage_collector;
+static atomic<bool> stop_garbage_collector;
+
+/// Fills the map with entries that do not expire within the benchmark.
+static void SetUpMap(const benchmark::State&) {
+  auto async_executor = make_shared<MockAsyncExecutor>();
+  // The rounds are run by the benchmarks instead.
+  async_executor->schedule_for_mock =
+      [](const AsyncOperation&, Timestamp, function<bool()>&) {
+        return SuccessExecutionResult();
+      };
+  map = make_unique<BenchmarkMap>(
+      /*map_entry_lifetime_seconds=*/3600,
+      /*extend_entry_lifetime_on_access=*/false,
+      /*block_entry_while_eviction=*/true,
+      [](int&, int&, function<void(bool)> deleter) { deleter(true); },
+      async_executor);
+  int out_value;
+  for (int i = 0; i < kEntryCount; i++) {
+    map->Insert(make_pair(i, i), out_value);
+  }
+}
+
+static void TearDownMap(const benchmark::State&) {
+  map.reset();
+}
+
+static void SetUpMapWithGarbageCollector(const benchmark::State& state) {
+  SetUpMap(state);
+  stop_garbage_collector = false;
+  garbage_collector = make_unique<thread>([]() {
+    while (!stop_garbage_collector) {
+      map->RunGarbageCollector();
+      std::this_thread::yield();
+    }
+  });
+}
+
+static void TearDownMapWithGarbageCollector(const benchmark::State& state) {
+  stop_garbage_collector = true;
+  garbage_collector->join();
+  garbage_collector.reset();
+  TearDownMap(state);
+}
+
+/**
+ * @brief Measures a garbage collection round over the map, with the number of
+ * entries expired before the round as the benchmark argument. The expired
+ * entries are collected and put back between the rounds.
+ */
+static void BM_GarbageCollectionPause(benchmark::State& state) {
+  int expired_count = state.range(0);
+  int out_value;
+  for (auto _ : state) {
+    state.PauseTiming();
+    // Spread over the key space, and so over the shards.
+    for (int i = 0; i < expired_count; i++) {
+      int key = i * (kEntryCount / expired_count);
+      shared_ptr<BenchmarkMap::AutoExpiryConcurrentMapEntry> entry;
+      map->GetUnderlyingConcurrentMap().Find(key, entry);
+      entry->expiration_time = 0;
+      map->AddToExpiryIndex(key);
+    }
+    state.ResumeTiming();
+
+    map->RunGarbageCollector();
+
+    state.PauseTiming();
+    for (int i = 0; i < expired_count; i++) {
+      int key = i * (kEntryCount / expired_count);
+      map->Insert(make_pair(key, key), out_value);
+    }
+    state.ResumeTiming();
+  }
+}
+
+/// Measures the lookups of the readers while garbage collection rounds run.
+static void BM_FindDuringGarbageCollection(benchmark::State& state) {
+  int key = state.thread_index() * 7919;
+  int out_value;
+  for (auto _ : state) {
+    key = (key + 1) % kEntryCount;
+    benchmark::DoNotOptimize(map->Find(key, out_value));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+}  // namespace google::scp::core::common::test
+
+BENCHMARK(google::scp::core::common::test::BM_GarbageCollectionPause)
+    ->Setup(google::scp::core::common::test::SetUpMap)
+    ->Teardown(google::scp::core::common::test::TearDownMap)
+    ->Arg(0)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK(google::scp::core::common::test::BM_FindDuringGarbageCollection)
+    ->Setup(google::scp::core::common::test::SetUpMapWithGarbageCollector)
+    ->Teardown(google::scp::core::common::test::TearDownMapWithGarbageCollector)
+    ->Threads(1)
+    ->Threads(4)
+    ->UseRealTime();
+
+// Run the benchmark
+BENCHMARK_MAIN();
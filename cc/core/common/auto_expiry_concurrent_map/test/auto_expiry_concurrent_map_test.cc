@@ -429,6 +429,7 @@ TEST_F(AutoExpiryConcurrentMapTest, GarbageCollection) {
   shared_ptr<UnderlyingEntry> underlying_entry;
   auto_expiry_map.GetUnderlyingConcurrentMap().Find(3, underlying_entry);
   underlying_entry->expiration_time = 0;
+  auto_expiry_map.AddToExpiryIndex(3);
 
   shared_lock<shared_timed_mutex> lock(underlying_entry->record_lock);
 
@@ -452,6 +453,91 @@ TEST_F(AutoExpiryConcurrentMapTest, GarbageCollection) {
   EXPECT_EQ(keys_to_be_deleted[0], 3);
 }
 
+TEST_F(AutoExpiryConcurrentMapTest, GarbageCollectionOfManyEntries) {
+  vector<function<void(bool)>> deleters;
+  auto on_before_element_deletion_callback_ =
+      [&](int& key, shared_ptr<EmptyEntry>&,
+          function<void(bool can_delete)> deleter) {
+        deleters.push_back(deleter);
+      };
+
+  // Expire right away.
+  MockAutoExpiryConcurrentMap<int, shared_ptr<EmptyEntry>> auto_expiry_map(
+      0, true, true, on_before_element_deletion_callback_,
+      mock_async_executor_);
+  EXPECT_SUCCESS(auto_expiry_map.Run());
+
+  auto entry = make_shared<EmptyEntry>();
+  for (int i = 0; i < 1000; i++) {
+    EXPECT_SUCCESS(auto_expiry_map.Insert(make_pair(i, entry), entry));
+  }
+
+  auto_expiry_map.RunGarbageCollector();
+  EXPECT_EQ(deleters.size(), 1000);
+  for (auto& deleter : deleters) {
+    deleter(true);
+  }
+  EXPECT_EQ(auto_expiry_map.Size(), 0);
+
+  // The collected entries left the expiry index.
+  deleters.clear();
+  auto_expiry_map.RunGarbageCollector();
+  EXPECT_EQ(deleters.size(), 0);
+}
+
+TEST_F(AutoExpiryConcurrentMapTest, ReinsertedEntryIsCollectedOnce) {
+  vector<int> keys_to_be_deleted;
+  auto on_before_element_deletion_callback_ =
+      [&](int& key, shared_ptr<EmptyEntry>&,
+          function<void(bool can_delete)> deleter) {
+        keys_to_be_deleted.push_back(key);
+      };
+
+  MockAutoExpiryConcurrentMap<int, shared_ptr<EmptyEntry>> auto_expiry_map(
+      0, true, true, on_before_element_deletion_callback_,
+      mock_async_executor_);
+  EXPECT_SUCCESS(auto_expiry_map.Run());
+
+  auto entry = make_shared<EmptyEntry>();
+  int key = 3;
+  EXPECT_SUCCESS(auto_expiry_map.Insert(make_pair(key, entry), entry));
+  EXPECT_SUCCESS(auto_expiry_map.Erase(key));
+  EXPECT_SUCCESS(auto_expiry_map.Insert(make_pair(key, entry), entry));
+
+  // The index entry of the erased record is dropped.
+  auto_expiry_map.RunGarbageCollector();
+  EXPECT_EQ(keys_to_be_deleted, vector<int>({3}));
+}
+
+TEST_F(AutoExpiryConcurrentMapTest, DeclinedDeletionIsRetriedNextRound) {
+  vector<function<void(bool)>> deleters;
+  auto on_before_element_deletion_callback_ =
+      [&](int& key, shared_ptr<EmptyEntry>&,
+          function<void(bool can_delete)> deleter) {
+        deleters.push_back(deleter);
+      };
+
+  MockAutoExpiryConcurrentMap<int, shared_ptr<EmptyEntry>> auto_expiry_map(
+      0, true, true, on_before_element_deletion_callback_,
+      mock_async_executor_);
+  EXPECT_SUCCESS(auto_expiry_map.Run());
+
+  auto entry = make_shared<EmptyEntry>();
+  EXPECT_SUCCESS(auto_expiry_map.Insert(make_pair(3, entry), entry));
+
+  auto_expiry_map.RunGarbageCollector();
+  ASSERT_EQ(deleters.size(), 1);
+  deleters[0](false);
+  EXPECT_SUCCESS(auto_expiry_map.Find(3, entry));
+
+  auto_expiry_map.RunGarbageCollector();
+  ASSERT_EQ(deleters.size(), 2);
+  deleters[1](true);
+  EXPECT_THAT(auto_expiry_map.Find(3, entry),
+              ResultIs(FailureExecutionResult(
+                  errors::SC_CONCURRENT_MAP_ENTRY_DOES_NOT_EXIST)));
+}
+
 TEST_F(AutoExpiryConcurrentMapTest, OnRemoveEntryFromCacheLogged) {
   vector<int> keys_to_be_deleted;
   auto on_before_element_deletion_callback_ =
@@ -602,13 +688,16 @@ TEST(AutoExpiryConcurrentMapDeletionTest, DeletionForExpired) {
                                                       underlying_entry);
   underlying_entry->expiration_time = 0;
   underlying_entry->is_evictable = true;
+  auto_expiry_map.AddToExpiryIndex(3);
 
   entry = make_shared<EmptyEntry>();
+  underlying_entry = make_shared<UnderlyingEntry>(entry, 0);
   underlying_pair = make_pair(5, underlying_entry);
   auto_expiry_map.GetUnderlyingConcurrentMap().Insert(underlying_pair,
                                                       underlying_entry);
   underlying_entry->expiration_time = 0;
   underlying_entry->is_evictable = true;
+  auto_expiry_map.AddToExpiryIndex(5);
   EXPECT_SUCCESS(auto_expiry_map.Run());
 
   WaitUntil([&]() { return total_count == 2; });
@@ -0,0 +1,261 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "oneapi/tbb/concurrent_hash_map.h"
+#include "oneapi/tbb/spin_rw_mutex.h"
+#include "public/core/interface/execution_result.h"
+
+#include "error_codes.h"
+
+namespace google::scp::core::common {
+/// The default number of shards of a ShardedConcurrentMap.
+static constexpr size_t kDefaultConcurrentMapShardCount = 64;
+/// The size of a cache line, to keep the locks of the shards apart.
+static constexpr size_t kConcurrentMapCacheLineSize = 64;
+
+/**
+ * @brief ShardedConcurrentMap provides the same multi producers and multi
+ * consumers map as ConcurrentMap, split into shards by the hash of the key.
+ * Every shard has its own reader-writer spin lock, so the operations on
+ * different shards never contend, and the readers of a shard only contend with
+ * its writers, not with each other.
+ *
+ * Visit and Update work on the value in place instead of copying it out, and
+ * Keys and ForEach visit one shard at a time. They are weakly consistent: an
+ * element inserted or erased while they run may or may not be seen, and
+ * writers are only held up for the time a single shard is visited.
+ *
+ * @tparam TCompare hashes and compares the keys, with the interface of
+ * oneapi::tbb::tbb_hash_compare so that it can be swapped for ConcurrentMap.
+ */
+template <class TKey, class TValue,
+          typename TCompare = oneapi::tbb::tbb_hash_compare<TKey>>
+class ShardedConcurrentMap {
+  /**
+   * @brief The lock of a shard. A reader takes it with a single atomic
+   * operation, and the critical sections are short.
+   */
+  typedef oneapi::tbb::spin_rw_mutex ShardMutex;
+
+ public:
+  /**
+   * @brief Construct a new Sharded Concurrent Map object
+   * @param shard_count the number of shards, rounded up to a power of two.
+   */
+  explicit ShardedConcurrentMap(
+      size_t shard_count = kDefaultConcurrentMapShardCount)
+      : shard_mask_(GetShardCount(shard_count) - 1),
+        shards_(std::make_unique<Shard[]>(shard_mask_ + 1)) {}
+
+  ShardedConcurrentMap(const ShardedConcurrentMap&) = delete;
+  ShardedConcurrentMap& operator=(const ShardedConcurrentMap&) = delete;
+
+  /**
+   * @brief Inserts an element into the map, see ConcurrentMap::Insert.
+   *
+   * @param key_value A pair of key value containing the key and values to be
+   * inserted.
+   * @param out_value A reference to the actual value inserted into the map.
+   * @return ExecutionResult The execution result of the operation.
+   */
+  ExecutionResult Insert(std::pair<TKey, TValue> key_value, TValue& out_value) {
+    auto& shard = GetShard(key_value.first);
+    ShardMutex::scoped_lock lock(shard.mutex, /*write=*/true);
+    auto [it, inserted] = shard.map.insert(std::move(key_value));
+    out_value = it->second;
+    if (!inserted) {
+      return FailureExecutionResult(
+          errors::SC_CONCURRENT_MAP_ENTRY_ALREADY_EXISTS);
+    }
+    shard.size.fetch_add(1, std::memory_order_relaxed);
+    return SuccessExecutionResult();
+  }
+
+  /**
+   * @brief Finds an element within the map with the provided key and copies
+   * its value out, see ConcurrentMap::Find.
+   *
+   * @param key The key to be found from the map.
+   * @param out_value A reference to the actual value in the map.
+   * @return ExecutionResult The execution result of the operation.
+   */
+  ExecutionResult Find(const TKey& key, TValue& out_value) {
+    return Visit(key, [&out_value](const TValue& value) { out_value = value; });
+  }
+
+  /**
+   * @brief Calls the visitor with the value of the key in place, while writers
+   * of the shard of the key wait. The visitor must not access the map.
+   *
+   * @param key The key to be found from the map.
+   * @param visitor is called with a const reference to the value.
+   * @return ExecutionResult The execution result of the operation.
+   */
+  template <class Visitor>
+  ExecutionResult Visit(const TKey& key, Visitor&& visitor) const {
+    const auto& shard = GetShard(key);
+    ShardMutex::scoped_lock lock(shard.mutex, /*write=*/false);
+    auto it = shard.map.find(key);
+    if (it == shard.map.end()) {
+      return FailureExecutionResult(
+          errors::SC_CONCURRENT_MAP_ENTRY_DOES_NOT_EXIST);
+    }
+    visitor(it->second);
+    return SuccessExecutionResult();
+  }
+
+  /**
+   * @brief Same as Visit but the visitor can modify the value, while readers
+   * and writers of the shard of the key wait.
+   *
+   * @param key The key to be found from the map.
+   * @param visitor is called with a reference to the value.
+   * @return ExecutionResult The execution result of the operation.
+   */
+  template <class Visitor>
+  ExecutionResult Update(const TKey& key, Visitor&& visitor) {
+    auto& shard = GetShard(key);
+    ShardMutex::scoped_lock lock(shard.mutex, /*write=*/true);
+    auto it = shard.map.find(key);
+    if (it == shard.map.end()) {
+      return FailureExecutionResult(
+          errors::SC_CONCURRENT_MAP_ENTRY_DOES_NOT_EXIST);
+    }
+    visitor(it->second);
+    return SuccessExecutionResult();
+  }
+
+  /**
+   * @brief Erases an element from the map with the provided key, see
+   * ConcurrentMap::Erase.
+   *
+   * @param key The key to be erased from the map.
+   * @return ExecutionResult The execution result of the operation.
+   */
+  ExecutionResult Erase(const TKey& key) {
+    auto& shard = GetShard(key);
+    ShardMutex::scoped_lock lock(shard.mutex, /*write=*/true);
+    if (shard.map.erase(key) == 0) {
+      return FailureExecutionResult(
+          errors::SC_CONCURRENT_MAP_ENTRY_DOES_NOT_EXIST);
+    }
+    shard.size.fetch_sub(1, std::memory_order_relaxed);
+    return SuccessExecutionResult();
+  }
+
+  /**
+   * @brief Gets the keys in the map, one shard at a time. Weakly consistent,
+   * see the class comment.
+   *
+   * @param keys A vector of the keys to be filled in once looked up.
+   * @return ExecutionResult The execution result of the operation.
+   */
+  ExecutionResult Keys(std::vector<TKey>& keys) {
+    keys.clear();
+    ForEach([&keys](const TKey& key, const TValue&) { keys.push_back(key); });
+    return SuccessExecutionResult();
+  }
+
+  /**
+   * @brief Calls the visitor with every element of the map in place, one shard
+   * at a time. Weakly consistent, see the class comment. The visitor must not
+   * access the map.
+   *
+   * @param visitor is called with a const reference to the key and the value.
+   */
+  template <class Visitor>
+  void ForEach(Visitor&& visitor) const {
+    for (size_t i = 0; i <= shard_mask_; ++i) {
+      const auto& shard = shards_[i];
+      ShardMutex::scoped_lock lock(shard.mutex, /*write=*/false);
+      for (const auto& [key, value] : shard.map) {
+        visitor(key, value);
+      }
+    }
+  }
+
+  /**
+   * @brief Returns the current size of the map in a thread-safe way. Due to
+   * the concurrent writers, this value is approximate.
+   *
+   * @return size_t
+   */
+  size_t Size() const {
+    size_t size = 0;
+    for (size_t i = 0; i <= shard_mask_; ++i) {
+      size += shards_[i].size.load(std::memory_order_relaxed);
+    }
+    return size;
+  }
+
+ private:
+  /// Adapts TCompare to the hash function of std::unordered_map.
+  struct Hash {
+    size_t operator()(const TKey& key) const { return TCompare().hash(key); }
+  };
+
+  /// Adapts TCompare to the key equality of std::unordered_map.
+  struct KeyEqual {
+    bool operator()(const TKey& left, const TKey& right) const {
+      return TCompare().equal(left, right);
+    }
+  };
+
+  /// A shard of the map, on cache lines of its own.
+  struct alignas(kConcurrentMapCacheLineSize) Shard {
+    /// Guards the map of the shard.
+    mutable ShardMutex mutex;
+    /// The elements of the shard.
+    std::unordered_map<TKey, TValue, Hash, KeyEqual> map;
+    /// The number of elements, readable without the lock.
+    std::atomic<size_t> size{0};
+  };
+
+  /// Rounds the shard count up to a power of two.
+  static size_t GetShardCount(size_t shard_count) {
+    size_t rounded_shard_count = 1;
+    while (rounded_shard_count < shard_count) {
+      rounded_shard_count <<= 1;
+    }
+    return rounded_shard_count;
+  }
+
+  /**
+   * @brief Returns the shard of the key. The hash is mixed first, as the hashes
+   * of TCompare can have few distinct low bits, e.g. for integers and
+   * pointers.
+   */
+  Shard& GetShard(const TKey& key) const {
+    uint64_t mixed_hash =
+        static_cast<uint64_t>(TCompare().hash(key)) * 0x9E3779B97F4A7C15ULL;
+    return shards_[(mixed_hash >> 32) & shard_mask_];
+  }
+
+  /// The number of shards minus one, to pick a shard from the hash.
+  const size_t shard_mask_;
+  /// The shards of the map.
+  std::unique_ptr<Shard[]> shards_;
+};
+}  // namespace google::scp::core::common
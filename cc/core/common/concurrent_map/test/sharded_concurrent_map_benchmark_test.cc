@@ -0,0 +1,197 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include <benchmark/benchmark.h>
+
+#include "core/common/concurrent_map/src/concurrent_map.h"
+#include "core/common/concurrent_map/src/sharded_concurrent_map.h"
+#include "core/common/uuid/src/uuid.h"
+
+using google::scp::core::common::ConcurrentMap;
+using google::scp::core::common::ShardedConcurrentMap;
+using google::scp::core::common::Uuid;
+using google::scp::core::common::UuidCompare;
+using std::make_pair;
+using std::make_unique;
+using std::string;
+using std::to_string;
+using std::unique_ptr;
+
+namespace google::scp::core::common::test {
+/// The number of keys the map is filled with before the benchmark.
+static constexpr int kKeyCount = 10000;
+/// The number of request types a MessageRouter typically has actions for.
+static constexpr int kRequestTypeCount = 16;
+
+/**
+ * @brief Has every benchmark thread do lookups on a shared map of key_count
+ * keys, with write_percent percent of the operations being an erase followed
+ * by an insert of the same key. The keys and values are strings, the way the
+ * maps are keyed on the hot paths.
+ */
+template <class MapType>
+static void BenchmarkMixedOperations(benchmark::State& state, int key_count,
+                                     int write_percent) {
+  static unique_ptr<MapType> map;
+  if (state.thread_index() == 0) {
+    map = make_unique<MapType>();
+    string out_value;
+    for (int i = 0; i < key_count; i++) {
+      map->Insert(make_pair(to_string(i), string(32, 'v')), out_value);
+    }
+  }
+
+  // Every thread walks the keys with its own stride.
+  size_t key_index = state.thread_index() * 7919;
+  size_t operation_index = 0;
+  string out_value;
+  for (auto _ : state) {
+    auto key = to_string(key_index++ % key_count);
+    if (static_cast<int>(operation_index++ % 100) < write_percent) {
+      map->Erase(key);
+      map->Insert(make_pair(key, string(32, 'v')), out_value);
+    } else {
+      benchmark::DoNotOptimize(map->Find(key, out_value));
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * @brief Has every benchmark thread insert a request under a new Uuid, look
+ * it up, and erase it, the way HttpConnection tracks its pending network
+ * calls. Every thread keeps kInFlightCount requests in the map.
+ */
+template <class MapType>
+static void BenchmarkPendingCalls(benchmark::State& state) {
+  static constexpr uint64_t kInFlightCount = 64;
+  static unique_ptr<MapType> map;
+  if (state.thread_index() == 0) {
+    map = make_unique<MapType>();
+  }
+
+  Uuid request_id;
+  request_id.high = state.thread_index();
+  uint64_t next_request_index = 0;
+  string out_value;
+  for (auto _ : state) {
+    request_id.low = next_request_index++;
+    map->Insert(make_pair(request_id, string(32, 'v')), out_value);
+    if (request_id.low >= kInFlightCount) {
+      request_id.low -= kInFlightCount;
+      benchmark::DoNotOptimize(map->Find(request_id, out_value));
+      map->Erase(request_id);
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_ConcurrentMapReadHeavy(benchmark::State& state) {
+  BenchmarkMixedOperations<ConcurrentMap<string, string>>(
+      state, kKeyCount, /*write_percent=*/5);
+}
+
+static void BM_ShardedConcurrentMapReadHeavy(benchmark::State& state) {
+  BenchmarkMixedOperations<ShardedConcurrentMap<string, string>>(
+      state, kKeyCount, /*write_percent=*/5);
+}
+
+static void BM_ConcurrentMapWriteHeavy(benchmark::State& state) {
+  BenchmarkMixedOperations<ConcurrentMap<string, string>>(
+      state, kKeyCount, /*write_percent=*/50);
+}
+
+static void BM_ShardedConcurrentMapWriteHeavy(benchmark::State& state) {
+  BenchmarkMixedOperations<ShardedConcurrentMap<string, string>>(
+      state, kKeyCount, /*write_percent=*/50);
+}
+
+/// The lookups of MessageRouter, on a few keys that every thread shares.
+static void BM_ConcurrentMapRouterLookup(benchmark::State& state) {
+  BenchmarkMixedOperations<ConcurrentMap<string, string>>(
+      state, kRequestTypeCount, /*write_percent=*/0);
+}
+
+static void BM_ShardedConcurrentMapRouterLookup(benchmark::State& state) {
+  BenchmarkMixedOperations<ShardedConcurrentMap<string, string>>(
+      state, kRequestTypeCount, /*write_percent=*/0);
+}
+
+static void BM_ConcurrentMapPendingCalls(benchmark::State& state) {
+  BenchmarkPendingCalls<ConcurrentMap<Uuid, string, UuidCompare>>(state);
+}
+
+static void BM_ShardedConcurrentMapPendingCalls(benchmark::State& state) {
+  BenchmarkPendingCalls<ShardedConcurrentMap<Uuid, string, UuidCompare>>(
+      state);
+}
+}  // namespace google::scp::core::common::test
+
+BENCHMARK(google::scp::core::common::test::BM_ConcurrentMapReadHeavy)
+    ->Threads(1)
+    ->Threads(4)
+    ->Threads(16)
+    ->UseRealTime();
+
+BENCHMARK(google::scp::core::common::test::BM_ShardedConcurrentMapReadHeavy)
+    ->Threads(1)
+    ->Threads(4)
+    ->Threads(16)
+    ->UseRealTime();
+
+BENCHMARK(google::scp::core::common::test::BM_ConcurrentMapWriteHeavy)
+    ->Threads(1)
+    ->Threads(4)
+    ->Threads(16)
+    ->UseRealTime();
+
+BENCHMARK(google::scp::core::common::test::BM_ShardedConcurrentMapWriteHeavy)
+    ->Threads(1)
+    ->Threads(4)
+    ->Threads(16)
+    ->UseRealTime();
+
+BENCHMARK(google::scp::core::common::test::BM_ConcurrentMapRouterLookup)
+    ->Threads(1)
+    ->Threads(4)
+    ->Threads(16)
+    ->UseRealTime();
+
+BENCHMARK(google::scp::core::common::test::BM_ShardedConcurrentMapRouterLookup)
+    ->Threads(1)
+    ->Threads(4)
+    ->Threads(16)
+    ->UseRealTime();
+
+BENCHMARK(google::scp::core::common::test::BM_ConcurrentMapPendingCalls)
+    ->Threads(1)
+    ->Threads(4)
+    ->Threads(16)
+    ->UseRealTime();
+
+BENCHMARK(google::scp::core::common::test::BM_ShardedConcurrentMapPendingCalls)
+    ->Threads(1)
+    ->Threads(4)
+    ->Threads(16)
+    ->UseRealTime();
+
+// Run the benchmark
+BENCHMARK_MAIN();
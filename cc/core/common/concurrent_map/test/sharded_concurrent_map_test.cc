@@ -0,0 +1,180 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/common/concurrent_map/src/sharded_concurrent_map.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/common/uuid/src/uuid.h"
+#include "core/test/scp_test_base.h"
+#include "public/core/test/interface/execution_result_matchers.h"
+
+using google::scp::core::common::ShardedConcurrentMap;
+using google::scp::core::test::ResultIs;
+using google::scp::core::test::ScpTestBase;
+using std::atomic;
+using std::make_pair;
+using std::sort;
+using std::string;
+using std::thread;
+using std::vector;
+
+namespace google::scp::core::common::test {
+
+class ShardedConcurrentMapTests : public ScpTestBase {};
+
+TEST_F(ShardedConcurrentMapTests, InsertElement) {
+  ShardedConcurrentMap<int, int> map;
+
+  int i;
+  EXPECT_SUCCESS(map.Insert(make_pair(1, 1), i));
+  EXPECT_EQ(i, 1);
+  EXPECT_EQ(map.Size(), 1);
+}
+
+TEST_F(ShardedConcurrentMapTests, InsertExistingElement) {
+  ShardedConcurrentMap<int, int> map;
+
+  int i;
+  EXPECT_SUCCESS(map.Insert(make_pair(1, 1), i));
+  EXPECT_THAT(map.Insert(make_pair(1, 2), i),
+              ResultIs(FailureExecutionResult(
+                  errors::SC_CONCURRENT_MAP_ENTRY_ALREADY_EXISTS)));
+  // The existing value is handed out.
+  EXPECT_EQ(i, 1);
+  EXPECT_EQ(map.Size(), 1);
+}
+
+TEST_F(ShardedConcurrentMapTests, EraseElement) {
+  ShardedConcurrentMap<int, int> map;
+
+  int value = 1;
+  EXPECT_SUCCESS(map.Insert(make_pair(2, value), value));
+  EXPECT_SUCCESS(map.Erase(2));
+  EXPECT_EQ(map.Size(), 0);
+
+  EXPECT_THAT(map.Find(2, value),
+              ResultIs(FailureExecutionResult(
+                  errors::SC_CONCURRENT_MAP_ENTRY_DOES_NOT_EXIST)));
+  EXPECT_THAT(map.Erase(2),
+              ResultIs(FailureExecutionResult(
+                  errors::SC_CONCURRENT_MAP_ENTRY_DOES_NOT_EXIST)));
+}
+
+TEST_F(ShardedConcurrentMapTests, FindAnExistingElementUuid) {
+  ShardedConcurrentMap<Uuid, Uuid, UuidCompare> map;
+
+  Uuid uuid_key = Uuid::GenerateUuid();
+  Uuid uuid_value = Uuid::GenerateUuid();
+
+  Uuid value;
+  EXPECT_SUCCESS(map.Insert(make_pair(uuid_key, uuid_value), value));
+  EXPECT_SUCCESS(map.Find(uuid_key, value));
+  EXPECT_EQ(value, uuid_value);
+}
+
+TEST_F(ShardedConcurrentMapTests, VisitAndUpdateInPlace) {
+  ShardedConcurrentMap<int, string> map(4);
+  string inserted;
+  EXPECT_SUCCESS(map.Insert(make_pair(1, "value"), inserted));
+  EXPECT_SUCCESS(map.Update(1, [](string& value) { value += "_updated"; }));
+  const string* visited_address = nullptr;
+  EXPECT_SUCCESS(map.Visit(1, [&](const string& value) {
+    EXPECT_EQ(value, "value_updated");
+    visited_address = &value;
+  }));
+  EXPECT_SUCCESS(map.Visit(1, [&](const string& value) {
+    EXPECT_EQ(&value, visited_address);
+  }));
+  EXPECT_THAT(map.Update(2, [](string&) {}),
+              ResultIs(FailureExecutionResult(
+                  errors::SC_CONCURRENT_MAP_ENTRY_DOES_NOT_EXIST)));
+}
+
+TEST_F(ShardedConcurrentMapTests, KeysAndForEachCoverAllShards) {
+  ShardedConcurrentMap<int, int> map(8);
+
+  int value;
+  for (int i = 0; i < 100; i++) {
+    EXPECT_SUCCESS(map.Insert(make_pair(i, i * 2), value));
+  }
+
+  vector<int> keys;
+  EXPECT_SUCCESS(map.Keys(keys));
+  sort(keys.begin(), keys.end());
+  ASSERT_EQ(keys.size(), 100);
+  for (int i = 0; i < 100; i++) {
+    EXPECT_EQ(keys[i], i);
+  }
+
+  int visited_count = 0;
+  map.ForEach([&](const int& key, const int& value) {
+    EXPECT_EQ(value, key * 2);
+    visited_count++;
+  });
+  EXPECT_EQ(visited_count, 100);
+}
+
+TEST_F(ShardedConcurrentMapTests, ConcurrentInsertFindErase) {
+  constexpr int kThreadCount = 4;
+  constexpr int kKeysPerThread = 5000;
+  ShardedConcurrentMap<int, int> map(16);
+
+  vector<thread> threads;
+  for (int t = 0; t < kThreadCount; t++) {
+    threads.push_back(thread([&map, t]() {
+      for (int i = 0; i < kKeysPerThread; i++) {
+        int key = t * kKeysPerThread + i;
+        int value;
+        EXPECT_SUCCESS(map.Insert(make_pair(key, key), value));
+        EXPECT_SUCCESS(map.Find(key, value));
+        EXPECT_EQ(value, key);
+        if (i % 2 == 0) {
+          EXPECT_SUCCESS(map.Erase(key));
+        }
+      }
+    }));
+  }
+  // Iterates while the writers run.
+  atomic<bool> done(false);
+  thread iterator([&]() {
+    while (!done) {
+      map.ForEach([](const int& key, const int& value) {
+        EXPECT_EQ(key, value);
+      });
+    }
+  });
+  for (auto& t : threads) {
+    t.join();
+  }
+  done = true;
+  iterator.join();
+
+  EXPECT_EQ(map.Size(), kThreadCount * kKeysPerThread / 2);
+  vector<int> keys;
+  EXPECT_SUCCESS(map.Keys(keys));
+  EXPECT_EQ(keys.size(), kThreadCount * kKeysPerThread / 2);
+  for (auto key : keys) {
+    EXPECT_EQ(key % 2, 1);
+  }
+}
+}  // namespace google::scp::core::common::test
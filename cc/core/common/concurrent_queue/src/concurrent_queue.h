@@ -17,7 +17,12 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
 
 #include "oneapi/tbb/concurrent_queue.h"
 
@@ -27,8 +32,14 @@ namespace google::scp::core::common {
 /**
  * @brief ConcurrentQueue provides multi producers and multi consumers queue
  * support to be used generically.
+ *
+ * When kWaitable is set, consumers can also wait for an element with a
+ * timeout. The waiting consumers are woken up by the enqueues, which then pay
+ * for a fence on every enqueue and only take the wait mutex when a consumer is
+ * waiting. Queues that are only polled, such as the executor task queues,
+ * leave kWaitable unset and keep the enqueues fence free.
  */
-template <class T>
+template <class T, bool kWaitable = false>
 class ConcurrentQueue {
  public:
   /**
@@ -51,6 +62,36 @@ class ConcurrentQueue {
     if (!queue_->try_push(element)) {
       return FailureExecutionResult(errors::SC_CONCURRENT_QUEUE_CANNOT_ENQUEUE);
     }
+    NotifyWaitingConsumers();
+    return SuccessExecutionResult();
+  }
+
+  /**
+   * @brief Enqueues an element into the queue by moving it if possible. This
+   * function is thread-safe. The element is left untouched if it cannot be
+   * queued.
+   * @param element the element to be queued.
+   */
+  ExecutionResult TryEnqueue(T&& element) noexcept {
+    if (!queue_->try_push(std::move(element))) {
+      return FailureExecutionResult(errors::SC_CONCURRENT_QUEUE_CANNOT_ENQUEUE);
+    }
+    NotifyWaitingConsumers();
+    return SuccessExecutionResult();
+  }
+
+  /**
+   * @brief Constructs an element in place at the end of the queue if possible.
+   * This function is thread-safe. The arguments are only consumed if the
+   * element is queued, so rvalue arguments are left untouched on failure.
+   * @param args the arguments to construct the element with.
+   */
+  template <class... Args>
+  ExecutionResult TryEmplace(Args&&... args) noexcept {
+    if (!queue_->try_emplace(std::forward<Args>(args)...)) {
+      return FailureExecutionResult(errors::SC_CONCURRENT_QUEUE_CANNOT_ENQUEUE);
+    }
+    NotifyWaitingConsumers();
     return SuccessExecutionResult();
   }
 
@@ -67,6 +108,65 @@ class ConcurrentQueue {
     return SuccessExecutionResult();
   }
 
+  /**
+   * @brief Dequeues up to max_count elements if possible, appending them to
+   * elements in queue order. If there is no element the result will contain
+   * the proper error code.
+   * @param elements the vector to append the dequeued elements to.
+   * @param max_count the maximum number of elements to dequeue.
+   * @return ExecutionResult result of the operation.
+   */
+  ExecutionResult TryDequeueBulk(std::vector<T>& elements,
+                                 size_t max_count) noexcept {
+    auto initial_size = elements.size();
+    T element;
+    while (elements.size() - initial_size < max_count &&
+           queue_->try_pop(element)) {
+      elements.push_back(std::move(element));
+    }
+    if (elements.size() == initial_size) {
+      return FailureExecutionResult(errors::SC_CONCURRENT_QUEUE_CANNOT_DEQUEUE);
+    }
+    return SuccessExecutionResult();
+  }
+
+  /**
+   * @brief Dequeues an element, waiting for up to timeout for one to be
+   * enqueued if the queue is empty. If there is still no element the result
+   * will contain the proper error code.
+   * @param element the element to be dequeued
+   * @param timeout the maximum time to wait for.
+   * @return ExecutionResult result of the operation.
+   */
+  ExecutionResult DequeueWithTimeout(
+      T& element, std::chrono::nanoseconds timeout) noexcept {
+    static_assert(kWaitable, "Waiting requires a WaitableConcurrentQueue.");
+    if (!WaitFor(timeout, [&]() { return queue_->try_pop(element); })) {
+      return FailureExecutionResult(errors::SC_CONCURRENT_QUEUE_CANNOT_DEQUEUE);
+    }
+    return SuccessExecutionResult();
+  }
+
+  /**
+   * @brief Same as TryDequeueBulk, but waits for up to timeout for an element
+   * to be enqueued if the queue is empty.
+   * @param elements the vector to append the dequeued elements to.
+   * @param max_count the maximum number of elements to dequeue.
+   * @param timeout the maximum time to wait for.
+   * @return ExecutionResult result of the operation.
+   */
+  ExecutionResult DequeueBulkWithTimeout(
+      std::vector<T>& elements, size_t max_count,
+      std::chrono::nanoseconds timeout) noexcept {
+    static_assert(kWaitable, "Waiting requires a WaitableConcurrentQueue.");
+    if (!WaitFor(timeout, [&]() {
+          return TryDequeueBulk(elements, max_count).Successful();
+        })) {
+      return FailureExecutionResult(errors::SC_CONCURRENT_QUEUE_CANNOT_DEQUEUE);
+    }
+    return SuccessExecutionResult();
+  }
+
   /**
    * @brief Provides the size of the elements in the queue. Due to the nature of
    * the concurrent queue, this value will be approximate.
@@ -75,7 +175,59 @@ class ConcurrentQueue {
   size_t Size() noexcept { return queue_->size(); }
 
  private:
+  /**
+   * @brief Calls try_dequeue until it succeeds, waiting for the enqueues in
+   * between, or until timeout passes.
+   * @return true if try_dequeue succeeded.
+   */
+  template <class TryDequeueFunction>
+  bool WaitFor(std::chrono::nanoseconds timeout,
+               TryDequeueFunction&& try_dequeue) noexcept {
+    if (try_dequeue()) {
+      return true;
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    std::unique_lock lock(wait_mutex_);
+    // Registered before trying again, so that an enqueue either is seen by
+    // the next try or sees the waiting consumer, see NotifyWaitingConsumers.
+    waiting_consumers_.fetch_add(1);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    auto dequeued = wait_condition_.wait_until(lock, deadline, try_dequeue);
+    waiting_consumers_.fetch_sub(1);
+    return dequeued;
+  }
+
+  /// Wakes up one of the consumers waiting for an element, if any. Each
+  /// enqueue adds a single element, so waking one consumer per enqueue is
+  /// enough and avoids a thundering herd on the wait mutex.
+  void NotifyWaitingConsumers() noexcept {
+    if constexpr (!kWaitable) {
+      return;
+    }
+    // Orders the enqueue before the read of the waiting consumers, pairing
+    // with the registration of a waiting consumer before its next try.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiting_consumers_.load(std::memory_order_relaxed) == 0) {
+      return;
+    }
+    // Taken so that the notification cannot fall between the failed try of a
+    // consumer and the start of its wait.
+    std::lock_guard lock(wait_mutex_);
+    wait_condition_.notify_one();
+  }
+
   /// queue implementation.
   std::unique_ptr<tbb::concurrent_bounded_queue<T>> queue_;
+  /// The number of consumers waiting for an element.
+  std::atomic<size_t> waiting_consumers_{0};
+  /// Guards the waits of the consumers.
+  std::mutex wait_mutex_;
+  /// Signaled when an element is enqueued while consumers are waiting.
+  std::condition_variable wait_condition_;
 };
+
+/// A ConcurrentQueue whose consumers can wait for an element with a timeout.
+template <class T>
+using WaitableConcurrentQueue = ConcurrentQueue<T, /*kWaitable=*/true>;
 }  // namespace google::scp::core::common
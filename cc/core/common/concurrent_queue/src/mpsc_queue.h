@@ -0,0 +1,225 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "error_codes.h"
+
+namespace google::scp::core::common {
+/// The size of a cache line, to keep the producer and consumer state apart.
+static constexpr size_t kMpscQueueCacheLineSize = 64;
+
+/**
+ * @brief MpscQueue provides a bounded lock-free queue for multiple producers
+ * and a single consumer. The elements are kept by value in a ring of
+ * max_size slots allocated upfront, and every slot carries a sequence number
+ * telling whether it is free for the producer or filled for the consumer at
+ * the current lap of the ring.
+ *
+ * An enqueue costs one compare-and-swap on the shared enqueue position and a
+ * release store on the slot. A dequeue costs no read-modify-write at all,
+ * since there is only one consumer. The producer and consumer positions are
+ * on separate cache lines.
+ *
+ * TryDequeue must only be called by one thread at a time.
+ */
+template <class T>
+class MpscQueue {
+ public:
+  /**
+   * @brief Construct a new Mpsc Queue object
+   * @param max_size Maximum size of the queue. The memory for all the
+   * elements is allocated upfront.
+   */
+  explicit MpscQueue(size_t max_size)
+      : max_size_(max_size),
+        slots_(max_size > 0 ? std::make_unique<Slot[]>(max_size) : nullptr) {
+    for (size_t i = 0; i < max_size_; ++i) {
+      slots_[i].sequence.store(GetFreeSequence(i), std::memory_order_relaxed);
+    }
+    enqueue_position_.store(0, std::memory_order_relaxed);
+    dequeue_position_.store(0, std::memory_order_relaxed);
+  }
+
+  MpscQueue() = delete;
+  MpscQueue(const MpscQueue&) = delete;
+  MpscQueue& operator=(const MpscQueue&) = delete;
+
+  ~MpscQueue() {
+    auto position = dequeue_position_.load(std::memory_order_relaxed);
+    auto end_position = enqueue_position_.load(std::memory_order_relaxed);
+    for (; position != end_position; ++position) {
+      GetElement(slots_[position % max_size_])->~T();
+    }
+  }
+
+  /**
+   * @brief Enqueues an element into the queue if possible. This function is
+   * thread-safe.
+   * @param element the element to be queued.
+   */
+  ExecutionResult TryEnqueue(const T& element) noexcept {
+    return TryEmplace(element);
+  }
+
+  /**
+   * @brief Enqueues an element into the queue by moving it if possible. This
+   * function is thread-safe. The element is left untouched if it cannot be
+   * queued.
+   * @param element the element to be queued.
+   */
+  ExecutionResult TryEnqueue(T&& element) noexcept {
+    return TryEmplace(std::move(element));
+  }
+
+  /**
+   * @brief Constructs an element in place at the end of the queue if possible.
+   * This function is thread-safe. The arguments are only consumed if the
+   * element is queued, so rvalue arguments are left untouched on failure.
+   * @param args the arguments to construct the element with.
+   */
+  template <class... Args>
+  ExecutionResult TryEmplace(Args&&... args) noexcept {
+    if (max_size_ == 0) {
+      return FailureExecutionResult(errors::SC_CONCURRENT_QUEUE_CANNOT_ENQUEUE);
+    }
+
+    auto position = enqueue_position_.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true) {
+      slot = &slots_[position % max_size_];
+      auto sequence = slot->sequence.load(std::memory_order_acquire);
+      auto difference = static_cast<intptr_t>(sequence) -
+                        static_cast<intptr_t>(GetFreeSequence(position));
+      if (difference == 0) {
+        // The slot is free at this lap, claim the position.
+        if (enqueue_position_.compare_exchange_weak(
+                position, position + 1, std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (difference < 0) {
+        // The slot still holds the element of the previous lap, so the queue
+        // is full.
+        return FailureExecutionResult(
+            errors::SC_CONCURRENT_QUEUE_CANNOT_ENQUEUE);
+      } else {
+        // Another producer claimed the position first.
+        position = enqueue_position_.load(std::memory_order_relaxed);
+      }
+    }
+
+    new (&slot->storage) T(std::forward<Args>(args)...);
+    slot->sequence.store(GetFilledSequence(position),
+                         std::memory_order_release);
+    return SuccessExecutionResult();
+  }
+
+  /**
+   * @brief Dequeue an element if possible. If there is no element the result
+   * will contain the proper error code. Must only be called by one thread at a
+   * time.
+   * @param element the element to be dequeued
+   * @return ExecutionResult result of the operation.
+   */
+  ExecutionResult TryDequeue(T& element) noexcept {
+    if (max_size_ == 0) {
+      return FailureExecutionResult(errors::SC_CONCURRENT_QUEUE_CANNOT_DEQUEUE);
+    }
+
+    auto position = dequeue_position_.load(std::memory_order_relaxed);
+    auto& slot = slots_[position % max_size_];
+    if (slot.sequence.load(std::memory_order_acquire) !=
+        GetFilledSequence(position)) {
+      // Either empty, or the producer of the position has not finished yet.
+      return FailureExecutionResult(errors::SC_CONCURRENT_QUEUE_CANNOT_DEQUEUE);
+    }
+
+    auto* stored_element = GetElement(slot);
+    element = std::move(*stored_element);
+    stored_element->~T();
+    // Frees the slot for the producers of the next lap.
+    slot.sequence.store(GetFreeSequence(position + max_size_),
+                        std::memory_order_release);
+    dequeue_position_.store(position + 1, std::memory_order_release);
+    return SuccessExecutionResult();
+  }
+
+  /**
+   * @brief Provides the size of the elements in the queue. Due to the nature of
+   * the concurrent queue, this value will be approximate.
+   * @return size_t number of elements in the queue.
+   */
+  size_t Size() noexcept {
+    auto dequeue_position = dequeue_position_.load(std::memory_order_acquire);
+    auto enqueue_position = enqueue_position_.load(std::memory_order_acquire);
+    // The positions are read one after the other, so the dequeue position may
+    // have moved past the read enqueue position.
+    return enqueue_position > dequeue_position
+               ? enqueue_position - dequeue_position
+               : 0;
+  }
+
+ private:
+  /// A slot of the ring, holding an element when it is filled.
+  struct Slot {
+    /**
+     * @brief The free sequence of the position of the slot at the current lap
+     * when the slot is free, and the filled sequence when it holds an element.
+     */
+    std::atomic<size_t> sequence;
+    /// The storage of the element.
+    std::aligned_storage_t<sizeof(T), alignof(T)> storage;
+  };
+
+  /**
+   * @brief Returns the sequence of a slot that is free for the position. The
+   * sequences of a position are two apart from the ones of the next position,
+   * so that a free and a filled slot are told apart even with a single slot.
+   */
+  static size_t GetFreeSequence(size_t position) noexcept {
+    return position * 2;
+  }
+
+  /// Returns the sequence of a slot that holds the element of the position.
+  static size_t GetFilledSequence(size_t position) noexcept {
+    return position * 2 + 1;
+  }
+
+  /// Returns the element held by the slot.
+  static T* GetElement(Slot& slot) noexcept {
+    return std::launder(reinterpret_cast<T*>(&slot.storage));
+  }
+
+  /// The maximum number of queued elements, and the number of slots.
+  const size_t max_size_;
+  /// The ring of slots.
+  std::unique_ptr<Slot[]> slots_;
+  /// The next position to be claimed by the producers.
+  alignas(kMpscQueueCacheLineSize) std::atomic<size_t> enqueue_position_;
+  /**
+   * @brief The next position to be read by the consumer. The alignment of the
+   * class pads it to the end of its cache line.
+   */
+  alignas(kMpscQueueCacheLineSize) std::atomic<size_t> dequeue_position_;
+};
+}  // namespace google::scp::core::common
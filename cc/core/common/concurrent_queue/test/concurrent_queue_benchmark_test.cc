@@ -0,0 +1,131 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "core/common/concurrent_queue/src/concurrent_queue.h"
+
+using google::scp::core::common::ConcurrentQueue;
+using google::scp::core::common::WaitableConcurrentQueue;
+using std::atomic;
+using std::thread;
+using std::vector;
+using std::chrono::microseconds;
+using std::chrono::seconds;
+
+namespace google::scp::core::common::test {
+/// The number of elements enqueued before they are drained.
+static constexpr int kBatchSize = 256;
+/// The sleep between the tries of a polling consumer.
+static constexpr microseconds kPollInterval = microseconds(100);
+
+/// Enqueues a batch of elements and drains it one element at a time.
+static void BM_DrainOneByOne(benchmark::State& state) {
+  ConcurrentQueue<int> queue(kBatchSize);
+  int element;
+  for (auto _ : state) {
+    for (int i = 0; i < kBatchSize; i++) {
+      queue.TryEnqueue(i);
+    }
+    while (queue.TryDequeue(element).Successful()) {
+      benchmark::DoNotOptimize(element);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kBatchSize);
+}
+
+/// Same as BM_DrainOneByOne, but drains with TryDequeueBulk.
+static void BM_DrainBulk(benchmark::State& state) {
+  ConcurrentQueue<int> queue(kBatchSize);
+  vector<int> elements;
+  elements.reserve(kBatchSize);
+  for (auto _ : state) {
+    for (int i = 0; i < kBatchSize; i++) {
+      queue.TryEnqueue(i);
+    }
+    elements.clear();
+    while (queue.TryDequeueBulk(elements, kBatchSize).Successful()) {
+    }
+    benchmark::DoNotOptimize(elements.data());
+  }
+  state.SetItemsProcessed(state.iterations() * kBatchSize);
+}
+
+/**
+ * @brief Bounces an element between two threads through two queues, with the
+ * echoing thread waiting on DequeueWithTimeout. The iteration time is the
+ * round trip time.
+ */
+static void BM_PingPongWaiting(benchmark::State& state) {
+  WaitableConcurrentQueue<int> ping(1);
+  WaitableConcurrentQueue<int> pong(1);
+  atomic<bool> stop(false);
+  thread echo([&]() {
+    int element;
+    while (!stop) {
+      if (ping.DequeueWithTimeout(element, seconds(1)).Successful()) {
+        pong.TryEnqueue(element);
+      }
+    }
+  });
+
+  int element = 0;
+  for (auto _ : state) {
+    ping.TryEnqueue(element);
+    pong.DequeueWithTimeout(element, seconds(1));
+  }
+  stop = true;
+  echo.join();
+}
+
+/// Same as BM_PingPongWaiting, but the echoing thread polls with sleeps.
+static void BM_PingPongPolling(benchmark::State& state) {
+  ConcurrentQueue<int> ping(1);
+  WaitableConcurrentQueue<int> pong(1);
+  atomic<bool> stop(false);
+  thread echo([&]() {
+    int element;
+    while (!stop) {
+      if (ping.TryDequeue(element).Successful()) {
+        pong.TryEnqueue(element);
+      } else {
+        std::this_thread::sleep_for(kPollInterval);
+      }
+    }
+  });
+
+  int element = 0;
+  for (auto _ : state) {
+    ping.TryEnqueue(element);
+    pong.DequeueWithTimeout(element, seconds(1));
+  }
+  stop = true;
+  echo.join();
+}
+}  // namespace google::scp::core::common::test
+
+BENCHMARK(google::scp::core::common::test::BM_DrainOneByOne);
+BENCHMARK(google::scp::core::common::test::BM_DrainBulk);
+BENCHMARK(google::scp::core::common::test::BM_PingPongWaiting)->UseRealTime();
+BENCHMARK(google::scp::core::common::test::BM_PingPongPolling)->UseRealTime();
+
+// Run the benchmark
+BENCHMARK_MAIN();
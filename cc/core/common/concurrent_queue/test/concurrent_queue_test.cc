@@ -19,7 +19,10 @@
 #include <gtest/gtest.h>
 
 #include <atomic>
+#include <chrono>
+#include <memory>
 #include <thread>
+#include <utility>
 #include <vector>
 
 #include "core/test/scp_test_base.h"
@@ -27,12 +30,19 @@
 
 using google::scp::core::ExecutionResult;
 using google::scp::core::common::ConcurrentQueue;
+using google::scp::core::common::WaitableConcurrentQueue;
 using google::scp::core::test::ResultIs;
 using google::scp::core::test::ScpTestBase;
 
 using std::atomic;
+using std::make_unique;
+using std::move;
 using std::thread;
+using std::unique_ptr;
 using std::vector;
+using std::chrono::milliseconds;
+using std::chrono::steady_clock;
+using std::this_thread::sleep_for;
 using std::this_thread::yield;
 
 namespace google::scp::core::common::test {
@@ -65,6 +75,160 @@ TEST_F(ConcurrentQueueTests, ErrorOnNoElement) {
                           errors::SC_CONCURRENT_QUEUE_CANNOT_DEQUEUE)));
 }
 
+TEST_F(ConcurrentQueueTests, EmplaceLeavesArgumentsOnFailure) {
+  ConcurrentQueue<unique_ptr<int>> queue(1);
+
+  auto first = make_unique<int>(1);
+  EXPECT_SUCCESS(queue.TryEmplace(move(first)));
+  EXPECT_EQ(first, nullptr);
+
+  auto second = make_unique<int>(2);
+  EXPECT_THAT(queue.TryEmplace(move(second)),
+              ResultIs(FailureExecutionResult(
+                  errors::SC_CONCURRENT_QUEUE_CANNOT_ENQUEUE)));
+  ASSERT_NE(second, nullptr);
+  EXPECT_EQ(*second, 2);
+
+  unique_ptr<int> element;
+  EXPECT_SUCCESS(queue.TryDequeue(element));
+  EXPECT_EQ(*element, 1);
+}
+
+TEST_F(ConcurrentQueueTests, DequeueBulk) {
+  ConcurrentQueue<int> queue(10);
+
+  vector<int> elements;
+  EXPECT_THAT(queue.TryDequeueBulk(elements, 4),
+              ResultIs(FailureExecutionResult(
+                  errors::SC_CONCURRENT_QUEUE_CANNOT_DEQUEUE)));
+
+  for (int i = 0; i < 6; i++) {
+    EXPECT_SUCCESS(queue.TryEnqueue(i));
+  }
+  EXPECT_SUCCESS(queue.TryDequeueBulk(elements, 4));
+  EXPECT_EQ(elements, vector<int>({0, 1, 2, 3}));
+
+  // Appends to the elements.
+  EXPECT_SUCCESS(queue.TryDequeueBulk(elements, 4));
+  EXPECT_EQ(elements, vector<int>({0, 1, 2, 3, 4, 5}));
+  EXPECT_EQ(queue.Size(), 0);
+}
+
+TEST_F(ConcurrentQueueTests, DequeueBulkOfMoveOnlyElements) {
+  ConcurrentQueue<unique_ptr<int>> queue(10);
+
+  EXPECT_SUCCESS(queue.TryEnqueue(make_unique<int>(1)));
+  EXPECT_SUCCESS(queue.TryEmplace(make_unique<int>(2)));
+
+  vector<unique_ptr<int>> elements;
+  EXPECT_SUCCESS(queue.TryDequeueBulk(elements, 10));
+  ASSERT_EQ(elements.size(), 2);
+  EXPECT_EQ(*elements[0], 1);
+  EXPECT_EQ(*elements[1], 2);
+}
+
+TEST_F(ConcurrentQueueTests, DequeueWithTimeoutTimesOut) {
+  WaitableConcurrentQueue<int> queue(10);
+
+  int element;
+  auto start = steady_clock::now();
+  EXPECT_THAT(queue.DequeueWithTimeout(element, milliseconds(50)),
+              ResultIs(FailureExecutionResult(
+                  errors::SC_CONCURRENT_QUEUE_CANNOT_DEQUEUE)));
+  EXPECT_GE(steady_clock::now() - start, milliseconds(50));
+
+  vector<int> elements;
+  EXPECT_THAT(queue.DequeueBulkWithTimeout(elements, 10, milliseconds(0)),
+              ResultIs(FailureExecutionResult(
+                  errors::SC_CONCURRENT_QUEUE_CANNOT_DEQUEUE)));
+}
+
+TEST_F(ConcurrentQueueTests, DequeueWithTimeoutWakesOnEnqueue) {
+  WaitableConcurrentQueue<int> queue(10);
+
+  // Returns right away if there is an element.
+  EXPECT_SUCCESS(queue.TryEnqueue(1));
+  int element;
+  EXPECT_SUCCESS(queue.DequeueWithTimeout(element, milliseconds(0)));
+  EXPECT_EQ(element, 1);
+
+  thread producer([&queue]() {
+    sleep_for(milliseconds(50));
+    EXPECT_SUCCESS(queue.TryEnqueue(2));
+  });
+  auto start = steady_clock::now();
+  EXPECT_SUCCESS(queue.DequeueWithTimeout(element, milliseconds(10000)));
+  EXPECT_LT(steady_clock::now() - start, milliseconds(5000));
+  EXPECT_EQ(element, 2);
+  producer.join();
+}
+
+TEST_F(ConcurrentQueueTests, EachEnqueueWakesAWaitingConsumer) {
+  constexpr int kConsumerCount = 4;
+  WaitableConcurrentQueue<int> queue(10);
+
+  atomic<int> dequeued_count(0);
+  vector<thread> consumers;
+  for (int i = 0; i < kConsumerCount; i++) {
+    consumers.push_back(thread([&]() {
+      int element;
+      if (queue.DequeueWithTimeout(element, milliseconds(10000)).Successful()) {
+        dequeued_count++;
+      }
+    }));
+  }
+  // Gives the consumers time to start waiting.
+  sleep_for(milliseconds(50));
+
+  auto start = steady_clock::now();
+  for (int i = 0; i < kConsumerCount; i++) {
+    EXPECT_SUCCESS(queue.TryEnqueue(i));
+  }
+  for (auto& consumer : consumers) {
+    consumer.join();
+  }
+  EXPECT_LT(steady_clock::now() - start, milliseconds(5000));
+  EXPECT_EQ(dequeued_count, kConsumerCount);
+}
+
+TEST_F(ConcurrentQueueTests, MultiThreadedDequeueBulkWithTimeout) {
+  constexpr int kElementCount = 10000;
+  constexpr int kConsumerCount = 4;
+  WaitableConcurrentQueue<int> queue(100);
+
+  atomic<int> dequeued_count(0);
+  atomic<int64_t> dequeued_sum(0);
+  vector<thread> consumers;
+  for (int i = 0; i < kConsumerCount; i++) {
+    consumers.push_back(thread([&]() {
+      vector<int> elements;
+      while (dequeued_count < kElementCount) {
+        elements.clear();
+        if (queue.DequeueBulkWithTimeout(elements, 16, milliseconds(10))
+                .Successful()) {
+          for (auto element : elements) {
+            dequeued_sum += element;
+          }
+          dequeued_count += elements.size();
+        }
+      }
+    }));
+  }
+
+  for (int i = 0; i < kElementCount; i++) {
+    while (!queue.TryEnqueue(i).Successful()) {
+      yield();
+    }
+  }
+  for (auto& consumer : consumers) {
+    consumer.join();
+  }
+
+  EXPECT_EQ(dequeued_count, kElementCount);
+  EXPECT_EQ(dequeued_sum,
+            static_cast<int64_t>(kElementCount) * (kElementCount - 1) / 2);
+}
+
 TEST_F(ConcurrentQueueTests, MultiThreadedEnqueue) {
   ConcurrentQueue<int> queue(100);
 
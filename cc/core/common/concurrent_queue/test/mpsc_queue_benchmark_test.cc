@@ -0,0 +1,108 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "core/common/concurrent_queue/src/concurrent_queue.h"
+#include "core/common/concurrent_queue/src/mpsc_queue.h"
+
+using google::scp::core::common::ConcurrentQueue;
+using google::scp::core::common::MpscQueue;
+using std::atomic;
+using std::function;
+using std::move;
+using std::thread;
+using std::vector;
+using std::this_thread::yield;
+
+namespace google::scp::core::common::test {
+static constexpr size_t kElementsPerProducer = 100000;
+static constexpr size_t kQueueCap = 100000;
+
+/**
+ * @brief Has state.range(0) producer threads enqueue into the queue while the
+ * benchmark thread dequeues, the way the worker of an executor does. The
+ * elements have the size of a scheduled operation.
+ */
+template <class QueueType>
+static void BenchmarkProducersToSingleConsumer(benchmark::State& state) {
+  size_t producer_count = state.range(0);
+  size_t rejected_count = 0;
+  for (auto _ : state) {
+    QueueType queue(kQueueCap);
+    atomic<size_t> producer_rejected_count(0);
+    vector<thread> producers;
+    for (size_t producer = 0; producer < producer_count; producer++) {
+      producers.push_back(thread([&]() {
+        size_t local_rejected_count = 0;
+        for (size_t i = 0; i < kElementsPerProducer; i++) {
+          function<void()> element = [i]() { benchmark::DoNotOptimize(i); };
+          while (!queue.TryEnqueue(move(element)).Successful()) {
+            local_rejected_count++;
+            yield();
+          }
+        }
+        producer_rejected_count += local_rejected_count;
+      }));
+    }
+
+    size_t dequeued_count = 0;
+    function<void()> element;
+    while (dequeued_count < producer_count * kElementsPerProducer) {
+      if (queue.TryDequeue(element).Successful()) {
+        dequeued_count++;
+      }
+    }
+    for (auto& producer : producers) {
+      producer.join();
+    }
+    rejected_count += producer_rejected_count;
+  }
+  state.counters["rejected"] = rejected_count;
+  state.SetItemsProcessed(state.iterations() * producer_count *
+                          kElementsPerProducer);
+}
+
+static void BM_ConcurrentQueue(benchmark::State& state) {
+  BenchmarkProducersToSingleConsumer<ConcurrentQueue<function<void()>>>(state);
+}
+
+static void BM_MpscQueue(benchmark::State& state) {
+  BenchmarkProducersToSingleConsumer<MpscQueue<function<void()>>>(state);
+}
+}  // namespace google::scp::core::common::test
+
+// Arg<Producer count>
+BENCHMARK(google::scp::core::common::test::BM_ConcurrentQueue)
+    ->Arg(1)
+    ->Arg(4)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+// Arg<Producer count>
+BENCHMARK(google::scp::core::common::test::BM_MpscQueue)
+    ->Arg(1)
+    ->Arg(4)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+// Run the benchmark
+BENCHMARK_MAIN();
@@ -0,0 +1,180 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/common/concurrent_queue/src/mpsc_queue.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "core/test/scp_test_base.h"
+#include "public/core/test/interface/execution_result_matchers.h"
+
+using google::scp::core::common::MpscQueue;
+using google::scp::core::test::ResultIs;
+using google::scp::core::test::ScpTestBase;
+
+using std::atomic;
+using std::make_shared;
+using std::make_unique;
+using std::move;
+using std::pair;
+using std::shared_ptr;
+using std::thread;
+using std::unique_ptr;
+using std::vector;
+using std::this_thread::yield;
+
+namespace google::scp::core::common::test {
+
+class MpscQueueTests : public ScpTestBase {};
+
+TEST_F(MpscQueueTests, CreateQueueTest) {
+  MpscQueue<int> queue(10);
+
+  EXPECT_EQ(queue.Size(), 0);
+}
+
+TEST_F(MpscQueueTests, ErrorOnMaxSize) {
+  MpscQueue<int> queue(0);
+
+  int i = 1;
+  EXPECT_THAT(queue.TryEnqueue(i),
+              ResultIs(FailureExecutionResult(
+                  errors::SC_CONCURRENT_QUEUE_CANNOT_ENQUEUE)));
+  EXPECT_THAT(queue.TryDequeue(i),
+              ResultIs(FailureExecutionResult(
+                  errors::SC_CONCURRENT_QUEUE_CANNOT_DEQUEUE)));
+}
+
+TEST_F(MpscQueueTests, ErrorOnNoElement) {
+  MpscQueue<int> queue(1);
+
+  int i;
+  auto result = queue.TryDequeue(i);
+
+  EXPECT_THAT(result, ResultIs(FailureExecutionResult(
+                          errors::SC_CONCURRENT_QUEUE_CANNOT_DEQUEUE)));
+}
+
+TEST_F(MpscQueueTests, RejectsWhenFullAndOrdersAcrossLaps) {
+  MpscQueue<int> queue(3);
+
+  int next_enqueued = 0;
+  int next_dequeued = 0;
+  for (int lap = 0; lap < 5; lap++) {
+    for (int i = 0; i < 3; i++) {
+      EXPECT_SUCCESS(queue.TryEnqueue(next_enqueued++));
+    }
+    EXPECT_EQ(queue.Size(), 3);
+    EXPECT_THAT(queue.TryEnqueue(-1),
+                ResultIs(FailureExecutionResult(
+                    errors::SC_CONCURRENT_QUEUE_CANNOT_ENQUEUE)));
+
+    // Frees one slot at a time, in the middle of the ring.
+    int element;
+    EXPECT_SUCCESS(queue.TryDequeue(element));
+    EXPECT_EQ(element, next_dequeued++);
+    EXPECT_SUCCESS(queue.TryEnqueue(next_enqueued++));
+    while (queue.TryDequeue(element).Successful()) {
+      EXPECT_EQ(element, next_dequeued++);
+    }
+    EXPECT_EQ(queue.Size(), 0);
+  }
+  EXPECT_EQ(next_dequeued, next_enqueued);
+}
+
+TEST_F(MpscQueueTests, EmplaceLeavesArgumentsOnFailure) {
+  MpscQueue<unique_ptr<int>> queue(1);
+
+  auto first = make_unique<int>(1);
+  EXPECT_SUCCESS(queue.TryEmplace(move(first)));
+  EXPECT_EQ(first, nullptr);
+
+  auto second = make_unique<int>(2);
+  EXPECT_THAT(queue.TryEmplace(move(second)),
+              ResultIs(FailureExecutionResult(
+                  errors::SC_CONCURRENT_QUEUE_CANNOT_ENQUEUE)));
+  ASSERT_NE(second, nullptr);
+  EXPECT_EQ(*second, 2);
+
+  unique_ptr<int> element;
+  EXPECT_SUCCESS(queue.TryDequeue(element));
+  EXPECT_EQ(*element, 1);
+}
+
+TEST_F(MpscQueueTests, DestroysQueuedElements) {
+  auto element = make_shared<int>(1);
+  {
+    MpscQueue<shared_ptr<int>> queue(4);
+    // Wraps around the ring before the queue is destroyed.
+    for (int i = 0; i < 3; i++) {
+      EXPECT_SUCCESS(queue.TryEnqueue(element));
+    }
+    shared_ptr<int> dequeued;
+    EXPECT_SUCCESS(queue.TryDequeue(dequeued));
+    EXPECT_SUCCESS(queue.TryDequeue(dequeued));
+    dequeued.reset();
+    for (int i = 0; i < 3; i++) {
+      EXPECT_SUCCESS(queue.TryEnqueue(element));
+    }
+    EXPECT_EQ(element.use_count(), 5);
+  }
+  EXPECT_EQ(element.use_count(), 1);
+}
+
+TEST_F(MpscQueueTests, MultipleProducersSingleConsumer) {
+  constexpr int kProducerCount = 4;
+  constexpr int kElementsPerProducer = 20000;
+  MpscQueue<pair<int, int>> queue(64);
+
+  vector<thread> producers;
+  for (int producer = 0; producer < kProducerCount; producer++) {
+    producers.push_back(thread([producer, &queue]() {
+      for (int i = 0; i < kElementsPerProducer; i++) {
+        while (!queue.TryEnqueue({producer, i}).Successful()) {
+          yield();
+        }
+      }
+    }));
+  }
+
+  // The elements of every producer are dequeued in the order it enqueued them.
+  vector<int> next_elements(kProducerCount, 0);
+  int dequeued_count = 0;
+  while (dequeued_count < kProducerCount * kElementsPerProducer) {
+    pair<int, int> element;
+    if (!queue.TryDequeue(element).Successful()) {
+      yield();
+      continue;
+    }
+    EXPECT_EQ(element.second, next_elements[element.first]++);
+    dequeued_count++;
+  }
+
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  EXPECT_EQ(queue.Size(), 0);
+  for (auto next_element : next_elements) {
+    EXPECT_EQ(next_element, kElementsPerProducer);
+  }
+}
+}  // namespace google::scp::core::common::test
@@ -0,0 +1,389 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/hash/hash.h"
+#include "core/common/time_provider/src/time_provider.h"
+#include "oneapi/tbb/spin_rw_mutex.h"
+
+namespace google::scp::core::common {
+/// The default maximum number of shards of a ShardedLruCache.
+static constexpr size_t kDefaultLruCacheShardCount = 16;
+/**
+ * @brief The minimum capacity of a shard. Smaller caches have fewer shards, so
+ * that an uneven spread of the keys does not evict elements early.
+ */
+static constexpr size_t kMinLruCacheShardCapacity = 16;
+/// The size of a cache line, to keep the locks of the shards apart.
+static constexpr size_t kLruCacheCacheLineSize = 64;
+
+/// The counters of a ShardedLruCache since it was created.
+struct LruCacheCounters {
+  /// The number of Get calls that found an element.
+  uint64_t hit_count = 0;
+  /// The number of Get calls that found no element, or an expired one.
+  uint64_t miss_count = 0;
+  /// The number of elements evicted to make room for new ones.
+  uint64_t eviction_count = 0;
+  /// The number of elements removed because their time to live passed.
+  uint64_t expiration_count = 0;
+};
+
+/**
+ * @brief A concurrent cache of a bounded number of elements, split into shards
+ * by the hash of the key. Every shard has its own reader-writer spin lock, and
+ * the lookups only take it for reading.
+ *
+ * The least recently used elements are approximated with the CLOCK algorithm:
+ * a lookup only sets the referenced bit of the element, and when a shard is
+ * full, its clock hand sweeps over the elements, clearing the referenced bits,
+ * until it finds an element that was not referenced since the previous sweep
+ * to evict.
+ *
+ * The values are immutable and handed out as reference counted handles, so a
+ * lookup never copies the value, and a handle stays valid after its element
+ * is replaced or evicted.
+ *
+ * @tparam TKey
+ * @tparam TVal
+ */
+template <typename TKey, typename TVal>
+class ShardedLruCache {
+  /// The lock of a shard.
+  typedef oneapi::tbb::spin_rw_mutex ShardMutex;
+
+ public:
+  /// A handle to a cached value.
+  using Handle = std::shared_ptr<const TVal>;
+
+  /**
+   * @brief Construct a new Sharded Lru Cache object
+   *
+   * @param capacity the maximum number of elements in the cache.
+   * @param time_to_live if set, the elements expire this long after they are
+   * set.
+   * @param max_shard_count the maximum number of shards, see
+   * kMinLruCacheShardCapacity.
+   */
+  explicit ShardedLruCache(
+      size_t capacity,
+      std::optional<std::chrono::nanoseconds> time_to_live = std::nullopt,
+      size_t max_shard_count = kDefaultLruCacheShardCount)
+      : capacity_(capacity),
+        time_to_live_(time_to_live),
+        shard_mask_(GetShardCount(capacity, max_shard_count) - 1),
+        shards_(std::make_unique<Shard[]>(shard_mask_ + 1)) {
+    auto shard_count = shard_mask_ + 1;
+    for (size_t i = 0; i < shard_count; ++i) {
+      // The remainder of the capacity goes to the first shards.
+      shards_[i].Init(capacity / shard_count +
+                      (i < capacity % shard_count ? 1 : 0));
+    }
+  }
+
+  ShardedLruCache(const ShardedLruCache&) = delete;
+  ShardedLruCache& operator=(const ShardedLruCache&) = delete;
+
+  /**
+   * @brief Sets the value of the key, evicting an element if the shard of the
+   * key is full. The handles to a replaced value stay valid.
+   */
+  void Set(const TKey& key, TVal value) {
+    if (capacity_ == 0) {
+      return;
+    }
+    auto handle = std::make_shared<const TVal>(std::move(value));
+    auto expiration_timestamp = GetExpirationTimestamp();
+    auto& shard = GetShard(key);
+    // Declared before the lock, so that the old value is destroyed after the
+    // lock is released.
+    Handle old_value;
+    ShardMutex::scoped_lock lock(shard.mutex, /*write=*/true);
+
+    size_t slot;
+    auto found = shard.index.find(key);
+    if (found != shard.index.end()) {
+      slot = found->second;
+    } else {
+      slot = shard.AcquireSlot(time_to_live_.has_value());
+      shard.slots[slot].key = key;
+      shard.index.emplace(key, slot);
+    }
+    auto& entry = shard.slots[slot];
+    old_value = std::move(entry.value);
+    entry.value = std::move(handle);
+    entry.expiration_timestamp = expiration_timestamp;
+    // A new element gets a full sweep of the clock before it can be evicted.
+    entry.referenced.store(true, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Returns a handle to the value of the key, or nullptr if the key is
+   * not in the cache or has expired.
+   */
+  Handle Get(const TKey& key) {
+    auto& shard = GetShard(key);
+    ShardMutex::scoped_lock lock(shard.mutex, /*write=*/false);
+    auto found = shard.index.find(key);
+    if (found == shard.index.end()) {
+      shard.miss_count.fetch_add(1, std::memory_order_relaxed);
+      return nullptr;
+    }
+    auto& entry = shard.slots[found->second];
+    if (IsExpired(entry)) {
+      // Left to the clock hand or the next Set, as the lock is only shared.
+      shard.miss_count.fetch_add(1, std::memory_order_relaxed);
+      return nullptr;
+    }
+    // Only written when it changes, to keep the cache line shared.
+    if (!entry.referenced.load(std::memory_order_relaxed)) {
+      entry.referenced.store(true, std::memory_order_relaxed);
+    }
+    shard.hit_count.fetch_add(1, std::memory_order_relaxed);
+    return entry.value;
+  }
+
+  /**
+   * @brief Returns true if the key is in the cache and has not expired. Does
+   * not count as a use of the element.
+   */
+  bool Contains(const TKey& key) {
+    auto& shard = GetShard(key);
+    ShardMutex::scoped_lock lock(shard.mutex, /*write=*/false);
+    auto found = shard.index.find(key);
+    return found != shard.index.end() &&
+           !IsExpired(shard.slots[found->second]);
+  }
+
+  /// Removes the key from the cache. Returns false if it was not in the cache.
+  bool Erase(const TKey& key) {
+    auto& shard = GetShard(key);
+    Handle old_value;
+    ShardMutex::scoped_lock lock(shard.mutex, /*write=*/true);
+    auto found = shard.index.find(key);
+    if (found == shard.index.end()) {
+      return false;
+    }
+    old_value = shard.ReleaseSlot(found->second);
+    return true;
+  }
+
+  /// Returns the number of elements in the cache, including expired ones.
+  size_t Size() {
+    size_t size = 0;
+    for (size_t i = 0; i <= shard_mask_; ++i) {
+      size += shards_[i].size.load(std::memory_order_relaxed);
+    }
+    return size;
+  }
+
+  size_t Capacity() { return capacity_; }
+
+  void Clear() {
+    for (size_t i = 0; i <= shard_mask_; ++i) {
+      auto& shard = shards_[i];
+      std::vector<Handle> old_values;
+      ShardMutex::scoped_lock lock(shard.mutex, /*write=*/true);
+      while (!shard.index.empty()) {
+        old_values.push_back(shard.ReleaseSlot(shard.index.begin()->second));
+      }
+    }
+  }
+
+  /// Returns a copy of all the elements that have not expired.
+  absl::flat_hash_map<TKey, TVal> GetAll() {
+    absl::flat_hash_map<TKey, TVal> result;
+    for (size_t i = 0; i <= shard_mask_; ++i) {
+      auto& shard = shards_[i];
+      ShardMutex::scoped_lock lock(shard.mutex, /*write=*/false);
+      for (const auto& [key, slot] : shard.index) {
+        if (!IsExpired(shard.slots[slot])) {
+          result.emplace(key, *shard.slots[slot].value);
+        }
+      }
+    }
+    return result;
+  }
+
+  /// Returns the counters summed over the shards.
+  LruCacheCounters GetCounters() {
+    LruCacheCounters counters;
+    for (size_t i = 0; i <= shard_mask_; ++i) {
+      auto& shard = shards_[i];
+      counters.hit_count += shard.hit_count.load(std::memory_order_relaxed);
+      counters.miss_count += shard.miss_count.load(std::memory_order_relaxed);
+      counters.eviction_count +=
+          shard.eviction_count.load(std::memory_order_relaxed);
+      counters.expiration_count +=
+          shard.expiration_count.load(std::memory_order_relaxed);
+    }
+    return counters;
+  }
+
+ private:
+  /// A slot of a shard, holding an element when value is set.
+  struct Entry {
+    TKey key{};
+    Handle value;
+    /// The steady clock timestamp in nanoseconds the element expires at.
+    Timestamp expiration_timestamp = UINT64_MAX;
+    /// Set by the lookups, cleared by the clock hand.
+    std::atomic<bool> referenced{false};
+  };
+
+  /// A shard of the cache, on cache lines of its own.
+  struct alignas(kLruCacheCacheLineSize) Shard {
+    /// Allocates the slots of the shard.
+    void Init(size_t shard_capacity) {
+      capacity = shard_capacity;
+      slots = std::make_unique<Entry[]>(capacity);
+      index.reserve(capacity);
+      free_slots.reserve(capacity);
+      for (size_t i = capacity; i > 0; --i) {
+        free_slots.push_back(i - 1);
+      }
+    }
+
+    /**
+     * @brief Returns a free slot, evicting an element if the shard is full.
+     * The slot is counted in the size of the shard.
+     */
+    size_t AcquireSlot(bool has_time_to_live) {
+      if (free_slots.empty()) {
+        Evict(has_time_to_live);
+      }
+      auto slot = free_slots.back();
+      free_slots.pop_back();
+      size.fetch_add(1, std::memory_order_relaxed);
+      return slot;
+    }
+
+    /**
+     * @brief Sweeps the clock hand until it finds an element to evict. An
+     * expired element is evicted right away, and the elements referenced since
+     * the previous sweep get another round.
+     */
+    void Evict(bool has_time_to_live) {
+      auto current_timestamp =
+          has_time_to_live
+              ? TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks()
+              : 0;
+      while (true) {
+        auto slot = clock_hand;
+        clock_hand = (clock_hand + 1) % capacity;
+        auto& entry = slots[slot];
+        if (has_time_to_live &&
+            entry.expiration_timestamp <= current_timestamp) {
+          expiration_count.fetch_add(1, std::memory_order_relaxed);
+        } else if (entry.referenced.load(std::memory_order_relaxed)) {
+          entry.referenced.store(false, std::memory_order_relaxed);
+          continue;
+        } else {
+          eviction_count.fetch_add(1, std::memory_order_relaxed);
+        }
+        // The evicted value is only referenced by the handles out there.
+        ReleaseSlot(slot);
+        return;
+      }
+    }
+
+    /// Removes the element of the slot and returns its value.
+    Handle ReleaseSlot(size_t slot) {
+      auto& entry = slots[slot];
+      index.erase(entry.key);
+      free_slots.push_back(slot);
+      size.fetch_sub(1, std::memory_order_relaxed);
+      entry.referenced.store(false, std::memory_order_relaxed);
+      return std::move(entry.value);
+    }
+
+    /// Guards the elements of the shard.
+    ShardMutex mutex;
+    /// The maximum number of elements in the shard.
+    size_t capacity = 0;
+    /// The slots the clock hand sweeps over.
+    std::unique_ptr<Entry[]> slots;
+    /// The slots of the keys in the shard.
+    absl::flat_hash_map<TKey, size_t> index;
+    /// The slots without an element.
+    std::vector<size_t> free_slots;
+    /// The slot the clock hand looks at next.
+    size_t clock_hand = 0;
+    /// The number of elements, readable without the lock.
+    std::atomic<size_t> size{0};
+    std::atomic<uint64_t> hit_count{0};
+    std::atomic<uint64_t> miss_count{0};
+    std::atomic<uint64_t> eviction_count{0};
+    std::atomic<uint64_t> expiration_count{0};
+  };
+
+  /**
+   * @brief Returns the number of shards, the largest power of two that is at
+   * most max_shard_count and leaves every shard kMinLruCacheShardCapacity.
+   */
+  static size_t GetShardCount(size_t capacity, size_t max_shard_count) {
+    auto shard_count_limit =
+        std::min(max_shard_count, capacity / kMinLruCacheShardCapacity);
+    size_t shard_count = 1;
+    while (shard_count * 2 <= shard_count_limit) {
+      shard_count *= 2;
+    }
+    return shard_count;
+  }
+
+  /// Returns the timestamp an element set now expires at.
+  Timestamp GetExpirationTimestamp() const {
+    if (!time_to_live_) {
+      return UINT64_MAX;
+    }
+    return TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks() +
+           time_to_live_->count();
+  }
+
+  /// Returns true if the element of the entry has expired.
+  bool IsExpired(const Entry& entry) const {
+    return time_to_live_ &&
+           entry.expiration_timestamp <=
+               TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks();
+  }
+
+  /// Returns the shard of the key.
+  Shard& GetShard(const TKey& key) {
+    // The upper bits, as the hash table of the shard uses the lower ones.
+    return shards_[(absl::Hash<TKey>()(key) >> 32) & shard_mask_];
+  }
+
+  /// The maximum number of elements in the cache.
+  const size_t capacity_;
+  /// The time after which the elements expire, if any.
+  const std::optional<std::chrono::nanoseconds> time_to_live_;
+  /// The number of shards minus one, to pick a shard from the hash.
+  const size_t shard_mask_;
+  /// The shards of the cache.
+  std::unique_ptr<Shard[]> shards_;
+};
+}  // namespace google::scp::core::common
@@ -0,0 +1,133 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "core/common/lru_cache/src/lru_cache.h"
+#include "core/common/lru_cache/src/sharded_lru_cache.h"
+
+using google::scp::core::common::LruCache;
+using google::scp::core::common::ShardedLruCache;
+using std::make_unique;
+using std::string;
+using std::unique_ptr;
+
+namespace google::scp::core::common::test {
+/**
+ * @brief The number of elements the cache can hold, and the number of distinct
+ * keys, as LruCache::Get must not be called for a key that another thread may
+ * evict after Contains.
+ */
+static constexpr int kCacheCapacity = 1024;
+
+/// The cache shared by the benchmark threads of a run.
+template <class CacheType>
+static unique_ptr<CacheType> cache;
+
+/// Fills the cache before the benchmark threads of a run start.
+template <class CacheType>
+static void SetUpCache(const benchmark::State& state) {
+  cache<CacheType> = make_unique<CacheType>(kCacheCapacity);
+  string value(state.range(0), 'v');
+  for (int i = 0; i < kCacheCapacity; i++) {
+    cache<CacheType>->Set(i, value);
+  }
+}
+
+template <class CacheType>
+static void TearDownCache(const benchmark::State&) {
+  cache<CacheType>.reset();
+}
+
+static void SetUpLruCache(const benchmark::State& state) {
+  SetUpCache<LruCache<int, string>>(state);
+}
+
+static void TearDownLruCache(const benchmark::State& state) {
+  TearDownCache<LruCache<int, string>>(state);
+}
+
+static void SetUpShardedLruCache(const benchmark::State& state) {
+  SetUpCache<ShardedLruCache<int, string>>(state);
+}
+
+static void TearDownShardedLruCache(const benchmark::State& state) {
+  TearDownCache<ShardedLruCache<int, string>>(state);
+}
+
+/**
+ * @brief Has every benchmark thread do lookups on the shared cache, with one in
+ * ten operations being a set. The size of the values is the benchmark
+ * argument, as it sets the cost of the copies made while the lock is held.
+ */
+template <class CacheType, class LookupFunction>
+static void BenchmarkMixedOperations(benchmark::State& state,
+                                     LookupFunction lookup) {
+  string value(state.range(0), 'v');
+  // Every thread walks the keys with its own stride.
+  int key = state.thread_index() * 7919;
+  int operation_index = 0;
+  for (auto _ : state) {
+    key = (key + 1) % kCacheCapacity;
+    if (operation_index++ % 10 == 0) {
+      cache<CacheType>->Set(key, value);
+    } else {
+      lookup(*cache<CacheType>, key);
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_LruCache(benchmark::State& state) {
+  BenchmarkMixedOperations<LruCache<int, string>>(
+      state, [](LruCache<int, string>& cache, int key) {
+        benchmark::DoNotOptimize(cache.Get(key));
+      });
+}
+
+static void BM_ShardedLruCache(benchmark::State& state) {
+  BenchmarkMixedOperations<ShardedLruCache<int, string>>(
+      state, [](ShardedLruCache<int, string>& cache, int key) {
+        benchmark::DoNotOptimize(cache.Get(key));
+      });
+}
+}  // namespace google::scp::core::common::test
+
+BENCHMARK(google::scp::core::common::test::BM_LruCache)
+    ->Setup(google::scp::core::common::test::SetUpLruCache)
+    ->Teardown(google::scp::core::common::test::TearDownLruCache)
+    ->Arg(64)
+    ->Arg(4096)
+    ->Arg(65536)
+    ->Threads(1)
+    ->Threads(4)
+    ->UseRealTime();
+
+BENCHMARK(google::scp::core::common::test::BM_ShardedLruCache)
+    ->Setup(google::scp::core::common::test::SetUpShardedLruCache)
+    ->Teardown(google::scp::core::common::test::TearDownShardedLruCache)
+    ->Arg(64)
+    ->Arg(4096)
+    ->Arg(65536)
+    ->Threads(1)
+    ->Threads(4)
+    ->UseRealTime();
+
+// Run the benchmark
+BENCHMARK_MAIN();
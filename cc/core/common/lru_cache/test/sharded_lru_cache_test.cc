@@ -0,0 +1,200 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/common/lru_cache/src/sharded_lru_cache.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+using std::string;
+using std::thread;
+using std::to_string;
+using std::vector;
+using std::chrono::milliseconds;
+using std::chrono::seconds;
+
+namespace google::scp::core::common::test {
+TEST(ShardedLruCacheTest, CanAddAndGetElement) {
+  ShardedLruCache<string, string> cache(10);
+
+  cache.Set("key", "value");
+
+  EXPECT_TRUE(cache.Contains("key"));
+  auto handle = cache.Get("key");
+  ASSERT_NE(handle, nullptr);
+  EXPECT_EQ(*handle, "value");
+  EXPECT_EQ(cache.Get("other key"), nullptr);
+  EXPECT_FALSE(cache.Contains("other key"));
+}
+
+TEST(ShardedLruCacheTest, HandleOutlivesReplacementAndEviction) {
+  ShardedLruCache<int, string> cache(1);
+
+  cache.Set(1, "first");
+  auto handle = cache.Get(1);
+  cache.Set(1, "second");
+  EXPECT_EQ(*handle, "first");
+  EXPECT_EQ(*cache.Get(1), "second");
+
+  handle = cache.Get(1);
+  cache.Set(2, "third");
+  EXPECT_FALSE(cache.Contains(1));
+  EXPECT_EQ(*handle, "second");
+}
+
+TEST(ShardedLruCacheTest, ShouldEvictNotRecentlyUsedElements) {
+  // Small enough to be a single shard, so the eviction order is exact.
+  ShardedLruCache<int, int> cache(4);
+  EXPECT_EQ(cache.Capacity(), 4);
+
+  for (int i = 0; i < 4; i++) {
+    cache.Set(i, i);
+  }
+  // The first sweep of the clock clears the referenced bits of the new
+  // elements and evicts the first one.
+  cache.Set(4, 4);
+  EXPECT_FALSE(cache.Contains(0));
+  EXPECT_EQ(cache.Size(), 4);
+
+  // 1 is used and gets a second chance, 2 is evicted instead.
+  EXPECT_NE(cache.Get(1), nullptr);
+  cache.Set(5, 5);
+  EXPECT_TRUE(cache.Contains(1));
+  EXPECT_FALSE(cache.Contains(2));
+  EXPECT_EQ(cache.GetCounters().eviction_count, 2);
+}
+
+TEST(ShardedLruCacheTest, ShouldNotExceedCapacityAcrossShards) {
+  ShardedLruCache<int, int> cache(100, /*time_to_live=*/std::nullopt,
+                                  /*max_shard_count=*/4);
+
+  for (int i = 0; i < 1000; i++) {
+    cache.Set(i, i);
+    EXPECT_LE(cache.Size(), 100);
+  }
+  EXPECT_EQ(cache.Size(), 100);
+  EXPECT_EQ(cache.GetCounters().eviction_count, 900);
+
+  auto all = cache.GetAll();
+  EXPECT_EQ(all.size(), 100);
+  for (const auto& [key, value] : all) {
+    EXPECT_EQ(key, value);
+  }
+}
+
+TEST(ShardedLruCacheTest, EraseAndClear) {
+  ShardedLruCache<string, string> cache(64, /*time_to_live=*/std::nullopt,
+                                        /*max_shard_count=*/1);
+
+  for (int i = 0; i < 10; i++) {
+    cache.Set(to_string(i), to_string(i));
+  }
+  EXPECT_TRUE(cache.Erase("3"));
+  EXPECT_FALSE(cache.Erase("3"));
+  EXPECT_FALSE(cache.Contains("3"));
+  EXPECT_EQ(cache.Size(), 9);
+
+  cache.Clear();
+  EXPECT_EQ(cache.Size(), 0);
+  EXPECT_TRUE(cache.GetAll().empty());
+
+  // The freed slots are reused.
+  for (int i = 0; i < 64; i++) {
+    cache.Set(to_string(i), to_string(i));
+  }
+  EXPECT_EQ(cache.Size(), 64);
+  EXPECT_EQ(cache.GetCounters().eviction_count, 0);
+}
+
+TEST(ShardedLruCacheTest, ZeroCapacityCacheIsAlwaysEmpty) {
+  ShardedLruCache<int, int> cache(0);
+
+  cache.Set(1, 1);
+  EXPECT_EQ(cache.Get(1), nullptr);
+  EXPECT_EQ(cache.Size(), 0);
+}
+
+TEST(ShardedLruCacheTest, ExpiredElementsAreNotReturned) {
+  ShardedLruCache<int, int> cache(2, milliseconds(50));
+
+  cache.Set(1, 1);
+  EXPECT_NE(cache.Get(1), nullptr);
+  std::this_thread::sleep_for(milliseconds(100));
+  EXPECT_EQ(cache.Get(1), nullptr);
+  EXPECT_FALSE(cache.Contains(1));
+  EXPECT_TRUE(cache.GetAll().empty());
+
+  // Setting the key again renews it.
+  cache.Set(1, 2);
+  EXPECT_EQ(*cache.Get(1), 2);
+
+  // An expired element is evicted first, even if it was used.
+  cache.Set(2, 2);
+  std::this_thread::sleep_for(milliseconds(100));
+  cache.Set(3, 3);
+  EXPECT_EQ(cache.GetCounters().expiration_count, 1);
+  EXPECT_EQ(cache.GetCounters().eviction_count, 0);
+}
+
+TEST(ShardedLruCacheTest, CountsHitsAndMisses) {
+  ShardedLruCache<int, int> cache(10, seconds(100));
+
+  cache.Set(1, 1);
+  cache.Get(1);
+  cache.Get(1);
+  cache.Get(2);
+  // Contains is not counted.
+  cache.Contains(2);
+
+  auto counters = cache.GetCounters();
+  EXPECT_EQ(counters.hit_count, 2);
+  EXPECT_EQ(counters.miss_count, 1);
+  EXPECT_EQ(counters.eviction_count, 0);
+  EXPECT_EQ(counters.expiration_count, 0);
+}
+
+TEST(ShardedLruCacheTest, ConcurrentSetAndGet) {
+  constexpr int kThreadCount = 4;
+  constexpr int kOperationsPerThread = 20000;
+  ShardedLruCache<int, string> cache(256);
+
+  vector<thread> threads;
+  for (int t = 0; t < kThreadCount; t++) {
+    threads.push_back(thread([&cache, t]() {
+      for (int i = 0; i < kOperationsPerThread; i++) {
+        int key = (t * 7919 + i) % 1024;
+        if (i % 4 == 0) {
+          cache.Set(key, to_string(key));
+        } else if (auto handle = cache.Get(key)) {
+          EXPECT_EQ(*handle, to_string(key));
+        }
+      }
+    }));
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  EXPECT_LE(cache.Size(), 256);
+  auto counters = cache.GetCounters();
+  EXPECT_EQ(counters.hit_count + counters.miss_count,
+            kThreadCount * kOperationsPerThread * 3 / 4);
+}
+}  // namespace google::scp::core::common::test
@@ -0,0 +1,145 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+
+#include "core/common/time_provider/src/time_provider.h"
+#include "core/interface/type_def.h"
+
+namespace google::scp::core::common {
+/// CircuitBreaker options.
+struct CircuitBreakerOptions {
+  /// The number of consecutive retriable failures that opens the circuit.
+  size_t failure_threshold;
+
+  /// How long an open circuit fails the requests before it lets one through.
+  std::chrono::milliseconds open_duration;
+};
+
+/// The states of a CircuitBreaker.
+enum class CircuitBreakerState {
+  /// The requests go through.
+  Closed = 0,
+  /// The target is unhealthy, and the requests fail fast.
+  Open = 1,
+  /**
+   * @brief The open duration passed, and a single request is let through to
+   * probe the target. The others fail fast until it completes, or until
+   * another open duration passes without it completing.
+   */
+  HalfOpen = 2,
+};
+
+/**
+ * @brief Tracks the health of a target from the outcomes of its requests, and
+ * fails the requests fast while the target is unhealthy instead of adding to
+ * its load. The closed state, where the target is healthy, takes no lock.
+ */
+class CircuitBreaker {
+ public:
+  explicit CircuitBreaker(CircuitBreakerOptions options)
+      : options_(options),
+        state_(CircuitBreakerState::Closed),
+        consecutive_failure_count_(0),
+        state_deadline_(0) {}
+
+  /**
+   * @brief Returns true if a request can be sent to the target.
+   */
+  bool AllowRequest() noexcept {
+    if (state_.load(std::memory_order_acquire) ==
+        CircuitBreakerState::Closed) {
+      return true;
+    }
+
+    std::lock_guard lock(mutex_);
+    auto state = state_.load(std::memory_order_relaxed);
+    if (state == CircuitBreakerState::Closed) {
+      return true;
+    }
+    auto now = TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks();
+    if (now < state_deadline_) {
+      return false;
+    }
+    // The request is the probe, either the first one after the circuit opened
+    // or a replacement for one that did not complete in time.
+    state_.store(CircuitBreakerState::HalfOpen, std::memory_order_release);
+    state_deadline_ = GetDeadline(now);
+    return true;
+  }
+
+  /// Records a request that the target completed.
+  void RecordSuccess() noexcept {
+    consecutive_failure_count_.store(0, std::memory_order_relaxed);
+    if (state_.load(std::memory_order_acquire) !=
+        CircuitBreakerState::Closed) {
+      std::lock_guard lock(mutex_);
+      state_.store(CircuitBreakerState::Closed, std::memory_order_release);
+    }
+  }
+
+  /// Records a request that failed with a retriable failure.
+  void RecordFailure() noexcept {
+    auto state = state_.load(std::memory_order_acquire);
+    if (state == CircuitBreakerState::Open) {
+      return;
+    }
+    if (state == CircuitBreakerState::Closed) {
+      auto failure_count =
+          consecutive_failure_count_.fetch_add(1, std::memory_order_relaxed) +
+          1;
+      if (failure_count < options_.failure_threshold) {
+        return;
+      }
+    }
+
+    std::lock_guard lock(mutex_);
+    state_.store(CircuitBreakerState::Open, std::memory_order_release);
+    state_deadline_ = GetDeadline(
+        TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks());
+    consecutive_failure_count_.store(0, std::memory_order_relaxed);
+  }
+
+  /// Returns the current state of the circuit.
+  CircuitBreakerState GetState() const noexcept {
+    return state_.load(std::memory_order_acquire);
+  }
+
+ private:
+  Timestamp GetDeadline(Timestamp now) const noexcept {
+    return now + std::chrono::duration_cast<std::chrono::nanoseconds>(
+                     options_.open_duration)
+                     .count();
+  }
+
+  const CircuitBreakerOptions options_;
+  std::atomic<CircuitBreakerState> state_;
+  /// The retriable failures since the last success, while closed.
+  std::atomic<size_t> consecutive_failure_count_;
+  /// Guards the transitions of the state and the state deadline.
+  std::mutex mutex_;
+  /**
+   * @brief When open, the end of the open duration. When half open, the time
+   * by which the probe must complete before another one is let through.
+   */
+  Timestamp state_deadline_;
+};
+}  // namespace google::scp::core::common
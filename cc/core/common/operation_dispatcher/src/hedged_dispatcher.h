@@ -0,0 +1,261 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+#include "core/common/time_provider/src/time_provider.h"
+#include "core/interface/async_executor_interface.h"
+#include "core/interface/type_def.h"
+
+#include "latency_percentile_tracker.h"
+#include "retry_budget.h"
+
+namespace google::scp::core::common {
+/// HedgedDispatcher options.
+struct HedgingOptions {
+  /**
+   * @brief The delay after which an operation that did not complete is sent
+   * again. Also used until the latency percentile is known, if set.
+   */
+  std::chrono::milliseconds hedge_delay;
+
+  /**
+   * @brief If set, the hedge delay is this percentile of the latencies of the
+   * recent first attempts, between 0 and 1, e.g. 0.95.
+   */
+  std::optional<double> hedge_latency_percentile;
+
+  /// The number of first attempts the latency percentile is estimated from.
+  size_t latency_window_size = 1000;
+
+  /**
+   * @brief The budget of the hedges. Every operation deposits its token ratio
+   * and every hedge withdraws a token, so e.g. a ratio of 0.05 bounds the extra
+   * load of the hedges to 5%.
+   */
+  RetryBudgetOptions hedge_budget_options;
+};
+
+/**
+ * @brief Dispatches idempotent operations, and sends them to the target a
+ * second time if they do not complete within the hedge delay. The first
+ * successful attempt completes the operation and the other one is ignored
+ * when it completes, as the targets cannot cancel their calls. A failure
+ * completes the operation only once no other attempt is in flight.
+ *
+ * Only operations that can safely run twice must be hedged, e.g. reads.
+ */
+class HedgedDispatcher {
+ public:
+  /**
+   * @brief Construct a new hedged dispatcher object.
+   *
+   * @param async_executor The async executor instance that delays the hedges.
+   * @param options The options of the hedging.
+   */
+  HedgedDispatcher(
+      const std::shared_ptr<AsyncExecutorInterface>& async_executor,
+      HedgingOptions options)
+      : async_executor_(async_executor),
+        hedge_delay_(options.hedge_delay),
+        hedge_budget_(
+            std::make_shared<RetryBudget>(options.hedge_budget_options)),
+        latency_tracker_(options.hedge_latency_percentile
+                             ? std::make_shared<LatencyPercentileTracker>(
+                                   *options.hedge_latency_percentile,
+                                   options.latency_window_size)
+                             : nullptr) {}
+
+  /**
+   * @brief Dispatches the operation to the target, and hedges it if it does
+   * not complete within the hedge delay.
+   *
+   * @tparam Context should be AsyncContext<TRequest, TResponse>
+   * @param async_context The async context of the operation to be executed.
+   * @param dispatch_to_target_function The function to call the target
+   * component. It is called with a copy of the context per attempt.
+   */
+  template <class Context>
+  void Dispatch(Context& async_context,
+                const std::function<ExecutionResult(Context&)>&
+                    dispatch_to_target_function) {
+    hedge_budget_->Deposit();
+    auto operation = std::make_shared<HedgedOperation<Context>>(
+        async_context, dispatch_to_target_function);
+    // Counted before the hedge can fire, so that a failing hedge does not
+    // complete the operation before the first attempt is sent.
+    operation->attempts_in_flight = 1;
+
+    std::function<bool()> cancel_hedge;
+    auto execution_result = async_executor_->ScheduleFor(
+        [this, operation]() { Hedge(operation); },
+        (TimeProvider::GetSteadyTimestampInNanoseconds() + GetHedgeDelay())
+            .count(),
+        cancel_hedge);
+    if (execution_result.Successful()) {
+      std::lock_guard lock(operation->mutex);
+      if (operation->hedge_pending) {
+        operation->cancel_hedge = std::move(cancel_hedge);
+      }
+    } else {
+      // The operation goes on without a hedge.
+      std::lock_guard lock(operation->mutex);
+      operation->hedge_pending = false;
+    }
+
+    Attempt(operation, /*is_hedge=*/false);
+  }
+
+ private:
+  /// The state of an operation shared by its attempts.
+  template <class Context>
+  struct HedgedOperation {
+    HedgedOperation(const Context& context,
+                    const std::function<ExecutionResult(Context&)>&
+                        dispatch_to_target_function)
+        : context(context),
+          dispatch_to_target_function(dispatch_to_target_function) {}
+
+    /// The context of the operation, completed by the first attempt to win.
+    Context context;
+    const std::function<ExecutionResult(Context&)> dispatch_to_target_function;
+    /// Guards the fields below.
+    std::mutex mutex;
+    /// Whether the context of the operation completed.
+    bool finished = false;
+    /// Whether the hedge can still be sent.
+    bool hedge_pending = true;
+    /// The number of attempts sent to the target that did not complete.
+    size_t attempts_in_flight = 0;
+    /// Cancels the scheduled hedge.
+    std::function<bool()> cancel_hedge;
+  };
+
+  std::chrono::nanoseconds GetHedgeDelay() const noexcept {
+    if (latency_tracker_) {
+      if (auto latency_ns = latency_tracker_->GetPercentileLatency()) {
+        return std::chrono::nanoseconds(*latency_ns);
+      }
+    }
+    return hedge_delay_;
+  }
+
+  /// Sends the hedge of the operation, if it did not complete yet.
+  template <class Context>
+  void Hedge(const std::shared_ptr<HedgedOperation<Context>>& operation) {
+    {
+      std::lock_guard lock(operation->mutex);
+      if (!operation->hedge_pending) {
+        return;
+      }
+      operation->hedge_pending = false;
+      operation->cancel_hedge = nullptr;
+      if (operation->finished || !hedge_budget_->TryWithdraw()) {
+        return;
+      }
+      // Counted along with taking the hedge, so that a first attempt failing
+      // before the hedge is sent waits for it.
+      operation->attempts_in_flight++;
+    }
+    Attempt(operation, /*is_hedge=*/true);
+  }
+
+  /**
+   * @brief Sends an attempt of the operation to the target. The caller counts
+   * the attempt in attempts_in_flight beforehand.
+   */
+  template <class Context>
+  void Attempt(const std::shared_ptr<HedgedOperation<Context>>& operation,
+               bool is_hedge) {
+    // Only the first attempts are tracked, so that the latencies are the ones
+    // of the target rather than the ones of the hedging.
+    Timestamp start_time = 0;
+    if (latency_tracker_ && !is_hedge) {
+      start_time = TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks();
+    }
+    Context attempt_context = operation->context;
+    attempt_context.callback = [this, operation,
+                                start_time](Context& attempt_context) {
+      OnAttemptCompleted(operation, attempt_context, start_time);
+    };
+
+    auto execution_result =
+        operation->dispatch_to_target_function(attempt_context);
+    if (!execution_result.Successful()) {
+      attempt_context.result = execution_result;
+      OnAttemptCompleted(operation, attempt_context, start_time);
+    }
+  }
+
+  /**
+   * @brief Completes the operation with the attempt, unless another attempt
+   * completed it already or may still succeed.
+   *
+   * @param start_time The start time of the attempt if its latency is tracked,
+   * 0 otherwise.
+   */
+  template <class Context>
+  void OnAttemptCompleted(
+      const std::shared_ptr<HedgedOperation<Context>>& operation,
+      Context& attempt_context, Timestamp start_time) {
+    if (start_time != 0 && attempt_context.result.Successful()) {
+      latency_tracker_->Record(
+          TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks() -
+          start_time);
+    }
+
+    std::function<bool()> cancel_hedge;
+    {
+      std::lock_guard lock(operation->mutex);
+      operation->attempts_in_flight--;
+      if (operation->finished) {
+        return;
+      }
+      if (!attempt_context.result.Successful() &&
+          operation->attempts_in_flight > 0) {
+        // The other attempt may still succeed.
+        return;
+      }
+      operation->finished = true;
+      operation->hedge_pending = false;
+      cancel_hedge = std::move(operation->cancel_hedge);
+    }
+    if (cancel_hedge) {
+      cancel_hedge();
+    }
+
+    operation->context.result = attempt_context.result;
+    operation->context.response = attempt_context.response;
+    operation->context.Finish();
+  }
+
+  /// An instance to the async executor.
+  std::shared_ptr<AsyncExecutorInterface> async_executor_;
+  /// The hedge delay until the latency percentile is known, if used.
+  std::chrono::nanoseconds hedge_delay_;
+  /// The budget of the hedges.
+  std::shared_ptr<RetryBudget> hedge_budget_;
+  /// The latencies of the attempts, if the hedge delay is a percentile.
+  std::shared_ptr<LatencyPercentileTracker> latency_tracker_;
+};
+}  // namespace google::scp::core::common
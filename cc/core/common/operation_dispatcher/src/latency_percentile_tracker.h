@@ -0,0 +1,103 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "core/interface/type_def.h"
+
+namespace google::scp::core::common {
+/**
+ * @brief Estimates a percentile of the latencies of the most recent operations.
+ * The latencies are kept in a sliding window, and the percentile is recomputed
+ * every few recordings so that reading it stays a single atomic load.
+ */
+class LatencyPercentileTracker {
+ public:
+  /**
+   * @brief Construct a new Latency Percentile Tracker object.
+   *
+   * @param percentile The percentile to estimate, between 0 and 1.
+   * @param window_size The number of recent latencies the estimate is from.
+   */
+  LatencyPercentileTracker(double percentile, size_t window_size)
+      : percentile_(percentile),
+        latencies_ns_(window_size),
+        next_index_(0),
+        latency_count_(0),
+        percentile_latency_ns_(kUnknownLatency) {}
+
+  /// Records the latency of an operation, in nanoseconds.
+  void Record(TimeDuration latency_ns) noexcept {
+    std::lock_guard lock(mutex_);
+    latencies_ns_[next_index_] = latency_ns;
+    next_index_ = (next_index_ + 1) % latencies_ns_.size();
+    latency_count_ = std::min(latency_count_ + 1, latencies_ns_.size());
+    if (latency_count_ == latencies_ns_.size() &&
+        next_index_ % kRecordingsPerEstimate == 0) {
+      Estimate();
+    }
+  }
+
+  /**
+   * @brief Returns the percentile of the latencies in nanoseconds, or nullopt
+   * until the window is full.
+   */
+  std::optional<TimeDuration> GetPercentileLatency() const noexcept {
+    auto latency_ns = percentile_latency_ns_.load(std::memory_order_relaxed);
+    if (latency_ns == kUnknownLatency) {
+      return std::nullopt;
+    }
+    return latency_ns;
+  }
+
+ private:
+  static constexpr TimeDuration kUnknownLatency = 0;
+  /// The number of recordings between two estimates of the percentile.
+  static constexpr size_t kRecordingsPerEstimate = 64;
+
+  void Estimate() noexcept {
+    sorted_latencies_ns_ = latencies_ns_;
+    auto rank = std::min(
+        static_cast<size_t>(percentile_ * sorted_latencies_ns_.size()),
+        sorted_latencies_ns_.size() - 1);
+    std::nth_element(sorted_latencies_ns_.begin(),
+                     sorted_latencies_ns_.begin() + rank,
+                     sorted_latencies_ns_.end());
+    // A zero latency would read as unknown.
+    percentile_latency_ns_.store(std::max<TimeDuration>(
+                                     sorted_latencies_ns_[rank], 1),
+                                 std::memory_order_relaxed);
+  }
+
+  const double percentile_;
+  /// Guards the window of latencies.
+  std::mutex mutex_;
+  /// The window of latencies, overwritten oldest first.
+  std::vector<TimeDuration> latencies_ns_;
+  /// The scratch copy of the window that the percentile is selected from.
+  std::vector<TimeDuration> sorted_latencies_ns_;
+  size_t next_index_;
+  size_t latency_count_;
+  std::atomic<TimeDuration> percentile_latency_ns_;
+};
+}  // namespace google::scp::core::common
@@ -19,12 +19,19 @@
 #include <chrono>
 #include <functional>
 #include <memory>
+#include <optional>
+#include <string>
+#include <utility>
 
+#include "core/common/concurrent_map/src/sharded_concurrent_map.h"
 #include "core/common/time_provider/src/time_provider.h"
+#include "core/common/tracing/src/global_tracer.h"
 #include "core/interface/async_executor_interface.h"
 #include "core/interface/streaming_context.h"
 
+#include "circuit_breaker.h"
 #include "error_codes.h"
+#include "retry_budget.h"
 #include "retry_strategy.h"
 
 namespace google::scp::core::common {
@@ -34,6 +41,11 @@ static constexpr char kOperationDispatcher[] = "OperationDispatcher";
 /**
  * @brief Provides dispatching mechanism for the callers to automatically retry
  * on the Retry status code.
+ *
+ * The dispatcher can also protect its targets while they fail: a retry budget
+ * bounds its retries to a fraction of its first attempts, and a circuit breaker
+ * per target fails the operations fast once the target keeps failing. The
+ * copies of a dispatcher share them.
  */
 class OperationDispatcher {
  public:
@@ -43,11 +55,26 @@ class OperationDispatcher {
    * @param async_executor The async executor instance.
    * @param retry_strategy The retry strategy for dispatch operations in case of
    * Retry status code.
+   * @param retry_budget_options The options of the retry budget of the
+   * dispatcher. The retries are not bounded if not set.
+   * @param circuit_breaker_options The options of the circuit breakers of the
+   * targets. The circuits are always closed if not set.
    */
   OperationDispatcher(
       const std::shared_ptr<AsyncExecutorInterface>& async_executor,
-      RetryStrategy retry_strategy)
-      : async_executor_(async_executor), retry_strategy_(retry_strategy) {}
+      RetryStrategy retry_strategy,
+      std::optional<RetryBudgetOptions> retry_budget_options = std::nullopt,
+      std::optional<CircuitBreakerOptions> circuit_breaker_options =
+          std::nullopt)
+      : async_executor_(async_executor),
+        retry_strategy_(retry_strategy),
+        retry_budget_(retry_budget_options
+                          ? std::make_shared<RetryBudget>(*retry_budget_options)
+                          : nullptr),
+        circuit_breaker_options_(circuit_breaker_options),
+        circuit_breakers_(circuit_breaker_options
+                              ? std::make_shared<CircuitBreakerMap>()
+                              : nullptr) {}
 
   /**
    * @brief Dispatches an async_context object to the target component with a
@@ -62,19 +89,51 @@ class OperationDispatcher {
   void Dispatch(Context& async_context,
                 const std::function<ExecutionResult(Context&)>&
                     dispatch_to_target_function) {
+    Dispatch(async_context, kDefaultTarget, dispatch_to_target_function);
+  }
+
+  /**
+   * @brief Same as Dispatch, for dispatchers whose operations go to different
+   * targets, e.g. hosts, that fail independently.
+   *
+   * @tparam Context should be AsyncContext<TRequest, TResponse>
+   * @param async_context The async context of the operation to be executed.
+   * @param target The target of the operation, whose circuit breaker tracks
+   * the outcome.
+   * @param dispatch_to_target_function The function to call the target
+   * component.
+   */
+  template <class Context>
+  void Dispatch(Context& async_context, const std::string& target,
+                const std::function<ExecutionResult(Context&)>&
+                    dispatch_to_target_function) {
+    auto circuit_breaker = GetCircuitBreaker(target);
+    // The span covers the retries, up to the completion of the operation.
+    auto* tracer = GetSampledTracer(async_context.correlation_id);
+    auto start_timestamp =
+        tracer ? TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks()
+               : 0;
     auto original_callback = async_context.callback;
     async_context.callback = [this, dispatch_to_target_function,
-                              original_callback](Context& async_context) {
+                              original_callback, circuit_breaker, tracer,
+                              start_timestamp](Context& async_context) {
+      RecordOutcome(circuit_breaker.get(), async_context.result);
       if (async_context.result.status == ExecutionStatus::Retry) {
         async_context.retry_count++;
-        DispatchWithRetry(async_context, dispatch_to_target_function);
+        DispatchWithRetry(async_context, dispatch_to_target_function,
+                          circuit_breaker);
         return;
       }
 
+      if (tracer) {
+        RecordContextSpan(*tracer, "OperationDispatcher::Dispatch",
+                          async_context, start_timestamp);
+      }
       original_callback(async_context);
     };
 
-    DispatchWithRetry<Context>(async_context, dispatch_to_target_function);
+    DispatchWithRetry<Context>(async_context, dispatch_to_target_function,
+                               circuit_breaker);
   }
 
   /**
@@ -92,10 +151,12 @@ class OperationDispatcher {
       const std::function<
           ExecutionResult(ProducerStreamingContext<TRequest, TResponse>&)>&
           dispatch_to_target_function) {
+    auto circuit_breaker = GetCircuitBreaker(kDefaultTarget);
     auto original_callback = producer_streaming_context.callback;
     producer_streaming_context.callback =
-        [this, dispatch_to_target_function,
-         original_callback](AsyncContext<TRequest, TResponse>& async_context) {
+        [this, dispatch_to_target_function, original_callback,
+         circuit_breaker](AsyncContext<TRequest, TResponse>& async_context) {
+          RecordOutcome(circuit_breaker.get(), async_context.result);
           if (async_context.result.status == ExecutionStatus::Retry) {
             async_context.retry_count++;
             // Downcast is safe here. We must downcast because only one
@@ -104,13 +165,14 @@ class OperationDispatcher {
             DispatchWithRetry(
                 static_cast<ProducerStreamingContext<TRequest, TResponse>&>(
                     async_context),
-                dispatch_to_target_function);
+                dispatch_to_target_function, circuit_breaker);
             return;
           }
           original_callback(async_context);
         };
 
-    DispatchWithRetry(producer_streaming_context, dispatch_to_target_function);
+    DispatchWithRetry(producer_streaming_context, dispatch_to_target_function,
+                      circuit_breaker);
   }
 
   /**
@@ -128,18 +190,21 @@ class OperationDispatcher {
       const std::function<
           ExecutionResult(ConsumerStreamingContext<TRequest, TResponse>&)>&
           dispatch_to_target_function) {
+    auto circuit_breaker = GetCircuitBreaker(kDefaultTarget);
     auto original_callback = consumer_streaming_context.process_callback;
     consumer_streaming_context.process_callback =
-        [this, dispatch_to_target_function, original_callback](
-            ConsumerStreamingContext<TRequest, TResponse>&
-                consumer_streaming_context,
-            bool is_finish) {
+        [this, dispatch_to_target_function, original_callback,
+         circuit_breaker](ConsumerStreamingContext<TRequest, TResponse>&
+                              consumer_streaming_context,
+                          bool is_finish) {
           if (is_finish) {
+            RecordOutcome(circuit_breaker.get(),
+                          consumer_streaming_context.result);
             if (consumer_streaming_context.result.status ==
                 ExecutionStatus::Retry) {
               consumer_streaming_context.retry_count++;
               DispatchWithRetry(consumer_streaming_context,
-                                dispatch_to_target_function);
+                                dispatch_to_target_function, circuit_breaker);
               return;
             }
           }
@@ -147,16 +212,69 @@ class OperationDispatcher {
         };
 
     DispatchWithRetry<ConsumerStreamingContext<TRequest, TResponse>>(
-        consumer_streaming_context, dispatch_to_target_function);
+        consumer_streaming_context, dispatch_to_target_function,
+        circuit_breaker);
   }
 
  private:
+  using CircuitBreakerMap =
+      ShardedConcurrentMap<std::string, std::shared_ptr<CircuitBreaker>>;
+
+  /// The target of the operations that are dispatched without one.
+  static inline const std::string kDefaultTarget;
+
+  /// Returns the circuit breaker of the target, or null if there are none.
+  std::shared_ptr<CircuitBreaker> GetCircuitBreaker(const std::string& target) {
+    if (!circuit_breakers_) {
+      return nullptr;
+    }
+    std::shared_ptr<CircuitBreaker> circuit_breaker;
+    if (!circuit_breakers_->Find(target, circuit_breaker).Successful()) {
+      // Keeps the circuit breaker of a concurrent insertion, if any.
+      circuit_breakers_->Insert(
+          std::make_pair(target, std::make_shared<CircuitBreaker>(
+                                     *circuit_breaker_options_)),
+          circuit_breaker);
+    }
+    return circuit_breaker;
+  }
+
+  /**
+   * @brief Records the outcome of an operation on the circuit breaker of its
+   * target. A retriable failure counts against the target, and any other
+   * result it returned counts for it. The failures of the dispatcher itself
+   * say nothing about the target.
+   */
+  static void RecordOutcome(CircuitBreaker* circuit_breaker,
+                            const ExecutionResult& result) {
+    if (circuit_breaker == nullptr) {
+      return;
+    }
+    if (result.status == ExecutionStatus::Retry) {
+      circuit_breaker->RecordFailure();
+      return;
+    }
+    if (core::errors::ExtractComponentCode(result.status_code) ==
+        core::errors::SC_DISPATCHER) {
+      return;
+    }
+    circuit_breaker->RecordSuccess();
+  }
+
   template <class Context>
-  void DispatchWithRetry(Context& async_context,
-                         const std::function<ExecutionResult(Context&)>&
-                             dispatch_to_target_function) {
-    auto async_operation = [async_context,
-                            dispatch_to_target_function]() mutable {
+  void DispatchWithRetry(
+      Context& async_context,
+      const std::function<ExecutionResult(Context&)>&
+          dispatch_to_target_function,
+      const std::shared_ptr<CircuitBreaker>& circuit_breaker) {
+    auto async_operation = [async_context, dispatch_to_target_function,
+                            circuit_breaker]() mutable {
+      if (circuit_breaker && !circuit_breaker->AllowRequest()) {
+        async_context.result =
+            FailureExecutionResult(core::errors::SC_DISPATCHER_CIRCUIT_OPEN);
+        async_context.Finish();
+        return;
+      }
       auto execution_result = dispatch_to_target_function(async_context);
       if (!execution_result.Successful()) {
         async_context.result = execution_result;
@@ -166,6 +284,9 @@ class OperationDispatcher {
 
     // The very first call does not need to be queued.
     if (async_context.retry_count == 0) {
+      if (retry_budget_) {
+        retry_budget_->Deposit();
+      }
       async_operation();
       return;
     }
@@ -217,6 +338,17 @@ class OperationDispatcher {
       return;
     }
 
+    if (retry_budget_ && !retry_budget_->TryWithdraw()) {
+      SCP_ERROR_CONTEXT(kOperationDispatcher, async_context,
+                        async_context.result,
+                        "Retry budget exhausted. Total retries: %lld",
+                        async_context.retry_count);
+      async_context.result = FailureExecutionResult(
+          core::errors::SC_DISPATCHER_RETRY_BUDGET_EXHAUSTED);
+      async_context.Finish();
+      return;
+    }
+
     auto execution_result = async_executor_->ScheduleFor(
         async_operation, current_time + back_off_duration_ns);
     if (!execution_result.Successful()) {
@@ -229,5 +361,11 @@ class OperationDispatcher {
   const std::shared_ptr<AsyncExecutorInterface> async_executor_;
   /// The retry strategy for the dispatcher.
   RetryStrategy retry_strategy_;
+  /// The budget of the retries, if bounded.
+  std::shared_ptr<RetryBudget> retry_budget_;
+  /// The options of the circuit breakers, if any.
+  std::optional<CircuitBreakerOptions> circuit_breaker_options_;
+  /// The circuit breakers of the targets, created on their first operation.
+  std::shared_ptr<CircuitBreakerMap> circuit_breakers_;
 };
 }  // namespace google::scp::core::common
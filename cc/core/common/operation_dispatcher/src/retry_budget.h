@@ -0,0 +1,93 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace google::scp::core::common {
+/// RetryBudget options.
+struct RetryBudgetOptions {
+  /// The number of retries the budget holds, and starts with.
+  size_t maximum_token_count;
+
+  /**
+   * @brief The fraction of a retry that every first attempt adds to the budget,
+   * e.g. 0.1 lets retries be 10% of the first attempts once the budget is
+   * spent.
+   */
+  double token_ratio;
+};
+
+/**
+ * @brief A token bucket that bounds the retries to a fraction of the first
+ * attempts, so that the retries of the callers cannot multiply the load on a
+ * target that fails. Every first attempt deposits a fraction of a token, and
+ * every retry withdraws a whole one.
+ */
+class RetryBudget {
+ public:
+  explicit RetryBudget(RetryBudgetOptions options)
+      : maximum_milli_tokens_(options.maximum_token_count *
+                              kMilliTokensPerToken),
+        milli_tokens_per_deposit_(options.token_ratio * kMilliTokensPerToken),
+        milli_tokens_(maximum_milli_tokens_) {}
+
+  /// Adds the share of a first attempt to the budget.
+  void Deposit() noexcept {
+    auto milli_tokens = milli_tokens_.load(std::memory_order_relaxed);
+    while (milli_tokens < maximum_milli_tokens_ &&
+           !milli_tokens_.compare_exchange_weak(
+               milli_tokens,
+               std::min(milli_tokens + milli_tokens_per_deposit_,
+                        maximum_milli_tokens_),
+               std::memory_order_relaxed)) {}
+  }
+
+  /**
+   * @brief Takes a retry out of the budget.
+   *
+   * @return true if the budget had a retry left.
+   */
+  bool TryWithdraw() noexcept {
+    auto milli_tokens = milli_tokens_.load(std::memory_order_relaxed);
+    while (milli_tokens >= kMilliTokensPerToken) {
+      if (milli_tokens_.compare_exchange_weak(
+              milli_tokens, milli_tokens - kMilliTokensPerToken,
+              std::memory_order_relaxed)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /// Returns the number of whole retries left in the budget.
+  size_t GetTokenCount() const noexcept {
+    return milli_tokens_.load(std::memory_order_relaxed) / kMilliTokensPerToken;
+  }
+
+ private:
+  /// The tokens are counted in thousandths, so that deposits are integers.
+  static constexpr uint64_t kMilliTokensPerToken = 1000;
+
+  const uint64_t maximum_milli_tokens_;
+  const uint64_t milli_tokens_per_deposit_;
+  std::atomic<uint64_t> milli_tokens_;
+};
+}  // namespace google::scp::core::common
@@ -18,6 +18,7 @@
 
 #include <chrono>
 #include <cmath>
+#include <random>
 
 #include "core/interface/type_def.h"
 #include "public/core/interface/execution_result.h"
@@ -30,16 +31,30 @@ enum class RetryStrategyType {
   Exponential = 1,
 };
 
+/// Types of randomization of the back off durations.
+enum class RetryJitterType {
+  /// The back off duration is the one of the retry strategy type.
+  None = 0,
+  /**
+   * @brief The back off duration is drawn uniformly between zero and the one
+   * of the retry strategy type, so that the callers that failed together do
+   * not retry together.
+   */
+  Full = 1,
+};
+
 /// RetryStrategy options.
 struct RetryStrategyOptions {
   RetryStrategyOptions() = delete;
 
   RetryStrategyOptions(RetryStrategyType retry_strategy_type,
                        TimeDuration delay_duration_ms,
-                       size_t maximum_allowed_retry_count)
+                       size_t maximum_allowed_retry_count,
+                       RetryJitterType jitter_type = RetryJitterType::None)
       : retry_strategy_type(retry_strategy_type),
         delay_duration_ms(delay_duration_ms),
-        maximum_allowed_retry_count(maximum_allowed_retry_count) {}
+        maximum_allowed_retry_count(maximum_allowed_retry_count),
+        jitter_type(jitter_type) {}
 
   /// The type of the retry strategy, linear or exponential.
   const RetryStrategyType retry_strategy_type;
@@ -49,6 +64,9 @@ struct RetryStrategyOptions {
 
   /// The maximum number of retries that is allowed.
   const size_t maximum_allowed_retry_count;
+
+  /// The randomization of the back off durations.
+  const RetryJitterType jitter_type;
 };
 
 /**
@@ -68,18 +86,22 @@ class RetryStrategy {
    * milliseconds.
    * @param maximum_allowed_retry_count The maximum number of retries that is
    * allowed.
+   * @param jitter_type The randomization of the back off durations.
    */
   RetryStrategy(RetryStrategyType retry_strategy_type,
                 TimeDuration delay_duration_ms,
-                size_t maximum_allowed_retry_count)
+                size_t maximum_allowed_retry_count,
+                RetryJitterType jitter_type = RetryJitterType::None)
       : retry_strategy_type_(retry_strategy_type),
         delay_duration_ms_(delay_duration_ms),
-        maximum_allowed_retry_count_(maximum_allowed_retry_count) {}
+        maximum_allowed_retry_count_(maximum_allowed_retry_count),
+        jitter_type_(jitter_type) {}
 
   explicit RetryStrategy(RetryStrategyOptions options)
       : retry_strategy_type_(options.retry_strategy_type),
         delay_duration_ms_(options.delay_duration_ms),
-        maximum_allowed_retry_count_(options.maximum_allowed_retry_count) {}
+        maximum_allowed_retry_count_(options.maximum_allowed_retry_count),
+        jitter_type_(options.jitter_type) {}
 
   /**
    * @brief Get the back-off duration in milliseconds for any specific retry
@@ -93,13 +115,21 @@ class RetryStrategy {
       return 0;
     }
 
+    TimeDuration back_off_duration_ms;
     switch (retry_strategy_type_) {
       case RetryStrategyType::Linear:
-        return retry_count * delay_duration_ms_;
+        back_off_duration_ms = retry_count * delay_duration_ms_;
+        break;
       case RetryStrategyType::Exponential:
       default:
-        return pow(2, retry_count - 1) * delay_duration_ms_;
+        back_off_duration_ms = pow(2, retry_count - 1) * delay_duration_ms_;
     }
+
+    if (jitter_type_ == RetryJitterType::Full) {
+      return std::uniform_int_distribution<TimeDuration>(
+          0, back_off_duration_ms)(GetJitterRandomGenerator());
+    }
+    return back_off_duration_ms;
   }
 
   /**
@@ -110,11 +140,20 @@ class RetryStrategy {
   size_t GetMaximumAllowedRetryCount() { return maximum_allowed_retry_count_; }
 
  private:
+  /// Returns the generator of the jitter of the calling thread.
+  static std::minstd_rand& GetJitterRandomGenerator() {
+    static thread_local std::minstd_rand random_generator(
+        std::random_device{}());
+    return random_generator;
+  }
+
   /// Retry strategy type.
   RetryStrategyType retry_strategy_type_;
   /// The delay in the back off time in milliseconds.
   TimeDuration delay_duration_ms_;
   /// Maximum allowed retry count for the retry strategy.
   size_t maximum_allowed_retry_count_;
+  /// The randomization of the back off durations.
+  RetryJitterType jitter_type_;
 };
 }  // namespace google::scp::core::common
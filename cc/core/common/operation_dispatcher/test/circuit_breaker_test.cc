@@ -0,0 +1,78 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/common/operation_dispatcher/src/circuit_breaker.h"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+using std::chrono::hours;
+using std::chrono::milliseconds;
+
+namespace google::scp::core::common::test {
+TEST(CircuitBreakerTests, OpensAfterConsecutiveFailures) {
+  CircuitBreaker circuit_breaker(
+      {.failure_threshold = 3, .open_duration = hours(1)});
+  EXPECT_EQ(circuit_breaker.GetState(), CircuitBreakerState::Closed);
+
+  circuit_breaker.RecordFailure();
+  circuit_breaker.RecordFailure();
+  EXPECT_TRUE(circuit_breaker.AllowRequest());
+  circuit_breaker.RecordFailure();
+
+  EXPECT_EQ(circuit_breaker.GetState(), CircuitBreakerState::Open);
+  EXPECT_FALSE(circuit_breaker.AllowRequest());
+}
+
+TEST(CircuitBreakerTests, SuccessResetsTheFailureCount) {
+  CircuitBreaker circuit_breaker(
+      {.failure_threshold = 2, .open_duration = hours(1)});
+  circuit_breaker.RecordFailure();
+  circuit_breaker.RecordSuccess();
+  circuit_breaker.RecordFailure();
+
+  EXPECT_EQ(circuit_breaker.GetState(), CircuitBreakerState::Closed);
+  EXPECT_TRUE(circuit_breaker.AllowRequest());
+}
+
+TEST(CircuitBreakerTests, LetsOneProbeThroughAfterOpenDuration) {
+  CircuitBreaker circuit_breaker(
+      {.failure_threshold = 1, .open_duration = milliseconds(0)});
+  circuit_breaker.RecordFailure();
+  EXPECT_EQ(circuit_breaker.GetState(), CircuitBreakerState::Open);
+
+  EXPECT_TRUE(circuit_breaker.AllowRequest());
+  EXPECT_EQ(circuit_breaker.GetState(), CircuitBreakerState::HalfOpen);
+
+  circuit_breaker.RecordSuccess();
+  EXPECT_EQ(circuit_breaker.GetState(), CircuitBreakerState::Closed);
+}
+
+TEST(CircuitBreakerTests, FailedProbeReopensTheCircuit) {
+  CircuitBreaker circuit_breaker(
+      {.failure_threshold = 5, .open_duration = milliseconds(0)});
+  for (int i = 0; i < 5; i++) {
+    circuit_breaker.RecordFailure();
+  }
+  EXPECT_TRUE(circuit_breaker.AllowRequest());
+  EXPECT_EQ(circuit_breaker.GetState(), CircuitBreakerState::HalfOpen);
+
+  // A single failure of the probe is enough, regardless of the threshold.
+  circuit_breaker.RecordFailure();
+  EXPECT_EQ(circuit_breaker.GetState(), CircuitBreakerState::Open);
+}
+}  // namespace google::scp::core::common::test
@@ -0,0 +1,149 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "core/async_executor/src/async_executor.h"
+#include "core/common/operation_dispatcher/src/hedged_dispatcher.h"
+#include "core/common/time_provider/src/time_provider.h"
+#include "core/interface/async_context.h"
+
+using google::scp::core::AsyncContext;
+using google::scp::core::AsyncExecutor;
+using std::atomic;
+using std::function;
+using std::make_shared;
+using std::mt19937;
+using std::promise;
+using std::string;
+using std::uniform_real_distribution;
+using std::vector;
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+using std::chrono::nanoseconds;
+
+namespace google::scp::core::common::test {
+/// The hedging of the operations, from the benchmark argument.
+enum class Hedging {
+  None = 0,
+  FixedDelay = 1,
+  LatencyPercentile = 2,
+};
+
+static constexpr const char* kHedgingNames[] = {"no hedging", "hedge at 5ms",
+                                                "hedge at p90"};
+
+/// The latency of most calls to the fake target.
+static constexpr milliseconds kFastLatency(1);
+/// The latency of the slow calls to the fake target.
+static constexpr milliseconds kSlowLatency(50);
+/// The fraction of the calls to the fake target that are slow.
+static constexpr double kSlowFraction = 0.03;
+
+/// Returns the percentile of the latencies in microseconds.
+static double GetPercentile(vector<nanoseconds>& latencies, double percentile) {
+  auto rank = static_cast<size_t>(percentile * (latencies.size() - 1));
+  std::nth_element(latencies.begin(), latencies.begin() + rank,
+                   latencies.end());
+  return duration_cast<microseconds>(latencies[rank]).count();
+}
+
+/**
+ * @brief Sends operations one at a time to a fake target whose calls complete
+ * after a fast latency, except for a fraction that are slow, and reports the
+ * latency percentiles of the operations.
+ */
+static void BM_DispatchToSlowTarget(benchmark::State& state) {
+  auto hedging = static_cast<Hedging>(state.range(0));
+  auto async_executor = make_shared<AsyncExecutor>(/*thread_count=*/2,
+                                                   /*queue_cap=*/1000);
+  async_executor->Init();
+  async_executor->Run();
+
+  HedgingOptions options{
+      .hedge_delay = milliseconds(5),
+      .hedge_budget_options = {.maximum_token_count = 10, .token_ratio = 0.1}};
+  if (hedging == Hedging::LatencyPercentile) {
+    options.hedge_latency_percentile = 0.9;
+    options.latency_window_size = 200;
+  }
+  HedgedDispatcher dispatcher(async_executor, options);
+
+  mt19937 random_generator(1234);
+  uniform_real_distribution<double> distribution(0, 1);
+  atomic<int64_t> target_call_count(0);
+  function<ExecutionResult(AsyncContext<string, string>&)> dispatch_to_target =
+      [&](AsyncContext<string, string>& context) {
+        target_call_count++;
+        auto latency = distribution(random_generator) < kSlowFraction
+                           ? kSlowLatency
+                           : kFastLatency;
+        return async_executor->ScheduleFor(
+            [context]() mutable {
+              context.result = SuccessExecutionResult();
+              context.Finish();
+            },
+            (TimeProvider::GetSteadyTimestampInNanoseconds() + latency)
+                .count());
+      };
+
+  vector<nanoseconds> latencies;
+  for (auto _ : state) {
+    promise<void> completed;
+    AsyncContext<string, string> context(
+        make_shared<string>(),
+        [&](AsyncContext<string, string>&) { completed.set_value(); });
+    auto start_time = TimeProvider::GetSteadyTimestampInNanoseconds();
+    if (hedging == Hedging::None) {
+      if (!dispatch_to_target(context).Successful()) {
+        state.SkipWithError("The target did not accept the operation.");
+        break;
+      }
+    } else {
+      dispatcher.Dispatch(context, dispatch_to_target);
+    }
+    completed.get_future().wait();
+    latencies.push_back(TimeProvider::GetSteadyTimestampInNanoseconds() -
+                        start_time);
+  }
+  async_executor->Stop();
+
+  state.SetLabel(kHedgingNames[state.range(0)]);
+  state.counters["p50_us"] = GetPercentile(latencies, 0.5);
+  state.counters["p99_us"] = GetPercentile(latencies, 0.99);
+  state.counters["target_calls_per_operation"] = benchmark::Counter(
+      target_call_count.load(), benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(BM_DispatchToSlowTarget)
+    ->DenseRange(0, 2)
+    ->Iterations(2000)
+    ->UseRealTime();
+}  // namespace google::scp::core::common::test
+
+// Run the benchmark
+BENCHMARK_MAIN();
@@ -0,0 +1,281 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/common/operation_dispatcher/src/hedged_dispatcher.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/async_executor/mock/mock_async_executor.h"
+#include "core/interface/async_context.h"
+#include "public/core/test/interface/execution_result_matchers.h"
+
+using google::scp::core::AsyncContext;
+using google::scp::core::async_executor::mock::MockAsyncExecutor;
+using google::scp::core::test::ResultIs;
+using std::atomic;
+using std::function;
+using std::make_shared;
+using std::shared_ptr;
+using std::string;
+using std::thread;
+using std::vector;
+using std::chrono::milliseconds;
+
+namespace google::scp::core::common::test {
+/**
+ * @brief Holds the hedges scheduled on the async executor, and the attempts
+ * sent to the target, until the test completes them.
+ */
+class HedgedDispatcherTest : public testing::Test {
+ protected:
+  HedgedDispatcherTest() {
+    mock_async_executor_->schedule_for_mock =
+        [this](const AsyncOperation& work, Timestamp,
+               function<bool()>& cancellation_callback) {
+          hedges_.push_back(work);
+          cancellation_callback = [this]() {
+            cancelled_hedge_count_++;
+            return true;
+          };
+          return SuccessExecutionResult();
+        };
+    dispatch_to_target_ = [this](AsyncContext<string, string>& context) {
+      attempts_.push_back(context);
+      return SuccessExecutionResult();
+    };
+  }
+
+  HedgedDispatcher CreateDispatcher(size_t maximum_hedge_count = 10) {
+    return HedgedDispatcher(
+        mock_async_executor_,
+        HedgingOptions{.hedge_delay = milliseconds(10),
+                       .hedge_budget_options = {
+                           .maximum_token_count = maximum_hedge_count,
+                           .token_ratio = 0}});
+  }
+
+  /// Completes the attempt with the result, and the request as the response.
+  void CompleteAttempt(size_t index, ExecutionResult result) {
+    auto& attempt = attempts_[index];
+    attempt.result = result;
+    attempt.response = make_shared<string>(*attempt.request);
+    attempt.Finish();
+  }
+
+  shared_ptr<MockAsyncExecutor> mock_async_executor_ =
+      make_shared<MockAsyncExecutor>();
+  vector<AsyncOperation> hedges_;
+  size_t cancelled_hedge_count_ = 0;
+  vector<AsyncContext<string, string>> attempts_;
+  function<ExecutionResult(AsyncContext<string, string>&)> dispatch_to_target_;
+};
+
+TEST_F(HedgedDispatcherTest, FastOperationIsNotHedged) {
+  auto dispatcher = CreateDispatcher();
+  size_t callback_count = 0;
+  AsyncContext<string, string> context(
+      make_shared<string>("request"),
+      [&](AsyncContext<string, string>& context) {
+        EXPECT_SUCCESS(context.result);
+        EXPECT_EQ(*context.response, "request");
+        callback_count++;
+      });
+
+  dispatcher.Dispatch(context, dispatch_to_target_);
+  ASSERT_EQ(attempts_.size(), 1);
+  ASSERT_EQ(hedges_.size(), 1);
+  CompleteAttempt(0, SuccessExecutionResult());
+  EXPECT_EQ(callback_count, 1);
+  EXPECT_EQ(cancelled_hedge_count_, 1);
+
+  // A hedge that could not be cancelled in time does nothing.
+  hedges_[0]();
+  EXPECT_EQ(attempts_.size(), 1);
+  EXPECT_EQ(callback_count, 1);
+}
+
+TEST_F(HedgedDispatcherTest, SlowOperationIsHedged) {
+  auto dispatcher = CreateDispatcher();
+  size_t callback_count = 0;
+  AsyncContext<string, string> context(
+      make_shared<string>("request"),
+      [&](AsyncContext<string, string>& context) {
+        EXPECT_SUCCESS(context.result);
+        callback_count++;
+      });
+
+  dispatcher.Dispatch(context, dispatch_to_target_);
+  hedges_[0]();
+  ASSERT_EQ(attempts_.size(), 2);
+  EXPECT_EQ(*attempts_[1].request, "request");
+
+  CompleteAttempt(1, SuccessExecutionResult());
+  EXPECT_EQ(callback_count, 1);
+  // The loser is ignored.
+  CompleteAttempt(0, FailureExecutionResult(1234));
+  EXPECT_EQ(callback_count, 1);
+}
+
+TEST_F(HedgedDispatcherTest, FailureWaitsForTheOtherAttempt) {
+  auto dispatcher = CreateDispatcher();
+  size_t callback_count = 0;
+  AsyncContext<string, string> context(
+      make_shared<string>("request"),
+      [&](AsyncContext<string, string>& context) {
+        EXPECT_SUCCESS(context.result);
+        callback_count++;
+      });
+
+  dispatcher.Dispatch(context, dispatch_to_target_);
+  hedges_[0]();
+  CompleteAttempt(0, FailureExecutionResult(1234));
+  EXPECT_EQ(callback_count, 0);
+  CompleteAttempt(1, SuccessExecutionResult());
+  EXPECT_EQ(callback_count, 1);
+}
+
+TEST_F(HedgedDispatcherTest, FailureOfTheLastAttemptCompletesTheOperation) {
+  auto dispatcher = CreateDispatcher();
+  size_t callback_count = 0;
+  AsyncContext<string, string> context(
+      make_shared<string>("request"),
+      [&](AsyncContext<string, string>& context) {
+        EXPECT_THAT(context.result, ResultIs(FailureExecutionResult(1234)));
+        callback_count++;
+      });
+
+  dispatcher.Dispatch(context, dispatch_to_target_);
+  CompleteAttempt(0, FailureExecutionResult(1234));
+  EXPECT_EQ(callback_count, 1);
+  EXPECT_EQ(cancelled_hedge_count_, 1);
+}
+
+TEST_F(HedgedDispatcherTest, FailedOnAcceptance) {
+  auto dispatcher = CreateDispatcher();
+  size_t callback_count = 0;
+  AsyncContext<string, string> context(
+      make_shared<string>("request"),
+      [&](AsyncContext<string, string>& context) {
+        EXPECT_THAT(context.result, ResultIs(FailureExecutionResult(1234)));
+        callback_count++;
+      });
+
+  function<ExecutionResult(AsyncContext<string, string>&)> dispatch_to_target =
+      [](AsyncContext<string, string>&) {
+        return FailureExecutionResult(1234);
+      };
+  dispatcher.Dispatch(context, dispatch_to_target);
+  EXPECT_EQ(callback_count, 1);
+}
+
+TEST_F(HedgedDispatcherTest, HedgesCountAgainstTheBudget) {
+  auto dispatcher = CreateDispatcher(/*maximum_hedge_count=*/1);
+  for (int i = 0; i < 2; i++) {
+    AsyncContext<string, string> context(make_shared<string>("request"),
+                                         [](auto&) {});
+    dispatcher.Dispatch(context, dispatch_to_target_);
+  }
+  ASSERT_EQ(hedges_.size(), 2);
+  hedges_[0]();
+  hedges_[1]();
+  EXPECT_EQ(attempts_.size(), 3);
+}
+TEST_F(HedgedDispatcherTest, FirstAttemptFailingWhileTheHedgeFires) {
+  auto dispatcher = CreateDispatcher(/*maximum_hedge_count=*/1000);
+  for (int i = 0; i < 1000; i++) {
+    hedges_.clear();
+    attempts_.clear();
+    atomic<size_t> callback_count(0);
+    atomic<bool> is_hedge_sent_after_completion(false);
+    AsyncContext<string, string> context(
+        make_shared<string>("request"),
+        [&](AsyncContext<string, string>& context) { callback_count++; });
+    AsyncContext<string, string> hedge_attempt;
+    function<ExecutionResult(AsyncContext<string, string>&)>
+        dispatch_to_target = [&](AsyncContext<string, string>& context) {
+          if (attempts_.empty()) {
+            attempts_.push_back(context);
+          } else {
+            is_hedge_sent_after_completion = callback_count > 0;
+            hedge_attempt = context;
+          }
+          return SuccessExecutionResult();
+        };
+
+    dispatcher.Dispatch(context, dispatch_to_target);
+    ASSERT_EQ(hedges_.size(), 1);
+    atomic<bool> is_hedge_firing(false);
+    thread hedge_thread([&]() {
+      is_hedge_firing = true;
+      hedges_[0]();
+    });
+    while (!is_hedge_firing) {
+      std::this_thread::yield();
+    }
+    CompleteAttempt(0, FailureExecutionResult(1234));
+    hedge_thread.join();
+
+    // A hedge that is sent must not be ignored.
+    EXPECT_FALSE(is_hedge_sent_after_completion);
+    if (hedge_attempt.request) {
+      EXPECT_EQ(callback_count, 0);
+      hedge_attempt.result = SuccessExecutionResult();
+      hedge_attempt.Finish();
+    }
+    EXPECT_EQ(callback_count, 1);
+  }
+}
+
+TEST_F(HedgedDispatcherTest, HedgeFailingBeforeTheFirstAttemptIsSent) {
+  // The hedge fires before ScheduleFor returns.
+  mock_async_executor_->schedule_for_mock =
+      [](const AsyncOperation& work, Timestamp, function<bool()>&) {
+        work();
+        return SuccessExecutionResult();
+      };
+  auto dispatcher = CreateDispatcher();
+  size_t callback_count = 0;
+  AsyncContext<string, string> context(
+      make_shared<string>("request"),
+      [&](AsyncContext<string, string>& context) {
+        EXPECT_SUCCESS(context.result);
+        callback_count++;
+      });
+
+  size_t dispatch_count = 0;
+  function<ExecutionResult(AsyncContext<string, string>&)> dispatch_to_target =
+      [&](AsyncContext<string, string>& context) -> ExecutionResult {
+        if (dispatch_count++ == 0) {
+          return FailureExecutionResult(1234);
+        }
+        attempts_.push_back(context);
+        return SuccessExecutionResult();
+      };
+  dispatcher.Dispatch(context, dispatch_to_target);
+  EXPECT_EQ(callback_count, 0);
+  ASSERT_EQ(attempts_.size(), 1);
+  CompleteAttempt(0, SuccessExecutionResult());
+  EXPECT_EQ(callback_count, 1);
+}
+}  // namespace google::scp::core::common::test
@@ -0,0 +1,46 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/common/operation_dispatcher/src/latency_percentile_tracker.h"
+
+#include <gtest/gtest.h>
+
+namespace google::scp::core::common::test {
+TEST(LatencyPercentileTrackerTests, UnknownUntilTheWindowIsFull) {
+  LatencyPercentileTracker tracker(0.5, 128);
+  for (int i = 0; i < 127; i++) {
+    tracker.Record(i + 1);
+  }
+  EXPECT_FALSE(tracker.GetPercentileLatency().has_value());
+
+  tracker.Record(128);
+  ASSERT_TRUE(tracker.GetPercentileLatency().has_value());
+  EXPECT_EQ(*tracker.GetPercentileLatency(), 65);
+}
+
+TEST(LatencyPercentileTrackerTests, FollowsTheRecentLatencies) {
+  LatencyPercentileTracker tracker(0.9, 128);
+  for (int i = 0; i < 128; i++) {
+    tracker.Record(i % 10 == 0 ? 1000 : 10);
+  }
+  EXPECT_EQ(*tracker.GetPercentileLatency(), 1000);
+
+  for (int i = 0; i < 128; i++) {
+    tracker.Record(20);
+  }
+  EXPECT_EQ(*tracker.GetPercentileLatency(), 20);
+}
+}  // namespace google::scp::core::common::test
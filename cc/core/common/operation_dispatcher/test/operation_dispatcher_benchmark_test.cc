@@ -0,0 +1,104 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "core/async_executor/mock/mock_async_executor.h"
+#include "core/common/operation_dispatcher/src/operation_dispatcher.h"
+#include "core/interface/async_context.h"
+
+using google::scp::core::AsyncContext;
+using google::scp::core::async_executor::mock::MockAsyncExecutor;
+using std::atomic;
+using std::function;
+using std::make_shared;
+using std::nullopt;
+using std::optional;
+using std::string;
+using std::chrono::milliseconds;
+
+namespace google::scp::core::common::test {
+/// The protections of the dispatcher, from the benchmark argument.
+enum class Protection {
+  None = 0,
+  RetryBudget = 1,
+  CircuitBreaker = 2,
+  RetryBudgetAndCircuitBreaker = 3,
+};
+
+static constexpr const char* kProtectionNames[] = {
+    "none", "retry budget", "circuit breaker", "retry budget+circuit breaker"};
+
+/**
+ * @brief Dispatches operations to a target that fails every call with a
+ * retriable failure, and reports how many calls reach the target per
+ * operation.
+ */
+static void BM_DispatchDuringOutage(benchmark::State& state) {
+  auto protection = static_cast<Protection>(state.range(0));
+  optional<RetryBudgetOptions> retry_budget_options;
+  if (protection == Protection::RetryBudget ||
+      protection == Protection::RetryBudgetAndCircuitBreaker) {
+    retry_budget_options =
+        RetryBudgetOptions{.maximum_token_count = 10, .token_ratio = 0.1};
+  }
+  optional<CircuitBreakerOptions> circuit_breaker_options;
+  if (protection == Protection::CircuitBreaker ||
+      protection == Protection::RetryBudgetAndCircuitBreaker) {
+    circuit_breaker_options = CircuitBreakerOptions{
+        .failure_threshold = 5, .open_duration = milliseconds(1)};
+  }
+  OperationDispatcher dispatcher(
+      make_shared<MockAsyncExecutor>(),
+      RetryStrategy(RetryStrategyType::Exponential, 0, 5,
+                    RetryJitterType::Full),
+      retry_budget_options, circuit_breaker_options);
+
+  atomic<int64_t> target_call_count(0);
+  function<ExecutionResult(AsyncContext<string, string>&)>
+      dispatch_to_target = [&](AsyncContext<string, string>& context) {
+        target_call_count++;
+        context.result = RetryExecutionResult(1);
+        context.Finish();
+        return SuccessExecutionResult();
+      };
+
+  for (auto _ : state) {
+    AsyncContext<string, string> context(
+        make_shared<string>(), [](AsyncContext<string, string>& context) {
+          benchmark::DoNotOptimize(context.result);
+        });
+    dispatcher.Dispatch(context, dispatch_to_target);
+  }
+
+  state.SetLabel(kProtectionNames[state.range(0)]);
+  state.counters["target_calls_per_operation"] = benchmark::Counter(
+      target_call_count.load(), benchmark::Counter::kAvgIterations);
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK(BM_DispatchDuringOutage)->DenseRange(0, 3);
+}  // namespace google::scp::core::common::test
+
+// Run the benchmark
+BENCHMARK_MAIN();
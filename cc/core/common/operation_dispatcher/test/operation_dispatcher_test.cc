@@ -39,6 +39,7 @@ using std::atomic;
 using std::function;
 using std::make_shared;
 using std::string;
+using std::chrono::hours;
 using std::chrono::milliseconds;
 
 namespace google::scp::core::common::test {
@@ -383,4 +384,124 @@ TEST(OperationDispatcherTests, RetryOnAcceptance) {
   WaitUntil([&]() { return condition.load(); });
 }
 
+TEST(OperationDispatcherTests, RetryBudgetExhausted) {
+  std::shared_ptr<AsyncExecutorInterface> mock_async_executor =
+      make_shared<MockAsyncExecutor>();
+  RetryStrategy retry_strategy(RetryStrategyType::Exponential, 0, 5);
+  OperationDispatcher dispatcher(
+      mock_async_executor, retry_strategy,
+      RetryBudgetOptions{.maximum_token_count = 2, .token_ratio = 0});
+
+  atomic<size_t> call_count = 0;
+  function<ExecutionResult(AsyncContext<string, string>&)>
+      dispatch_to_component = [&](AsyncContext<string, string>& context) {
+        call_count++;
+        context.result = RetryExecutionResult(1);
+        context.Finish();
+        return SuccessExecutionResult();
+      };
+
+  atomic<bool> condition(false);
+  AsyncContext<string, string> context;
+  context.callback = [&](AsyncContext<string, string>& context) {
+    EXPECT_THAT(context.result,
+                ResultIs(FailureExecutionResult(
+                    core::errors::SC_DISPATCHER_RETRY_BUDGET_EXHAUSTED)));
+    condition = true;
+  };
+  dispatcher.Dispatch(context, dispatch_to_component);
+  WaitUntil([&]() { return condition.load(); });
+  EXPECT_EQ(call_count, 3);
+
+  // The copies of the dispatcher share the spent budget.
+  auto dispatcher_copy = dispatcher;
+  condition = false;
+  AsyncContext<string, string> other_context;
+  other_context.callback = context.callback;
+  dispatcher_copy.Dispatch(other_context, dispatch_to_component);
+  WaitUntil([&]() { return condition.load(); });
+  EXPECT_EQ(call_count, 4);
+}
+
+TEST(OperationDispatcherTests, CircuitOpensOnRetriableFailures) {
+  std::shared_ptr<AsyncExecutorInterface> mock_async_executor =
+      make_shared<MockAsyncExecutor>();
+  RetryStrategy retry_strategy(RetryStrategyType::Exponential, 0, 5);
+  OperationDispatcher dispatcher(
+      mock_async_executor, retry_strategy, std::nullopt,
+      CircuitBreakerOptions{.failure_threshold = 3, .open_duration = hours(1)});
+
+  atomic<size_t> call_count = 0;
+  function<ExecutionResult(AsyncContext<string, string>&)>
+      dispatch_to_component = [&](AsyncContext<string, string>& context) {
+        call_count++;
+        context.result = *context.request == "healthy"
+                             ? SuccessExecutionResult()
+                             : RetryExecutionResult(1);
+        context.Finish();
+        return SuccessExecutionResult();
+      };
+
+  atomic<bool> condition(false);
+  AsyncContext<string, string> context;
+  context.request = make_shared<string>("unhealthy");
+  context.callback = [&](AsyncContext<string, string>& context) {
+    EXPECT_THAT(context.result, ResultIs(FailureExecutionResult(
+                                    core::errors::SC_DISPATCHER_CIRCUIT_OPEN)));
+    condition = true;
+  };
+  dispatcher.Dispatch(context, "target", dispatch_to_component);
+  WaitUntil([&]() { return condition.load(); });
+  EXPECT_EQ(call_count, 3);
+
+  // The open circuit fails the next operations without calling the target.
+  condition = false;
+  AsyncContext<string, string> failing_context;
+  failing_context.request = make_shared<string>("healthy");
+  failing_context.callback = context.callback;
+  dispatcher.Dispatch(failing_context, "target", dispatch_to_component);
+  WaitUntil([&]() { return condition.load(); });
+  EXPECT_EQ(call_count, 3);
+
+  // The circuits of the other targets are still closed.
+  condition = false;
+  AsyncContext<string, string> succeeding_context;
+  succeeding_context.request = make_shared<string>("healthy");
+  succeeding_context.callback = [&](AsyncContext<string, string>& context) {
+    EXPECT_SUCCESS(context.result);
+    condition = true;
+  };
+  dispatcher.Dispatch(succeeding_context, "other target",
+                      dispatch_to_component);
+  WaitUntil([&]() { return condition.load(); });
+  EXPECT_EQ(call_count, 4);
+}
+
+TEST(OperationDispatcherTests, CircuitIgnoresNonRetriableFailures) {
+  std::shared_ptr<AsyncExecutorInterface> mock_async_executor =
+      make_shared<MockAsyncExecutor>();
+  RetryStrategy retry_strategy(RetryStrategyType::Exponential, 0, 5);
+  OperationDispatcher dispatcher(
+      mock_async_executor, retry_strategy, std::nullopt,
+      CircuitBreakerOptions{.failure_threshold = 1, .open_duration = hours(1)});
+
+  function<ExecutionResult(AsyncContext<string, string>&)>
+      dispatch_to_component = [](AsyncContext<string, string>& context) {
+        context.result = FailureExecutionResult(1234);
+        context.Finish();
+        return SuccessExecutionResult();
+      };
+
+  for (int i = 0; i < 3; i++) {
+    atomic<bool> condition(false);
+    AsyncContext<string, string> context;
+    context.callback = [&](AsyncContext<string, string>& context) {
+      EXPECT_THAT(context.result, ResultIs(FailureExecutionResult(1234)));
+      condition = true;
+    };
+    dispatcher.Dispatch(context, dispatch_to_component);
+    WaitUntil([&]() { return condition.load(); });
+  }
+}
+
 }  // namespace google::scp::core::common::test
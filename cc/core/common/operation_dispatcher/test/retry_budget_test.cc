@@ -0,0 +1,53 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/common/operation_dispatcher/src/retry_budget.h"
+
+#include <gtest/gtest.h>
+
+namespace google::scp::core::common::test {
+TEST(RetryBudgetTests, StartsFull) {
+  RetryBudget retry_budget({.maximum_token_count = 3, .token_ratio = 0.1});
+  EXPECT_EQ(retry_budget.GetTokenCount(), 3);
+  EXPECT_TRUE(retry_budget.TryWithdraw());
+  EXPECT_TRUE(retry_budget.TryWithdraw());
+  EXPECT_TRUE(retry_budget.TryWithdraw());
+  EXPECT_FALSE(retry_budget.TryWithdraw());
+  EXPECT_EQ(retry_budget.GetTokenCount(), 0);
+}
+
+TEST(RetryBudgetTests, DepositsRefillTheBudget) {
+  RetryBudget retry_budget({.maximum_token_count = 2, .token_ratio = 0.25});
+  EXPECT_TRUE(retry_budget.TryWithdraw());
+  EXPECT_TRUE(retry_budget.TryWithdraw());
+
+  for (int i = 0; i < 3; i++) {
+    retry_budget.Deposit();
+    EXPECT_FALSE(retry_budget.TryWithdraw());
+  }
+  retry_budget.Deposit();
+  EXPECT_TRUE(retry_budget.TryWithdraw());
+  EXPECT_FALSE(retry_budget.TryWithdraw());
+}
+
+TEST(RetryBudgetTests, DepositsDoNotExceedTheMaximum) {
+  RetryBudget retry_budget({.maximum_token_count = 2, .token_ratio = 0.5});
+  for (int i = 0; i < 10; i++) {
+    retry_budget.Deposit();
+  }
+  EXPECT_EQ(retry_budget.GetTokenCount(), 2);
+}
+}  // namespace google::scp::core::common::test
@@ -43,4 +43,20 @@ TEST(RetryStrategyTests, LinearRetryStrategyTest) {
   EXPECT_EQ(retry_strategy.GetMaximumAllowedRetryCount(), 5);
 }
 
+TEST(RetryStrategyTests, FullJitterRetryStrategyTest) {
+  RetryStrategy retry_strategy(RetryStrategyType::Exponential, 1000, 5,
+                               RetryJitterType::Full);
+  EXPECT_EQ(retry_strategy.GetBackOffDurationInMilliseconds(0), 0);
+
+  bool back_off_durations_differ = false;
+  auto first_back_off_duration =
+      retry_strategy.GetBackOffDurationInMilliseconds(3);
+  for (int i = 0; i < 100; i++) {
+    auto back_off_duration = retry_strategy.GetBackOffDurationInMilliseconds(3);
+    EXPECT_LE(back_off_duration, 4000);
+    back_off_durations_differ |= back_off_duration != first_back_off_duration;
+  }
+  EXPECT_TRUE(back_off_durations_differ);
+}
+
 }  // namespace google::scp::core::common::test
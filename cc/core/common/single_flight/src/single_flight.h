@@ -0,0 +1,186 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "core/interface/async_context.h"
+#include "public/core/interface/execution_result.h"
+
+namespace google::scp::core::common {
+/**
+ * @brief Coalesces the concurrent operations of the same key into a single
+ * in-flight operation. The first caller of a key starts the operation, the
+ * callers that arrive while it is in flight are attached to it, and its result
+ * is fanned out to all of them. The next caller after the completion starts a
+ * new operation, so results are never served stale.
+ *
+ * Each caller gets its own copy of the response.
+ *
+ * @tparam TKey The key of the operations, derived from their requests.
+ * @tparam TRequest The request of the operations.
+ * @tparam TResponse The response of the operations.
+ * @tparam THash The hash of the keys.
+ */
+template <typename TKey, typename TRequest, typename TResponse,
+          typename THash = std::hash<TKey>>
+class SingleFlight {
+ public:
+  using Context = AsyncContext<TRequest, TResponse>;
+  using OperationFunction = std::function<ExecutionResult(Context&)>;
+
+  /**
+   * @brief Attaches the context to the in-flight operation of the key, or
+   * starts one with the operation function and the request of the context.
+   *
+   * @param key The key of the operation.
+   * @param context The context to complete with the result of the operation.
+   * @param operation_function The function that starts the operation, if none
+   * is in flight.
+   * @param cancellation_callback Set to a function that detaches the context
+   * from the operation. It returns true if the context was detached before
+   * the operation completed, in which case its callback is never called.
+   * @return ExecutionResult The result of starting the operation. If the
+   * operation could not start, every attached context is finished with the
+   * failure.
+   */
+  ExecutionResult Do(const TKey& key, Context& context,
+                     const OperationFunction& operation_function,
+                     std::function<bool()>& cancellation_callback) noexcept {
+    std::shared_ptr<Flight> flight;
+    uint64_t waiter_id;
+    bool is_leader = false;
+    {
+      std::lock_guard lock(mutex_);
+      auto& in_flight = flights_[key];
+      if (!in_flight) {
+        in_flight = std::make_shared<Flight>();
+        is_leader = true;
+      }
+      flight = in_flight;
+      // Attached under the lock of the flights, so that the flight cannot
+      // complete without this context once it has been found.
+      std::lock_guard flight_lock(flight->mutex);
+      waiter_id = flight->next_waiter_id++;
+      flight->waiters.emplace_back(waiter_id, context);
+    }
+
+    cancellation_callback = [weak_flight = std::weak_ptr<Flight>(flight),
+                             waiter_id]() {
+      return Detach(weak_flight, waiter_id);
+    };
+    if (!is_leader) {
+      return SuccessExecutionResult();
+    }
+
+    Context operation_context(
+        context.request,
+        [this, key, flight](Context& operation_context) {
+          Complete(key, flight, operation_context);
+        },
+        context);
+    operation_context.expiration_time = context.expiration_time;
+    auto execution_result = operation_function(operation_context);
+    if (!execution_result.Successful()) {
+      operation_context.result = execution_result;
+      Complete(key, flight, operation_context);
+    }
+    return execution_result;
+  }
+
+  /// Same as Do, for contexts that are never detached.
+  ExecutionResult Do(const TKey& key, Context& context,
+                     const OperationFunction& operation_function) noexcept {
+    std::function<bool()> cancellation_callback;
+    return Do(key, context, operation_function, cancellation_callback);
+  }
+
+ private:
+  /// An in-flight operation and the contexts attached to it.
+  struct Flight {
+    /// Guards the fields below.
+    std::mutex mutex;
+    /// Whether the operation completed.
+    bool completed = false;
+    uint64_t next_waiter_id = 0;
+    std::vector<std::pair<uint64_t, Context>> waiters;
+  };
+
+  static bool Detach(const std::weak_ptr<Flight>& weak_flight,
+                     uint64_t waiter_id) noexcept {
+    auto flight = weak_flight.lock();
+    if (!flight) {
+      return false;
+    }
+    std::lock_guard lock(flight->mutex);
+    auto& waiters = flight->waiters;
+    for (auto it = waiters.begin(); it != waiters.end(); ++it) {
+      if (it->first == waiter_id) {
+        waiters.erase(it);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /// Completes the contexts attached to the flight, at most once.
+  void Complete(const TKey& key, const std::shared_ptr<Flight>& flight,
+                Context& operation_context) noexcept {
+    {
+      std::lock_guard lock(mutex_);
+      auto it = flights_.find(key);
+      if (it != flights_.end() && it->second == flight) {
+        flights_.erase(it);
+      }
+    }
+
+    std::vector<std::pair<uint64_t, Context>> waiters;
+    {
+      std::lock_guard lock(flight->mutex);
+      if (flight->completed) {
+        return;
+      }
+      flight->completed = true;
+      waiters.swap(flight->waiters);
+    }
+
+    for (size_t i = 0; i < waiters.size(); i++) {
+      auto& context = waiters[i].second;
+      context.result = operation_context.result;
+      // The last context gets the response itself, once the others copied it.
+      if (i + 1 == waiters.size() || !operation_context.response) {
+        context.response = std::move(operation_context.response);
+      } else {
+        context.response =
+            std::make_shared<TResponse>(*operation_context.response);
+      }
+      context.Finish();
+    }
+  }
+
+  /// Guards the in-flight operations.
+  std::mutex mutex_;
+  /// The in-flight operations by key.
+  std::unordered_map<TKey, std::shared_ptr<Flight>, THash> flights_;
+};
+}  // namespace google::scp::core::common
@@ -0,0 +1,105 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+
+#include <benchmark/benchmark.h>
+
+#include "core/common/single_flight/src/single_flight.h"
+#include "core/interface/async_context.h"
+
+using google::scp::core::AsyncContext;
+using std::atomic;
+using std::function;
+using std::make_shared;
+using std::string;
+using std::chrono::microseconds;
+
+namespace google::scp::core::common::test {
+/// The latency of the fake remote call.
+static constexpr microseconds kRemoteCallLatency(200);
+
+/// The number of calls made to the fake remote target.
+static atomic<int64_t> remote_call_count(0);
+
+/// A fake remote call, which blocks its caller for the call latency.
+static ExecutionResult CallRemote(AsyncContext<string, string>& context) {
+  remote_call_count++;
+  std::this_thread::sleep_for(kRemoteCallLatency);
+  context.response = make_shared<string>("a response of a typical size");
+  context.result = SuccessExecutionResult();
+  context.Finish();
+  return SuccessExecutionResult();
+}
+
+static void ReportRemoteCalls(benchmark::State& state,
+                              int64_t initial_remote_call_count) {
+  if (state.thread_index() == 0) {
+    state.counters["remote_calls_per_request"] = benchmark::Counter(
+        remote_call_count.load() - initial_remote_call_count,
+        benchmark::Counter::kAvgIterations);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+/// Every thread asks for the same thing, each with its own remote call.
+static void BM_RemoteCallPerRequest(benchmark::State& state) {
+  auto initial_remote_call_count = remote_call_count.load();
+  for (auto _ : state) {
+    AsyncContext<string, string> context(
+        make_shared<string>("request"),
+        [](AsyncContext<string, string>& context) {
+          benchmark::DoNotOptimize(context.response);
+        });
+    CallRemote(context);
+  }
+  ReportRemoteCalls(state, initial_remote_call_count);
+}
+
+/// Every thread asks for the same thing through a shared single flight.
+static void BM_SingleFlight(benchmark::State& state) {
+  static SingleFlight<string, string, string> single_flight;
+  static const function<ExecutionResult(AsyncContext<string, string>&)>
+      operation_function = CallRemote;
+
+  auto initial_remote_call_count = remote_call_count.load();
+  for (auto _ : state) {
+    atomic<bool> completed(false);
+    AsyncContext<string, string> context(
+        make_shared<string>("request"),
+        [&](AsyncContext<string, string>& context) {
+          benchmark::DoNotOptimize(context.response);
+          completed = true;
+        });
+    single_flight.Do("key", context, operation_function);
+    while (!completed) {
+      std::this_thread::yield();
+    }
+  }
+  ReportRemoteCalls(state, initial_remote_call_count);
+}
+
+BENCHMARK(BM_RemoteCallPerRequest)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK(BM_SingleFlight)->ThreadRange(1, 16)->UseRealTime();
+}  // namespace google::scp::core::common::test
+
+// Run the benchmark
+BENCHMARK_MAIN();
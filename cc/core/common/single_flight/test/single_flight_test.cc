@@ -0,0 +1,188 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/common/single_flight/src/single_flight.h"
+
+#include <gtest/gtest.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/interface/async_context.h"
+#include "public/core/test/interface/execution_result_matchers.h"
+
+using google::scp::core::AsyncContext;
+using google::scp::core::test::ResultIs;
+using std::function;
+using std::make_shared;
+using std::string;
+using std::vector;
+
+namespace google::scp::core::common::test {
+/**
+ * @brief Holds the operations started by the single flight until the test
+ * completes them.
+ */
+class SingleFlightTest : public testing::Test {
+ protected:
+  SingleFlightTest() {
+    operation_function_ = [this](AsyncContext<string, string>& context) {
+      operations_.push_back(context);
+      return SuccessExecutionResult();
+    };
+  }
+
+  /// Creates a context that records its results.
+  AsyncContext<string, string> CreateContext(const string& request) {
+    return AsyncContext<string, string>(
+        make_shared<string>(request),
+        [this](AsyncContext<string, string>& context) {
+          results_.push_back(context.result);
+          responses_.push_back(context.response);
+        });
+  }
+
+  /// Completes the operation with the result, and the request as the response.
+  void CompleteOperation(size_t index, ExecutionResult result) {
+    auto& operation = operations_[index];
+    operation.result = result;
+    operation.response = make_shared<string>(*operation.request);
+    operation.Finish();
+  }
+
+  SingleFlight<string, string, string> single_flight_;
+  function<ExecutionResult(AsyncContext<string, string>&)> operation_function_;
+  vector<AsyncContext<string, string>> operations_;
+  vector<ExecutionResult> results_;
+  vector<std::shared_ptr<string>> responses_;
+};
+
+TEST_F(SingleFlightTest, ConcurrentCallersShareTheOperation) {
+  for (int i = 0; i < 3; i++) {
+    auto context = CreateContext("request");
+    EXPECT_SUCCESS(single_flight_.Do("key", context, operation_function_));
+  }
+  ASSERT_EQ(operations_.size(), 1);
+  EXPECT_TRUE(results_.empty());
+
+  CompleteOperation(0, SuccessExecutionResult());
+  ASSERT_EQ(results_.size(), 3);
+  for (int i = 0; i < 3; i++) {
+    EXPECT_SUCCESS(results_[i]);
+    EXPECT_EQ(*responses_[i], "request");
+  }
+  // Every caller gets its own response.
+  EXPECT_NE(responses_[0], responses_[1]);
+  EXPECT_NE(responses_[1], responses_[2]);
+}
+
+TEST_F(SingleFlightTest, KeysHaveSeparateOperations) {
+  auto context1 = CreateContext("request1");
+  auto context2 = CreateContext("request2");
+  EXPECT_SUCCESS(single_flight_.Do("key1", context1, operation_function_));
+  EXPECT_SUCCESS(single_flight_.Do("key2", context2, operation_function_));
+  ASSERT_EQ(operations_.size(), 2);
+
+  CompleteOperation(1, SuccessExecutionResult());
+  ASSERT_EQ(results_.size(), 1);
+  EXPECT_EQ(*responses_[0], "request2");
+}
+
+TEST_F(SingleFlightTest, CompletedOperationIsNotReused) {
+  auto context = CreateContext("request");
+  EXPECT_SUCCESS(single_flight_.Do("key", context, operation_function_));
+  CompleteOperation(0, SuccessExecutionResult());
+
+  EXPECT_SUCCESS(single_flight_.Do("key", context, operation_function_));
+  EXPECT_EQ(operations_.size(), 2);
+}
+
+TEST_F(SingleFlightTest, FailureIsFannedOut) {
+  for (int i = 0; i < 2; i++) {
+    auto context = CreateContext("request");
+    EXPECT_SUCCESS(single_flight_.Do("key", context, operation_function_));
+  }
+  CompleteOperation(0, FailureExecutionResult(1234));
+
+  ASSERT_EQ(results_.size(), 2);
+  EXPECT_THAT(results_[0], ResultIs(FailureExecutionResult(1234)));
+  EXPECT_THAT(results_[1], ResultIs(FailureExecutionResult(1234)));
+}
+
+TEST_F(SingleFlightTest, FailureToStartCompletesTheCallers) {
+  function<ExecutionResult(AsyncContext<string, string>&)> operation_function =
+      [](AsyncContext<string, string>&) {
+        return FailureExecutionResult(1234);
+      };
+  auto context = CreateContext("request");
+  EXPECT_THAT(single_flight_.Do("key", context, operation_function),
+              ResultIs(FailureExecutionResult(1234)));
+  ASSERT_EQ(results_.size(), 1);
+  EXPECT_THAT(results_[0], ResultIs(FailureExecutionResult(1234)));
+
+  // The failed operation is not in flight anymore.
+  EXPECT_SUCCESS(single_flight_.Do("key", context, operation_function_));
+  EXPECT_EQ(operations_.size(), 1);
+}
+
+TEST_F(SingleFlightTest, FinishedAndFailedToStartCompletesTheCallersOnce) {
+  function<ExecutionResult(AsyncContext<string, string>&)> operation_function =
+      [](AsyncContext<string, string>& context) {
+        context.result = FailureExecutionResult(1234);
+        context.Finish();
+        return FailureExecutionResult(1234);
+      };
+  auto context = CreateContext("request");
+  EXPECT_THAT(single_flight_.Do("key", context, operation_function),
+              ResultIs(FailureExecutionResult(1234)));
+  EXPECT_EQ(results_.size(), 1);
+}
+
+TEST_F(SingleFlightTest, CancelledCallerIsNotCompleted) {
+  function<bool()> cancel_first;
+  function<bool()> cancel_second;
+  auto first_context = CreateContext("request");
+  auto second_context = CreateContext("request");
+  EXPECT_SUCCESS(single_flight_.Do("key", first_context, operation_function_,
+                                   cancel_first));
+  EXPECT_SUCCESS(single_flight_.Do("key", second_context, operation_function_,
+                                   cancel_second));
+
+  // The operation goes on for the other callers.
+  EXPECT_TRUE(cancel_first());
+  EXPECT_FALSE(cancel_first());
+  CompleteOperation(0, SuccessExecutionResult());
+  EXPECT_EQ(results_.size(), 1);
+
+  // Too late to cancel.
+  EXPECT_FALSE(cancel_second());
+}
+
+TEST_F(SingleFlightTest, OperationCompletesWithoutCallers) {
+  function<bool()> cancel;
+  auto context = CreateContext("request");
+  EXPECT_SUCCESS(
+      single_flight_.Do("key", context, operation_function_, cancel));
+  EXPECT_TRUE(cancel());
+  CompleteOperation(0, SuccessExecutionResult());
+  EXPECT_TRUE(results_.empty());
+
+  EXPECT_SUCCESS(single_flight_.Do("key", context, operation_function_));
+  EXPECT_EQ(operations_.size(), 2);
+}
+}  // namespace google::scp::core::common::test
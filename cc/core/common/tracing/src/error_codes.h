@@ -0,0 +1,36 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+
+#include "core/interface/errors.h"
+#include "public/core/interface/execution_result.h"
+
+namespace google::scp::core::errors {
+
+/// Registers component code as 0x001C for tracer.
+REGISTER_COMPONENT_CODE(SC_TRACER, 0x001C);
+
+DEFINE_ERROR_CODE(SC_TRACER_INVALID_OPTIONS, SC_TRACER, 0x0001,
+                  "The options of the tracer are invalid",
+                  HttpStatusCode::BAD_REQUEST);
+
+DEFINE_ERROR_CODE(SC_TRACER_CANNOT_OPEN_OUTPUT_FILE, SC_TRACER, 0x0002,
+                  "The output file of the tracer cannot be opened",
+                  HttpStatusCode::INTERNAL_SERVER_ERROR);
+
+DEFINE_ERROR_CODE(SC_TRACER_ALREADY_RUNNING, SC_TRACER, 0x0003,
+                  "The tracer is already running",
+                  HttpStatusCode::INTERNAL_SERVER_ERROR);
+
+}  // namespace google::scp::core::errors
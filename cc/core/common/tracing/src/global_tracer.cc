@@ -0,0 +1,46 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "global_tracer.h"
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using std::lock_guard;
+using std::memory_order_release;
+using std::mutex;
+using std::shared_ptr;
+using std::vector;
+
+namespace google::scp::core::common {
+static mutex tracers_mutex_;
+/// The tracers that were set, kept alive for the threads still using them.
+static vector<shared_ptr<Tracer>> tracers_;
+
+void GlobalTracer::SetGlobalTracer(shared_ptr<Tracer> tracer) noexcept {
+  lock_guard lock(tracers_mutex_);
+  tracer_.store(tracer.get(), memory_order_release);
+  if (tracer) {
+    tracers_.push_back(tracer);
+  }
+}
+
+void GlobalTracer::ShutdownGlobalTracer() noexcept {
+  tracer_.store(nullptr, memory_order_release);
+}
+}  // namespace google::scp::core::common
@@ -0,0 +1,95 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+#include "core/common/time_provider/src/time_provider.h"
+#include "core/common/uuid/src/uuid.h"
+
+#include "span_ring_buffer.h"
+#include "tracer.h"
+
+namespace google::scp::core::common {
+/**
+ * @brief The tracer that the components record their spans into. Tracing is
+ * disabled until a tracer is set, and checking for it is a single atomic load.
+ */
+class GlobalTracer {
+ public:
+  /// Returns the global tracer, or nullptr if tracing is disabled.
+  static Tracer* GetGlobalTracer() noexcept {
+    return tracer_.load(std::memory_order_acquire);
+  }
+
+  /**
+   * @brief Sets the global tracer. The caller initializes, runs and stops it.
+   * The tracer is kept until the process exits, as threads may still be
+   * recording into it after it is replaced.
+   */
+  static void SetGlobalTracer(std::shared_ptr<Tracer> tracer) noexcept;
+
+  /// Disables tracing.
+  static void ShutdownGlobalTracer() noexcept;
+
+ private:
+  static inline std::atomic<Tracer*> tracer_ = nullptr;
+};
+
+/**
+ * @brief Returns the global tracer if it records the spans of the trace, or
+ * nullptr.
+ *
+ * @param correlation_id The correlation id of the trace.
+ */
+inline Tracer* GetSampledTracer(const Uuid& correlation_id) noexcept {
+  auto* tracer = GlobalTracer::GetGlobalTracer();
+  if (tracer && tracer->IsSampled(correlation_id)) {
+    return tracer;
+  }
+  return nullptr;
+}
+
+/**
+ * @brief Records a span of the work on the context, which started at
+ * start_timestamp and ends now.
+ *
+ * @param tracer The tracer from GetSampledTracer.
+ * @param name The name of the span, which must outlive the tracer.
+ * @param context The context whose ids the span carries.
+ * @param start_timestamp The start of the span in steady clock nanoseconds.
+ */
+template <typename Context>
+void RecordContextSpan(Tracer& tracer, const char* name, const Context& context,
+                       Timestamp start_timestamp) noexcept {
+  SpanRecord span;
+  span.name = name;
+  span.correlation_id = context.correlation_id;
+  span.parent_activity_id = context.parent_activity_id;
+  span.activity_id = context.activity_id;
+  span.start_timestamp = start_timestamp;
+  span.end_timestamp =
+      TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks();
+  if (context.retry_count > 0) {
+    span.argument_name = "retry_count";
+    span.argument_value = context.retry_count;
+  }
+  tracer.RecordSpan(span);
+}
+}  // namespace google::scp::core::common
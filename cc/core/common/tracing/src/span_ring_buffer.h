@@ -0,0 +1,126 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "core/common/uuid/src/uuid.h"
+#include "core/interface/type_def.h"
+
+namespace google::scp::core::common {
+/// A timed section of the work on a request.
+struct SpanRecord {
+  /// The name of the span. Must outlive the tracer, e.g. a string literal.
+  const char* name = nullptr;
+  Uuid correlation_id;
+  Uuid parent_activity_id;
+  Uuid activity_id;
+  /// The start and end of the span, in steady clock nanoseconds.
+  Timestamp start_timestamp = 0;
+  Timestamp end_timestamp = 0;
+  /// The name of an optional numeric argument, which must outlive the tracer.
+  const char* argument_name = nullptr;
+  int64_t argument_value = 0;
+};
+
+/**
+ * @brief A bounded single producer, single consumer queue of spans, written by
+ * the thread that owns it and read by the thread that flushes the spans. Both
+ * sides are wait-free, and the spans that do not fit are dropped rather than
+ * blocking the producer.
+ */
+class SpanRingBuffer {
+ public:
+  /**
+   * @brief Construct a new Span Ring Buffer object
+   *
+   * @param capacity The number of spans the buffer holds, rounded up to a power
+   * of two.
+   * @param thread_id The id of the producer thread in the trace.
+   */
+  SpanRingBuffer(size_t capacity, uint64_t thread_id)
+      : capacity_(RoundUpToPowerOfTwo(capacity)),
+        thread_id_(thread_id),
+        spans_(std::make_unique<SpanRecord[]>(capacity_)),
+        head_(0),
+        tail_(0),
+        dropped_count_(0) {}
+
+  /**
+   * @brief Adds a span to the buffer. Must only be called by the producer.
+   *
+   * @return true if the span fit into the buffer.
+   */
+  bool TryPush(const SpanRecord& span) noexcept {
+    auto tail = tail_.load(std::memory_order_relaxed);
+    if (tail - head_.load(std::memory_order_acquire) == capacity_) {
+      dropped_count_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    spans_[tail & (capacity_ - 1)] = span;
+    tail_.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Removes the spans in the buffer, and passes them to the consumer.
+   * Must only be called by the consumer.
+   *
+   * @return The number of spans removed.
+   */
+  template <typename Consumer>
+  size_t Drain(Consumer&& consumer) noexcept {
+    auto head = head_.load(std::memory_order_relaxed);
+    auto tail = tail_.load(std::memory_order_acquire);
+    for (auto index = head; index != tail; index++) {
+      consumer(static_cast<const SpanRecord&>(spans_[index & (capacity_ - 1)]));
+    }
+    head_.store(tail, std::memory_order_release);
+    return tail - head;
+  }
+
+  /// Returns the id of the producer thread in the trace.
+  uint64_t GetThreadId() const noexcept { return thread_id_; }
+
+  /// Returns the number of spans dropped because the buffer was full.
+  uint64_t GetDroppedCount() const noexcept {
+    return dropped_count_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  static size_t RoundUpToPowerOfTwo(size_t value) noexcept {
+    size_t power = 1;
+    while (power < value) {
+      power <<= 1;
+    }
+    return power;
+  }
+
+  const size_t capacity_;
+  const uint64_t thread_id_;
+  std::unique_ptr<SpanRecord[]> spans_;
+  /// The next span to read, written by the consumer.
+  alignas(64) std::atomic<uint64_t> head_;
+  /// The next span to write, written by the producer.
+  alignas(64) std::atomic<uint64_t> tail_;
+  std::atomic<uint64_t> dropped_count_;
+};
+}  // namespace google::scp::core::common
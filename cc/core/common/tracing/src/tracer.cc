@@ -0,0 +1,291 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "tracer.h"
+
+#include <unistd.h>
+
+#include <cinttypes>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "error_codes.h"
+
+using google::scp::core::errors::SC_TRACER_ALREADY_RUNNING;
+using google::scp::core::errors::SC_TRACER_CANNOT_OPEN_OUTPUT_FILE;
+using google::scp::core::errors::SC_TRACER_INVALID_OPTIONS;
+using std::atomic;
+using std::lock_guard;
+using std::make_shared;
+using std::make_unique;
+using std::mutex;
+using std::shared_ptr;
+using std::thread;
+using std::unique_lock;
+using std::vector;
+
+namespace {
+/// The number of bytes formatted before they are written to the file.
+constexpr size_t kOutputBufferFlushSize = 64 * 1024;
+
+/// Spreads the bits of the key, so that sequential keys sample evenly.
+uint64_t Mix(uint64_t key) {
+  key ^= key >> 30;
+  key *= 0xbf58476d1ce4e5b9ULL;
+  key ^= key >> 27;
+  key *= 0x94d049bb133111ebULL;
+  return key ^ (key >> 31);
+}
+
+uint64_t GetSampleThreshold(double sample_ratio) {
+  if (sample_ratio >= 1) {
+    return UINT64_MAX;
+  }
+  if (sample_ratio <= 0) {
+    return 0;
+  }
+  // 2^64, which is not representable as an integer.
+  return static_cast<uint64_t>(sample_ratio * 18446744073709551616.0);
+}
+
+uint64_t GenerateTracerId() {
+  static atomic<uint64_t> next_tracer_id(1);
+  return next_tracer_id.fetch_add(1);
+}
+}  // namespace
+
+namespace google::scp::core::common {
+Tracer::Tracer(TracerOptions options)
+    : options_(options),
+      tracer_id_(GenerateTracerId()),
+      sample_threshold_(GetSampleThreshold(options.sample_ratio)),
+      buffer_pool_(make_shared<SpanBufferPool>()),
+      is_first_event_(true),
+      is_running_(false) {}
+
+Tracer::~Tracer() {
+  if (flush_thread_) {
+    Stop();
+  }
+}
+
+ExecutionResult Tracer::Init() noexcept {
+  if (options_.output_path.empty() || options_.sample_ratio < 0 ||
+      options_.sample_ratio > 1 || options_.buffer_capacity_per_thread == 0) {
+    return FailureExecutionResult(SC_TRACER_INVALID_OPTIONS);
+  }
+
+  lock_guard lock(output_mutex_);
+  output_.open(options_.output_path, std::ios::out | std::ios::trunc);
+  if (!output_.is_open()) {
+    return FailureExecutionResult(SC_TRACER_CANNOT_OPEN_OUTPUT_FILE);
+  }
+  // The JSON array format of the trace events.
+  output_buffer_ = "[";
+  return SuccessExecutionResult();
+}
+
+ExecutionResult Tracer::Run() noexcept {
+  lock_guard lock(flush_mutex_);
+  if (is_running_) {
+    return FailureExecutionResult(SC_TRACER_ALREADY_RUNNING);
+  }
+  is_running_ = true;
+  flush_thread_ = make_unique<thread>([this]() {
+    unique_lock lock(flush_mutex_);
+    while (is_running_) {
+      flush_condition_.wait_for(lock, options_.flush_interval,
+                                [this]() { return !is_running_; });
+      lock.unlock();
+      Flush();
+      lock.lock();
+    }
+  });
+  return SuccessExecutionResult();
+}
+
+ExecutionResult Tracer::Stop() noexcept {
+  {
+    lock_guard lock(flush_mutex_);
+    is_running_ = false;
+  }
+  flush_condition_.notify_all();
+  if (flush_thread_) {
+    flush_thread_->join();
+    flush_thread_ = nullptr;
+  }
+
+  Flush();
+  lock_guard lock(output_mutex_);
+  if (output_.is_open()) {
+    output_ << output_buffer_ << "\n]\n";
+    output_buffer_.clear();
+    output_.close();
+  }
+  return SuccessExecutionResult();
+}
+
+bool Tracer::IsSampled(const Uuid& correlation_id) noexcept {
+  if (sample_threshold_ == UINT64_MAX) {
+    return true;
+  }
+  uint64_t key;
+  if (correlation_id == kZeroUuid) {
+    static thread_local uint64_t uncorrelated_span_count = 0;
+    key = uncorrelated_span_count++;
+  } else {
+    key = correlation_id.high ^ correlation_id.low;
+  }
+  return Mix(key) < sample_threshold_;
+}
+
+void Tracer::RecordSpan(const SpanRecord& span) noexcept {
+  GetThreadBuffer()->TryPush(span);
+}
+
+SpanRingBuffer* Tracer::GetThreadBuffer() noexcept {
+  // Returns the buffer to the pool when the thread exits, or when it records
+  // into another tracer. The buffers outlive their threads, so that the spans
+  // of the threads that exited are still flushed.
+  struct ThreadBuffer {
+    ~ThreadBuffer() { Release(); }
+
+    void Release() noexcept {
+      if (!pool) {
+        return;
+      }
+      lock_guard lock(pool->mutex);
+      pool->free_buffers.push_back(buffer);
+      pool = nullptr;
+      buffer = nullptr;
+      tracer_id = 0;
+    }
+
+    uint64_t tracer_id = 0;
+    shared_ptr<SpanBufferPool> pool;
+    SpanRingBuffer* buffer = nullptr;
+  };
+  static thread_local ThreadBuffer thread_buffer;
+  if (thread_buffer.tracer_id == tracer_id_) {
+    return thread_buffer.buffer;
+  }
+  thread_buffer.Release();
+
+  lock_guard lock(buffer_pool_->mutex);
+  auto& free_buffers = buffer_pool_->free_buffers;
+  if (free_buffers.empty()) {
+    auto& buffers = buffer_pool_->buffers;
+    buffers.push_back(make_unique<SpanRingBuffer>(
+        options_.buffer_capacity_per_thread, buffers.size() + 1));
+    thread_buffer.buffer = buffers.back().get();
+  } else {
+    // The pool lock orders the spans of the previous thread before the ones of
+    // this thread, which keeps the buffer single producer.
+    thread_buffer.buffer = free_buffers.back();
+    free_buffers.pop_back();
+  }
+  thread_buffer.tracer_id = tracer_id_;
+  thread_buffer.pool = buffer_pool_;
+  return thread_buffer.buffer;
+}
+
+void Tracer::Flush() noexcept {
+  vector<SpanRingBuffer*> buffers;
+  {
+    lock_guard lock(buffer_pool_->mutex);
+    for (auto& buffer : buffer_pool_->buffers) {
+      buffers.push_back(buffer.get());
+    }
+  }
+
+  lock_guard lock(output_mutex_);
+  if (!output_.is_open()) {
+    return;
+  }
+  for (auto* buffer : buffers) {
+    buffer->Drain([&](const SpanRecord& span) {
+      WriteSpan(span, buffer->GetThreadId());
+      if (output_buffer_.size() >= kOutputBufferFlushSize) {
+        output_ << output_buffer_;
+        output_buffer_.clear();
+      }
+    });
+  }
+  output_ << output_buffer_;
+  output_buffer_.clear();
+  output_.flush();
+}
+
+uint64_t Tracer::GetDroppedSpanCount() noexcept {
+  lock_guard lock(buffer_pool_->mutex);
+  uint64_t dropped_span_count = 0;
+  for (auto& buffer : buffer_pool_->buffers) {
+    dropped_span_count += buffer->GetDroppedCount();
+  }
+  return dropped_span_count;
+}
+
+size_t Tracer::GetThreadBufferCount() noexcept {
+  lock_guard lock(buffer_pool_->mutex);
+  return buffer_pool_->buffers.size();
+}
+
+void Tracer::WriteSpan(const SpanRecord& span, uint64_t thread_id) noexcept {
+  static const int process_id = getpid();
+  auto duration = span.end_timestamp > span.start_timestamp
+                      ? span.end_timestamp - span.start_timestamp
+                      : 0;
+  // The names are literals of the code, which need no escaping.
+  char event[256];
+  snprintf(event, sizeof(event),
+           "%s\n{\"name\":\"%s\",\"cat\":\"scp\",\"ph\":\"X\","
+           "\"ts\":%" PRIu64 ".%03" PRIu64 ",\"dur\":%" PRIu64 ".%03" PRIu64
+           ",\"pid\":%d,\"tid\":%" PRIu64 ",\"args\":{",
+           is_first_event_ ? "" : ",", span.name, span.start_timestamp / 1000,
+           span.start_timestamp % 1000, duration / 1000, duration % 1000,
+           process_id, thread_id);
+  output_buffer_ += event;
+  is_first_event_ = false;
+
+  auto separator = "";
+  auto write_id = [&](const char* id_name, const Uuid& id) {
+    if (id == kZeroUuid) {
+      return;
+    }
+    char id_string[kUuidStringLength];
+    ToString(id, id_string);
+    output_buffer_.append(separator).append("\"").append(id_name).append(
+        "\":\"");
+    output_buffer_.append(id_string, kUuidStringLength).append("\"");
+    separator = ",";
+  };
+  write_id("correlation_id", span.correlation_id);
+  write_id("parent_activity_id", span.parent_activity_id);
+  write_id("activity_id", span.activity_id);
+  if (span.argument_name) {
+    output_buffer_.append(separator)
+        .append("\"")
+        .append(span.argument_name)
+        .append("\":")
+        .append(std::to_string(span.argument_value));
+  }
+  output_buffer_ += "}}";
+}
+}  // namespace google::scp::core::common
@@ -0,0 +1,140 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/common/uuid/src/uuid.h"
+#include "core/interface/service_interface.h"
+#include "public/core/interface/execution_result.h"
+
+#include "span_ring_buffer.h"
+
+namespace google::scp::core::common {
+/// Tracer options.
+struct TracerOptions {
+  /// The file the spans are written to, in the Chrome trace event format.
+  std::string output_path;
+  /**
+   * @brief The fraction of the traces that are recorded. The spans of a trace
+   * share its correlation id, so a trace is recorded whole or not at all.
+   */
+  double sample_ratio = 1.0;
+  /// The number of spans each thread buffers between two flushes.
+  size_t buffer_capacity_per_thread = 4096;
+  /// How often the buffered spans are written to the file.
+  std::chrono::milliseconds flush_interval = std::chrono::milliseconds(100);
+};
+
+/**
+ * @brief The span buffers of the threads that record into a tracer. A thread
+ * returns its buffer when it exits, and the next thread that starts recording
+ * reuses it, so there are only as many buffers as threads recording at once.
+ * The threads share the pool with the tracer, as they may exit after it.
+ */
+struct SpanBufferPool {
+  std::mutex mutex;
+  /// All the buffers. The free ones may still hold spans of exited threads.
+  std::vector<std::unique_ptr<SpanRingBuffer>> buffers;
+  /// The buffers that no thread records into.
+  std::vector<SpanRingBuffer*> free_buffers;
+};
+
+/**
+ * @brief Records spans into buffers of the threads that produce them, and
+ * writes them from a background thread to a file that chrome://tracing and
+ * Perfetto load. Recording a span takes no lock and does not allocate, except
+ * for the first span of each thread.
+ */
+class Tracer : public ServiceInterface {
+ public:
+  explicit Tracer(TracerOptions options);
+
+  ~Tracer();
+
+  /// Opens the output file.
+  ExecutionResult Init() noexcept override;
+  /// Starts the thread that flushes the spans.
+  ExecutionResult Run() noexcept override;
+  /// Flushes the remaining spans and closes the output file.
+  ExecutionResult Stop() noexcept override;
+
+  /**
+   * @brief Returns true if the spans of the trace are recorded. The traces
+   * without a correlation id are sampled one span at a time.
+   *
+   * @param correlation_id The correlation id of the trace.
+   */
+  bool IsSampled(const Uuid& correlation_id) noexcept;
+
+  /**
+   * @brief Records a span, dropping it if the buffer of the thread is full.
+   * The caller checks IsSampled first.
+   */
+  void RecordSpan(const SpanRecord& span) noexcept;
+
+  /// Writes the buffered spans to the output file.
+  void Flush() noexcept;
+
+  /// Returns the number of spans dropped because a buffer was full.
+  uint64_t GetDroppedSpanCount() noexcept;
+
+  /// Returns the number of span buffers, free or in use by a thread.
+  size_t GetThreadBufferCount() noexcept;
+
+ protected:
+  /**
+   * @brief Returns the buffer of the calling thread. On first use, takes a
+   * free buffer from the pool or creates one.
+   */
+  SpanRingBuffer* GetThreadBuffer() noexcept;
+
+  /// Appends a span to the output as a Chrome trace event.
+  void WriteSpan(const SpanRecord& span, uint64_t thread_id) noexcept;
+
+  const TracerOptions options_;
+  /// Distinguishes the tracers in the buffer caches of the threads.
+  const uint64_t tracer_id_;
+  /// The sampled fraction of the 64-bit hash space.
+  const uint64_t sample_threshold_;
+
+  /// The buffers of the threads.
+  const std::shared_ptr<SpanBufferPool> buffer_pool_;
+
+  /// Guards the output file and the formatting buffer.
+  std::mutex output_mutex_;
+  std::ofstream output_;
+  std::string output_buffer_;
+  bool is_first_event_;
+
+  std::mutex flush_mutex_;
+  std::condition_variable flush_condition_;
+  bool is_running_;
+  std::unique_ptr<std::thread> flush_thread_;
+};
+}  // namespace google::scp::core::common
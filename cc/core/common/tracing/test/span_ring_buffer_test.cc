@@ -0,0 +1,74 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "core/common/tracing/src/span_ring_buffer.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+using std::thread;
+using std::vector;
+
+namespace google::scp::core::common::test {
+TEST(SpanRingBufferTest, DropsSpansWhenFull) {
+  SpanRingBuffer buffer(/*capacity=*/3, /*thread_id=*/7);
+  EXPECT_EQ(buffer.GetThreadId(), 7);
+  for (Timestamp i = 0; i < 4; i++) {
+    SpanRecord span;
+    span.start_timestamp = i;
+    EXPECT_TRUE(buffer.TryPush(span));
+  }
+  EXPECT_FALSE(buffer.TryPush(SpanRecord()));
+  EXPECT_EQ(buffer.GetDroppedCount(), 1);
+
+  vector<Timestamp> start_timestamps;
+  EXPECT_EQ(buffer.Drain([&](const SpanRecord& span) {
+    start_timestamps.push_back(span.start_timestamp);
+  }),
+            4);
+  EXPECT_EQ(start_timestamps, vector<Timestamp>({0, 1, 2, 3}));
+  EXPECT_TRUE(buffer.TryPush(SpanRecord()));
+}
+
+TEST(SpanRingBufferTest, ConsumerSeesSpansInOrder) {
+  constexpr Timestamp kSpanCount = 10000;
+  SpanRingBuffer buffer(/*capacity=*/64, /*thread_id=*/1);
+  thread producer([&]() {
+    for (Timestamp i = 0; i < kSpanCount;) {
+      SpanRecord span;
+      span.start_timestamp = i;
+      if (buffer.TryPush(span)) {
+        i++;
+      } else {
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  Timestamp next_timestamp = 0;
+  while (next_timestamp < kSpanCount) {
+    buffer.Drain([&](const SpanRecord& span) {
+      EXPECT_EQ(span.start_timestamp, next_timestamp);
+      next_timestamp++;
+    });
+    std::this_thread::yield();
+  }
+  producer.join();
+}
+}  // namespace google::scp::core::common::test
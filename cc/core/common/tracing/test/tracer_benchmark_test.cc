@@ -0,0 +1,123 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include <atomic>
+#include <memory>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "core/async_executor/src/async_executor.h"
+#include "core/common/time_provider/src/time_provider.h"
+#include "core/common/tracing/src/global_tracer.h"
+#include "core/common/tracing/src/tracer.h"
+#include "core/interface/async_context.h"
+
+using google::scp::core::AsyncContext;
+using google::scp::core::AsyncExecutor;
+using google::scp::core::AsyncPriority;
+using std::atomic;
+using std::make_shared;
+using std::shared_ptr;
+using std::string;
+
+namespace google::scp::core::common::test {
+/// The tracing of a benchmark, from its argument.
+enum class Tracing {
+  Disabled = 0,
+  OnePercent = 1,
+  Full = 2,
+};
+
+static constexpr const char* kTracingNames[] = {"disabled", "1% sampled",
+                                                "100% sampled"};
+
+/// The number of tasks scheduled by an iteration of the executor benchmark.
+static constexpr size_t kTaskCount = 1000;
+
+/// Sets the global tracer for the tracing of the benchmark, if any.
+static shared_ptr<Tracer> StartTracing(benchmark::State& state) {
+  auto tracing = static_cast<Tracing>(state.range(0));
+  state.SetLabel(kTracingNames[state.range(0)]);
+  if (tracing == Tracing::Disabled) {
+    return nullptr;
+  }
+
+  TracerOptions options;
+  options.output_path = "/tmp/tracer_benchmark_test.json";
+  options.sample_ratio = tracing == Tracing::OnePercent ? 0.01 : 1.0;
+  options.flush_interval = std::chrono::milliseconds(10);
+  auto tracer = make_shared<Tracer>(options);
+  if (!tracer->Init().Successful() || !tracer->Run().Successful()) {
+    state.SkipWithError("The tracer did not start.");
+    return nullptr;
+  }
+  GlobalTracer::SetGlobalTracer(tracer);
+  return tracer;
+}
+
+static void StopTracing(benchmark::State& state,
+                        const shared_ptr<Tracer>& tracer) {
+  if (!tracer) {
+    return;
+  }
+  GlobalTracer::ShutdownGlobalTracer();
+  tracer->Stop();
+  state.counters["dropped_spans"] = tracer->GetDroppedSpanCount();
+}
+
+/// Records the span of a context the way the instrumented components do.
+static void BM_RecordContextSpan(benchmark::State& state) {
+  auto tracer = StartTracing(state);
+  AsyncContext<string, string> context(make_shared<string>(), [](auto&) {});
+  for (auto _ : state) {
+    context.correlation_id.low++;
+    if (auto* sampled_tracer = GetSampledTracer(context.correlation_id)) {
+      RecordContextSpan(
+          *sampled_tracer, "Benchmark::Span", context,
+          TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks());
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+  StopTracing(state, tracer);
+}
+
+/// Runs trivial tasks on an executor, each of which records a span if traced.
+static void BM_ExecuteTasks(benchmark::State& state) {
+  auto tracer = StartTracing(state);
+  AsyncExecutor async_executor(/*thread_count=*/2, /*queue_cap=*/10000);
+  async_executor.Init();
+  async_executor.Run();
+  for (auto _ : state) {
+    atomic<size_t> completed_count(0);
+    for (size_t i = 0; i < kTaskCount; i++) {
+      async_executor.Schedule([&]() { completed_count++; },
+                              AsyncPriority::Normal);
+    }
+    while (completed_count.load() < kTaskCount) {}
+  }
+  async_executor.Stop();
+  state.SetItemsProcessed(state.iterations() * kTaskCount);
+  StopTracing(state, tracer);
+}
+
+BENCHMARK(BM_RecordContextSpan)->DenseRange(0, 2);
+BENCHMARK(BM_ExecuteTasks)->DenseRange(0, 2)->UseRealTime();
+}  // namespace google::scp::core::common::test
+
+// Run the benchmark
+BENCHMARK_MAIN();
@@ -0,0 +1,207 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "core/common/tracing/src/tracer.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include "core/common/tracing/src/error_codes.h"
+#include "core/common/tracing/src/global_tracer.h"
+#include "core/interface/async_context.h"
+#include "public/core/test/interface/execution_result_matchers.h"
+
+using google::scp::core::errors::SC_TRACER_CANNOT_OPEN_OUTPUT_FILE;
+using google::scp::core::errors::SC_TRACER_INVALID_OPTIONS;
+using google::scp::core::test::ResultIs;
+using nlohmann::json;
+using std::atomic;
+using std::ifstream;
+using std::make_shared;
+using std::string;
+using std::thread;
+using std::vector;
+
+namespace google::scp::core::common::test {
+class TracerTest : public testing::Test {
+ protected:
+  TracerOptions CreateOptions() {
+    TracerOptions options;
+    options.output_path = testing::TempDir() + "/tracer_test.json";
+    return options;
+  }
+
+  json ReadTrace(const TracerOptions& options) {
+    ifstream input(options.output_path);
+    return json::parse(input);
+  }
+};
+
+TEST_F(TracerTest, WritesSpansAsChromeTraceEvents) {
+  auto options = CreateOptions();
+  Tracer tracer(options);
+  EXPECT_SUCCESS(tracer.Init());
+  EXPECT_SUCCESS(tracer.Run());
+
+  AsyncContext<string, string> context(make_shared<string>(), [](auto&) {},
+                                       Uuid{1, 2}, Uuid{3, 4});
+  context.activity_id = Uuid{5, 6};
+  context.retry_count = 2;
+  ASSERT_TRUE(tracer.IsSampled(context.correlation_id));
+  RecordContextSpan(tracer, "Component::Operation", context,
+                    /*start_timestamp=*/1000);
+
+  SpanRecord span;
+  span.name = "Component::Task";
+  span.start_timestamp = 2500;
+  span.end_timestamp = 4000;
+  thread([&]() { tracer.RecordSpan(span); }).join();
+  EXPECT_SUCCESS(tracer.Stop());
+
+  auto trace = ReadTrace(options);
+  ASSERT_EQ(trace.size(), 2);
+  EXPECT_EQ(trace[0]["name"], "Component::Operation");
+  EXPECT_EQ(trace[0]["ph"], "X");
+  EXPECT_EQ(trace[0]["ts"], 1.0);
+  EXPECT_EQ(trace[0]["args"]["parent_activity_id"],
+            ToString(context.parent_activity_id));
+  EXPECT_EQ(trace[0]["args"]["correlation_id"],
+            ToString(context.correlation_id));
+  EXPECT_EQ(trace[0]["args"]["activity_id"], ToString(Uuid{5, 6}));
+  EXPECT_EQ(trace[0]["args"]["retry_count"], 2);
+
+  EXPECT_EQ(trace[1]["name"], "Component::Task");
+  EXPECT_EQ(trace[1]["ts"], 2.5);
+  EXPECT_EQ(trace[1]["dur"], 1.5);
+  EXPECT_NE(trace[1]["tid"], trace[0]["tid"]);
+  EXPECT_TRUE(trace[1]["args"].empty());
+}
+
+TEST_F(TracerTest, WritesAnEmptyTrace) {
+  auto options = CreateOptions();
+  Tracer tracer(options);
+  EXPECT_SUCCESS(tracer.Init());
+  EXPECT_SUCCESS(tracer.Run());
+  EXPECT_SUCCESS(tracer.Stop());
+  EXPECT_TRUE(ReadTrace(options).empty());
+}
+
+TEST_F(TracerTest, FlushesPeriodically) {
+  auto options = CreateOptions();
+  options.flush_interval = std::chrono::milliseconds(1);
+  options.buffer_capacity_per_thread = 2;
+  Tracer tracer(options);
+  EXPECT_SUCCESS(tracer.Init());
+  EXPECT_SUCCESS(tracer.Run());
+
+  SpanRecord span;
+  span.name = "Component::Task";
+  for (int i = 0; i < 1000; i++) {
+    tracer.RecordSpan(span);
+    std::this_thread::sleep_for(std::chrono::microseconds(50));
+  }
+  EXPECT_SUCCESS(tracer.Stop());
+  EXPECT_EQ(ReadTrace(options).size() + tracer.GetDroppedSpanCount(), 1000);
+  EXPECT_GT(ReadTrace(options).size(), 2);
+}
+
+TEST_F(TracerTest, ReusesTheBuffersOfExitedThreads) {
+  constexpr int kRoundCount = 100;
+  constexpr int kThreadCount = 4;
+  auto options = CreateOptions();
+  Tracer tracer(options);
+  EXPECT_SUCCESS(tracer.Init());
+  EXPECT_SUCCESS(tracer.Run());
+
+  SpanRecord span;
+  span.name = "Component::Task";
+  for (int round = 0; round < kRoundCount; round++) {
+    // The threads of a round record at the same time, so each needs a buffer.
+    atomic<int> recorded_count(0);
+    vector<thread> threads;
+    for (int i = 0; i < kThreadCount; i++) {
+      threads.emplace_back([&]() {
+        tracer.RecordSpan(span);
+        recorded_count++;
+        while (recorded_count < kThreadCount) {
+          std::this_thread::yield();
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  }
+  EXPECT_EQ(tracer.GetThreadBufferCount(), kThreadCount);
+  EXPECT_SUCCESS(tracer.Stop());
+  EXPECT_EQ(ReadTrace(options).size(), kRoundCount * kThreadCount);
+}
+
+TEST_F(TracerTest, SamplesWholeTraces) {
+  auto options = CreateOptions();
+  options.sample_ratio = 0.25;
+  Tracer tracer(options);
+
+  size_t sampled_count = 0;
+  for (int i = 0; i < 10000; i++) {
+    auto correlation_id = Uuid::GenerateUuid();
+    auto is_sampled = tracer.IsSampled(correlation_id);
+    EXPECT_EQ(tracer.IsSampled(correlation_id), is_sampled);
+    sampled_count += is_sampled;
+  }
+  EXPECT_NEAR(sampled_count, 2500, 250);
+
+  sampled_count = 0;
+  for (int i = 0; i < 10000; i++) {
+    sampled_count += tracer.IsSampled(kZeroUuid);
+  }
+  EXPECT_NEAR(sampled_count, 2500, 250);
+}
+
+TEST_F(TracerTest, InvalidOptions) {
+  auto options = CreateOptions();
+  options.sample_ratio = 2;
+  EXPECT_THAT(Tracer(options).Init(),
+              ResultIs(FailureExecutionResult(SC_TRACER_INVALID_OPTIONS)));
+
+  options = CreateOptions();
+  options.output_path = "/nonexistent/directory/trace.json";
+  EXPECT_THAT(
+      Tracer(options).Init(),
+      ResultIs(FailureExecutionResult(SC_TRACER_CANNOT_OPEN_OUTPUT_FILE)));
+}
+
+TEST(GlobalTracerTest, SampledTracerIsTheGlobalOne) {
+  EXPECT_EQ(GetSampledTracer(kZeroUuid), nullptr);
+
+  auto tracer = make_shared<Tracer>(TracerOptions());
+  GlobalTracer::SetGlobalTracer(tracer);
+  EXPECT_EQ(GlobalTracer::GetGlobalTracer(), tracer.get());
+  EXPECT_EQ(GetSampledTracer(kZeroUuid), tracer.get());
+
+  GlobalTracer::ShutdownGlobalTracer();
+  EXPECT_EQ(GetSampledTracer(kZeroUuid), nullptr);
+}
+}  // namespace google::scp::core::common::test
@@ -16,151 +16,221 @@
 
 #include "uuid.h"
 
-#include <cctype>
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <cstdint>
 #include <random>
-#include <sstream>
 #include <string>
+#include <thread>
 
 #include "core/common/time_provider/src/time_provider.h"
 
 #include "error_codes.h"
 
+using std::array;
 using std::atomic;
-using std::isxdigit;
-using std::mt19937;
+using std::memory_order_acquire;
+using std::memory_order_relaxed;
+using std::memory_order_release;
 using std::random_device;
 using std::string;
-using std::uniform_int_distribution;
 
 static constexpr char kHexMap[] = {"0123456789ABCDEF"};
+/// The offsets of the bytes of a Uuid in its guid string, high part first.
+static constexpr int kByteOffsets[] = {0,  2,  4,  6,  9,  11, 14, 16,
+                                       19, 21, 24, 26, 28, 30, 32, 34};
+/// The offsets of the dashes in a guid string.
+static constexpr int kDashOffsets[] = {8, 13, 18, 23};
+/// Set by ReadHexByte for a pair of characters that are not both hex digits.
+static constexpr uint16_t kInvalidHexByte = 0xFF00;
+/// The number of high parts a thread reserves from the shared counter at once.
+static constexpr uint64_t kUuidHighBlockSize = 1024;
+
+namespace {
+/**
+ * @brief The Uuid generation state of a thread: the block of high parts it
+ * reserved, and a xoshiro256** generator for the low parts.
+ */
+struct ThreadUuidGenerator {
+  uint64_t next_high;
+  uint64_t high_block_end;
+  uint64_t random_state[4];
+  bool seeded;
+};
 
-namespace google::scp::core::common {
-Uuid Uuid::GenerateUuid() noexcept {
-  // TODO: Might want to use GetUniqueWallTimestampInNanoseconds()
-  static atomic<Timestamp> current_clock(
-      TimeProvider::GetWallTimestampInNanosecondsAsClockTicks());
-
-  uint64_t high = current_clock.fetch_add(1);
-  static random_device random_device_local;
-  static mt19937 random_generator(random_device_local());
-  uniform_int_distribution<uint64_t> distribution;
+thread_local ThreadUuidGenerator thread_uuid_generator{};
 
-  uint64_t low = distribution(random_generator);
-  return Uuid{.high = high, .low = low};
+/// Reserves the next block of high parts from the counter shared by threads.
+uint64_t ReserveHighBlock() noexcept {
+  // TODO: Might want to use GetUniqueWallTimestampInNanoseconds()
+  static atomic<google::scp::core::Timestamp> current_clock(
+      google::scp::core::common::TimeProvider::
+          GetWallTimestampInNanosecondsAsClockTicks());
+  return current_clock.fetch_add(kUuidHighBlockSize, memory_order_relaxed);
 }
 
-void AppendHex(int byte, std::string& string_to_append) {
-  int first_digit = byte >> 4;
-  string_to_append += kHexMap[first_digit];
-
-  int second_digit = byte & 0x0F;
-  string_to_append += kHexMap[second_digit];
+uint64_t SplitMix64(uint64_t& state) noexcept {
+  uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+  return z ^ (z >> 31);
 }
 
-uint64_t ReadHex(const std::string& string_to_read, int offset) {
-  string digits = string_to_read.substr(offset, 2);
-  std::istringstream istrstream(digits);
-
-  int byte = 0;
-  istrstream >> std::hex >> byte;
-  return byte;
+uint64_t RotateLeft(uint64_t value, int shift) noexcept {
+  return (value << shift) | (value >> (64 - shift));
 }
 
-std::string ToString(const Uuid& uuid) noexcept {
-  // Uuid has two 8 bytes variable, high and low. Printing each byte to a
-  // hexadecimal value a guid can be generated.
-  string uuid_string;
-  uuid_string.reserve(36);
-
-  auto high = uuid.high;
-  auto low = uuid.low;
-
-  // Guid format is 00000000-0000-0000-0000-000000000000
-  // 4 bytes
-  AppendHex((high >> 56) & 0xFF, uuid_string);
-  AppendHex((high >> 48) & 0xFF, uuid_string);
-  AppendHex((high >> 40) & 0xFF, uuid_string);
-  AppendHex((high >> 32) & 0xFF, uuid_string);
+uint64_t NextRandom(ThreadUuidGenerator& generator) noexcept {
+  auto* s = generator.random_state;
+  uint64_t result = RotateLeft(s[1] * 5, 7) * 9;
+  uint64_t t = s[1] << 17;
+  s[2] ^= s[0];
+  s[3] ^= s[1];
+  s[1] ^= s[2];
+  s[0] ^= s[3];
+  s[2] ^= t;
+  s[3] = RotateLeft(s[3], 45);
+  return result;
+}
 
-  uuid_string += "-";
+/**
+ * @brief Seeds the generator of the thread from the OS. The first high block
+ * of the thread is unique to it and is mixed in, so that threads cannot share a
+ * sequence even where random_device is deterministic.
+ */
+void SeedThreadUuidGenerator(ThreadUuidGenerator& generator) noexcept {
+  random_device random_device_local;
+  uint64_t seed = (static_cast<uint64_t>(random_device_local()) << 32) |
+                  random_device_local();
+  seed ^= generator.next_high;
+  for (auto& state : generator.random_state) {
+    state = SplitMix64(seed);
+  }
+  generator.seeded = true;
+}
 
-  // 2 bytes
-  AppendHex((high >> 24) & 0xFF, uuid_string);
-  AppendHex((high >> 16) & 0xFF, uuid_string);
+/// The two hex digits of every byte value.
+constexpr array<array<char, 2>, 256> kHexBytes = []() {
+  array<array<char, 2>, 256> hex_bytes{};
+  for (int i = 0; i < 256; i++) {
+    hex_bytes[i] = {kHexMap[i >> 4], kHexMap[i & 0x0F]};
+  }
+  return hex_bytes;
+}();
+
+/// The values of the hex digit characters, and 0xFF for the others.
+constexpr array<uint8_t, 256> kHexDigitValues = []() {
+  array<uint8_t, 256> hex_digit_values{};
+  for (auto& value : hex_digit_values) {
+    value = 0xFF;
+  }
+  for (int i = 0; i < 16; i++) {
+    hex_digit_values[static_cast<uint8_t>(kHexMap[i])] = i;
+  }
+  return hex_digit_values;
+}();
 
-  uuid_string += "-";
+void WriteHexByte(uint8_t byte, char* output) noexcept {
+  output[0] = kHexBytes[byte][0];
+  output[1] = kHexBytes[byte][1];
+}
 
-  // 2 bytes
-  AppendHex((high >> 8) & 0xFF, uuid_string);
-  AppendHex(high & 0xFF, uuid_string);
+/**
+ * @brief Reads the byte written as two hex digits. The bits of kInvalidHexByte
+ * are set in the output if either character is not a hex digit.
+ */
+uint16_t ReadHexByte(const char* input) noexcept {
+  uint16_t first_digit = kHexDigitValues[static_cast<uint8_t>(input[0])];
+  uint16_t second_digit = kHexDigitValues[static_cast<uint8_t>(input[1])];
+  // An invalid digit is 0xFF, and so sets the upper byte either way.
+  return (first_digit << 4 | second_digit) |
+         ((first_digit | second_digit) & 0xF0) << 8;
+}
+}  // namespace
 
-  uuid_string += "-";
+namespace google::scp::core::common {
+Uuid Uuid::GenerateUuid() noexcept {
+  auto& generator = thread_uuid_generator;
+  if (generator.next_high == generator.high_block_end) {
+    generator.next_high = ReserveHighBlock();
+    generator.high_block_end = generator.next_high + kUuidHighBlockSize;
+  }
+  if (!generator.seeded) {
+    SeedThreadUuidGenerator(generator);
+  }
 
-  // 2 bytes
-  AppendHex((low >> 56) & 0xFF, uuid_string);
-  AppendHex((low >> 48) & 0xFF, uuid_string);
+  uint64_t high = generator.next_high++;
+  uint64_t low = NextRandom(generator);
+  return Uuid{.high = high, .low = low};
+}
 
-  uuid_string += "-";
+void DeferredUuid::Generate() const noexcept {
+  auto expected = State::kDeferred;
+  if (state_.compare_exchange_strong(expected, State::kGenerating,
+                                     memory_order_acquire)) {
+    uuid_ = Uuid::GenerateUuid();
+    state_.store(State::kGenerated, memory_order_release);
+    return;
+  }
+  while (state_.load(memory_order_acquire) != State::kGenerated) {
+    std::this_thread::yield();
+  }
+}
 
-  // 6 bytes
-  AppendHex((low >> 40) & 0xFF, uuid_string);
-  AppendHex((low >> 32) & 0xFF, uuid_string);
-  AppendHex((low >> 24) & 0xFF, uuid_string);
-  AppendHex((low >> 16) & 0xFF, uuid_string);
-  AppendHex((low >> 8) & 0xFF, uuid_string);
-  AppendHex(low & 0xFF, uuid_string);
+std::string ToString(const Uuid& uuid) noexcept {
+  char uuid_string[kUuidStringLength];
+  ToString(uuid, uuid_string);
+  return string(uuid_string, kUuidStringLength);
+}
 
-  return uuid_string;
+void ToString(const Uuid& uuid,
+              char (&uuid_string)[kUuidStringLength]) noexcept {
+  // Uuid has two 8 bytes variable, high and low. Printing each byte to a
+  // hexadecimal value a guid can be generated.
+  // Guid format is 00000000-0000-0000-0000-000000000000
+  for (int i = 0; i < 8; i++) {
+    WriteHexByte(uuid.high >> (56 - 8 * i), &uuid_string[kByteOffsets[i]]);
+    WriteHexByte(uuid.low >> (56 - 8 * i), &uuid_string[kByteOffsets[8 + i]]);
+  }
+  for (auto offset : kDashOffsets) {
+    uuid_string[offset] = '-';
+  }
 }
 
 ExecutionResult FromString(const std::string& uuid_string,
                            Uuid& uuid) noexcept {
-  if (uuid_string.length() != 36) {
-    return FailureExecutionResult(errors::SC_UUID_INVALID_STRING);
-  }
-
-  if (uuid_string[8] != '-' || uuid_string[13] != '-' ||
-      uuid_string[18] != '-' || uuid_string[23] != '-') {
+  if (uuid_string.length() != kUuidStringLength) {
     return FailureExecutionResult(errors::SC_UUID_INVALID_STRING);
   }
+  return FromString(
+      *reinterpret_cast<const char(*)[kUuidStringLength]>(uuid_string.data()),
+      uuid);
+}
 
-  for (size_t i = 0; i < uuid_string.length(); ++i) {
-    if (uuid_string[i] == '-') {
-      continue;
-    }
-
-    if (!isxdigit(uuid_string[i])) {
-      return FailureExecutionResult(errors::SC_UUID_INVALID_STRING);
-    }
-
-    if (islower(uuid_string[i])) {
+ExecutionResult FromString(const char (&uuid_string)[kUuidStringLength],
+                           Uuid& uuid) noexcept {
+  for (auto offset : kDashOffsets) {
+    if (uuid_string[offset] != '-') {
       return FailureExecutionResult(errors::SC_UUID_INVALID_STRING);
     }
   }
 
-  uuid.high |= (ReadHex(uuid_string, 0) << 56);
-  uuid.high |= (ReadHex(uuid_string, 2) << 48);
-  uuid.high |= (ReadHex(uuid_string, 4) << 40);
-  uuid.high |= (ReadHex(uuid_string, 6) << 32);
-
-  uuid.high |= (ReadHex(uuid_string, 9) << 24);
-  uuid.high |= (ReadHex(uuid_string, 11) << 16);
-
-  uuid.high |= (ReadHex(uuid_string, 14) << 8);
-  uuid.high |= (ReadHex(uuid_string, 16));
-
-  uuid.low |= (ReadHex(uuid_string, 19) << 56);
-  uuid.low |= (ReadHex(uuid_string, 21) << 48);
-
-  uuid.low |= (ReadHex(uuid_string, 24) << 40);
-  uuid.low |= (ReadHex(uuid_string, 26) << 32);
-  uuid.low |= (ReadHex(uuid_string, 28) << 24);
-  uuid.low |= (ReadHex(uuid_string, 30) << 16);
-  uuid.low |= (ReadHex(uuid_string, 32) << 8);
-  uuid.low |= (ReadHex(uuid_string, 34));
+  uint64_t high = 0;
+  uint64_t low = 0;
+  uint16_t digits = 0;
+  for (int i = 0; i < 8; i++) {
+    uint16_t high_byte = ReadHexByte(&uuid_string[kByteOffsets[i]]);
+    uint16_t low_byte = ReadHexByte(&uuid_string[kByteOffsets[8 + i]]);
+    high = (high << 8) | (high_byte & 0xFF);
+    low = (low << 8) | (low_byte & 0xFF);
+    digits |= high_byte | low_byte;
+  }
+  if ((digits & kInvalidHexByte) != 0) {
+    return FailureExecutionResult(errors::SC_UUID_INVALID_STRING);
+  }
 
+  uuid = Uuid{.high = high, .low = low};
   return SuccessExecutionResult();
 }
 }  // namespace google::scp::core::common
@@ -16,6 +16,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <string>
@@ -42,10 +43,65 @@ struct Uuid {
 
   bool operator<(const Uuid& other) const { return high < other.high; }
 
-  /// Generates a random Uuid.
+  /**
+   * @brief Generates a random Uuid. The high part is taken from a counter that
+   * starts at the wall clock time, in blocks reserved by each thread, and the
+   * low part is drawn from a generator of the calling thread.
+   */
   static Uuid GenerateUuid() noexcept;
 };
 
+/**
+ * @brief A Uuid that is generated on its first read rather than on
+ * construction, for ids that are often never read. Copying reads the source,
+ * so that the copies hold the same value. Concurrent reads are safe, but writes
+ * must not race with other accesses.
+ */
+class DeferredUuid {
+ public:
+  DeferredUuid() noexcept : state_(State::kDeferred) {}
+
+  DeferredUuid(const Uuid& uuid) noexcept
+      : state_(State::kGenerated), uuid_(uuid) {}
+
+  DeferredUuid(const DeferredUuid& other) noexcept
+      : DeferredUuid(other.Get()) {}
+
+  DeferredUuid& operator=(const DeferredUuid& other) noexcept {
+    return operator=(other.Get());
+  }
+
+  DeferredUuid& operator=(const Uuid& uuid) noexcept {
+    uuid_ = uuid;
+    state_.store(State::kGenerated, std::memory_order_release);
+    return *this;
+  }
+
+  /// Returns the Uuid, generating it if this is the first read.
+  const Uuid& Get() const noexcept {
+    if (state_.load(std::memory_order_acquire) != State::kGenerated) {
+      Generate();
+    }
+    return uuid_;
+  }
+
+  operator const Uuid&() const noexcept { return Get(); }
+
+  /// Returns true if the Uuid was generated or assigned.
+  bool IsGenerated() const noexcept {
+    return state_.load(std::memory_order_acquire) == State::kGenerated;
+  }
+
+ private:
+  enum class State : uint8_t { kDeferred, kGenerating, kGenerated };
+
+  /// Generates the Uuid, or waits for the reader that is generating it.
+  void Generate() const noexcept;
+
+  mutable std::atomic<State> state_;
+  mutable Uuid uuid_;
+};
+
 /**
  * @brief A Uuid comparator that can be used for maps and sets.
  */
@@ -67,6 +123,9 @@ struct UuidHash {
   }
 };
 
+/// The length of the guid string of a Uuid, without a terminator.
+static constexpr size_t kUuidStringLength = 36;
+
 /**
  * @brief Converts a Uuid object to string. The format of the output is a guid
  * 00000000-0000-0000-0000-000000000000.
@@ -76,6 +135,16 @@ struct UuidHash {
  */
 std::string ToString(const Uuid& uuid) noexcept;
 
+/**
+ * @brief Writes the guid string of a Uuid to a buffer of the caller, without
+ * allocating. The output is not null terminated.
+ *
+ * @param uuid The uuid to be converted to guid string.
+ * @param uuid_string The output guid.
+ */
+void ToString(const Uuid& uuid,
+              char (&uuid_string)[kUuidStringLength]) noexcept;
+
 /**
  * @brief Parses a Uuid object from a provided string.
  *
@@ -85,5 +154,17 @@ std::string ToString(const Uuid& uuid) noexcept;
  */
 ExecutionResult FromString(const std::string& uuid_string, Uuid& uuid) noexcept;
 
+/**
+ * @brief Parses a Uuid object from a guid string that is not null terminated,
+ * without allocating. Only uppercase hex digits are accepted, as ToString
+ * writes them. The output uuid is left unchanged on failure.
+ *
+ * @param uuid_string The string to parse the uuid from.
+ * @param uuid The output uuid.
+ * @return ExecutionResult The execution result of the operation.
+ */
+ExecutionResult FromString(const char (&uuid_string)[kUuidStringLength],
+                           Uuid& uuid) noexcept;
+
 static constexpr Uuid kZeroUuid{0ULL, 0ULL};
 }  // namespace google::scp::core::common
@@ -0,0 +1,113 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "core/common/uuid/src/uuid.h"
+#include "core/interface/async_context.h"
+
+using google::scp::core::AsyncContext;
+using google::scp::core::common::Uuid;
+using std::make_shared;
+using std::string;
+
+namespace google::scp::core::common::test {
+static void BM_GenerateUuid(benchmark::State& state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(Uuid::GenerateUuid());
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+static void BM_UuidToString(benchmark::State& state) {
+  auto uuid = Uuid::GenerateUuid();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ToString(uuid));
+  }
+}
+
+static void BM_UuidToStringBuffer(benchmark::State& state) {
+  auto uuid = Uuid::GenerateUuid();
+  char uuid_string[kUuidStringLength];
+  for (auto _ : state) {
+    ToString(uuid, uuid_string);
+    benchmark::DoNotOptimize(uuid_string);
+  }
+}
+
+static void BM_UuidFromString(benchmark::State& state) {
+  auto uuid_string = ToString(Uuid::GenerateUuid());
+  Uuid uuid;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(FromString(uuid_string, uuid));
+  }
+}
+
+static void BM_UuidFromStringBuffer(benchmark::State& state) {
+  char uuid_string[kUuidStringLength];
+  ToString(Uuid::GenerateUuid(), uuid_string);
+  Uuid uuid;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(FromString(uuid_string, uuid));
+  }
+}
+
+/// Constructs contexts whose activity ids are never read.
+static void BM_CreateAsyncContext(benchmark::State& state) {
+  auto request = make_shared<int>(0);
+  for (auto _ : state) {
+    AsyncContext<int, int> context(request, [](AsyncContext<int, int>&) {});
+    benchmark::DoNotOptimize(context);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+/// Constructs contexts and reads their activity ids.
+static void BM_CreateAsyncContextAndReadActivityId(benchmark::State& state) {
+  auto request = make_shared<int>(0);
+  for (auto _ : state) {
+    AsyncContext<int, int> context(request, [](AsyncContext<int, int>&) {});
+    const Uuid& activity_id = context.activity_id;
+    benchmark::DoNotOptimize(activity_id);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+}  // namespace google::scp::core::common::test
+
+BENCHMARK(google::scp::core::common::test::BM_GenerateUuid)
+    ->Threads(1)
+    ->Threads(4)
+    ->Threads(16)
+    ->UseRealTime();
+BENCHMARK(google::scp::core::common::test::BM_UuidToString);
+BENCHMARK(google::scp::core::common::test::BM_UuidToStringBuffer);
+BENCHMARK(google::scp::core::common::test::BM_UuidFromString);
+BENCHMARK(google::scp::core::common::test::BM_UuidFromStringBuffer);
+BENCHMARK(google::scp::core::common::test::BM_CreateAsyncContext)
+    ->Threads(1)
+    ->Threads(4)
+    ->UseRealTime();
+BENCHMARK(
+    google::scp::core::common::test::BM_CreateAsyncContextAndReadActivityId)
+    ->Threads(1)
+    ->Threads(4)
+    ->UseRealTime();
+
+// Run the benchmark
+BENCHMARK_MAIN();
@@ -18,13 +18,22 @@
 
 #include <gtest/gtest.h>
 
+#include <cstring>
+#include <random>
 #include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
 
 #include "core/common/uuid/src/error_codes.h"
 #include "public/core/test/interface/execution_result_matchers.h"
 
 using google::scp::core::test::ResultIs;
+using std::mt19937_64;
 using std::string;
+using std::thread;
+using std::unordered_set;
+using std::vector;
 
 namespace google::scp::core::common::test {
 TEST(UuidTests, UuidGeneration) {
@@ -34,6 +43,81 @@ TEST(UuidTests, UuidGeneration) {
   EXPECT_NE(uuid.low, 0);
 }
 
+TEST(UuidTests, UuidsAreUniqueAcrossThreads) {
+  constexpr int kThreadCount = 8;
+  constexpr int kUuidsPerThread = 100000;
+  vector<vector<Uuid>> uuids(kThreadCount);
+  vector<thread> threads;
+  for (int i = 0; i < kThreadCount; i++) {
+    threads.push_back(thread([&uuids, i]() {
+      uuids[i].reserve(kUuidsPerThread);
+      for (int j = 0; j < kUuidsPerThread; j++) {
+        uuids[i].push_back(Uuid::GenerateUuid());
+      }
+    }));
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  unordered_set<Uuid, UuidHash> unique_uuids;
+  unordered_set<uint64_t> unique_lows;
+  for (const auto& thread_uuids : uuids) {
+    for (const auto& uuid : thread_uuids) {
+      EXPECT_TRUE(unique_uuids.insert(uuid).second);
+      unique_lows.insert(uuid.low);
+    }
+  }
+  EXPECT_EQ(unique_uuids.size(), kThreadCount * kUuidsPerThread);
+  // The threads do not share a random sequence either.
+  EXPECT_EQ(unique_lows.size(), kThreadCount * kUuidsPerThread);
+}
+
+TEST(UuidTests, DeferredUuidIsGeneratedOnFirstRead) {
+  DeferredUuid deferred_uuid;
+  EXPECT_FALSE(deferred_uuid.IsGenerated());
+
+  Uuid uuid = deferred_uuid;
+  EXPECT_TRUE(deferred_uuid.IsGenerated());
+  EXPECT_NE(uuid, kZeroUuid);
+  EXPECT_EQ(deferred_uuid.Get(), uuid);
+
+  Uuid assigned_uuid = Uuid::GenerateUuid();
+  deferred_uuid = assigned_uuid;
+  EXPECT_EQ(deferred_uuid.Get(), assigned_uuid);
+}
+
+TEST(UuidTests, DeferredUuidCopiesShareValue) {
+  DeferredUuid deferred_uuid;
+  DeferredUuid copy = deferred_uuid;
+  EXPECT_TRUE(deferred_uuid.IsGenerated());
+  EXPECT_EQ(copy.Get(), deferred_uuid.Get());
+
+  DeferredUuid assigned;
+  DeferredUuid other;
+  assigned = other;
+  EXPECT_EQ(assigned.Get(), other.Get());
+}
+
+TEST(UuidTests, DeferredUuidConcurrentFirstReads) {
+  constexpr int kThreadCount = 8;
+  for (int round = 0; round < 100; round++) {
+    DeferredUuid deferred_uuid;
+    vector<Uuid> reads(kThreadCount);
+    vector<thread> threads;
+    for (int i = 0; i < kThreadCount; i++) {
+      threads.push_back(thread(
+          [&deferred_uuid, &reads, i]() { reads[i] = deferred_uuid.Get(); }));
+    }
+    for (auto& t : threads) {
+      t.join();
+    }
+    for (const auto& read : reads) {
+      EXPECT_EQ(read, reads[0]);
+    }
+  }
+}
+
 TEST(UuidTests, UuidToString) {
   Uuid uuid = Uuid::GenerateUuid();
 
@@ -43,6 +127,68 @@ TEST(UuidTests, UuidToString) {
   EXPECT_EQ(parsed_uuid, uuid);
 }
 
+TEST(UuidTests, UuidToStringBuffer) {
+  Uuid uuid{.high = 0x0123456789ABCDEF, .low = 0xFEDCBA9876543210};
+
+  char uuid_string[kUuidStringLength];
+  ToString(uuid, uuid_string);
+  EXPECT_EQ(string(uuid_string, kUuidStringLength),
+            "01234567-89AB-CDEF-FEDC-BA9876543210");
+  EXPECT_EQ(ToString(uuid), "01234567-89AB-CDEF-FEDC-BA9876543210");
+
+  Uuid parsed_uuid = Uuid::GenerateUuid();
+  EXPECT_SUCCESS(FromString(uuid_string, parsed_uuid));
+  EXPECT_EQ(parsed_uuid, uuid);
+}
+
+TEST(UuidTests, RandomUuidsRoundTrip) {
+  mt19937_64 random_generator;
+  for (int i = 0; i < 100000; i++) {
+    Uuid uuid{.high = random_generator(), .low = random_generator()};
+    char uuid_string[kUuidStringLength];
+    ToString(uuid, uuid_string);
+    EXPECT_EQ(ToString(uuid), string(uuid_string, kUuidStringLength));
+
+    Uuid parsed_uuid;
+    EXPECT_SUCCESS(FromString(uuid_string, parsed_uuid));
+    EXPECT_EQ(parsed_uuid, uuid);
+  }
+}
+
+TEST(UuidTests, MutatedUuidStrings) {
+  mt19937_64 random_generator;
+  auto uuid = Uuid::GenerateUuid();
+  char valid_uuid_string[kUuidStringLength];
+  ToString(uuid, valid_uuid_string);
+
+  for (int i = 0; i < 100000; i++) {
+    char uuid_string[kUuidStringLength];
+    memcpy(uuid_string, valid_uuid_string, kUuidStringLength);
+    auto position = random_generator() % kUuidStringLength;
+    char character = static_cast<char>(random_generator());
+    uuid_string[position] = character;
+
+    bool is_dash_position =
+        position == 8 || position == 13 || position == 18 || position == 23;
+    bool is_valid = is_dash_position
+                        ? character == '-'
+                        : (character >= '0' && character <= '9') ||
+                              (character >= 'A' && character <= 'F');
+    Uuid parsed_uuid = kZeroUuid;
+    auto result = FromString(uuid_string, parsed_uuid);
+    EXPECT_EQ(result.Successful(), is_valid) << position << " " << character;
+    if (is_valid) {
+      // The string wrapper agrees.
+      Uuid other_parsed_uuid;
+      EXPECT_SUCCESS(FromString(string(uuid_string, kUuidStringLength),
+                                other_parsed_uuid));
+      EXPECT_EQ(other_parsed_uuid, parsed_uuid);
+    } else {
+      EXPECT_EQ(parsed_uuid, kZeroUuid);
+    }
+  }
+}
+
 TEST(UuidTests, InvalidUuidString) {
   string uuid_string = "123";
   Uuid parsed_uuid;
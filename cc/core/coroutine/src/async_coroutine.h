@@ -0,0 +1,182 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+#include "core/interface/async_context.h"
+#include "core/interface/async_executor_interface.h"
+#include "public/core/interface/execution_result.h"
+
+namespace google::scp::core {
+/**
+ * @brief The return type of a coroutine that starts right away and frees its
+ * frame when it returns. Nothing waits on it, so the coroutine reports its
+ * outcome the way a callback chain does, e.g. by finishing the context it
+ * was handed.
+ *
+ * The frame is the only allocation of the coroutine. The state that a
+ * callback chain copies into a std::function at every hop stays in the frame.
+ */
+struct DetachedCoroutine {
+  struct promise_type {
+    DetachedCoroutine get_return_object() noexcept { return {}; }
+
+    std::suspend_never initial_suspend() noexcept { return {}; }
+
+    std::suspend_never final_suspend() noexcept { return {}; }
+
+    void return_void() noexcept {}
+
+    void unhandled_exception() noexcept { std::terminate(); }
+  };
+};
+
+/**
+ * @brief Awaits an async operation that takes an AsyncContext. Replaces the
+ * callback of the context, starts the operation, and resumes the coroutine
+ * once the operation finishes the context, on the thread that finishes it.
+ * Returns the result of the context, and leaves the response in the context.
+ *
+ * The callback only captures the awaitable, so it fits in the inline storage
+ * of std::function and copying the context does not allocate.
+ *
+ * An operation that returns a failure must either have finished the context
+ * before returning or never finish it.
+ *
+ * @tparam TRequest request template param
+ * @tparam TResponse response template param
+ * @tparam TOperation callable that takes the context and returns an
+ * ExecutionResult.
+ */
+template <typename TRequest, typename TResponse, typename TOperation>
+class AsyncContextAwaitable {
+ public:
+  AsyncContextAwaitable(AsyncContext<TRequest, TResponse>& context,
+                        TOperation operation)
+      : context_(context),
+        operation_(std::move(operation)),
+        is_finished_or_suspended_(false) {}
+
+  bool await_ready() const noexcept { return false; }
+
+  bool await_suspend(std::coroutine_handle<> handle) noexcept {
+    handle_ = handle;
+    context_.callback =
+        [this](AsyncContext<TRequest, TResponse>& finished_context) {
+          context_.result = finished_context.result;
+          context_.response = finished_context.response;
+          // The second of the callback and await_suspend resumes.
+          if (is_finished_or_suspended_.exchange(true,
+                                                 std::memory_order_acq_rel)) {
+            handle_.resume();
+          }
+        };
+
+    auto execution_result = operation_(context_);
+    if (!execution_result.Successful()) {
+      if (!is_finished_or_suspended_.exchange(true,
+                                              std::memory_order_acq_rel)) {
+        context_.result = execution_result;
+      }
+      return false;
+    }
+    // Once the exchange is done, the coroutine can be resumed and this
+    // awaitable destroyed by the callback on another thread.
+    return !is_finished_or_suspended_.exchange(true,
+                                               std::memory_order_acq_rel);
+  }
+
+  ExecutionResult await_resume() const noexcept { return context_.result; }
+
+ private:
+  /// The context of the awaited operation.
+  AsyncContext<TRequest, TResponse>& context_;
+  /// Starts the awaited operation.
+  TOperation operation_;
+  /// The suspended coroutine.
+  std::coroutine_handle<> handle_;
+  /// Set by the first of the callback and await_suspend.
+  std::atomic<bool> is_finished_or_suspended_;
+};
+
+/**
+ * @brief Returns an awaitable that starts the operation with the context, see
+ * AsyncContextAwaitable. For example:
+ *
+ *   auto result = co_await AwaitContext(
+ *       fetch_context, [&](auto& context) {
+ *         return fetcher->FetchPrivateKey(context);
+ *       });
+ */
+template <typename TRequest, typename TResponse, typename TOperation>
+AsyncContextAwaitable<TRequest, TResponse, TOperation> AwaitContext(
+    AsyncContext<TRequest, TResponse>& context, TOperation operation) {
+  return AsyncContextAwaitable<TRequest, TResponse, TOperation>(
+      context, std::move(operation));
+}
+
+/**
+ * @brief Moves the coroutine onto a thread of an async executor. The scheduled
+ * work only captures the coroutine handle, so it fits in the inline storage of
+ * std::function. If the executor rejects the work, the coroutine keeps
+ * running on the current thread and the failure is returned.
+ */
+class ExecutorAwaitable {
+ public:
+  ExecutorAwaitable(AsyncExecutorInterface& async_executor,
+                    AsyncPriority priority)
+      : async_executor_(async_executor),
+        priority_(priority),
+        schedule_result_(SuccessExecutionResult()) {}
+
+  bool await_ready() const noexcept { return false; }
+
+  bool await_suspend(std::coroutine_handle<> handle) noexcept {
+    auto execution_result = async_executor_.Schedule(
+        [handle]() mutable { handle.resume(); }, priority_);
+    // The coroutine may already be running on the executor, so this awaitable
+    // is only touched if the work was rejected.
+    if (execution_result.Successful()) {
+      return true;
+    }
+    schedule_result_ = execution_result;
+    return false;
+  }
+
+  ExecutionResult await_resume() const noexcept { return schedule_result_; }
+
+ private:
+  AsyncExecutorInterface& async_executor_;
+  AsyncPriority priority_;
+  ExecutionResult schedule_result_;
+};
+
+/**
+ * @brief Returns an awaitable that resumes the coroutine on the executor with
+ * the priority, see ExecutorAwaitable. For example:
+ *
+ *   co_await ResumeOn(*async_executor, AsyncPriority::High);
+ */
+inline ExecutorAwaitable ResumeOn(AsyncExecutorInterface& async_executor,
+                                  AsyncPriority priority) {
+  return ExecutorAwaitable(async_executor, priority);
+}
+}  // namespace google::scp::core
@@ -0,0 +1,196 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <cstdlib>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <new>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "core/async_executor/mock/mock_async_executor.h"
+#include "core/coroutine/src/async_coroutine.h"
+#include "core/interface/async_context.h"
+#include "public/core/interface/execution_result.h"
+
+using google::scp::core::AsyncContext;
+using google::scp::core::AsyncExecutorInterface;
+using google::scp::core::AsyncOperation;
+using google::scp::core::AsyncPriority;
+using google::scp::core::AwaitContext;
+using google::scp::core::DetachedCoroutine;
+using google::scp::core::ExecutionResult;
+using google::scp::core::FinishContext;
+using google::scp::core::ResumeOn;
+using google::scp::core::SuccessExecutionResult;
+using google::scp::core::async_executor::mock::MockAsyncExecutor;
+using std::atomic;
+using std::bind;
+using std::deque;
+using std::make_shared;
+using std::memory_order_relaxed;
+using std::shared_ptr;
+using std::string;
+using std::placeholders::_1;
+
+/// Counts the heap allocations done by the process.
+static atomic<size_t> allocation_count(0);
+
+void* operator new(size_t size) {
+  allocation_count.fetch_add(1, memory_order_relaxed);
+  if (auto* ptr = std::malloc(size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+namespace google::scp::core::test {
+using StringContext = AsyncContext<string, string>;
+
+/**
+ * @brief A fetch followed by a decrypt, with a hop onto the executor after
+ * each, the way PrivateKeyClientProvider chains them. The operations complete
+ * inline, and the executor queues the work until Drain runs it.
+ */
+class Chain {
+ public:
+  Chain() {
+    async_executor_ = make_shared<MockAsyncExecutor>();
+    async_executor_->schedule_mock = [this](const AsyncOperation& work) {
+      scheduled_work_.push_back(work);
+      return SuccessExecutionResult();
+    };
+  }
+
+  /// Completes the context inline with the request as the response.
+  static ExecutionResult Operate(StringContext& context) {
+    context.response = context.request;
+    context.result = SuccessExecutionResult();
+    context.Finish();
+    return SuccessExecutionResult();
+  }
+
+  /// Runs the scheduled work until there is none.
+  void Drain() {
+    while (!scheduled_work_.empty()) {
+      auto work = std::move(scheduled_work_.front());
+      scheduled_work_.pop_front();
+      work();
+    }
+  }
+
+  /// Runs the chain with callbacks bound to copies of the contexts.
+  void RunWithCallbacks(StringContext& request_context) {
+    StringContext fetch_context(request_context.request,
+                                bind(&Chain::OnFetched, this, request_context,
+                                     _1),
+                                request_context);
+    Operate(fetch_context);
+  }
+
+  void OnFetched(StringContext& request_context,
+                 StringContext& fetch_context) {
+    async_executor_->Schedule(
+        [this, request_context, fetch_context]() mutable {
+          StringContext decrypt_context(
+              fetch_context.response,
+              bind(&Chain::OnDecrypted, this, request_context, _1),
+              request_context);
+          Operate(decrypt_context);
+        },
+        AsyncPriority::High);
+  }
+
+  void OnDecrypted(StringContext& request_context,
+                   StringContext& decrypt_context) {
+    request_context.response = decrypt_context.response;
+    FinishContext(decrypt_context.result, request_context, async_executor_);
+  }
+
+  /// Runs the chain as a coroutine.
+  DetachedCoroutine RunAsCoroutine(StringContext request_context) {
+    StringContext fetch_context;
+    fetch_context.request = request_context.request;
+    auto result = co_await AwaitContext(fetch_context, &Chain::Operate);
+    co_await ResumeOn(*async_executor_, AsyncPriority::High);
+
+    StringContext decrypt_context;
+    decrypt_context.request = fetch_context.response;
+    result = co_await AwaitContext(decrypt_context, &Chain::Operate);
+    co_await ResumeOn(*async_executor_, AsyncPriority::High);
+
+    request_context.response = decrypt_context.response;
+    request_context.result = result;
+    request_context.Finish();
+  }
+
+ private:
+  shared_ptr<MockAsyncExecutor> async_executor_;
+  deque<AsyncOperation> scheduled_work_;
+};
+
+template <typename TRun>
+void BenchmarkChain(benchmark::State& state, TRun run) {
+  Chain chain;
+  size_t finished_count = 0;
+  StringContext request_context(
+      make_shared<string>("request"),
+      [&](StringContext& context) {
+        finished_count += context.result.Successful() ? 1 : 0;
+      });
+  // Warms up the queue of the executor.
+  run(chain, request_context);
+  chain.Drain();
+
+  size_t allocations = 0;
+  for (auto _ : state) {
+    auto start_allocation_count = allocation_count.load();
+    run(chain, request_context);
+    chain.Drain();
+    allocations += allocation_count.load() - start_allocation_count;
+  }
+  state.counters["allocations_per_request"] =
+      static_cast<double>(allocations) / state.iterations();
+  if (finished_count != state.iterations() + 1) {
+    state.SkipWithError("Not every request finished.");
+  }
+}
+
+static void BM_CallbackChain(benchmark::State& state) {
+  BenchmarkChain(state, [](Chain& chain, StringContext& request_context) {
+    chain.RunWithCallbacks(request_context);
+  });
+}
+
+static void BM_CoroutineChain(benchmark::State& state) {
+  BenchmarkChain(state, [](Chain& chain, StringContext& request_context) {
+    chain.RunAsCoroutine(request_context);
+  });
+}
+}  // namespace google::scp::core::test
+
+BENCHMARK(google::scp::core::test::BM_CallbackChain);
+BENCHMARK(google::scp::core::test::BM_CoroutineChain);
+
+// Run the benchmark
+BENCHMARK_MAIN();
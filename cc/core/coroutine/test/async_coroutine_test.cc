@@ -0,0 +1,190 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/coroutine/src/async_coroutine.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "core/async_executor/mock/mock_async_executor.h"
+#include "core/async_executor/src/async_executor.h"
+#include "core/interface/async_context.h"
+#include "core/test/utils/conditional_wait.h"
+#include "public/core/test/interface/execution_result_matchers.h"
+
+using google::scp::core::async_executor::mock::MockAsyncExecutor;
+using std::atomic;
+using std::make_shared;
+using std::shared_ptr;
+using std::string;
+using std::vector;
+
+namespace google::scp::core::test {
+using StringContext = AsyncContext<string, string>;
+
+/// Awaits the operation, and records the result and the response.
+template <typename TOperation>
+DetachedCoroutine AwaitOperation(TOperation operation, ExecutionResult& result,
+                                 string& response, bool& done) {
+  StringContext context;
+  context.request = make_shared<string>("request");
+  result = co_await AwaitContext(context, operation);
+  if (context.response) {
+    response = *context.response;
+  }
+  done = true;
+}
+
+TEST(AsyncCoroutineTest, AwaitContextResumesWhenTheContextIsFinished) {
+  vector<StringContext> started_contexts;
+  auto operation = [&](StringContext& context) {
+    started_contexts.push_back(context);
+    return SuccessExecutionResult();
+  };
+  ExecutionResult result;
+  string response;
+  bool done = false;
+  AwaitOperation(operation, result, response, done);
+  ASSERT_EQ(started_contexts.size(), 1);
+  EXPECT_EQ(*started_contexts[0].request, "request");
+  EXPECT_FALSE(done);
+
+  // The operation finishes a copy of the context.
+  started_contexts[0].response = make_shared<string>("response");
+  started_contexts[0].result = SuccessExecutionResult();
+  started_contexts[0].Finish();
+  EXPECT_TRUE(done);
+  EXPECT_SUCCESS(result);
+  EXPECT_EQ(response, "response");
+}
+
+TEST(AsyncCoroutineTest, AwaitContextFinishedBeforeTheOperationReturns) {
+  auto operation = [](StringContext& context) {
+    context.response = make_shared<string>("response");
+    context.result = SuccessExecutionResult();
+    context.Finish();
+    return SuccessExecutionResult();
+  };
+  ExecutionResult result;
+  string response;
+  bool done = false;
+  AwaitOperation(operation, result, response, done);
+  EXPECT_TRUE(done);
+  EXPECT_SUCCESS(result);
+  EXPECT_EQ(response, "response");
+}
+
+TEST(AsyncCoroutineTest, AwaitContextOperationFails) {
+  auto operation = [](StringContext&) {
+    return FailureExecutionResult(SC_UNKNOWN);
+  };
+  ExecutionResult result;
+  string response;
+  bool done = false;
+  AwaitOperation(operation, result, response, done);
+  EXPECT_TRUE(done);
+  EXPECT_THAT(result, ResultIs(FailureExecutionResult(SC_UNKNOWN)));
+  EXPECT_EQ(response, "");
+}
+
+TEST(AsyncCoroutineTest, AwaitContextOperationFinishesAndFails) {
+  auto operation = [](StringContext& context) {
+    context.result = FailureExecutionResult(SC_UNKNOWN);
+    context.Finish();
+    return FailureExecutionResult(SC_UNKNOWN);
+  };
+  ExecutionResult result;
+  string response;
+  bool done = false;
+  AwaitOperation(operation, result, response, done);
+  EXPECT_TRUE(done);
+  EXPECT_THAT(result, ResultIs(FailureExecutionResult(SC_UNKNOWN)));
+}
+
+/// Resumes on the executor twice, and records the results.
+DetachedCoroutine HopTwice(AsyncExecutorInterface& async_executor,
+                           vector<ExecutionResult>& results, bool& done) {
+  results.push_back(co_await ResumeOn(async_executor, AsyncPriority::Normal));
+  results.push_back(co_await ResumeOn(async_executor, AsyncPriority::High));
+  done = true;
+}
+
+TEST(AsyncCoroutineTest, ResumeOnSchedulesTheContinuation) {
+  MockAsyncExecutor async_executor;
+  vector<AsyncOperation> scheduled_work;
+  async_executor.schedule_mock = [&](const AsyncOperation& work) {
+    scheduled_work.push_back(work);
+    return SuccessExecutionResult();
+  };
+  vector<ExecutionResult> results;
+  bool done = false;
+  HopTwice(async_executor, results, done);
+  ASSERT_EQ(scheduled_work.size(), 1);
+  EXPECT_TRUE(results.empty());
+
+  scheduled_work[0]();
+  ASSERT_EQ(scheduled_work.size(), 2);
+  EXPECT_EQ(results.size(), 1);
+  EXPECT_FALSE(done);
+
+  scheduled_work[1]();
+  EXPECT_TRUE(done);
+  ASSERT_EQ(results.size(), 2);
+  EXPECT_SUCCESS(results[0]);
+  EXPECT_SUCCESS(results[1]);
+}
+
+TEST(AsyncCoroutineTest, ResumeOnContinuesInlineIfRejected) {
+  MockAsyncExecutor async_executor;
+  async_executor.schedule_mock = [](const AsyncOperation&) {
+    return RetryExecutionResult(SC_UNKNOWN);
+  };
+  vector<ExecutionResult> results;
+  bool done = false;
+  HopTwice(async_executor, results, done);
+  EXPECT_TRUE(done);
+  ASSERT_EQ(results.size(), 2);
+  EXPECT_THAT(results[0], ResultIs(RetryExecutionResult(SC_UNKNOWN)));
+  EXPECT_THAT(results[1], ResultIs(RetryExecutionResult(SC_UNKNOWN)));
+}
+
+/// Records the thread the coroutine resumes on.
+DetachedCoroutine RecordResumingThread(AsyncExecutorInterface& async_executor,
+                                       std::thread::id& thread_id,
+                                       atomic<bool>& done) {
+  co_await ResumeOn(async_executor, AsyncPriority::Normal);
+  thread_id = std::this_thread::get_id();
+  done = true;
+}
+
+TEST(AsyncCoroutineTest, ResumeOnRunsOnTheExecutorThread) {
+  AsyncExecutor async_executor(1, 10);
+  EXPECT_SUCCESS(async_executor.Init());
+  EXPECT_SUCCESS(async_executor.Run());
+
+  std::thread::id thread_id;
+  atomic<bool> done(false);
+  RecordResumingThread(async_executor, thread_id, done);
+  WaitUntil([&]() { return done.load(); });
+  EXPECT_NE(thread_id, std::this_thread::get_id());
+  EXPECT_SUCCESS(async_executor.Stop());
+}
+}  // namespace google::scp::core::test
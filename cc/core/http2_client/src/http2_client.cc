@@ -18,9 +18,15 @@
 
 #include <memory>
 
+#include "core/common/time_provider/src/time_provider.h"
+#include "core/common/tracing/src/global_tracer.h"
+
+using google::scp::core::common::GetSampledTracer;
 using google::scp::core::common::kZeroUuid;
+using google::scp::core::common::RecordContextSpan;
 using google::scp::core::common::RetryStrategy;
 using google::scp::core::common::RetryStrategyType;
+using google::scp::core::common::TimeProvider;
 using std::make_unique;
 using std::shared_ptr;
 
@@ -49,6 +55,18 @@ ExecutionResult HttpClient::Stop() noexcept {
 
 ExecutionResult HttpClient::PerformRequest(
     AsyncContext<HttpRequest, HttpResponse>& http_context) noexcept {
+  if (auto* tracer = GetSampledTracer(http_context.correlation_id)) {
+    auto start_timestamp =
+        TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks();
+    http_context.callback =
+        [tracer, start_timestamp, callback = http_context.callback](
+            AsyncContext<HttpRequest, HttpResponse>& http_context) {
+          RecordContextSpan(*tracer, "HttpClient::PerformRequest",
+                            http_context, start_timestamp);
+          callback(http_context);
+        };
+  }
+
   operation_dispatcher_.Dispatch<AsyncContext<HttpRequest, HttpResponse>>(
       http_context,
       [this](AsyncContext<HttpRequest, HttpResponse>& http_context) mutable {
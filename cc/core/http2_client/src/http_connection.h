@@ -25,7 +25,7 @@
 #include "cc/core/interface/async_context.h"
 #include "cc/core/interface/async_executor_interface.h"
 #include "cc/core/interface/http_client_interface.h"
-#include "core/common/concurrent_map/src/concurrent_map.h"
+#include "core/common/concurrent_map/src/sharded_concurrent_map.h"
 #include "public/core/interface/execution_result.h"
 
 #include "error_codes.h"
@@ -185,8 +185,10 @@ class HttpConnection : public ServiceInterface {
   std::atomic<bool> is_ready_;
   /// Indicates if the connection is dropped.
   std::atomic<bool> is_dropped_;
-  common::ConcurrentMap<common::Uuid, AsyncContext<HttpRequest, HttpResponse>,
-                        common::UuidCompare>
+  /// The contexts of the requests that are waiting for a response.
+  common::ShardedConcurrentMap<common::Uuid,
+                               AsyncContext<HttpRequest, HttpResponse>,
+                               common::UuidCompare>
       pending_network_calls_;
 };
 }  // namespace google::scp::core
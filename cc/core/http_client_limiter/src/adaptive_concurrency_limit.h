@@ -0,0 +1,163 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+#include "core/interface/type_def.h"
+
+namespace google::scp::core {
+/// AdaptiveConcurrencyLimit options.
+struct AdaptiveConcurrencyLimitOptions {
+  /// The limit before any request completed.
+  size_t initial_limit = 20;
+  /// The limit never goes below this.
+  size_t min_limit = 1;
+  /// The limit never goes above this.
+  size_t max_limit = 1000;
+  /**
+   * @brief A round trip slower than this multiple of the minimum round trip
+   * time means the requests are queueing at the target.
+   */
+  double rtt_tolerance = 2.0;
+  /// The factor the limit is multiplied by when the requests queue.
+  double backoff_ratio = 0.9;
+  /// The number of round trips after which the minimum is measured again.
+  size_t min_rtt_window_size = 1000;
+};
+
+/**
+ * @brief An additive increase, multiplicative decrease limit on the number of
+ * concurrent requests to a target, driven by their round trip times. The limit
+ * grows by about one per round trip while the round trips stay close to the
+ * minimum seen, and shrinks by the backoff ratio when they do not or when the
+ * target sheds load, at most once per round trip.
+ *
+ * Not thread-safe. The callers serialize the calls.
+ */
+class AdaptiveConcurrencyLimit {
+ public:
+  explicit AdaptiveConcurrencyLimit(AdaptiveConcurrencyLimitOptions options)
+      : options_(options),
+        limit_(std::clamp(static_cast<double>(options.initial_limit),
+                          static_cast<double>(options.min_limit),
+                          static_cast<double>(options.max_limit))),
+        in_flight_(0),
+        next_sequence_number_(0),
+        decrease_sequence_number_(0),
+        min_rtt_ns_(0),
+        window_min_rtt_ns_(0),
+        rtt_count_(0) {}
+
+  /**
+   * @brief Acquires a slot for a request if the limit allows it.
+   *
+   * @param sequence_number Set to the number that the release of the slot
+   * takes.
+   * @return true if the slot was acquired.
+   */
+  bool TryAcquire(uint64_t& sequence_number) noexcept {
+    if (in_flight_ >= GetLimit()) {
+      return false;
+    }
+    in_flight_++;
+    sequence_number = next_sequence_number_++;
+    return true;
+  }
+
+  /**
+   * @brief Releases the slot of a request that completed, and adjusts the
+   * limit from its round trip.
+   *
+   * @param sequence_number The number from the acquisition of the slot.
+   * @param rtt_ns The round trip time of the request.
+   */
+  void OnSuccess(uint64_t sequence_number, TimeDuration rtt_ns) noexcept {
+    auto in_flight = in_flight_--;
+    auto window_position = rtt_count_++ % options_.min_rtt_window_size;
+    if (window_position == 0 || rtt_ns < window_min_rtt_ns_) {
+      window_min_rtt_ns_ = rtt_ns;
+    }
+    if (rtt_count_ == 1 || rtt_ns < min_rtt_ns_) {
+      min_rtt_ns_ = rtt_ns;
+    }
+    // The minimum of the previous window stays in use until the current one
+    // completes, so that a congested start of a window is not taken as the
+    // minimum.
+    if (window_position + 1 == options_.min_rtt_window_size) {
+      min_rtt_ns_ = window_min_rtt_ns_;
+    }
+
+    if (rtt_ns > min_rtt_ns_ * options_.rtt_tolerance) {
+      Decrease(sequence_number);
+    } else if (in_flight * 2 >= limit_) {
+      // Only grows while the limit is in use, so that it stays meaningful.
+      limit_ = std::min(limit_ + 1 / limit_,
+                        static_cast<double>(options_.max_limit));
+    }
+  }
+
+  /**
+   * @brief Releases the slot of a request that the target rejected for its
+   * load, and decreases the limit.
+   *
+   * @param sequence_number The number from the acquisition of the slot.
+   */
+  void OnDropped(uint64_t sequence_number) noexcept {
+    in_flight_--;
+    Decrease(sequence_number);
+  }
+
+  /**
+   * @brief Releases the slot of a request whose outcome says nothing about
+   * the load of the target.
+   */
+  void OnIgnored() noexcept { in_flight_--; }
+
+  /// Returns the current limit.
+  size_t GetLimit() const noexcept { return static_cast<size_t>(limit_); }
+
+  /// Returns the number of requests in flight.
+  size_t GetInFlight() const noexcept { return in_flight_; }
+
+ private:
+  void Decrease(uint64_t sequence_number) noexcept {
+    // The requests sent before the last decrease saw the same queue.
+    if (sequence_number < decrease_sequence_number_) {
+      return;
+    }
+    limit_ = std::max(limit_ * options_.backoff_ratio,
+                      static_cast<double>(options_.min_limit));
+    decrease_sequence_number_ = next_sequence_number_;
+  }
+
+  const AdaptiveConcurrencyLimitOptions options_;
+  double limit_;
+  size_t in_flight_;
+  uint64_t next_sequence_number_;
+  /// The requests sent from this one on can decrease the limit again.
+  uint64_t decrease_sequence_number_;
+  /// The minimum round trip the limit is driven by.
+  TimeDuration min_rtt_ns_;
+  /// The minimum round trip of the current window.
+  TimeDuration window_min_rtt_ns_;
+  /// The number of round trips, which windows the minimum round trip.
+  uint64_t rtt_count_;
+};
+}  // namespace google::scp::core
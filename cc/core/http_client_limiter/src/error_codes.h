@@ -0,0 +1,34 @@
+// Copyright 2023 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#pragma once
+
+#include "core/interface/errors.h"
+#include "public/core/interface/execution_result.h"
+
+namespace google::scp::core::errors {
+
+/// Registers component code as 0x001B for HTTP client limiter.
+REGISTER_COMPONENT_CODE(SC_HTTP_CLIENT_LIMITER, 0x001B);
+
+DEFINE_ERROR_CODE(SC_HTTP_CLIENT_LIMITER_LIMIT_EXCEEDED, SC_HTTP_CLIENT_LIMITER,
+                  0x0001,
+                  "The concurrency limit of the host and its queue are full",
+                  HttpStatusCode::SERVICE_UNAVAILABLE);
+
+DEFINE_ERROR_CODE(SC_HTTP_CLIENT_LIMITER_NO_PATH_SUPPLIED,
+                  SC_HTTP_CLIENT_LIMITER, 0x0002,
+                  "No path supplied to find the host of the request",
+                  HttpStatusCode::BAD_REQUEST);
+
+}  // namespace google::scp::core::errors
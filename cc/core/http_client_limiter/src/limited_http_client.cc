@@ -0,0 +1,206 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "limited_http_client.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "core/common/time_provider/src/time_provider.h"
+#include "core/interface/errors.h"
+
+using google::scp::core::common::TimeProvider;
+using google::scp::core::errors::ExtractComponentCode;
+using google::scp::core::errors::GetGlobalErrorCodes;
+using google::scp::core::errors::SC_HTTP_CLIENT_LIMITER_LIMIT_EXCEEDED;
+using google::scp::core::errors::SC_HTTP_CLIENT_LIMITER_NO_PATH_SUPPLIED;
+using std::lock_guard;
+using std::make_pair;
+using std::make_shared;
+using std::move;
+using std::mutex;
+using std::shared_ptr;
+using std::string;
+using std::unique_lock;
+
+namespace {
+constexpr char kSchemeSeparator[] = "://";
+
+/// Returns true if the target failed the request because of its load.
+bool IsLoadShed(const google::scp::core::ExecutionResult& result) {
+  using google::scp::core::ExecutionStatus;
+  using google::scp::core::errors::HttpStatusCode;
+  if (result.status == ExecutionStatus::Retry) {
+    return true;
+  }
+  // Looked up without inserting, as the error codes are shared.
+  const auto& error_codes = GetGlobalErrorCodes();
+  auto component = error_codes.find(ExtractComponentCode(result.status_code));
+  if (component == error_codes.end()) {
+    return false;
+  }
+  auto error = component->second.find(result.status_code);
+  if (error == component->second.end()) {
+    return false;
+  }
+  switch (error->second.error_http_status_code) {
+    case HttpStatusCode::REQUEST_TIMEOUT:
+    case HttpStatusCode::TOO_MANY_REQUESTS:
+    case HttpStatusCode::SERVICE_UNAVAILABLE:
+    case HttpStatusCode::GATEWAY_TIMEOUT:
+      return true;
+    default:
+      return false;
+  }
+}
+}  // namespace
+
+namespace google::scp::core {
+
+LimitedHttpClient::LimitedHttpClient(
+    const shared_ptr<HttpClientInterface>& http_client,
+    LimitedHttpClientOptions options)
+    : http_client_(http_client), options_(options) {}
+
+ExecutionResult LimitedHttpClient::Init() noexcept {
+  return SuccessExecutionResult();
+}
+
+ExecutionResult LimitedHttpClient::Run() noexcept {
+  return SuccessExecutionResult();
+}
+
+ExecutionResult LimitedHttpClient::Stop() noexcept {
+  return SuccessExecutionResult();
+}
+
+string LimitedHttpClient::GetHost(const Uri& uri) noexcept {
+  auto authority_start = uri.find(kSchemeSeparator);
+  authority_start = authority_start == Uri::npos
+                        ? 0
+                        : authority_start + sizeof(kSchemeSeparator) - 1;
+  return uri.substr(0, uri.find_first_of("/?#", authority_start));
+}
+
+size_t LimitedHttpClient::GetLimit(const string& host) noexcept {
+  shared_ptr<HostLimit> host_limit;
+  if (!host_limits_.Find(host, host_limit).Successful()) {
+    return 0;
+  }
+  lock_guard lock(host_limit->mutex);
+  return host_limit->limit.GetLimit();
+}
+
+ExecutionResult LimitedHttpClient::PerformRequest(
+    AsyncContext<HttpRequest, HttpResponse>& http_context) noexcept {
+  if (!http_context.request || !http_context.request->path) {
+    return FailureExecutionResult(SC_HTTP_CLIENT_LIMITER_NO_PATH_SUPPLIED);
+  }
+
+  auto host = GetHost(*http_context.request->path);
+  shared_ptr<HostLimit> host_limit;
+  if (!host_limits_.Find(host, host_limit).Successful()) {
+    // Keeps the limit of a concurrent insertion, if any.
+    host_limits_.Insert(
+        make_pair(host, make_shared<HostLimit>(options_.limit_options)),
+        host_limit);
+  }
+
+  uint64_t sequence_number;
+  {
+    lock_guard lock(host_limit->mutex);
+    if (!host_limit->limit.TryAcquire(sequence_number)) {
+      if (host_limit->queue.size() >= options_.max_queue_size_per_host) {
+        return FailureExecutionResult(SC_HTTP_CLIENT_LIMITER_LIMIT_EXCEEDED);
+      }
+      host_limit->queue.push_back(http_context);
+      return SuccessExecutionResult();
+    }
+  }
+
+  auto execution_result = Send(host_limit, http_context, sequence_number);
+  if (!execution_result.Successful()) {
+    SendQueuedRequests(host_limit);
+  }
+  return execution_result;
+}
+
+ExecutionResult LimitedHttpClient::Send(
+    const shared_ptr<HostLimit>& host_limit,
+    AsyncContext<HttpRequest, HttpResponse>& http_context,
+    uint64_t sequence_number) noexcept {
+  auto start_time = TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks();
+  // The caller's context keeps its callback, in case it is sent again.
+  auto limited_context = http_context;
+  limited_context.callback =
+      [this, host_limit, sequence_number, start_time,
+       callback = http_context.callback](
+          AsyncContext<HttpRequest, HttpResponse>& context) {
+        Release(host_limit, context.result, sequence_number, start_time);
+        SendQueuedRequests(host_limit);
+        callback(context);
+      };
+
+  auto execution_result = http_client_->PerformRequest(limited_context);
+  if (!execution_result.Successful()) {
+    lock_guard lock(host_limit->mutex);
+    host_limit->limit.OnIgnored();
+  }
+  return execution_result;
+}
+
+void LimitedHttpClient::Release(const shared_ptr<HostLimit>& host_limit,
+                                const ExecutionResult& result,
+                                uint64_t sequence_number,
+                                Timestamp start_time) noexcept {
+  auto rtt_ns =
+      TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks() - start_time;
+  auto is_load_shed = !result.Successful() && IsLoadShed(result);
+
+  lock_guard lock(host_limit->mutex);
+  if (result.Successful()) {
+    host_limit->limit.OnSuccess(sequence_number, rtt_ns);
+  } else if (is_load_shed) {
+    host_limit->limit.OnDropped(sequence_number);
+  } else {
+    host_limit->limit.OnIgnored();
+  }
+}
+
+void LimitedHttpClient::SendQueuedRequests(
+    const shared_ptr<HostLimit>& host_limit) noexcept {
+  while (true) {
+    uint64_t sequence_number;
+    unique_lock lock(host_limit->mutex);
+    if (host_limit->queue.empty() ||
+        !host_limit->limit.TryAcquire(sequence_number)) {
+      return;
+    }
+    AsyncContext<HttpRequest, HttpResponse> http_context(
+        move(host_limit->queue.front()));
+    host_limit->queue.pop_front();
+    lock.unlock();
+
+    auto execution_result = Send(host_limit, http_context, sequence_number);
+    if (!execution_result.Successful()) {
+      http_context.result = execution_result;
+      http_context.Finish();
+    }
+  }
+}
+
+}  // namespace google::scp::core
@@ -0,0 +1,120 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "core/common/concurrent_map/src/sharded_concurrent_map.h"
+#include "core/interface/async_context.h"
+#include "core/interface/http_client_interface.h"
+#include "public/core/interface/execution_result.h"
+
+#include "adaptive_concurrency_limit.h"
+#include "error_codes.h"
+
+namespace google::scp::core {
+/// LimitedHttpClient options.
+struct LimitedHttpClientOptions {
+  /// The options of the concurrency limit of each host.
+  AdaptiveConcurrencyLimitOptions limit_options;
+  /**
+   * @brief The number of requests per host that wait for a slot once the limit
+   * is reached. The requests beyond are rejected.
+   */
+  size_t max_queue_size_per_host = 0;
+};
+
+/*! @copydoc HttpClientInterface
+ *  This client limits the concurrent requests of each host of the wrapped
+ *  client, so that a slow host sheds load instead of queueing it.
+ */
+class LimitedHttpClient : public HttpClientInterface {
+ public:
+  /**
+   * @brief Construct a new Limited Http Client object
+   *
+   * @param http_client the client that performs the requests.
+   * @param options the options of the limits.
+   */
+  LimitedHttpClient(const std::shared_ptr<HttpClientInterface>& http_client,
+                    LimitedHttpClientOptions options = {});
+
+  ExecutionResult Init() noexcept override;
+  ExecutionResult Run() noexcept override;
+  ExecutionResult Stop() noexcept override;
+
+  /**
+   * @copydoc HttpClientInterface::PerformRequest
+   *
+   * Fails with SC_HTTP_CLIENT_LIMITER_LIMIT_EXCEEDED if the limit of the host
+   * and its queue are full.
+   */
+  ExecutionResult PerformRequest(
+      AsyncContext<HttpRequest, HttpResponse>& http_context) noexcept override;
+
+  /// Returns the current concurrency limit of the host, or 0 if unknown.
+  size_t GetLimit(const std::string& host) noexcept;
+
+ protected:
+  /// The limit of a host and the requests waiting for it.
+  struct HostLimit {
+    explicit HostLimit(AdaptiveConcurrencyLimitOptions options)
+        : limit(options) {}
+
+    /// Guards the fields below.
+    std::mutex mutex;
+    AdaptiveConcurrencyLimit limit;
+    std::deque<AsyncContext<HttpRequest, HttpResponse>> queue;
+  };
+
+  /**
+   * @brief Returns the host of the URI, which is the scheme and authority of
+   * the URI, e.g. "https://example.com:443".
+   */
+  static std::string GetHost(const Uri& uri) noexcept;
+
+  /**
+   * @brief Sends the request to the wrapped client with the slot acquired.
+   * The slot is released if the wrapped client fails to accept the request.
+   */
+  ExecutionResult Send(const std::shared_ptr<HostLimit>& host_limit,
+                       AsyncContext<HttpRequest, HttpResponse>& http_context,
+                       uint64_t sequence_number) noexcept;
+
+  /**
+   * @brief Releases the slot of a request that completed, and adjusts the
+   * limit of the host from its outcome.
+   */
+  static void Release(const std::shared_ptr<HostLimit>& host_limit,
+                      const ExecutionResult& result, uint64_t sequence_number,
+                      Timestamp start_time) noexcept;
+
+  /// Sends the requests waiting for the host while the limit allows it.
+  void SendQueuedRequests(
+      const std::shared_ptr<HostLimit>& host_limit) noexcept;
+
+  /// The client that performs the requests.
+  std::shared_ptr<HttpClientInterface> http_client_;
+  const LimitedHttpClientOptions options_;
+  /// The limits by host.
+  common::ShardedConcurrentMap<std::string, std::shared_ptr<HostLimit>>
+      host_limits_;
+};
+}  // namespace google::scp::core
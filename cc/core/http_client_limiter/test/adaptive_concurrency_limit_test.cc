@@ -0,0 +1,114 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/http_client_limiter/src/adaptive_concurrency_limit.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <vector>
+
+using std::vector;
+
+namespace google::scp::core::test {
+TEST(AdaptiveConcurrencyLimitTest, RejectsBeyondTheLimit) {
+  AdaptiveConcurrencyLimit limit({.initial_limit = 2});
+  uint64_t sequence_number;
+  EXPECT_TRUE(limit.TryAcquire(sequence_number));
+  EXPECT_TRUE(limit.TryAcquire(sequence_number));
+  EXPECT_FALSE(limit.TryAcquire(sequence_number));
+  EXPECT_EQ(limit.GetInFlight(), 2);
+
+  limit.OnIgnored();
+  EXPECT_TRUE(limit.TryAcquire(sequence_number));
+}
+
+TEST(AdaptiveConcurrencyLimitTest, GrowsWhileRoundTripsStayLow) {
+  AdaptiveConcurrencyLimit limit({.initial_limit = 4, .max_limit = 6});
+  for (int round = 0; round < 20; round++) {
+    vector<uint64_t> sequence_numbers;
+    uint64_t sequence_number;
+    while (limit.TryAcquire(sequence_number)) {
+      sequence_numbers.push_back(sequence_number);
+    }
+    for (auto sequence_number : sequence_numbers) {
+      limit.OnSuccess(sequence_number, 1000);
+    }
+  }
+  EXPECT_EQ(limit.GetLimit(), 6);
+}
+
+TEST(AdaptiveConcurrencyLimitTest, ShrinksOnSlowRoundTrips) {
+  AdaptiveConcurrencyLimit limit(
+      {.initial_limit = 10, .rtt_tolerance = 2, .backoff_ratio = 0.5});
+  uint64_t sequence_number;
+  ASSERT_TRUE(limit.TryAcquire(sequence_number));
+  limit.OnSuccess(sequence_number, 1000);
+  EXPECT_EQ(limit.GetLimit(), 10);
+
+  ASSERT_TRUE(limit.TryAcquire(sequence_number));
+  limit.OnSuccess(sequence_number, 2001);
+  EXPECT_EQ(limit.GetLimit(), 5);
+}
+
+TEST(AdaptiveConcurrencyLimitTest, ShrinksOncePerRoundTrip) {
+  AdaptiveConcurrencyLimit limit(
+      {.initial_limit = 10, .min_limit = 2, .backoff_ratio = 0.5});
+  vector<uint64_t> sequence_numbers(5);
+  for (auto& sequence_number : sequence_numbers) {
+    ASSERT_TRUE(limit.TryAcquire(sequence_number));
+  }
+  // The requests sent together saw the same queue.
+  for (auto sequence_number : sequence_numbers) {
+    limit.OnDropped(sequence_number);
+  }
+  EXPECT_EQ(limit.GetLimit(), 5);
+
+  // The requests sent after the decrease can shrink the limit again, down to
+  // the minimum.
+  for (int i = 0; i < 3; i++) {
+    uint64_t sequence_number;
+    ASSERT_TRUE(limit.TryAcquire(sequence_number));
+    limit.OnDropped(sequence_number);
+  }
+  EXPECT_EQ(limit.GetLimit(), 2);
+}
+TEST(AdaptiveConcurrencyLimitTest, KeepsMinimumRoundTripUntilWindowCompletes) {
+  AdaptiveConcurrencyLimit limit({.initial_limit = 10,
+                                  .rtt_tolerance = 2,
+                                  .backoff_ratio = 0.5,
+                                  .min_rtt_window_size = 2});
+  uint64_t sequence_number;
+  for (auto rtt_ns : {1000, 1000}) {
+    ASSERT_TRUE(limit.TryAcquire(sequence_number));
+    limit.OnSuccess(sequence_number, rtt_ns);
+  }
+  EXPECT_EQ(limit.GetLimit(), 10);
+
+  // The first round trip of the new window is still compared to the minimum
+  // of the previous one.
+  ASSERT_TRUE(limit.TryAcquire(sequence_number));
+  limit.OnSuccess(sequence_number, 3000);
+  EXPECT_EQ(limit.GetLimit(), 5);
+
+  // Once the window completes, its own minimum is used.
+  ASSERT_TRUE(limit.TryAcquire(sequence_number));
+  limit.OnSuccess(sequence_number, 3000);
+  ASSERT_TRUE(limit.TryAcquire(sequence_number));
+  limit.OnSuccess(sequence_number, 5000);
+  EXPECT_EQ(limit.GetLimit(), 5);
+}
+}  // namespace google::scp::core::test
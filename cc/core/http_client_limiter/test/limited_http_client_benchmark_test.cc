@@ -0,0 +1,196 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "core/async_executor/src/async_executor.h"
+#include "core/common/time_provider/src/time_provider.h"
+#include "core/http_client_limiter/src/limited_http_client.h"
+#include "core/interface/async_context.h"
+#include "core/interface/http_client_interface.h"
+
+using google::scp::core::AsyncContext;
+using google::scp::core::AsyncExecutor;
+using google::scp::core::common::TimeProvider;
+using std::atomic;
+using std::greater;
+using std::lock_guard;
+using std::make_shared;
+using std::mutex;
+using std::priority_queue;
+using std::shared_ptr;
+using std::vector;
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+using std::chrono::nanoseconds;
+using std::chrono::steady_clock;
+
+namespace google::scp::core::test {
+/// The number of requests the fake backend serves at once.
+static constexpr size_t kWorkerCount = 4;
+/// The time the fake backend takes to serve a request.
+static constexpr milliseconds kServiceTime(2);
+/// The number of requests sent by a run of the benchmark.
+static constexpr int kRequestCount = 4000;
+static constexpr char kPath[] = "https://backend.example.com/path";
+
+/**
+ * @brief A backend with a fixed number of workers and service time, which
+ * queues the requests beyond its workers without bound, the way the requests
+ * queue in the connections of a client to a slow host.
+ */
+class FakeBackendHttpClient : public HttpClientInterface {
+ public:
+  explicit FakeBackendHttpClient(
+      const shared_ptr<AsyncExecutorInterface>& async_executor)
+      : async_executor_(async_executor) {
+    for (size_t i = 0; i < kWorkerCount; i++) {
+      worker_free_times_.push(nanoseconds(0));
+    }
+  }
+
+  ExecutionResult Init() noexcept override { return SuccessExecutionResult(); }
+
+  ExecutionResult Run() noexcept override { return SuccessExecutionResult(); }
+
+  ExecutionResult Stop() noexcept override { return SuccessExecutionResult(); }
+
+  ExecutionResult PerformRequest(
+      AsyncContext<HttpRequest, HttpResponse>& http_context) noexcept override {
+    nanoseconds completion_time;
+    {
+      lock_guard lock(mutex_);
+      auto start_time =
+          std::max(TimeProvider::GetSteadyTimestampInNanoseconds(),
+                   worker_free_times_.top());
+      worker_free_times_.pop();
+      completion_time = start_time + kServiceTime;
+      worker_free_times_.push(completion_time);
+    }
+    return async_executor_->ScheduleFor(
+        [http_context]() mutable {
+          http_context.result = SuccessExecutionResult();
+          http_context.Finish();
+        },
+        completion_time.count());
+  }
+
+ private:
+  shared_ptr<AsyncExecutorInterface> async_executor_;
+  mutex mutex_;
+  /// The times at which the workers are done with their requests.
+  priority_queue<nanoseconds, vector<nanoseconds>, greater<nanoseconds>>
+      worker_free_times_;
+};
+
+/// Returns the percentile of the latencies in microseconds.
+static double GetPercentile(vector<nanoseconds>& latencies, double percentile) {
+  if (latencies.empty()) {
+    return 0;
+  }
+  auto rank = static_cast<size_t>(percentile * (latencies.size() - 1));
+  std::nth_element(latencies.begin(), latencies.begin() + rank,
+                   latencies.end());
+  return duration_cast<microseconds>(latencies[rank]).count();
+}
+
+/**
+ * @brief Sends requests to the fake backend at a fixed rate, given as a
+ * percentage of the capacity of the backend, directly or through a
+ * LimitedHttpClient, and reports the throughput, the latency percentiles of
+ * the completed requests and the fraction of the requests rejected.
+ */
+static void BM_SendToSaturatedBackend(benchmark::State& state) {
+  auto offered_load_percentage = state.range(0);
+  auto is_limited = state.range(1) == 1;
+  auto async_executor = make_shared<AsyncExecutor>(/*thread_count=*/2,
+                                                   /*queue_cap=*/100000);
+  async_executor->Init();
+  async_executor->Run();
+
+  auto backend = make_shared<FakeBackendHttpClient>(async_executor);
+  shared_ptr<HttpClientInterface> http_client = backend;
+  if (is_limited) {
+    LimitedHttpClientOptions options;
+    options.limit_options.initial_limit = 2 * kWorkerCount;
+    http_client = make_shared<LimitedHttpClient>(backend, options);
+  }
+
+  auto capacity_per_second = kWorkerCount * (milliseconds(1000) / kServiceTime);
+  auto send_interval = duration_cast<nanoseconds>(milliseconds(1000)) * 100 /
+                       (capacity_per_second * offered_load_percentage);
+
+  mutex latencies_mutex;
+  vector<nanoseconds> latencies;
+  atomic<int> completed_count(0);
+  int rejected_count = 0;
+  nanoseconds duration(0);
+  for (auto _ : state) {
+    auto request = make_shared<HttpRequest>();
+    request->path = make_shared<Uri>(kPath);
+    auto start_time = steady_clock::now();
+    for (int i = 0; i < kRequestCount; i++) {
+      std::this_thread::sleep_until(start_time + i * send_interval);
+      auto send_time = TimeProvider::GetSteadyTimestampInNanoseconds();
+      AsyncContext<HttpRequest, HttpResponse> context(
+          request, [&, send_time](AsyncContext<HttpRequest, HttpResponse>&) {
+            auto latency =
+                TimeProvider::GetSteadyTimestampInNanoseconds() - send_time;
+            {
+              lock_guard lock(latencies_mutex);
+              latencies.push_back(latency);
+            }
+            completed_count++;
+          });
+      if (!http_client->PerformRequest(context).Successful()) {
+        rejected_count++;
+      }
+    }
+    while (completed_count.load() + rejected_count < kRequestCount) {
+      std::this_thread::sleep_for(milliseconds(1));
+    }
+    duration = steady_clock::now() - start_time;
+  }
+  async_executor->Stop();
+
+  state.SetLabel(is_limited ? "limited" : "unlimited");
+  state.counters["offered_load_pct"] = offered_load_percentage;
+  state.counters["throughput_per_s"] =
+      completed_count.load() * 1e9 / duration.count();
+  state.counters["rejected_pct"] = 100.0 * rejected_count / kRequestCount;
+  state.counters["p50_us"] = GetPercentile(latencies, 0.5);
+  state.counters["p99_us"] = GetPercentile(latencies, 0.99);
+}
+
+BENCHMARK(BM_SendToSaturatedBackend)
+    ->ArgsProduct({{50, 90, 120, 150}, {0, 1}})
+    ->Iterations(1)
+    ->UseRealTime();
+}  // namespace google::scp::core::test
+
+// Run the benchmark
+BENCHMARK_MAIN();
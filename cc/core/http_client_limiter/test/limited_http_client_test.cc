@@ -0,0 +1,157 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "core/http_client_limiter/src/limited_http_client.h"
+
+#include <gtest/gtest.h>
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/http2_client/mock/mock_http_client.h"
+#include "core/http_client_limiter/src/error_codes.h"
+#include "core/interface/async_context.h"
+#include "public/core/test/interface/execution_result_matchers.h"
+
+using google::scp::core::errors::SC_HTTP_CLIENT_LIMITER_LIMIT_EXCEEDED;
+using google::scp::core::errors::SC_HTTP_CLIENT_LIMITER_NO_PATH_SUPPLIED;
+using google::scp::core::http2_client::mock::MockHttpClient;
+using google::scp::core::test::ResultIs;
+using std::deque;
+using std::make_shared;
+using std::shared_ptr;
+using std::string;
+using std::vector;
+
+namespace google::scp::core::test {
+/**
+ * @brief Holds the requests sent to the wrapped client until the test
+ * completes them.
+ */
+class LimitedHttpClientTest : public testing::Test {
+ protected:
+  LimitedHttpClientTest() {
+    http_client_->perform_request_mock =
+        [this](AsyncContext<HttpRequest, HttpResponse>& http_context) {
+          sent_contexts_.push_back(http_context);
+          return SuccessExecutionResult();
+        };
+  }
+
+  shared_ptr<LimitedHttpClient> CreateClient(size_t limit, size_t queue_size) {
+    LimitedHttpClientOptions options;
+    options.limit_options.initial_limit = limit;
+    options.max_queue_size_per_host = queue_size;
+    return make_shared<LimitedHttpClient>(http_client_, options);
+  }
+
+  AsyncContext<HttpRequest, HttpResponse> CreateContext(const string& uri) {
+    auto request = make_shared<HttpRequest>();
+    request->path = make_shared<Uri>(uri);
+    return AsyncContext<HttpRequest, HttpResponse>(
+        request, [this](AsyncContext<HttpRequest, HttpResponse>& context) {
+          completed_paths_.push_back(*context.request->path);
+        });
+  }
+
+  void CompleteRequest(size_t index, ExecutionResult result) {
+    sent_contexts_[index].result = result;
+    sent_contexts_[index].Finish();
+  }
+
+  shared_ptr<MockHttpClient> http_client_ = make_shared<MockHttpClient>();
+  // A deque, as the completions send the queued requests.
+  deque<AsyncContext<HttpRequest, HttpResponse>> sent_contexts_;
+  vector<string> completed_paths_;
+};
+
+TEST_F(LimitedHttpClientTest, QueuesAndRejectsBeyondTheLimit) {
+  auto client = CreateClient(/*limit=*/1, /*queue_size=*/1);
+  auto first_context = CreateContext("https://example.com/first");
+  auto second_context = CreateContext("https://example.com/second");
+  auto third_context = CreateContext("https://example.com/third");
+  EXPECT_SUCCESS(client->PerformRequest(first_context));
+  EXPECT_SUCCESS(client->PerformRequest(second_context));
+  EXPECT_THAT(client->PerformRequest(third_context),
+              ResultIs(FailureExecutionResult(
+                  SC_HTTP_CLIENT_LIMITER_LIMIT_EXCEEDED)));
+  ASSERT_EQ(sent_contexts_.size(), 1);
+
+  // The completion of the first request sends the queued one.
+  CompleteRequest(0, SuccessExecutionResult());
+  ASSERT_EQ(sent_contexts_.size(), 2);
+  EXPECT_EQ(*sent_contexts_[1].request->path, "https://example.com/second");
+  CompleteRequest(1, SuccessExecutionResult());
+  EXPECT_EQ(completed_paths_,
+            vector<string>({"https://example.com/first",
+                            "https://example.com/second"}));
+}
+
+TEST_F(LimitedHttpClientTest, HostsHaveSeparateLimits) {
+  auto client = CreateClient(/*limit=*/1, /*queue_size=*/0);
+  auto first_context = CreateContext("https://example.com:443/path?query=1");
+  auto second_context = CreateContext("https://example.com:443");
+  auto third_context = CreateContext("http://other.example.com/path");
+  EXPECT_SUCCESS(client->PerformRequest(first_context));
+  EXPECT_THAT(client->PerformRequest(second_context),
+              ResultIs(FailureExecutionResult(
+                  SC_HTTP_CLIENT_LIMITER_LIMIT_EXCEEDED)));
+  EXPECT_SUCCESS(client->PerformRequest(third_context));
+
+  EXPECT_EQ(client->GetLimit("https://example.com:443"), 1);
+  EXPECT_EQ(client->GetLimit("http://other.example.com"), 1);
+  EXPECT_EQ(client->GetLimit("https://unknown.example.com"), 0);
+}
+
+TEST_F(LimitedHttpClientTest, FailedOnAcceptanceReleasesTheSlot) {
+  auto client = CreateClient(/*limit=*/1, /*queue_size=*/0);
+  http_client_->perform_request_mock =
+      [](AsyncContext<HttpRequest, HttpResponse>&) {
+        return FailureExecutionResult(1234);
+      };
+  auto context = CreateContext("https://example.com/path");
+  EXPECT_THAT(client->PerformRequest(context),
+              ResultIs(FailureExecutionResult(1234)));
+  EXPECT_THAT(client->PerformRequest(context),
+              ResultIs(FailureExecutionResult(1234)));
+  EXPECT_TRUE(completed_paths_.empty());
+}
+
+TEST_F(LimitedHttpClientTest, LoadSheddingShrinksTheLimit) {
+  auto client = CreateClient(/*limit=*/10, /*queue_size=*/0);
+  auto context = CreateContext("https://example.com/path");
+  EXPECT_SUCCESS(client->PerformRequest(context));
+  CompleteRequest(0, RetryExecutionResult(1234));
+  EXPECT_EQ(client->GetLimit("https://example.com"), 9);
+
+  // Other failures say nothing about the load.
+  EXPECT_SUCCESS(client->PerformRequest(context));
+  CompleteRequest(1, FailureExecutionResult(1234));
+  EXPECT_EQ(client->GetLimit("https://example.com"), 9);
+  EXPECT_EQ(completed_paths_.size(), 2);
+}
+
+TEST_F(LimitedHttpClientTest, RequestWithoutPath) {
+  auto client = CreateClient(/*limit=*/1, /*queue_size=*/0);
+  AsyncContext<HttpRequest, HttpResponse> context(make_shared<HttpRequest>(),
+                                                  [](auto&) {});
+  EXPECT_THAT(client->PerformRequest(context),
+              ResultIs(FailureExecutionResult(
+                  SC_HTTP_CLIENT_LIMITER_NO_PATH_SUPPLIED)));
+}
+}  // namespace google::scp::core::test
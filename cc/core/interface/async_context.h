@@ -19,6 +19,7 @@
 #include <chrono>
 #include <functional>
 #include <memory>
+#include <utility>
 
 #include "core/common/global_logger/src/global_logger.h"
 #include "core/common/time_provider/src/time_provider.h"
@@ -29,6 +30,23 @@
 #include "type_def.h"
 
 namespace google::scp::core {
+/// The way FinishContext completes an AsyncContext on an async executor.
+enum class AsyncCompletionPolicy {
+  /// The callback is always scheduled on the executor.
+  Schedule = 0,
+  /**
+   * @brief The callback runs inline if the caller is already on an executor
+   * thread that runs the tasks of the requested priority, and is scheduled
+   * otherwise.
+   */
+  InlineOnExecutorThread = 1,
+  /**
+   * @brief The callback is cheap enough to run inline on whichever thread
+   * completes the operation, e.g. a thread of a cloud SDK.
+   */
+  InlineCheapCallback = 2,
+};
+
 /**
  * @brief AsyncContext is used to control the lifecycle of any async operations.
  * The caller with set the request, response, and the callback on the object and
@@ -54,9 +72,9 @@ struct AsyncContext {
    * @param callback the callback object for when the async operation is
    * completed.
    */
-  AsyncContext(const std::shared_ptr<TRequest>& request,
-               const Callback& callback)
-      : AsyncContext(request, callback, common::kZeroUuid, common::kZeroUuid) {}
+  AsyncContext(const std::shared_ptr<TRequest>& request, Callback callback)
+      : AsyncContext(request, std::move(callback), common::kZeroUuid,
+                     common::kZeroUuid) {}
 
   /**
    * @brief Constructs a new Async Context object.
@@ -66,10 +84,10 @@ struct AsyncContext {
    * @param parent_activity_id The parent activity id of the current async
    * context.
    */
-  AsyncContext(const std::shared_ptr<TRequest>& request,
-               const Callback& callback, const common::Uuid& parent_activity_id)
-      : AsyncContext(request, callback, parent_activity_id, common::kZeroUuid) {
-  }
+  AsyncContext(const std::shared_ptr<TRequest>& request, Callback callback,
+               const common::Uuid& parent_activity_id)
+      : AsyncContext(request, std::move(callback), parent_activity_id,
+                     common::kZeroUuid) {}
 
   /**
    * @brief Constructs a new Async Context object.
@@ -80,31 +98,30 @@ struct AsyncContext {
    * context.
    */
   template <typename ParentAsyncContext>
-  AsyncContext(const std::shared_ptr<TRequest>& request,
-               const Callback& callback,
+  AsyncContext(const std::shared_ptr<TRequest>& request, Callback callback,
                const ParentAsyncContext& parent_context)
-      : AsyncContext(request, callback, parent_context.activity_id,
+      : AsyncContext(request, std::move(callback), parent_context.activity_id,
                      parent_context.correlation_id) {}
 
   /**
    * @brief Constructs a new Async Context object.
    * @param request instance of the request.
    * @param callback the callback object for when the async operation is
-   * completed.
+   * completed. Taken by value, so a temporary callback is moved in rather than
+   * copied into a second type-erased holder.
    * @param parent_activity_id The parent activity id of the current async
    * context.
    * @param correlation_id The correlation id of the current async context.
    */
-  AsyncContext(const std::shared_ptr<TRequest>& request,
-               const Callback& callback, const common::Uuid& parent_activity_id,
+  AsyncContext(const std::shared_ptr<TRequest>& request, Callback callback,
+               const common::Uuid& parent_activity_id,
                const common::Uuid& correlation_id)
       : parent_activity_id(parent_activity_id),
-        activity_id(common::Uuid::GenerateUuid()),
         correlation_id(correlation_id),
         request(request),
         response(nullptr),
         result(FailureExecutionResult(SC_UNKNOWN)),
-        callback(callback),
+        callback(std::move(callback)),
         retry_count(0) {
     expiration_time =
         (common::TimeProvider::GetSteadyTimestampInNanoseconds() +
@@ -122,6 +139,7 @@ struct AsyncContext {
     callback = right.callback;
     retry_count = right.retry_count;
     expiration_time = right.expiration_time;
+    completion_policy = right.completion_policy;
   }
 
   /// Finishes the async operation by calling the callback.
@@ -143,8 +161,11 @@ struct AsyncContext {
   /// The parent id of the current context.
   common::Uuid parent_activity_id;
 
-  /// The id of the current context.
-  common::Uuid activity_id;
+  /**
+   * @brief The id of the current context. It is generated on its first read,
+   * and copying the context reads it, so that the copies share it.
+   */
+  common::DeferredUuid activity_id;
 
   /// The unique id for the operation the current context is relate to.
   /// For example, in CMRTIO, it could be for a request, and in PBS, it could be
@@ -168,13 +189,46 @@ struct AsyncContext {
 
   /// The expiration_time time of the async context.
   Timestamp expiration_time;
+
+  /**
+   * @brief The way FinishContext completes the context on an async executor.
+   * Set by the owner of the callback, which knows what the callback costs.
+   */
+  AsyncCompletionPolicy completion_policy = AsyncCompletionPolicy::Schedule;
 };
 
+/**
+ * @brief Returns the number of callbacks FinishContext is running inline on the
+ * current thread, one inside the other.
+ */
+inline size_t& GetInlineFinishContextDepth() {
+  static thread_local size_t inline_finish_context_depth = 0;
+  return inline_finish_context_depth;
+}
+
+/**
+ * @brief Returns true if FinishContext can run the callback inline rather than
+ * scheduling it. The callbacks that are run inline can finish further contexts
+ * inline, so the nesting is bounded by kMaxInlineFinishContextDepth to keep the
+ * stack from growing without limit.
+ */
+inline bool CanFinishContextInline(AsyncCompletionPolicy completion_policy,
+                                   AsyncExecutorInterface& async_executor,
+                                   AsyncPriority priority) {
+  if (completion_policy == AsyncCompletionPolicy::Schedule ||
+      GetInlineFinishContextDepth() >= kMaxInlineFinishContextDepth) {
+    return false;
+  }
+  return completion_policy == AsyncCompletionPolicy::InlineCheapCallback ||
+         async_executor.IsRunningOnExecutorThread(priority);
+}
+
 /**
  * @brief Finish Context on a thread on the provided AsyncExecutor thread pool.
  * Assigns the result to the context, schedules Finish(), and
  * returns the result. If the context cannot be finished async, it will be
- * finished synchronously on the current thread.
+ * finished synchronously on the current thread. The completion_policy of the
+ * context can let Finish() run inline instead of being scheduled.
  * @param result execution result of operation.
  * @param context the async context to be completed.
  * @param async_executor the executor (thread pool) for the async context to
@@ -188,6 +242,15 @@ void FinishContext(
     AsyncPriority priority = AsyncPriority::High) {
   context.result = result;
 
+  if (CanFinishContextInline(context.completion_policy, *async_executor,
+                             priority)) {
+    auto& inline_finish_context_depth = GetInlineFinishContextDepth();
+    inline_finish_context_depth++;
+    context.Finish();
+    inline_finish_context_depth--;
+    return;
+  }
+
   // Make a copy of context - this way we know async_executor's handle will
   // never go out of scope.
   if (!async_executor
@@ -197,6 +260,37 @@ void FinishContext(
   }
 }
 
+/**
+ * @brief Schedules work that serves the context on the provided AsyncExecutor
+ * thread pool, with the expiration_time of the context as the deadline of the
+ * work. If the context expires before the work starts, the work is dropped and
+ * the context is finished with the result of the expiration instead, e.g.
+ * SC_ASYNC_EXECUTOR_TASK_DEADLINE_EXCEEDED, as its caller has stopped waiting.
+ * @param work the work that serves the context.
+ * @param context the async context the work serves.
+ * @param async_executor the executor (thread pool) to run the work on.
+ * @param priority the priority for the executor.
+ * @param affinity the affinity with which to schedule the work.
+ * @return ExecutionResult the result of scheduling the work. The context is
+ * not finished if the work cannot be scheduled, including when the context has
+ * already expired, so that the caller finishes it as for any other failure.
+ */
+template <typename TRequest, typename TResponse>
+ExecutionResult ScheduleBeforeExpiration(
+    AsyncOperation work, AsyncContext<TRequest, TResponse>& context,
+    const std::shared_ptr<AsyncExecutorInterface>& async_executor,
+    AsyncPriority priority,
+    AsyncExecutorAffinitySetting affinity =
+        AsyncExecutorAffinitySetting::NonAffinitized) {
+  return async_executor->ScheduleWithDeadline(
+      std::move(work), priority, context.expiration_time,
+      [context](const ExecutionResult& result) mutable {
+        context.result = result;
+        context.Finish();
+      },
+      affinity);
+}
+
 /**
  * @brief Finish Context on the current thread.
  * Assigns the result to the context, schedules Finish(), and returns the
@@ -18,6 +18,8 @@
 
 #include <functional>
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "service_interface.h"
 #include "type_def.h"
@@ -98,6 +100,12 @@ enum class AsyncExecutorAffinitySetting {
 
 using TaskCancellationLambda = std::function<bool()>;
 
+/**
+ * @brief Is called instead of a task whose deadline passed before the task
+ * started, with the result that explains why the task was dropped.
+ */
+using TaskExpirationCallback = std::function<void(const ExecutionResult&)>;
+
 /**
  * @brief AsyncExecutor is the main thread-pool of the service. It controls the
  * number of threads that are used across the application and is capable of
@@ -125,6 +133,126 @@ class AsyncExecutorInterface : public ServiceInterface {
       const AsyncOperation& work, AsyncPriority priority,
       AsyncExecutorAffinitySetting affinity) noexcept = 0;
 
+  /**
+   * @brief Same as above but takes ownership of the work. Implementations can
+   * override this to avoid copying the captured state of the operation. By
+   * default, it forwards to the copying overload.
+   */
+  virtual ExecutionResult Schedule(AsyncOperation&& work,
+                                   AsyncPriority priority) noexcept {
+    return Schedule(static_cast<const AsyncOperation&>(work), priority);
+  }
+
+  /**
+   * @brief Same as above but with the given affinity setting.
+   * @param affinity the affinity with which to schedule the work.
+   */
+  virtual ExecutionResult Schedule(
+      AsyncOperation&& work, AsyncPriority priority,
+      AsyncExecutorAffinitySetting affinity) noexcept {
+    return Schedule(static_cast<const AsyncOperation&>(work), priority,
+                    affinity);
+  }
+
+  /**
+   * @brief Schedules a batch of tasks with certain priority. Implementations
+   * can override this to queue the whole batch at once instead of paying the
+   * queueing and signaling cost of every task. By default, every operation is
+   * forwarded to Schedule.
+   *
+   * @param works the tasks that need to be scheduled. The scheduled operations
+   * are removed from the vector. If the result is not successful, the
+   * operations that were not scheduled are left in the vector in their
+   * original order.
+   * @param priority the priority of the tasks.
+   * @return ExecutionResult result of the execution with possible error code.
+   */
+  virtual ExecutionResult ScheduleBatch(std::vector<AsyncOperation>& works,
+                                        AsyncPriority priority) noexcept {
+    return ScheduleBatch(works, priority,
+                         AsyncExecutorAffinitySetting::NonAffinitized);
+  }
+
+  /**
+   * @brief Same as above but with the given affinity setting.
+   * @param affinity the affinity with which to schedule the work.
+   */
+  virtual ExecutionResult ScheduleBatch(
+      std::vector<AsyncOperation>& works, AsyncPriority priority,
+      AsyncExecutorAffinitySetting affinity) noexcept {
+    size_t scheduled_count = 0;
+    ExecutionResult execution_result = SuccessExecutionResult();
+    for (const auto& work : works) {
+      execution_result = Schedule(work, priority, affinity);
+      if (!execution_result.Successful()) {
+        break;
+      }
+      scheduled_count++;
+    }
+    works.erase(works.begin(), works.begin() + scheduled_count);
+    return execution_result;
+  }
+
+  /**
+   * @brief Schedules a task with certain priority that is only worth executing
+   * until its deadline, e.g. the expiration_time of the AsyncContext it serves.
+   * Implementations can run the tasks with a deadline earliest deadline first
+   * within their priority, and drop the ones whose deadline passes before they
+   * start instead of executing them. By default, the task is forwarded to
+   * Schedule and always executed.
+   *
+   * @param work the task that needs to be scheduled.
+   * @param priority the priority of the task.
+   * @param deadline the steady clock timestamp in nanoseconds after which the
+   * task is not worth starting.
+   * @param expiration_callback is called instead of the task if the task is
+   * dropped after it was scheduled.
+   * @return ExecutionResult result of the execution with possible error code.
+   */
+  virtual ExecutionResult ScheduleWithDeadline(
+      const AsyncOperation& work, AsyncPriority priority, Timestamp deadline,
+      const TaskExpirationCallback& expiration_callback) noexcept {
+    return ScheduleWithDeadline(work, priority, deadline, expiration_callback,
+                                AsyncExecutorAffinitySetting::NonAffinitized);
+  }
+
+  /**
+   * @brief Same as above but with the given affinity setting.
+   * @param affinity the affinity with which to schedule the work.
+   */
+  virtual ExecutionResult ScheduleWithDeadline(
+      const AsyncOperation& work, AsyncPriority priority,
+      Timestamp /*deadline*/,
+      const TaskExpirationCallback& /*expiration_callback*/,
+      AsyncExecutorAffinitySetting affinity) noexcept {
+    return Schedule(work, priority, affinity);
+  }
+
+  /**
+   * @brief Same as above but takes ownership of the work. By default, it
+   * forwards to the copying overload.
+   */
+  virtual ExecutionResult ScheduleWithDeadline(
+      AsyncOperation&& work, AsyncPriority priority, Timestamp deadline,
+      const TaskExpirationCallback& expiration_callback) noexcept {
+    return ScheduleWithDeadline(std::move(work), priority, deadline,
+                                expiration_callback,
+                                AsyncExecutorAffinitySetting::NonAffinitized);
+  }
+
+  /**
+   * @brief Same as above but with the given affinity setting.
+   * @param affinity the affinity with which to schedule the work.
+   */
+  virtual ExecutionResult ScheduleWithDeadline(
+      AsyncOperation&& work, AsyncPriority priority, Timestamp deadline,
+      const TaskExpirationCallback& expiration_callback,
+      AsyncExecutorAffinitySetting affinity) noexcept {
+    return ScheduleWithDeadline(static_cast<const AsyncOperation&>(work),
+                                priority, deadline, expiration_callback,
+                                affinity);
+  }
+
   /**
    * @brief Schedules a task to be executed after the specified time.
    * NOTE: There is no guarantee in terms of execution of the task at the
@@ -145,6 +273,43 @@ class AsyncExecutorInterface : public ServiceInterface {
       const AsyncOperation& work, Timestamp timestamp,
       AsyncExecutorAffinitySetting affinity) noexcept = 0;
 
+  /**
+   * @brief Schedules a batch of tasks to be executed after the specified time.
+   * By default, every operation is forwarded to ScheduleFor.
+   *
+   * @param works the tasks that need to be scheduled. The scheduled operations
+   * are removed from the vector. If the result is not successful, the
+   * operations that were not scheduled are left in the vector in their
+   * original order.
+   * @param timestamp the timestamp to the tasks to be executed.
+   * @return ExecutionResult result of the execution with possible error code.
+   */
+  virtual ExecutionResult ScheduleForBatch(std::vector<AsyncOperation>& works,
+                                           Timestamp timestamp) noexcept {
+    return ScheduleForBatch(works, timestamp,
+                            AsyncExecutorAffinitySetting::NonAffinitized);
+  }
+
+  /**
+   * @brief Same as above but with the given affinity setting.
+   * @param affinity the affinity with which to schedule the work.
+   */
+  virtual ExecutionResult ScheduleForBatch(
+      std::vector<AsyncOperation>& works, Timestamp timestamp,
+      AsyncExecutorAffinitySetting affinity) noexcept {
+    size_t scheduled_count = 0;
+    ExecutionResult execution_result = SuccessExecutionResult();
+    for (const auto& work : works) {
+      execution_result = ScheduleFor(work, timestamp, affinity);
+      if (!execution_result.Successful()) {
+        break;
+      }
+      scheduled_count++;
+    }
+    works.erase(works.begin(), works.begin() + scheduled_count);
+    return execution_result;
+  }
+
   /**
    * @brief Schedules a task to be executed after the specified
    * time. Cancellation callback is provided for the user to cancel the task if
@@ -167,5 +332,18 @@ class AsyncExecutorInterface : public ServiceInterface {
       const AsyncOperation& work, Timestamp timestamp,
       TaskCancellationLambda& cancellation_callback,
       AsyncExecutorAffinitySetting affinity) noexcept = 0;
+
+  /**
+   * @brief Returns true if the calling thread is a thread of this executor
+   * that runs the tasks of the given priority, i.e. work scheduled with the
+   * priority could as well run on the calling thread. By default, no thread is
+   * known to be an executor thread.
+   *
+   * @param priority the priority of the work.
+   */
+  virtual bool IsRunningOnExecutorThread(
+      AsyncPriority /*priority*/) noexcept {
+    return false;
+  }
 };
 }  // namespace google::scp::core
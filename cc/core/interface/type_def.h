@@ -127,6 +127,8 @@ struct LoadableObject {
 };
 
 static constexpr TimeDuration kAsyncContextExpirationDurationInSeconds = 90;
+/// The maximum nesting of the callbacks that FinishContext runs inline.
+static constexpr size_t kMaxInlineFinishContextDepth = 16;
 
 // The default config value for RetryStrategyOptions
 static constexpr size_t kDefaultRetryStrategyMaxRetries = 12;
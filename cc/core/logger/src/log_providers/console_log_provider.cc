@@ -25,6 +25,7 @@
 #include "core/common/uuid/src/uuid.h"
 #include "core/logger/src/log_utils.h"
 
+using google::scp::core::common::kUuidStringLength;
 using google::scp::core::common::TimeProvider;
 using google::scp::core::common::ToString;
 using google::scp::core::common::Uuid;
@@ -61,12 +62,20 @@ void ConsoleLogProvider::Log(
       TimeProvider::GetWallTimestampInNanosecondsAsClockTicks();
   auto current_timestamp_seconds = current_timestamp / nano_seconds_multiplier;
   auto remainder_nano_seconds = (current_timestamp % nano_seconds_multiplier);
+  char correlation_id_string[kUuidStringLength];
+  char parent_activity_id_string[kUuidStringLength];
+  char activity_id_string[kUuidStringLength];
+  ToString(correlation_id, correlation_id_string);
+  ToString(parent_activity_id, parent_activity_id_string);
+  ToString(activity_id, activity_id_string);
+
   std::stringstream output;
   output << current_timestamp_seconds << "." << remainder_nano_seconds << "|"
          << cluster_name << "|" << machine_name << "|" << component_name << "|"
-         << ToString(correlation_id) << "|" << ToString(parent_activity_id)
-         << "|" << ToString(activity_id) << "|" << location << "|"
-         << static_cast<int>(level) << ": ";
+         << string_view(correlation_id_string, kUuidStringLength) << "|"
+         << string_view(parent_activity_id_string, kUuidStringLength) << "|"
+         << string_view(activity_id_string, kUuidStringLength) << "|"
+         << location << "|" << static_cast<int>(level) << ": ";
 
   va_list size_args;
   va_copy(size_args, args);
@@ -36,6 +36,7 @@ using std::string_view;
 
 using absl::StrAppend;
 using absl::StrCat;
+using google::scp::core::common::kUuidStringLength;
 using google::scp::core::common::ToString;
 using google::scp::core::common::Uuid;
 using google::scp::core::errors::SC_SYSLOG_CLOSE_CONNECTION_ERROR;
@@ -73,10 +74,19 @@ void SyslogLogProvider::Log(const LogLevel& level, const Uuid& correlation_id,
                             const string_view& cluster_name,
                             const string_view& location,
                             const string_view& message, va_list args) noexcept {
-  auto formatted_message =
-      StrCat(cluster_name, "|", machine_name, "|", component_name, "|",
-             ToString(correlation_id), "|", ToString(parent_activity_id), "|",
-             ToString(activity_id), "|", location, "|", message);
+  char correlation_id_string[kUuidStringLength];
+  char parent_activity_id_string[kUuidStringLength];
+  char activity_id_string[kUuidStringLength];
+  ToString(correlation_id, correlation_id_string);
+  ToString(parent_activity_id, parent_activity_id_string);
+  ToString(activity_id, activity_id_string);
+
+  auto formatted_message = StrCat(
+      cluster_name, "|", machine_name, "|", component_name, "|",
+      string_view(correlation_id_string, kUuidStringLength), "|",
+      string_view(parent_activity_id_string, kUuidStringLength), "|",
+      string_view(activity_id_string, kUuidStringLength), "|", location, "|",
+      message);
 
   try {
     switch (level) {
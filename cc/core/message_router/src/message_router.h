@@ -20,7 +20,7 @@
 #include <memory>
 #include <string>
 
-#include "core/common/concurrent_map/src/concurrent_map.h"
+#include "core/common/concurrent_map/src/sharded_concurrent_map.h"
 #include "core/interface/async_context.h"
 #include "core/interface/message_router_interface.h"
 #include "google/protobuf/any.pb.h"
@@ -58,6 +58,6 @@ class MessageRouter : public MessageRouterInterface<google::protobuf::Any,
  private:
   // TODO(b/229794047): Figures out a better way to store the request_type to
   // have a better performance.
-  common::ConcurrentMap<std::string, AsyncAction> actions_;
+  common::ShardedConcurrentMap<std::string, AsyncAction> actions_;
 };
 }  // namespace google::scp::core
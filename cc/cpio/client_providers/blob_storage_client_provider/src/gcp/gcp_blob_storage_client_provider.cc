@@ -94,6 +94,7 @@ using google::scp::core::FailureExecutionResult;
 using google::scp::core::FinishContext;
 using google::scp::core::ProducerStreamingContext;
 using google::scp::core::RetryExecutionResult;
+using google::scp::core::ScheduleBeforeExpiration;
 using google::scp::core::SuccessExecutionResult;
 using google::scp::core::common::kZeroUuid;
 using google::scp::core::common::TimeProvider;
@@ -203,10 +204,10 @@ ExecutionResult GcpBlobStorageClientProvider::GetBlob(
     return get_blob_context.result;
   }
 
-  if (auto schedule_result = io_async_executor_->Schedule(
+  if (auto schedule_result = ScheduleBeforeExpiration(
           bind(&GcpBlobStorageClientProvider::GetBlobInternal, this,
                get_blob_context),
-          AsyncPriority::Normal);
+          get_blob_context, io_async_executor_, AsyncPriority::Normal);
       !schedule_result.Successful()) {
     get_blob_context.result = schedule_result;
     SCP_ERROR_CONTEXT(kGcpBlobStorageClientProvider, get_blob_context,
@@ -492,10 +493,10 @@ ExecutionResult GcpBlobStorageClientProvider::ListBlobsMetadata(
     return list_blobs_context.result;
   }
 
-  if (auto schedule_result = io_async_executor_->Schedule(
+  if (auto schedule_result = ScheduleBeforeExpiration(
           bind(&GcpBlobStorageClientProvider::ListBlobsMetadataInternal, this,
                list_blobs_context),
-          AsyncPriority::Normal);
+          list_blobs_context, io_async_executor_, AsyncPriority::Normal);
       !schedule_result.Successful()) {
     list_blobs_context.result = schedule_result;
     SCP_ERROR_CONTEXT(kGcpBlobStorageClientProvider, list_blobs_context,
@@ -588,10 +589,10 @@ ExecutionResult GcpBlobStorageClientProvider::PutBlob(
     return put_blob_context.result;
   }
 
-  if (auto schedule_result = io_async_executor_->Schedule(
+  if (auto schedule_result = ScheduleBeforeExpiration(
           bind(&GcpBlobStorageClientProvider::PutBlobInternal, this,
                put_blob_context),
-          AsyncPriority::Normal);
+          put_blob_context, io_async_executor_, AsyncPriority::Normal);
       !schedule_result.Successful()) {
     put_blob_context.result = schedule_result;
     SCP_ERROR_CONTEXT(kGcpBlobStorageClientProvider, put_blob_context,
@@ -842,10 +843,10 @@ ExecutionResult GcpBlobStorageClientProvider::DeleteBlob(
     return delete_blob_context.result;
   }
 
-  if (auto schedule_result = io_async_executor_->Schedule(
+  if (auto schedule_result = ScheduleBeforeExpiration(
           bind(&GcpBlobStorageClientProvider::DeleteBlobInternal, this,
                delete_blob_context),
-          AsyncPriority::Normal);
+          delete_blob_context, io_async_executor_, AsyncPriority::Normal);
       !schedule_result.Successful()) {
     delete_blob_context.result = schedule_result;
     SCP_ERROR_CONTEXT(kGcpBlobStorageClientProvider, delete_blob_context,
@@ -43,6 +43,7 @@
 #include "proto/hpke.pb.h"
 #include "public/core/interface/execution_result.h"
 #include "public/cpio/proto/crypto_service/v1/crypto_service.pb.h"
+#include "public/cpio/utils/arena_utils/arena_utils.h"
 
 #include "error_codes.h"
 
@@ -96,9 +97,9 @@ using google::scp::core::errors::SC_CRYPTO_CLIENT_PROVIDER_SECRET_EXPORT_FAILED;
 using google::scp::core::errors::
     SC_CRYPTO_CLIENT_PROVIDER_SPLIT_CIPHERTEXT_FAILED;
 using google::scp::core::utils::Base64Decode;
+using google::scp::cpio::ArenaUtils;
 using std::bind;
 using std::isxdigit;
-using std::make_shared;
 using std::make_unique;
 using std::map;
 using std::move;
@@ -264,7 +265,7 @@ ExecutionResult CryptoClientProvider::HpkeEncrypt(
     return encrypt_context.result;
   }
 
-  encrypt_context.response = make_shared<HpkeEncryptResponse>();
+  encrypt_context.response = ArenaUtils::CreateResponse(encrypt_context);
   if (encrypt_context.request->is_bidirectional()) {
     auto secret = (*cipher)->Export(
         encrypt_context.request->exporter_context().empty()
@@ -399,7 +400,7 @@ ExecutionResult CryptoClientProvider::HpkeDecrypt(
     return decrypt_context.result;
   }
 
-  decrypt_context.response = make_shared<HpkeDecryptResponse>();
+  decrypt_context.response = ArenaUtils::CreateResponse(decrypt_context);
   if (decrypt_context.request->is_bidirectional()) {
     auto secret = (*cipher)->Export(
         decrypt_context.request->exporter_context().empty()
@@ -454,7 +455,7 @@ ExecutionResult CryptoClientProvider::AeadEncrypt(
     context.Finish();
     return context.result;
   }
-  context.response = make_shared<AeadEncryptResponse>();
+  context.response = ArenaUtils::CreateResponse(context);
   context.response->mutable_encrypted_data()->set_ciphertext((*ciphertext));
   context.result = SuccessExecutionResult();
   context.Finish();
@@ -488,7 +489,7 @@ ExecutionResult CryptoClientProvider::AeadDecrypt(
     context.Finish();
     return context.result;
   }
-  context.response = make_shared<AeadDecryptResponse>();
+  context.response = ArenaUtils::CreateResponse(context);
   context.response->set_payload((*payload));
   context.result = SuccessExecutionResult();
   context.Finish();
@@ -39,6 +39,8 @@
 
 using google::scp::core::AsyncExecutor;
 using google::scp::core::AsyncExecutorInterface;
+using google::scp::core::AsyncExecutorOptions;
+using google::scp::core::ElasticThreadCountOptions;
 using google::scp::core::ExecutionResult;
 using google::scp::core::FailureExecutionResult;
 using google::scp::core::Http1CurlClient;
@@ -61,6 +63,8 @@ static constexpr char kLibCpioProvider[] = "LibCpioProvider";
 static const size_t kThreadPoolThreadCount = 2;
 static const size_t kThreadPoolQueueSize = 100000;
 static const size_t kIOThreadPoolThreadCount = 2;
+// The IO pool grows up to this many threads while blocking calls pile up.
+static const size_t kIOThreadPoolMaxThreadCount = 16;
 static const size_t kIOThreadPoolQueueSize = 100000;
 
 namespace google::scp::cpio::client_providers {
@@ -293,8 +297,12 @@ ExecutionResult LibCpioProvider::GetIoAsyncExecutor(
     return SuccessExecutionResult();
   }
 
-  io_async_executor_ = make_shared<AsyncExecutor>(kIOThreadPoolThreadCount,
-                                                  kIOThreadPoolQueueSize);
+  ElasticThreadCountOptions elastic_thread_count_options;
+  elastic_thread_count_options.max_thread_count = kIOThreadPoolMaxThreadCount;
+  io_async_executor_ = make_shared<AsyncExecutor>(AsyncExecutorOptions{
+      .thread_count = kIOThreadPoolThreadCount,
+      .queue_cap = kIOThreadPoolQueueSize,
+      .elastic_thread_count_options = elastic_thread_count_options});
   auto execution_result = io_async_executor_->Init();
   if (!execution_result.Successful()) {
     SCP_ERROR(kLibCpioProvider, kZeroUuid, execution_result,
@@ -36,6 +36,7 @@
 #include "public/cpio/interface/metric_client/metric_client_interface.h"
 #include "public/cpio/interface/metric_client/type_def.h"
 #include "public/cpio/proto/metric_service/v1/metric_service.pb.h"
+#include "public/cpio/utils/arena_utils/arena_utils.h"
 
 #include "aws_metric_client_utils.h"
 #include "cloud_watch_error_converter.h"
@@ -64,6 +65,7 @@ using google::scp::core::errors::
     SC_AWS_METRIC_CLIENT_PROVIDER_REQUEST_PAYLOAD_OVERSIZE;
 using google::scp::core::errors::
     SC_AWS_METRIC_CLIENT_PROVIDER_SHOULD_ENABLE_BATCH_RECORDING;
+using google::scp::cpio::ArenaUtils;
 using google::scp::cpio::client_providers::AwsInstanceClientUtils;
 using google::scp::cpio::common::CreateClientConfiguration;
 using std::bind;
@@ -229,7 +231,8 @@ void AwsMetricClientProvider::OnPutMetricDataAsyncCallback(
   active_push_count_--;
   if (outcome.IsSuccess()) {
     for (auto& record_metric_context : metric_requests_vector) {
-      record_metric_context.response = make_shared<PutMetricsResponse>();
+      record_metric_context.response =
+          ArenaUtils::CreateResponse(record_metric_context);
       FinishContext(SuccessExecutionResult(), record_metric_context,
                     async_executor_);
     }
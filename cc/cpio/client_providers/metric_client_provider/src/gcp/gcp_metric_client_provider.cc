@@ -28,6 +28,7 @@
 #include "google/cloud/monitoring/metric_connection.h"
 #include "public/core/interface/execution_result.h"
 #include "public/cpio/proto/metric_service/v1/metric_service.pb.h"
+#include "public/cpio/utils/arena_utils/arena_utils.h"
 
 #include "error_codes.h"
 #include "gcp_metric_client_utils.h"
@@ -48,6 +49,7 @@ using google::scp::core::ExecutionResult;
 using google::scp::core::FailureExecutionResult;
 using google::scp::core::SuccessExecutionResult;
 using google::scp::core::common::kZeroUuid;
+using google::scp::cpio::ArenaUtils;
 using google::scp::cpio::client_providers::GcpInstanceClientUtils;
 using google::scp::cpio::client_providers::GcpInstanceResourceNameDetails;
 using google::scp::cpio::client_providers::GcpMetricClientUtils;
@@ -212,7 +214,8 @@ void GcpMetricClientProvider::OnAsyncCreateTimeSeriesCallback(
   }
 
   for (auto& record_metric_context : *metric_requests_vector) {
-    record_metric_context.response = make_shared<PutMetricsResponse>();
+    record_metric_context.response =
+        ArenaUtils::CreateResponse(record_metric_context);
     record_metric_context.result = result;
     record_metric_context.Finish();
   }
@@ -22,6 +22,7 @@
 #include <utility>
 #include <vector>
 
+#include "core/coroutine/src/async_coroutine.h"
 #include "core/interface/async_context.h"
 #include "core/interface/http_client_interface.h"
 #include "core/interface/http_types.h"
@@ -38,6 +39,8 @@ using google::cmrt::sdk::private_key_service::v1::ListPrivateKeysRequest;
 using google::cmrt::sdk::private_key_service::v1::ListPrivateKeysResponse;
 using google::cmrt::sdk::private_key_service::v1::PrivateKey;
 using google::scp::core::AsyncContext;
+using google::scp::core::AwaitContext;
+using google::scp::core::DetachedCoroutine;
 using google::scp::core::ExecutionResult;
 using google::scp::core::ExecutionResultOr;
 using google::scp::core::FailureExecutionResult;
@@ -49,14 +52,12 @@ using google::scp::core::common::kZeroUuid;
 using google::scp::core::errors::
     SC_PRIVATE_KEY_CLIENT_PROVIDER_UNMATCHED_ENDPOINTS_SPLITS;
 using std::atomic;
-using std::bind;
 using std::make_pair;
 using std::make_shared;
 using std::move;
 using std::shared_ptr;
 using std::string;
 using std::vector;
-using std::placeholders::_1;
 
 static constexpr char kPrivateKeyClientProvider[] = "PrivateKeyClientProvider";
 
@@ -84,7 +85,8 @@ ExecutionResult PrivateKeyClientProvider::Stop() noexcept {
 ExecutionResult PrivateKeyClientProvider::ListPrivateKeys(
     AsyncContext<ListPrivateKeysRequest, ListPrivateKeysResponse>&
         list_private_keys_context) noexcept {
-  auto list_keys_status = make_shared<ListPrivateKeysStatus>();
+  auto list_keys_status =
+      make_shared<ListPrivateKeysStatus>(list_private_keys_context);
   list_keys_status->listing_method =
       list_private_keys_context.request->key_ids().empty()
           ? ListingMethod::kByMaxAge
@@ -114,15 +116,9 @@ ExecutionResult PrivateKeyClientProvider::ListPrivateKeys(
       request->key_vending_endpoint =
           make_shared<PrivateKeyVendingEndpoint>(endpoint);
 
-      AsyncContext<PrivateKeyFetchingRequest, PrivateKeyFetchingResponse>
-          fetch_private_key_context(
-              move(request),
-              bind(&PrivateKeyClientProvider::OnFetchPrivateKeyCallback, this,
-                   list_private_keys_context, _1, list_keys_status, uri_index),
-              list_private_keys_context);
-
-      auto execution_result =
-          private_key_fetcher_->FetchPrivateKey(fetch_private_key_context);
+      auto execution_result = SuccessExecutionResult();
+      FetchAndDecryptKeys(list_keys_status, move(request), uri_index,
+                          execution_result);
 
       if (!execution_result.Successful()) {
         // To avoid running context.Finish() repeatedly, use
@@ -146,19 +142,32 @@ ExecutionResult PrivateKeyClientProvider::ListPrivateKeys(
   return SuccessExecutionResult();
 }
 
-void PrivateKeyClientProvider::OnFetchPrivateKeyCallback(
-    AsyncContext<ListPrivateKeysRequest, ListPrivateKeysResponse>&
-        list_private_keys_context,
-    AsyncContext<PrivateKeyFetchingRequest, PrivateKeyFetchingResponse>&
-        fetch_private_key_context,
+DetachedCoroutine PrivateKeyClientProvider::FetchAndDecryptKeys(
     shared_ptr<ListPrivateKeysStatus> list_keys_status,
-    size_t uri_index) noexcept {
+    shared_ptr<PrivateKeyFetchingRequest> request, size_t uri_index,
+    ExecutionResult& fetch_start_result) noexcept {
+  auto& list_private_keys_context = list_keys_status->list_private_keys_context;
+  AsyncContext<PrivateKeyFetchingRequest, PrivateKeyFetchingResponse>
+      fetch_private_key_context(move(request), nullptr,
+                                list_private_keys_context);
+  auto start_result = SuccessExecutionResult();
+  auto execution_result =
+      co_await AwaitContext(fetch_private_key_context, [&](auto& context) {
+        start_result = private_key_fetcher_->FetchPrivateKey(context);
+        return start_result;
+      });
+  if (!start_result.Successful()) {
+    // The coroutine did not suspend, so the caller is still waiting for the
+    // result.
+    fetch_start_result = start_result;
+    co_return;
+  }
+
   if (list_keys_status->got_failure.load()) {
-    return;
+    co_return;
   }
 
   list_keys_status->fetching_call_returned_count.fetch_add(1);
-  auto execution_result = fetch_private_key_context.result;
   if (list_keys_status->listing_method == ListingMethod::kByKeyId) {
     ExecutionResult out;
     if (auto insert_result =
@@ -177,7 +186,7 @@ void PrivateKeyClientProvider::OnFetchPrivateKeyCallback(
                           "Failed to insert fetch result");
         list_private_keys_context.Finish();
       }
-      return;
+      co_return;
     }
     // For ListByKeyId, store the key IDs no matter the fetching failed or not.
     list_keys_status->set_mutex.lock();
@@ -191,12 +200,10 @@ void PrivateKeyClientProvider::OnFetchPrivateKeyCallback(
   // For empty key list, call callback directly.
   if (!execution_result.Successful() ||
       fetch_private_key_context.response->encryption_keys.empty()) {
-    AsyncContext<DecryptRequest, DecryptResponse> decrypt_context(
-        make_shared<DecryptRequest>(), [](auto&) {});
+    AsyncContext<DecryptRequest, DecryptResponse> decrypt_context;
     decrypt_context.result = SuccessExecutionResult();
-    OnDecryptCallback(list_private_keys_context, decrypt_context,
-                      list_keys_status, nullptr, uri_index);
-    return;
+    OnDecryptCallback(decrypt_context, list_keys_status, nullptr, uri_index);
+    co_return;
   }
 
   list_keys_status->total_key_split_count.fetch_add(
@@ -209,9 +216,9 @@ void PrivateKeyClientProvider::OnFetchPrivateKeyCallback(
       list_keys_status->key_id_set.insert(*encryption_key->key_id);
       list_keys_status->set_mutex.unlock();
     }
-    DecryptRequest kms_decrypt_request;
+    auto kms_decrypt_request = make_shared<DecryptRequest>();
     execution_result = PrivateKeyClientUtils::GetKmsDecryptRequest(
-        encryption_key, kms_decrypt_request);
+        encryption_key, *kms_decrypt_request);
     if (!execution_result.Successful()) {
       auto got_failure = false;
       if (list_keys_status->got_failure.compare_exchange_strong(got_failure,
@@ -222,39 +229,54 @@ void PrivateKeyClientProvider::OnFetchPrivateKeyCallback(
                           "Failed to get the key data.");
         list_private_keys_context.Finish();
       }
-      return;
+      co_return;
     }
-    kms_decrypt_request.set_account_identity(
+    kms_decrypt_request->set_account_identity(
         fetch_private_key_context.request->key_vending_endpoint
             ->account_identity);
-    kms_decrypt_request.set_kms_region(
+    kms_decrypt_request->set_kms_region(
         fetch_private_key_context.request->key_vending_endpoint
             ->service_region);
     // Only used for GCP.
-    kms_decrypt_request.set_gcp_wip_provider(
+    kms_decrypt_request->set_gcp_wip_provider(
         fetch_private_key_context.request->key_vending_endpoint
             ->gcp_wip_provider);
-    AsyncContext<DecryptRequest, DecryptResponse> decrypt_context(
-        make_shared<DecryptRequest>(kms_decrypt_request),
-        bind(&PrivateKeyClientProvider::OnDecryptCallback, this,
-             list_private_keys_context, _1, list_keys_status, encryption_key,
-             uri_index),
-        list_private_keys_context);
-    execution_result = kms_client_provider_->Decrypt(decrypt_context);
+    // The splits are decrypted concurrently, each in its own coroutine.
+    DecryptKeySplit(list_keys_status, encryption_key,
+                    move(kms_decrypt_request), uri_index);
+    if (list_keys_status->got_failure.load()) {
+      co_return;
+    }
+  }
+}
 
-    if (!execution_result.Successful()) {
-      auto got_failure = false;
-      if (list_keys_status->got_failure.compare_exchange_strong(got_failure,
-                                                                true)) {
-        list_private_keys_context.result = execution_result;
-        SCP_ERROR_CONTEXT(kPrivateKeyClientProvider, list_private_keys_context,
-                          list_private_keys_context.result,
-                          "Failed to send decrypt request.");
-        list_private_keys_context.Finish();
-      }
-      return;
+DetachedCoroutine PrivateKeyClientProvider::DecryptKeySplit(
+    shared_ptr<ListPrivateKeysStatus> list_keys_status,
+    shared_ptr<EncryptionKey> encryption_key,
+    shared_ptr<DecryptRequest> decrypt_request, size_t uri_index) noexcept {
+  auto& list_private_keys_context = list_keys_status->list_private_keys_context;
+  AsyncContext<DecryptRequest, DecryptResponse> decrypt_context(
+      move(decrypt_request), nullptr, list_private_keys_context);
+  auto start_result = SuccessExecutionResult();
+  co_await AwaitContext(decrypt_context, [&](auto& context) {
+    start_result = kms_client_provider_->Decrypt(context);
+    return start_result;
+  });
+  if (!start_result.Successful()) {
+    auto got_failure = false;
+    if (list_keys_status->got_failure.compare_exchange_strong(got_failure,
+                                                              true)) {
+      list_private_keys_context.result = start_result;
+      SCP_ERROR_CONTEXT(kPrivateKeyClientProvider, list_private_keys_context,
+                        list_private_keys_context.result,
+                        "Failed to send decrypt request.");
+      list_private_keys_context.Finish();
     }
+    co_return;
   }
+
+  OnDecryptCallback(decrypt_context, list_keys_status, encryption_key,
+                    uri_index);
 }
 
 ExecutionResult InsertDecryptResult(
@@ -277,15 +299,16 @@ ExecutionResult InsertDecryptResult(
 }
 
 void PrivateKeyClientProvider::OnDecryptCallback(
-    AsyncContext<ListPrivateKeysRequest, ListPrivateKeysResponse>&
-        list_private_keys_context,
     AsyncContext<DecryptRequest, DecryptResponse>& decrypt_context,
-    shared_ptr<ListPrivateKeysStatus> list_keys_status,
-    shared_ptr<EncryptionKey> encryption_key, size_t uri_index) noexcept {
+    const shared_ptr<ListPrivateKeysStatus>& list_keys_status,
+    const shared_ptr<EncryptionKey>& encryption_key,
+    size_t uri_index) noexcept {
   if (list_keys_status->got_failure.load()) {
     return;
   }
 
+  auto& list_private_keys_context = list_keys_status->list_private_keys_context;
+
   atomic<size_t> finished_key_split_count_prev(
       list_keys_status->finished_key_split_count.load() - 1);
   if (encryption_key) {
@@ -35,6 +35,13 @@
 #include "error_codes.h"
 #include "private_key_client_utils.h"
 
+namespace google::scp::core {
+// Defined in core/coroutine/src/async_coroutine.h, which needs C++20. Only the
+// implementation of the provider includes it, so that the targets depending
+// on this header can stay on C++17.
+struct DetachedCoroutine;
+}  // namespace google::scp::core
+
 namespace google::scp::cpio::client_providers {
 /*! @copydoc PrivateKeyClientProviderInterface
  */
@@ -68,14 +75,28 @@ class PrivateKeyClientProvider : public PrivateKeyClientProviderInterface {
  protected:
   /// The overrall status of the whole ListPrivateKeys call.
   struct ListPrivateKeysStatus {
-    ListPrivateKeysStatus()
-        : total_key_split_count(0),
+    explicit ListPrivateKeysStatus(
+        const core::AsyncContext<
+            cmrt::sdk::private_key_service::v1::ListPrivateKeysRequest,
+            cmrt::sdk::private_key_service::v1::ListPrivateKeysResponse>&
+            list_private_keys_context)
+        : list_private_keys_context(list_private_keys_context),
+          total_key_split_count(0),
           finished_key_split_count(0),
           fetching_call_returned_count(0),
           got_failure(false) {}
 
     virtual ~ListPrivateKeysStatus() = default;
 
+    /**
+     * @brief The ListPrivateKeys context. It is copied once here and shared by
+     * the fetching and decrypting coroutines.
+     */
+    core::AsyncContext<
+        cmrt::sdk::private_key_service::v1::ListPrivateKeysRequest,
+        cmrt::sdk::private_key_service::v1::ListPrivateKeysResponse>
+        list_private_keys_context;
+
     /// List of ExecutionResult.
     std::vector<KeysResultPerEndpoint> result_list;
 
@@ -100,46 +121,56 @@ class PrivateKeyClientProvider : public PrivateKeyClientProviderInterface {
   };
 
   /**
-   * @brief Is called after FetchPrivateKey is completed.
+   * @brief Fetches the keys from one endpoint and decrypts their splits. The
+   * coroutine starts right away and frees itself once it is done.
    *
-   * @param list_private_keys_context ListPrivateKeys context.
-   * @param fetch_private_key_context FetchPrivateKey context.
-   * @param kms_client KMS client instance for current endpoint.
-   * @param list_keys_status ListPrivateKeys operation status.
-   * @param endpoints_status operation status of endpoints for one key.
+   * @param list_keys_status ListPrivateKeys operation status, holding the
+   * ListPrivateKeys context.
+   * @param request the FetchPrivateKey request.
    * @param uri_index endpoint index in endpoints vector.
+   * @param fetch_start_result is set to the failure if FetchPrivateKey cannot
+   * be started. The coroutine returns right away in that case, so the result
+   * is only set before the call returns.
+   */
+  core::DetachedCoroutine FetchAndDecryptKeys(
+      std::shared_ptr<ListPrivateKeysStatus> list_keys_status,
+      std::shared_ptr<PrivateKeyFetchingRequest> request, size_t uri_index,
+      core::ExecutionResult& fetch_start_result) noexcept;
+
+  /**
+   * @brief Decrypts one key split with KMS. The coroutine starts right away
+   * and frees itself once it is done.
    *
+   * @param list_keys_status ListPrivateKeys operation status, holding the
+   * ListPrivateKeys context.
+   * @param encryption_key the key whose split is decrypted.
+   * @param decrypt_request the KMS client Decrypt request.
+   * @param uri_index endpoint index in endpoints vector.
    */
-  virtual void OnFetchPrivateKeyCallback(
-      core::AsyncContext<
-          cmrt::sdk::private_key_service::v1::ListPrivateKeysRequest,
-          cmrt::sdk::private_key_service::v1::ListPrivateKeysResponse>&
-          list_private_keys_context,
-      core::AsyncContext<PrivateKeyFetchingRequest, PrivateKeyFetchingResponse>&
-          fetch_private_key_context,
+  core::DetachedCoroutine DecryptKeySplit(
       std::shared_ptr<ListPrivateKeysStatus> list_keys_status,
+      std::shared_ptr<EncryptionKey> encryption_key,
+      std::shared_ptr<cmrt::sdk::kms_service::v1::DecryptRequest>
+          decrypt_request,
       size_t uri_index) noexcept;
 
   /**
-   * @brief Is called after Decrpyt is completed.
+   * @brief Is called after Decrypt is completed.
    *
-   * @param list_private_keys_context ListPrivateKeys context.
    * @param decrypt_context KMS client Decrypt context.
-   * @param list_keys_status ListPrivateKeys operation status.
-   * @param endpoints_status operation status of endpoints for one key.
+   * @param list_keys_status ListPrivateKeys operation status, holding the
+   * ListPrivateKeys context.
+   * @param encryption_key the key whose split was decrypted.
    * @param uri_index endpoint index in endpoints vector.
    *
    */
   virtual void OnDecryptCallback(
-      core::AsyncContext<
-          cmrt::sdk::private_key_service::v1::ListPrivateKeysRequest,
-          cmrt::sdk::private_key_service::v1::ListPrivateKeysResponse>&
-          list_private_keys_context,
       core::AsyncContext<cmrt::sdk::kms_service::v1::DecryptRequest,
                          cmrt::sdk::kms_service::v1::DecryptResponse>&
           decrypt_context,
-      std::shared_ptr<ListPrivateKeysStatus> list_keys_status,
-      std::shared_ptr<EncryptionKey> encryption_key, size_t uri_index) noexcept;
+      const std::shared_ptr<ListPrivateKeysStatus>& list_keys_status,
+      const std::shared_ptr<EncryptionKey>& encryption_key,
+      size_t uri_index) noexcept;
 
   /// Configurations for PrivateKeyClient.
   std::shared_ptr<PrivateKeyClientOptions> private_key_client_options_;
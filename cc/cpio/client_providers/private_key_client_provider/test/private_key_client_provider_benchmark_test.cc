@@ -0,0 +1,216 @@
+// Copyright 2022 Google LLC
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <atomic>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "core/interface/async_context.h"
+#include "cpio/client_providers/interface/kms_client_provider_interface.h"
+#include "cpio/client_providers/interface/private_key_fetcher_provider_interface.h"
+#include "cpio/client_providers/private_key_client_provider/src/private_key_client_provider.h"
+#include "public/core/interface/execution_result.h"
+#include "public/cpio/proto/private_key_service/v1/private_key_service.pb.h"
+
+using google::cmrt::sdk::kms_service::v1::DecryptRequest;
+using google::cmrt::sdk::kms_service::v1::DecryptResponse;
+using google::cmrt::sdk::private_key_service::v1::ListPrivateKeysRequest;
+using google::cmrt::sdk::private_key_service::v1::ListPrivateKeysResponse;
+using google::scp::core::AsyncContext;
+using google::scp::core::ExecutionResult;
+using google::scp::core::SuccessExecutionResult;
+using std::atomic;
+using std::make_pair;
+using std::make_shared;
+using std::map;
+using std::memory_order_relaxed;
+using std::pair;
+using std::shared_ptr;
+using std::string;
+using std::vector;
+
+/// Counts the heap allocations done by the process.
+static atomic<size_t> allocation_count(0);
+
+void* operator new(size_t size) {
+  allocation_count.fetch_add(1, memory_order_relaxed);
+  if (auto* ptr = std::malloc(size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept {
+  std::free(ptr);
+}
+
+namespace google::scp::cpio::client_providers::test {
+static const vector<string> kEndpoints = {"endpoint1", "endpoint2",
+                                          "endpoint3"};
+static const vector<string> kKeyIds = {"key_id_1", "key_id_2", "key_id_3"};
+static constexpr char kKeyEncryptionKeyUri[] =
+    "aws-kms://arn:aws:kms:us-east-1:012345678901:key/abcd";
+static constexpr char kPlaintext[] = "0123456789ab";
+
+/// Completes every fetch inline with a key split for the endpoint.
+class FakePrivateKeyFetcher : public PrivateKeyFetcherProviderInterface {
+ public:
+  FakePrivateKeyFetcher() {
+    for (size_t uri_index = 0; uri_index < kEndpoints.size(); ++uri_index) {
+      for (const auto& key_id : kKeyIds) {
+        auto encryption_key = make_shared<EncryptionKey>();
+        encryption_key->key_id = make_shared<string>(key_id);
+        encryption_key->resource_name = make_shared<string>(key_id);
+        encryption_key->encryption_key_type =
+            EncryptionKeyType::kMultiPartyHybridEvenKeysplit;
+        encryption_key->public_key_material =
+            make_shared<string>("public_key");
+        encryption_key->public_keyset_handle = make_shared<string>("handle");
+        for (size_t i = 0; i < kEndpoints.size(); ++i) {
+          auto key_data = make_shared<KeyData>();
+          key_data->key_encryption_key_uri =
+              make_shared<string>(kKeyEncryptionKeyUri);
+          key_data->public_key_signature = make_shared<string>("signature");
+          if (i == uri_index) {
+            key_data->key_material = make_shared<string>(key_id);
+          }
+          encryption_key->key_data.push_back(key_data);
+        }
+        auto response = make_shared<PrivateKeyFetchingResponse>();
+        response->encryption_keys.push_back(encryption_key);
+        responses_[make_pair(kEndpoints[uri_index], key_id)] = response;
+      }
+    }
+  }
+
+  core::ExecutionResult Init() noexcept override {
+    return SuccessExecutionResult();
+  }
+
+  core::ExecutionResult Run() noexcept override {
+    return SuccessExecutionResult();
+  }
+
+  core::ExecutionResult Stop() noexcept override {
+    return SuccessExecutionResult();
+  }
+
+  core::ExecutionResult FetchPrivateKey(
+      AsyncContext<PrivateKeyFetchingRequest, PrivateKeyFetchingResponse>&
+          context) noexcept override {
+    context.response = responses_.at(make_pair(
+        context.request->key_vending_endpoint
+            ->private_key_vending_service_endpoint,
+        *context.request->key_id));
+    context.result = SuccessExecutionResult();
+    context.Finish();
+    return SuccessExecutionResult();
+  }
+
+ private:
+  map<pair<string, string>, shared_ptr<PrivateKeyFetchingResponse>>
+      responses_;
+};
+
+/// Completes every decryption inline with the same plaintext.
+class FakeKmsClient : public KmsClientProviderInterface {
+ public:
+  core::ExecutionResult Init() noexcept override {
+    return SuccessExecutionResult();
+  }
+
+  core::ExecutionResult Run() noexcept override {
+    return SuccessExecutionResult();
+  }
+
+  core::ExecutionResult Stop() noexcept override {
+    return SuccessExecutionResult();
+  }
+
+  core::ExecutionResult Decrypt(
+      AsyncContext<DecryptRequest, DecryptResponse>& context) noexcept
+      override {
+    context.response = make_shared<DecryptResponse>();
+    context.response->set_plaintext(kPlaintext);
+    context.result = SuccessExecutionResult();
+    context.Finish();
+    return SuccessExecutionResult();
+  }
+};
+
+/**
+ * @brief Lists the keys by ID from every endpoint, going through one fetch per
+ * key and endpoint and one decryption per key split, and reports the heap
+ * allocations per ListPrivateKeys request. The fakes complete inline, so the
+ * count covers the whole callback chain.
+ */
+static void BM_ListPrivateKeysAllocations(benchmark::State& state) {
+  auto options = make_shared<PrivateKeyClientOptions>();
+  for (size_t i = 0; i < kEndpoints.size(); ++i) {
+    PrivateKeyVendingEndpoint endpoint;
+    endpoint.account_identity = "account";
+    endpoint.service_region = "region";
+    endpoint.private_key_vending_service_endpoint = kEndpoints[i];
+    if (i == 0) {
+      options->primary_private_key_vending_endpoint = endpoint;
+    } else {
+      options->secondary_private_key_vending_endpoints.push_back(endpoint);
+    }
+  }
+  PrivateKeyClientProvider private_key_client_provider(
+      options, nullptr, make_shared<FakePrivateKeyFetcher>(),
+      make_shared<FakeKmsClient>());
+  private_key_client_provider.Init();
+  private_key_client_provider.Run();
+
+  auto request = make_shared<ListPrivateKeysRequest>();
+  for (const auto& key_id : kKeyIds) {
+    request->add_key_ids(key_id);
+  }
+  size_t succeeded_count = 0;
+  auto allocation_count_before = allocation_count.load();
+  for (auto _ : state) {
+    AsyncContext<ListPrivateKeysRequest, ListPrivateKeysResponse> context(
+        request, [&succeeded_count](auto& context) {
+          if (context.result.Successful() &&
+              context.response->private_keys_size() == kKeyIds.size()) {
+            succeeded_count++;
+          }
+        });
+    private_key_client_provider.ListPrivateKeys(context);
+  }
+  auto allocations = allocation_count.load() - allocation_count_before;
+  private_key_client_provider.Stop();
+
+  if (succeeded_count != state.iterations()) {
+    state.SkipWithError("ListPrivateKeys did not succeed.");
+  }
+  state.counters["AllocsPerRequest"] =
+      static_cast<double>(allocations) / state.iterations();
+  state.SetItemsProcessed(state.iterations());
+}
+}  // namespace google::scp::cpio::client_providers::test
+
+BENCHMARK(
+    google::scp::cpio::client_providers::test::BM_ListPrivateKeysAllocations);
+
+// Run the benchmark
+BENCHMARK_MAIN();
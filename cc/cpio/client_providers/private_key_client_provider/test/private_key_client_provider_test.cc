@@ -20,7 +20,9 @@
 #include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -71,12 +73,15 @@ using std::atomic;
 using std::byte;
 using std::make_pair;
 using std::make_shared;
+using std::lock_guard;
 using std::make_unique;
 using std::map;
 using std::move;
+using std::mutex;
 using std::pair;
 using std::shared_ptr;
 using std::string;
+using std::thread;
 using std::unique_ptr;
 using std::vector;
 using testing::ElementsAre;
@@ -385,6 +390,72 @@ TEST_F(PrivateKeyClientProviderTest, ListPrivateKeysByIdsSuccess) {
   WaitUntil([&]() { return response_count.load() == 1; });
 }
 
+TEST_F(PrivateKeyClientProviderTest,
+       ListPrivateKeysByIdsSuccessWithAsyncCompletion) {
+  // Finishes the fetching and decrypting contexts on other threads, so that
+  // the provider resumes after the calls that started them have returned.
+  mutex threads_mutex;
+  vector<thread> threads;
+  auto finish_on_thread = [&](auto context) {
+    lock_guard lock(threads_mutex);
+    threads.emplace_back([context]() mutable { context.Finish(); });
+  };
+
+  EXPECT_CALL(*mock_kms_client, Decrypt)
+      .Times(9)
+      .WillRepeatedly(
+          [&](AsyncContext<DecryptRequest, DecryptResponse>& context) {
+            context.response = make_shared<DecryptResponse>();
+            context.response->set_plaintext(
+                kPlaintextMap.at(context.request->ciphertext()));
+            context.result = SuccessExecutionResult();
+            finish_on_thread(context);
+            return SuccessExecutionResult();
+          });
+  EXPECT_CALL(*mock_private_key_fetcher, FetchPrivateKey)
+      .Times(9)
+      .WillRepeatedly([&](AsyncContext<PrivateKeyFetchingRequest,
+                                       PrivateKeyFetchingResponse>& context) {
+        const auto& endpoint = context.request->key_vending_endpoint
+                                   ->private_key_vending_service_endpoint;
+        context.response = make_shared<PrivateKeyFetchingResponse>(
+            kMockSuccessKeyFetchingResponses.at(*context.request->key_id)
+                .at(endpoint));
+        context.result = SuccessExecutionResult();
+        finish_on_thread(context);
+        return SuccessExecutionResult();
+      });
+  ListPrivateKeysRequest request;
+  request.add_key_ids(kTestKeyIds[0]);
+  request.add_key_ids(kTestKeyIds[1]);
+  request.add_key_ids(kTestKeyIds[2]);
+
+  string encoded_private_key;
+  Base64Encode(kTestPrivateKey, encoded_private_key);
+  atomic<size_t> response_count = 0;
+  AsyncContext<ListPrivateKeysRequest, ListPrivateKeysResponse> context(
+      make_shared<ListPrivateKeysRequest>(request),
+      [&](AsyncContext<ListPrivateKeysRequest, ListPrivateKeysResponse>&
+              context) {
+        auto expected_keys = BuildExpectedPrivateKeys(encoded_private_key);
+        EXPECT_THAT(context.response->private_keys(),
+                    Pointwise(EqualsProto(), expected_keys));
+        EXPECT_SUCCESS(context.result);
+        response_count.fetch_add(1);
+      });
+
+  auto result = private_key_client_provider->ListPrivateKeys(context);
+  EXPECT_SUCCESS(result);
+  WaitUntil([&]() { return response_count.load() == 1; });
+
+  // The decrypting threads are only started by the fetching threads, so all
+  // of them are started once the response is received.
+  lock_guard lock(threads_mutex);
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
 TEST_F(PrivateKeyClientProviderTest, ListPrivateKeysByAgeSuccess) {
   auto mock_result = SuccessExecutionResult();
   SetMockKmsClient(mock_result, 9);
@@ -116,6 +116,17 @@ ExecutionResult PublicKeyClientProvider::Stop() noexcept {
 ExecutionResult PublicKeyClientProvider::ListPublicKeys(
     AsyncContext<ListPublicKeysRequest, ListPublicKeysResponse>&
         public_key_fetching_context) noexcept {
+  // The callers asking for the same keys at the same time share one fetch.
+  return list_public_keys_single_flight_.Do(
+      public_key_fetching_context.request->SerializeAsString(),
+      public_key_fetching_context,
+      [this](AsyncContext<ListPublicKeysRequest, ListPublicKeysResponse>&
+                 context) { return FetchPublicKeys(context); });
+}
+
+ExecutionResult PublicKeyClientProvider::FetchPublicKeys(
+    AsyncContext<ListPublicKeysRequest, ListPublicKeysResponse>&
+        public_key_fetching_context) noexcept {
   // Use got_success_result and unfinished_counter to track whether get success
   // response and how many failed responses. Only return one response whether
   // success or failed.
@@ -17,7 +17,9 @@
 #pragma once
 
 #include <memory>
+#include <string>
 
+#include "core/common/single_flight/src/single_flight.h"
 #include "core/interface/async_context.h"
 #include "core/interface/http_client_interface.h"
 #include "core/interface/http_types.h"
@@ -54,6 +56,19 @@ class PublicKeyClientProvider : public PublicKeyClientProviderInterface {
           context) noexcept override;
 
  protected:
+  /**
+   * @brief Fetches the public keys from the configured endpoints. The first
+   * endpoint to respond successfully completes the context.
+   *
+   * @param public_key_fetching_context the context of the fetch.
+   * @return core::ExecutionResult the result of starting the fetch.
+   */
+  core::ExecutionResult FetchPublicKeys(
+      core::AsyncContext<
+          cmrt::sdk::public_key_service::v1::ListPublicKeysRequest,
+          cmrt::sdk::public_key_service::v1::ListPublicKeysResponse>&
+          public_key_fetching_context) noexcept;
+
   /**
    * @brief Triggered when ListPublicKeysRequest arrives.
    *
@@ -86,5 +101,11 @@ class PublicKeyClientProvider : public PublicKeyClientProviderInterface {
 
   /// Configurations for PublicKeyClient.
   std::shared_ptr<PublicKeyClientOptions> public_key_client_options_;
+
+  /// Coalesces the concurrent ListPublicKeys calls into a single fetch.
+  core::common::SingleFlight<
+      std::string, cmrt::sdk::public_key_service::v1::ListPublicKeysRequest,
+      cmrt::sdk::public_key_service::v1::ListPublicKeysResponse>
+      list_public_keys_single_flight_;
 };
 }  // namespace google::scp::cpio::client_providers
@@ -19,6 +19,7 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "core/http2_client/mock/mock_http_client.h"
 #include "core/interface/async_context.h"
@@ -56,6 +57,7 @@ using std::move;
 using std::shared_ptr;
 using std::string;
 using std::unique_ptr;
+using std::vector;
 
 static constexpr char kPublicKeyHeaderDate[] = "date";
 static constexpr char kPublicKeyHeaderCacheControl[] = "cache-control";
@@ -271,4 +273,41 @@ TEST_F(PublicKeyClientProviderTestII, ListPublicKeysPartialUriSuccess) {
   WaitUntil([&]() { return perform_calls.load() == 2; });
 }
 
+TEST_F(PublicKeyClientProviderTestII, ConcurrentListPublicKeysShareAFetch) {
+  vector<AsyncContext<HttpRequest, HttpResponse>> http_contexts;
+  http_client_->perform_request_mock =
+      [&](AsyncContext<HttpRequest, HttpResponse>& http_context) {
+        http_contexts.push_back(http_context);
+        return SuccessExecutionResult();
+      };
+
+  atomic<int> success_callback(0);
+  for (int i = 0; i < 3; i++) {
+    AsyncContext<ListPublicKeysRequest, ListPublicKeysResponse> context(
+        make_shared<ListPublicKeysRequest>(),
+        [&](AsyncContext<ListPublicKeysRequest, ListPublicKeysResponse>&
+                context) {
+          EXPECT_SUCCESS(context.result);
+          EXPECT_EQ(context.response->public_keys()[0].key_id(), "1234");
+          success_callback++;
+        });
+    EXPECT_SUCCESS(public_key_client_->ListPublicKeys(context));
+  }
+  // A single request per uri.
+  ASSERT_EQ(http_contexts.size(), 2);
+
+  for (auto& http_context : http_contexts) {
+    http_context.response = make_shared<HttpResponse>(GetValidHttpResponse());
+    http_context.result = SuccessExecutionResult();
+    http_context.Finish();
+  }
+  EXPECT_EQ(success_callback, 3);
+
+  // The next call fetches the keys again.
+  AsyncContext<ListPublicKeysRequest, ListPublicKeysResponse> context(
+      make_shared<ListPublicKeysRequest>(), [](auto&) {});
+  EXPECT_SUCCESS(public_key_client_->ListPublicKeys(context));
+  EXPECT_EQ(http_contexts.size(), 4);
+}
+
 }  // namespace google::scp::cpio::client_providers::test
@@ -24,6 +24,7 @@
 #include "core/interface/errors.h"
 #include "cpio/client_providers/global_cpio/src/global_cpio.h"
 #include "public/core/interface/execution_result.h"
+#include "public/cpio/adapters/common/adapter_utils.h"
 #include "public/cpio/interface/blob_storage_client/type_def.h"
 #include "public/cpio/proto/blob_storage_service/v1/blob_storage_service.pb.h"
 
@@ -119,24 +120,28 @@ ExecutionResult BlobStorageClient::Stop() noexcept {
 
 ExecutionResult BlobStorageClient::GetBlob(
     AsyncContext<GetBlobRequest, GetBlobResponse> get_blob_context) noexcept {
+  TraceAsyncContext(get_blob_context);
   return blob_storage_client_provider_->GetBlob(get_blob_context);
 }
 
 ExecutionResult BlobStorageClient::ListBlobsMetadata(
     AsyncContext<ListBlobsMetadataRequest, ListBlobsMetadataResponse>
         list_blobs_metadata_context) noexcept {
+  TraceAsyncContext(list_blobs_metadata_context);
   return blob_storage_client_provider_->ListBlobsMetadata(
       list_blobs_metadata_context);
 }
 
 ExecutionResult BlobStorageClient::PutBlob(
     AsyncContext<PutBlobRequest, PutBlobResponse> put_blob_context) noexcept {
+  TraceAsyncContext(put_blob_context);
   return blob_storage_client_provider_->PutBlob(put_blob_context);
 }
 
 ExecutionResult BlobStorageClient::DeleteBlob(
     AsyncContext<DeleteBlobRequest, DeleteBlobResponse>
         delete_blob_context) noexcept {
+  TraceAsyncContext(delete_blob_context);
   return blob_storage_client_provider_->DeleteBlob(delete_blob_context);
 }
 
@@ -20,6 +20,8 @@
 #include <memory>
 #include <utility>
 
+#include "core/common/time_provider/src/time_provider.h"
+#include "core/common/tracing/src/global_tracer.h"
 #include "core/interface/async_context.h"
 #include "core/utils/src/error_utils.h"
 #include "public/core/interface/execution_result.h"
@@ -49,6 +51,68 @@ void OnExecutionCallback(Callback<TResponse>& client_callback,
                   std::move(*context.response));
 }
 
+/**
+ * @brief Records a span named after the request proto from now until the
+ * callback of the context runs.
+ *
+ * @tparam TRequest request type of the async call.
+ * @tparam TResponse response type of the async call.
+ * @param tracer the tracer that sampled the context.
+ * @param context async context, whose callback is wrapped.
+ */
+template <typename TRequest, typename TResponse>
+void RecordSpanOnCallback(core::common::Tracer& tracer,
+                          core::AsyncContext<TRequest, TResponse>& context) {
+  auto start_timestamp =
+      core::common::TimeProvider::GetSteadyTimestampInNanosecondsAsClockTicks();
+  // The names of the protos live as long as the process.
+  context.callback = [&tracer, start_timestamp, callback = context.callback](
+                         core::AsyncContext<TRequest, TResponse>& context) {
+    core::common::RecordContextSpan(tracer,
+                                    TRequest::descriptor()->name().c_str(),
+                                    context, start_timestamp);
+    callback(context);
+  };
+}
+
+/**
+ * @brief Traces the async call of the context, if the tracer samples it.
+ *
+ * @tparam TRequest request type of the async call.
+ * @tparam TResponse response type of the async call.
+ * @param context async context, whose callback is wrapped.
+ */
+template <typename TRequest, typename TResponse>
+void TraceAsyncContext(core::AsyncContext<TRequest, TResponse>& context) {
+  if (auto* tracer = core::common::GetSampledTracer(context.correlation_id)) {
+    RecordSpanOnCallback(*tracer, context);
+  }
+}
+
+/**
+ * @brief Calls func with the context, tracing the async call if the tracer
+ * samples it. For the calls that take the context of the caller by reference:
+ * a sampled call gets a copy of the context, so that the callback of the
+ * caller is not wrapped again every time it reuses the context.
+ *
+ * @tparam TRequest request type of the async call.
+ * @tparam TResponse response type of the async call.
+ * @param context async context.
+ * @param func the call to make with the context.
+ * @return core::ExecutionResult execution result of func.
+ */
+template <typename TRequest, typename TResponse, typename TFunction>
+core::ExecutionResult ExecuteTraced(
+    core::AsyncContext<TRequest, TResponse>& context, TFunction&& func) {
+  auto* tracer = core::common::GetSampledTracer(context.correlation_id);
+  if (!tracer) {
+    return func(context);
+  }
+  auto traced_context = context;
+  RecordSpanOnCallback(*tracer, traced_context);
+  return func(traced_context);
+}
+
 /**
  * @brief Executes the async call.
  *
@@ -68,6 +132,7 @@ core::ExecutionResult Execute(std::function<core::ExecutionResult(
       bind(OnExecutionCallback<TRequest, TResponse>, callback,
            std::placeholders::_1),
       activity_id, activity_id);
+  TraceAsyncContext(context);
 
   return core::utils::ConvertToPublicExecutionResult(func(context));
 }
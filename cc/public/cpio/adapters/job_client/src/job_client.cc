@@ -24,6 +24,7 @@
 #include "core/interface/errors.h"
 #include "cpio/client_providers/global_cpio/src/global_cpio.h"
 #include "public/core/interface/execution_result.h"
+#include "public/cpio/adapters/common/adapter_utils.h"
 #include "public/cpio/proto/job_service/v1/job_service.pb.h"
 
 using google::cmrt::sdk::job_service::v1::DeleteOrphanedJobMessageRequest;
@@ -120,47 +121,60 @@ ExecutionResult JobClient::Stop() noexcept {
 
 ExecutionResult JobClient::PutJob(
     AsyncContext<PutJobRequest, PutJobResponse>& put_job_context) noexcept {
-  return job_client_provider_->PutJob(put_job_context);
+  return ExecuteTraced(put_job_context, [this](auto& context) {
+    return job_client_provider_->PutJob(context);
+  });
 }
 
 ExecutionResult JobClient::GetNextJob(
     AsyncContext<GetNextJobRequest, GetNextJobResponse>&
         get_next_job_context) noexcept {
-  return job_client_provider_->GetNextJob(get_next_job_context);
+  return ExecuteTraced(get_next_job_context, [this](auto& context) {
+    return job_client_provider_->GetNextJob(context);
+  });
 }
 
 ExecutionResult JobClient::GetJobById(
     AsyncContext<GetJobByIdRequest, GetJobByIdResponse>&
         get_job_by_id_context) noexcept {
-  return job_client_provider_->GetJobById(get_job_by_id_context);
+  return ExecuteTraced(get_job_by_id_context, [this](auto& context) {
+    return job_client_provider_->GetJobById(context);
+  });
 };
 
 ExecutionResult JobClient::UpdateJobBody(
     AsyncContext<UpdateJobBodyRequest, UpdateJobBodyResponse>&
         update_job_body_context) noexcept {
-  return job_client_provider_->UpdateJobBody(update_job_body_context);
+  return ExecuteTraced(update_job_body_context, [this](auto& context) {
+    return job_client_provider_->UpdateJobBody(context);
+  });
 };
 
 ExecutionResult JobClient::UpdateJobStatus(
     AsyncContext<UpdateJobStatusRequest, UpdateJobStatusResponse>&
         update_job_status_context) noexcept {
-  return job_client_provider_->UpdateJobStatus(update_job_status_context);
+  return ExecuteTraced(update_job_status_context, [this](auto& context) {
+    return job_client_provider_->UpdateJobStatus(context);
+  });
 };
 
 ExecutionResult JobClient::UpdateJobVisibilityTimeout(
     AsyncContext<UpdateJobVisibilityTimeoutRequest,
                  UpdateJobVisibilityTimeoutResponse>&
         update_job_visibility_timeout_context) noexcept {
-  return job_client_provider_->UpdateJobVisibilityTimeout(
-      update_job_visibility_timeout_context);
+  return ExecuteTraced(
+      update_job_visibility_timeout_context, [this](auto& context) {
+        return job_client_provider_->UpdateJobVisibilityTimeout(context);
+      });
 };
 
 ExecutionResult JobClient::DeleteOrphanedJobMessage(
     AsyncContext<DeleteOrphanedJobMessageRequest,
                  DeleteOrphanedJobMessageResponse>&
         delete_orphaned_job_context) noexcept {
-  return job_client_provider_->DeleteOrphanedJobMessage(
-      delete_orphaned_job_context);
+  return ExecuteTraced(delete_orphaned_job_context, [this](auto& context) {
+    return job_client_provider_->DeleteOrphanedJobMessage(context);
+  });
 };
 
 unique_ptr<JobClientInterface> JobClientFactory::Create(
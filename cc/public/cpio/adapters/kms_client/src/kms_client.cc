@@ -25,6 +25,7 @@
 #include "cpio/client_providers/global_cpio/src/global_cpio.h"
 #include "cpio/client_providers/interface/role_credentials_provider_interface.h"
 #include "public/core/interface/execution_result.h"
+#include "public/cpio/adapters/common/adapter_utils.h"
 #include "public/cpio/proto/kms_service/v1/kms_service.pb.h"
 
 using google::cmrt::sdk::kms_service::v1::DecryptRequest;
@@ -99,6 +100,7 @@ ExecutionResult KmsClient::Stop() noexcept {
 
 ExecutionResult KmsClient::Decrypt(
     AsyncContext<DecryptRequest, DecryptResponse> decrypt_context) noexcept {
+  TraceAsyncContext(decrypt_context);
   return kms_client_provider_->Decrypt(decrypt_context);
 }
 
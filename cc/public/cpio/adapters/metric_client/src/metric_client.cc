@@ -118,6 +118,7 @@ ExecutionResult MetricClient::Stop() noexcept {
 
 core::ExecutionResult MetricClient::PutMetrics(
     AsyncContext<PutMetricsRequest, PutMetricsResponse> context) noexcept {
+  TraceAsyncContext(context);
   return metric_client_provider_->PutMetrics(move(context));
 }
 
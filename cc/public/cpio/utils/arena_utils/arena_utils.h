@@ -0,0 +1,94 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+#include <google/protobuf/arena.h>
+
+#include "core/interface/async_context.h"
+
+namespace google::scp::cpio {
+/// The size of the first block of a context arena, allocated with the arena.
+static constexpr size_t kArenaContextInitialBlockSize = 1024;
+
+class ArenaUtils {
+ public:
+  /**
+   * @brief Creates an AsyncContext whose request is allocated on a protobuf
+   * arena of its own. The arena and its first block are a single heap
+   * allocation, and they live as long as any copy of the context, its request
+   * or a response created with CreateResponse.
+   *
+   * The request is empty, and is filled in through context.request before the
+   * context is passed to the client.
+   *
+   * @tparam RequestT the request type. It must be a protobuf message.
+   * @tparam ResponseT the response type. It must be a protobuf message.
+   * @param callback the callback of the context.
+   * @param context_args the trailing arguments of the AsyncContext constructor,
+   * like the parent context or activity id.
+   * @return core::AsyncContext<RequestT, ResponseT> the context.
+   */
+  template <typename RequestT, typename ResponseT, typename... ContextArgs>
+  static core::AsyncContext<RequestT, ResponseT> CreateAsyncContext(
+      typename core::AsyncContext<RequestT, ResponseT>::Callback callback,
+      ContextArgs&&... context_args) noexcept {
+    auto arena_block = std::make_shared<ArenaBlock>();
+    auto* request =
+        google::protobuf::Arena::CreateMessage<RequestT>(&arena_block->arena);
+    return core::AsyncContext<RequestT, ResponseT>(
+        std::shared_ptr<RequestT>(arena_block, request), std::move(callback),
+        std::forward<ContextArgs>(context_args)...);
+  }
+
+  /**
+   * @brief Creates the response of the context. It is allocated on the arena
+   * of the request and shares its ownership when the context was created with
+   * CreateAsyncContext, and is allocated on the heap otherwise.
+   *
+   * @param context the context to create the response for.
+   * @return std::shared_ptr<ResponseT> the empty response.
+   */
+  template <typename RequestT, typename ResponseT>
+  static std::shared_ptr<ResponseT> CreateResponse(
+      const core::AsyncContext<RequestT, ResponseT>& context) noexcept {
+    google::protobuf::Arena* arena =
+        context.request ? context.request->GetArena() : nullptr;
+    if (arena == nullptr) {
+      return std::make_shared<ResponseT>();
+    }
+    // The owner of the request owns its arena.
+    return std::shared_ptr<ResponseT>(
+        context.request,
+        google::protobuf::Arena::CreateMessage<ResponseT>(arena));
+  }
+
+ private:
+  /// An arena that starts with the block allocated along with it.
+  struct ArenaBlock {
+    ArenaBlock() : arena(initial_block, sizeof(initial_block)) {}
+
+    // Declared before the arena, as the arena uses it from construction to
+    // destruction.
+    alignas(std::max_align_t) char initial_block[kArenaContextInitialBlockSize];
+    google::protobuf::Arena arena;
+  };
+};
+}  // namespace google::scp::cpio
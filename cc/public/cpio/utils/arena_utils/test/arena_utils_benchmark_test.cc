@@ -0,0 +1,170 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+#include <utility>
+
+#include <benchmark/benchmark.h>
+
+#include "core/interface/async_context.h"
+#include "public/cpio/proto/crypto_service/v1/crypto_service.pb.h"
+#include "public/cpio/proto/metric_service/v1/metric_service.pb.h"
+#include "public/cpio/utils/arena_utils/arena_utils.h"
+
+using google::cmrt::sdk::crypto_service::v1::AeadEncryptRequest;
+using google::cmrt::sdk::crypto_service::v1::AeadEncryptResponse;
+using google::cmrt::sdk::metric_service::v1::PutMetricsRequest;
+using google::cmrt::sdk::metric_service::v1::PutMetricsResponse;
+using google::scp::core::AsyncContext;
+using google::scp::cpio::ArenaUtils;
+using std::atomic;
+using std::make_shared;
+using std::memory_order_relaxed;
+using std::string;
+using std::to_string;
+
+/// The number of heap allocations made by the process.
+static atomic<int64_t> allocation_count(0);
+
+void* operator new(size_t size) {
+  allocation_count.fetch_add(1, memory_order_relaxed);
+  if (void* pointer = std::malloc(size)) {
+    return pointer;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept {
+  std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+  std::free(pointer);
+}
+
+namespace google::scp::cpio::test {
+/// The number of metrics in a PutMetrics request.
+static constexpr int kMetricCount = 10;
+/// The payload of an AeadEncrypt request.
+static constexpr char kPayload[] = "a payload of a typical size for a request";
+
+/// Creates the contexts of the round trips on the heap.
+struct HeapContextFactory {
+  template <typename RequestT, typename ResponseT>
+  static AsyncContext<RequestT, ResponseT> CreateAsyncContext(
+      typename AsyncContext<RequestT, ResponseT>::Callback callback) {
+    return AsyncContext<RequestT, ResponseT>(make_shared<RequestT>(),
+                                             std::move(callback));
+  }
+
+  template <typename RequestT, typename ResponseT>
+  static std::shared_ptr<ResponseT> CreateResponse(
+      const AsyncContext<RequestT, ResponseT>&) {
+    return make_shared<ResponseT>();
+  }
+};
+
+/// Creates the contexts of the round trips with ArenaUtils.
+struct ArenaContextFactory {
+  template <typename RequestT, typename ResponseT>
+  static AsyncContext<RequestT, ResponseT> CreateAsyncContext(
+      typename AsyncContext<RequestT, ResponseT>::Callback callback) {
+    return ArenaUtils::CreateAsyncContext<RequestT, ResponseT>(
+        std::move(callback));
+  }
+
+  template <typename RequestT, typename ResponseT>
+  static std::shared_ptr<ResponseT> CreateResponse(
+      const AsyncContext<RequestT, ResponseT>& context) {
+    return ArenaUtils::CreateResponse(context);
+  }
+};
+
+/// Reports the heap allocations per iteration of the benchmark.
+static void ReportAllocations(benchmark::State& state,
+                              int64_t initial_allocation_count) {
+  state.counters["allocations"] = benchmark::Counter(
+      allocation_count.load() - initial_allocation_count,
+      benchmark::Counter::kAvgIterations);
+  state.SetItemsProcessed(state.iterations());
+}
+
+/**
+ * @brief Builds an AeadEncrypt context, and completes it the way
+ * CryptoClientProvider does, with the encryption itself left out.
+ */
+template <typename ContextFactory>
+static void BM_AeadEncryptRoundTrip(benchmark::State& state) {
+  auto initial_allocation_count = allocation_count.load();
+  for (auto _ : state) {
+    auto context = ContextFactory::template CreateAsyncContext<
+        AeadEncryptRequest, AeadEncryptResponse>(
+        [](AsyncContext<AeadEncryptRequest, AeadEncryptResponse>& context) {
+          benchmark::DoNotOptimize(
+              context.response->encrypted_data().ciphertext().data());
+        });
+    context.request->set_payload(kPayload);
+    context.request->set_secret("secret");
+    context.request->set_shared_info("shared info");
+
+    context.response = ContextFactory::CreateResponse(context);
+    context.response->mutable_encrypted_data()->set_ciphertext(
+        context.request->payload());
+    context.Finish();
+  }
+  ReportAllocations(state, initial_allocation_count);
+}
+
+/**
+ * @brief Builds a PutMetrics context with labeled metrics, and completes it the
+ * way MetricClientProvider does once the metrics are pushed.
+ */
+template <typename ContextFactory>
+static void BM_PutMetricsRoundTrip(benchmark::State& state) {
+  auto initial_allocation_count = allocation_count.load();
+  for (auto _ : state) {
+    auto context = ContextFactory::template CreateAsyncContext<
+        PutMetricsRequest, PutMetricsResponse>(
+        [](AsyncContext<PutMetricsRequest, PutMetricsResponse>& context) {
+          benchmark::DoNotOptimize(context.response.get());
+        });
+    context.request->set_metric_namespace("namespace");
+    for (int i = 0; i < kMetricCount; i++) {
+      auto* metric = context.request->add_metrics();
+      metric->set_name("metric" + to_string(i));
+      metric->set_value(to_string(i));
+      (*metric->mutable_labels())["label"] = "label value";
+    }
+
+    context.response = ContextFactory::CreateResponse(context);
+    context.Finish();
+  }
+  ReportAllocations(state, initial_allocation_count);
+}
+
+BENCHMARK_TEMPLATE(BM_AeadEncryptRoundTrip, HeapContextFactory);
+BENCHMARK_TEMPLATE(BM_AeadEncryptRoundTrip, ArenaContextFactory);
+BENCHMARK_TEMPLATE(BM_PutMetricsRoundTrip, HeapContextFactory);
+BENCHMARK_TEMPLATE(BM_PutMetricsRoundTrip, ArenaContextFactory);
+}  // namespace google::scp::cpio::test
+
+// Run the benchmark
+BENCHMARK_MAIN();
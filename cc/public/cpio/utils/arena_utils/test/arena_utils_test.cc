@@ -0,0 +1,125 @@
+/*
+ * Copyright 2023 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "public/cpio/utils/arena_utils/arena_utils.h"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+
+#include "core/common/uuid/src/uuid.h"
+#include "core/interface/async_context.h"
+#include "public/cpio/proto/crypto_service/v1/crypto_service.pb.h"
+#include "public/cpio/proto/metric_service/v1/metric_service.pb.h"
+
+using google::cmrt::sdk::crypto_service::v1::AeadEncryptRequest;
+using google::cmrt::sdk::crypto_service::v1::AeadEncryptResponse;
+using google::cmrt::sdk::metric_service::v1::PutMetricsRequest;
+using google::cmrt::sdk::metric_service::v1::PutMetricsResponse;
+using google::scp::core::AsyncContext;
+using google::scp::core::common::Uuid;
+using std::make_shared;
+using std::shared_ptr;
+using std::string;
+
+namespace google::scp::cpio::test {
+TEST(ArenaUtilsTest, CreatesRequestOnArena) {
+  auto parent_activity_id = Uuid::GenerateUuid();
+  bool callback_called = false;
+  auto context = ArenaUtils::CreateAsyncContext<PutMetricsRequest,
+                                                PutMetricsResponse>(
+      [&](AsyncContext<PutMetricsRequest, PutMetricsResponse>& context) {
+        EXPECT_EQ(context.request->metric_namespace(), "namespace");
+        callback_called = true;
+      },
+      parent_activity_id);
+
+  ASSERT_NE(context.request, nullptr);
+  EXPECT_NE(context.request->GetArena(), nullptr);
+  EXPECT_EQ(context.response, nullptr);
+  EXPECT_EQ(context.parent_activity_id, parent_activity_id);
+
+  context.request->set_metric_namespace("namespace");
+  auto* metric = context.request->add_metrics();
+  metric->set_name("metric");
+  (*metric->mutable_labels())["label"] = "value";
+  EXPECT_EQ(metric->GetArena(), context.request->GetArena());
+
+  context.Finish();
+  EXPECT_TRUE(callback_called);
+}
+
+TEST(ArenaUtilsTest, ContextsDoNotShareArenas) {
+  auto context1 =
+      ArenaUtils::CreateAsyncContext<PutMetricsRequest, PutMetricsResponse>(
+          [](auto&) {});
+  auto context2 =
+      ArenaUtils::CreateAsyncContext<PutMetricsRequest, PutMetricsResponse>(
+          [](auto&) {});
+
+  EXPECT_NE(context1.request->GetArena(), context2.request->GetArena());
+}
+
+TEST(ArenaUtilsTest, ResponseIsCreatedOnArenaOfRequest) {
+  auto context =
+      ArenaUtils::CreateAsyncContext<AeadEncryptRequest, AeadEncryptResponse>(
+          [](auto&) {});
+  context.request->set_payload("payload");
+
+  context.response = ArenaUtils::CreateResponse(context);
+
+  ASSERT_NE(context.response, nullptr);
+  EXPECT_EQ(context.response->GetArena(), context.request->GetArena());
+  EXPECT_FALSE(context.response->has_encrypted_data());
+}
+
+TEST(ArenaUtilsTest, MessagesOutliveContext) {
+  // Larger than the first block of the arena.
+  string large_payload(4 * kArenaContextInitialBlockSize, 'p');
+  shared_ptr<AeadEncryptRequest> request;
+  shared_ptr<AeadEncryptResponse> response;
+  {
+    auto context =
+        ArenaUtils::CreateAsyncContext<AeadEncryptRequest, AeadEncryptResponse>(
+            [](auto&) {});
+    context.request->set_payload(large_payload);
+    context.response = ArenaUtils::CreateResponse(context);
+    context.response->mutable_encrypted_data()->set_ciphertext("ciphertext");
+
+    auto context_copy = context;
+    response = context_copy.response;
+    request = context.request;
+  }
+
+  EXPECT_EQ(request->payload(), large_payload);
+  request.reset();
+  EXPECT_EQ(response->encrypted_data().ciphertext(), "ciphertext");
+}
+
+TEST(ArenaUtilsTest, ResponseIsCreatedOnHeapWithoutArena) {
+  AsyncContext<AeadEncryptRequest, AeadEncryptResponse> context(
+      make_shared<AeadEncryptRequest>(), [](auto&) {});
+
+  context.response = ArenaUtils::CreateResponse(context);
+
+  ASSERT_NE(context.response, nullptr);
+  EXPECT_EQ(context.response->GetArena(), nullptr);
+
+  AsyncContext<AeadEncryptRequest, AeadEncryptResponse> empty_context;
+  EXPECT_NE(ArenaUtils::CreateResponse(empty_context), nullptr);
+}
+}  // namespace google::scp::cpio::test
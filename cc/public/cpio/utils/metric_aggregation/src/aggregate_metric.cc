@@ -36,6 +36,7 @@
 
 using google::cmrt::sdk::metric_service::v1::PutMetricsRequest;
 using google::cmrt::sdk::metric_service::v1::PutMetricsResponse;
+using google::scp::core::AsyncCompletionPolicy;
 using google::scp::core::AsyncContext;
 using google::scp::core::AsyncExecutorInterface;
 using google::scp::core::AsyncPriority;
@@ -211,6 +212,9 @@ void AggregateMetric::MetricPushHandler(
         }
       },
       object_activity_id_, object_activity_id_);
+  // The callback only logs failures, so it is not worth an executor task.
+  record_metric_context.completion_policy =
+      AsyncCompletionPolicy::InlineCheapCallback;
 
   auto metrics_count = record_metric_context.request->metrics().size();
   auto execution_result =
@@ -34,6 +34,7 @@
 
 using google::cmrt::sdk::metric_service::v1::PutMetricsRequest;
 using google::cmrt::sdk::metric_service::v1::PutMetricsResponse;
+using google::scp::core::AsyncCompletionPolicy;
 using google::scp::core::AsyncContext;
 using google::scp::core::AsyncPriority;
 using google::scp::core::ExecutionResult;
@@ -83,6 +84,9 @@ void SimpleMetric::RunMetricPush(
         }
       },
       activity_id, activity_id);
+  // Logging a failure is cheap enough to do on the completing thread.
+  record_metric_context.completion_policy =
+      AsyncCompletionPolicy::InlineCheapCallback;
   auto metrics_count = record_metric_context.request->metrics().size();
   auto execution_result =
       metric_client_->PutMetrics(move(record_metric_context));
@@ -27,7 +27,7 @@
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "core/async_executor/src/async_executor.h"
-#include "core/common/lru_cache/src/lru_cache.h"
+#include "core/common/lru_cache/src/sharded_lru_cache.h"
 #include "core/interface/service_interface.h"
 #include "public/core/interface/execution_result.h"
 #include "roma/interface/roma.h"
@@ -201,7 +201,8 @@ class Dispatcher : public core::ServiceInterface {
             return;
           }
 
-          if (!code_object_cache_.Contains(request->version_num)) {
+          auto code_object = code_object_cache_.Get(request->version_num);
+          if (!code_object) {
             response_or = std::make_unique<absl::StatusOr<ResponseObject>>(
                 absl::Status(absl::StatusCode::kInternal,
                              "Could not find code version in cache."));
@@ -210,11 +211,10 @@ class Dispatcher : public core::ServiceInterface {
             return;
           }
 
-          auto request_type =
-              code_object_cache_.Get(request->version_num).js.empty()
-                  ? constants::kRequestTypeWasm
-                  : constants::kRequestTypeJavascript;
-          if (!code_object_cache_.Get(request->version_num).wasm_bin.empty()) {
+          auto request_type = code_object->js.empty()
+                                  ? constants::kRequestTypeWasm
+                                  : constants::kRequestTypeJavascript;
+          if (!code_object->wasm_bin.empty()) {
             request_type = constants::kRequestTypeJavascriptWithWasm;
           }
 
@@ -291,6 +291,6 @@ class Dispatcher : public core::ServiceInterface {
   std::atomic<size_t> worker_index_;
   std::atomic<size_t> pending_requests_;
   const size_t max_pending_requests_;
-  core::common::LruCache<uint64_t, CodeObject> code_object_cache_;
+  core::common::ShardedLruCache<uint64_t, CodeObject> code_object_cache_;
 };
 }  // namespace google::scp::roma::sandbox::dispatcher